@@ -0,0 +1,110 @@
+#ifndef J2ME_ALLOC_PROFILER_H
+#define J2ME_ALLOC_PROFILER_H
+
+#include "j2me_types.h"
+#include "j2me_class.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file j2me_alloc_profiler.h
+ * @brief 堆分配分析器
+ *
+ * 通过堆的分配回调按class_id统计对象数和字节数；每分配约N字节采样一次，
+ * 记录正在执行的方法和pc（分配点）。报告在分析器销毁时（虚拟机退出）写出，
+ * 运行中收到SIGUSR1后在下一个时间片写出一次当前快照。
+ */
+
+// 默认采样间隔（字节）
+#define J2ME_ALLOC_PROFILER_DEFAULT_INTERVAL (16 * 1024)
+
+// 报告格式
+typedef enum {
+    J2ME_ALLOC_REPORT_TEXT = 0,     // 文本
+    J2ME_ALLOC_REPORT_JSON          // JSON
+} j2me_alloc_report_format_t;
+
+// 按类统计
+typedef struct {
+    uint32_t class_id;              // 类ID
+    bool used;                      // 槽位已使用
+    uint64_t objects;               // 分配对象数
+    uint64_t bytes;                 // 分配字节数（对象数据大小）
+} j2me_alloc_class_stats_t;
+
+// 采样到的分配点
+typedef struct {
+    const j2me_method_t* method;    // 分配时正在执行的方法，不在字节码中时为NULL
+    uint32_t pc;                    // 字节码偏移（分配指令的下一条指令，与返回地址的约定相同）
+    uint32_t class_id;              // 分配的类ID
+    bool used;                      // 槽位已使用
+    uint64_t samples;               // 样本数（每个样本代表约一个采样间隔的字节）
+} j2me_alloc_site_t;
+
+// 分配分析器
+typedef struct j2me_alloc_profiler {
+    j2me_vm_t* vm;                          // 虚拟机实例
+    char* report_path;                      // 报告路径
+    j2me_alloc_report_format_t format;      // 报告格式
+
+    // 按类统计（开放寻址哈希表，线性探测）
+    j2me_alloc_class_stats_t* classes;      // 槽位数组
+    size_t class_capacity;                  // 槽位数 (2的幂)
+    size_t class_count;                     // 已统计的类数
+
+    // 分配点采样（开放寻址哈希表，线性探测）
+    j2me_alloc_site_t* sites;               // 槽位数组
+    size_t site_capacity;                   // 槽位数 (2的幂)
+    size_t site_count;                      // 已记录的分配点数
+    size_t sample_interval;                 // 采样间隔（字节）
+    int64_t bytes_until_sample;             // 距下一次采样的字节数
+
+    // 汇总
+    uint64_t total_objects;                 // 分配对象总数
+    uint64_t total_bytes;                   // 分配字节总数
+    uint64_t total_samples;                 // 样本总数
+    uint64_t reports_written;               // 已写出的报告数
+} j2me_alloc_profiler_t;
+
+/**
+ * @brief 创建分配分析器并挂到虚拟机的堆上
+ * @param vm 虚拟机实例
+ * @param report_path 报告路径，以.json结尾时输出JSON，否则输出文本
+ * @param sample_interval 分配点采样间隔（字节），0表示使用默认值
+ * @return 分配分析器，失败返回NULL
+ */
+j2me_alloc_profiler_t* j2me_alloc_profiler_create(j2me_vm_t* vm, const char* report_path, size_t sample_interval);
+
+/**
+ * @brief 写出最终报告，从堆上摘下并销毁分析器
+ *
+ * 报告中的方法名和类名来自类加载器，必须在类加载器销毁之前调用。
+ *
+ * @param profiler 分配分析器
+ */
+void j2me_alloc_profiler_destroy(j2me_alloc_profiler_t* profiler);
+
+/**
+ * @brief 写出当前统计（覆盖报告文件）
+ * @param profiler 分配分析器
+ * @return 错误码
+ */
+j2me_error_t j2me_alloc_profiler_write_report(j2me_alloc_profiler_t* profiler);
+
+/**
+ * @brief 安装SIGUSR1处理函数：收到信号后由j2me_alloc_profiler_poll写出报告
+ */
+void j2me_alloc_profiler_install_signal_handler(void);
+
+/**
+ * @brief 请求写出报告（可以在信号处理函数中调用）
+ */
+void j2me_alloc_profiler_request_report(void);
+
+/**
+ * @brief 有写出请求时写出报告（在时间片之间调用）
+ * @param profiler 分配分析器
+ */
+void j2me_alloc_profiler_poll(j2me_alloc_profiler_t* profiler);
+
+#endif // J2ME_ALLOC_PROFILER_H
@@ -239,6 +239,20 @@
 #define OPCODE_GOTO_W       0xc8    // 宽索引无条件跳转
 #define OPCODE_JSR_W        0xc9    // 宽索引跳转到子程序
 
+// 快速指令 (0xcb-0xd4, VM内部使用)
+// 解析成功后由j2me_quicken_instruction原地改写，操作数保持常量池索引不变，
+// 解析结果保存在所属类的quick_entries表中
+#define OPCODE_LDC_QUICK            0xcb    // 已解析的ldc
+#define OPCODE_LDC_W_QUICK          0xcc    // 已解析的ldc_w
+#define OPCODE_GETSTATIC_QUICK      0xcd    // 已解析的getstatic
+#define OPCODE_PUTSTATIC_QUICK      0xce    // 已解析的putstatic
+#define OPCODE_GETFIELD_QUICK       0xcf    // 已解析的getfield
+#define OPCODE_PUTFIELD_QUICK       0xd0    // 已解析的putfield
+#define OPCODE_INVOKEVIRTUAL_QUICK  0xd1    // 已解析的invokevirtual
+#define OPCODE_INVOKESPECIAL_QUICK  0xd2    // 已解析的invokespecial
+#define OPCODE_INVOKESTATIC_QUICK   0xd3    // 已解析的invokestatic
+#define OPCODE_INVOKEINTERFACE_QUICK 0xd4   // 已解析的invokeinterface
+
 // 数组类型常量
 #define T_BOOLEAN   4
 #define T_CHAR      5
@@ -94,10 +94,34 @@ struct j2me_field {
     // 解析后的信息
     const char* name;
     const char* descriptor;
-    size_t offset;              // 在对象中的偏移量
+    size_t offset;              // 实例字段为对象数据中的字节偏移，静态字段为static_values下标 (链接时计算)
     j2me_class_t* owner_class;  // 所属类
 };
 
+// 实例对象数据开头存放类指针，字段布局从其后开始
+#define J2ME_INSTANCE_HEADER_SIZE sizeof(j2me_class_t*)
+
+/**
+ * @brief 字段在对象中占用的字节数
+ * @param descriptor 字段描述符
+ * @return 字节数 (boolean/byte为1，char/short为2，long/double为8，其余为4)
+ */
+static inline size_t j2me_field_storage_size(const char* descriptor) {
+    switch (descriptor ? descriptor[0] : 'I') {
+        case 'Z':
+        case 'B':
+            return 1;
+        case 'C':
+        case 'S':
+            return 2;
+        case 'J':
+        case 'D':
+            return 8;
+        default:
+            return 4;           // int、float和对象引用 (引用是32位堆引用)
+    }
+}
+
 // 方法信息
 struct j2me_method {
     uint16_t access_flags;
@@ -115,11 +139,25 @@ struct j2me_method {
     j2me_class_t* owner_class;  // 所属类
     
     // 运行时信息
-    uint32_t invocation_count;  // 调用次数 (用于JIT优化)
+    uint32_t invocation_count;  // 进入次数（调用和时间片恢复，JIT据此选择热点方法）
     bool is_native;             // 是否为本地方法
-    void* native_function;      // 本地方法指针
+    void* native_function;      // 本地方法实现 (j2me_native_method_func_t，第一次调用时从注册表绑定)
+    void* predecoded;           // 预解码指令流缓存 (j2me_predecoded_method_t)
+    void* stack_bounds;         // 线程化分发引擎的栈深度检查表，按字节码偏移索引 (j2me_stack_bound_t[bytecode_length])
+    uint16_t vtable_index;      // 虚方法表槽位，非虚方法为J2ME_VTABLE_INDEX_NONE
+    void* call_sites;           // 调用点内联缓存，按字节码偏移索引 (j2me_call_site_cache_t*[bytecode_length])
+    void* jit_code;             // JIT编译结果 (j2me_jit_method_t)
 };
 
+// 非虚方法（静态、私有、构造方法）的虚方法表槽位
+#define J2ME_VTABLE_INDEX_NONE 0xFFFF
+
+// 接口方法表条目：一个已实现接口到实现方法的映射
+typedef struct {
+    j2me_class_t* interface_class;  // 接口类
+    j2me_method_t** methods;        // 实现方法，按接口methods数组下标排列（未实现为NULL）
+} j2me_itable_entry_t;
+
 // 类状态
 typedef enum {
     CLASS_LOADED = 0,           // 已加载
@@ -142,6 +180,7 @@ struct j2me_class {
     // 常量池
     j2me_constant_pool_t constant_pool;
     void* constant_cache;       // 常量池缓存 (j2me_constant_cache_t*)
+    void* quick_entries;        // 快速指令解析结果，按常量池索引 (j2me_quick_entry_t*)
     
     // 字段和方法
     uint16_t fields_count;
@@ -151,14 +190,24 @@ struct j2me_class {
     
     // 解析后的信息
     const char* name;           // 类名
+    uint32_t name_hash;         // 类名哈希 (加入类加载器时计算)
     const char* super_name;     // 父类名
     j2me_class_t* super_class_ptr; // 父类指针
     j2me_class_state_t state;   // 类状态
     
+    // 分派表 (链接时构建)
+    j2me_method_t** vtable;     // 虚方法表，按vtable_index索引
+    uint16_t vtable_size;       // 虚方法表槽位数
+    j2me_itable_entry_t* itable; // 接口方法表（包括父类和父接口）
+    uint16_t itable_size;       // 接口方法表条目数
+    
     // 运行时信息
-    size_t instance_size;       // 实例大小
+    size_t instance_size;       // 实例数据大小 (含开头的类指针和父类字段，链接时计算)
+    void* static_values;        // 静态字段存储，按静态字段的offset索引 (j2me_value_t*，链接时分配)
+    uint16_t static_count;      // 静态字段槽位数
     j2me_method_t* clinit;      // 类初始化方法
     j2me_class_loader_t* loader; // 类加载器
+    bool image_backed;          // 常量池字符串和字节码指向类缓存映像（不单独释放）
     
     // 链表节点 (用于类加载器管理)
     j2me_class_t* next;
@@ -170,6 +219,17 @@ struct j2me_class_loader {
     char* classpath;              // 类路径
     j2me_vm_t* vm;               // 虚拟机实例
     void* jar_file;              // JAR文件对象 (j2me_jar_file_t*)
+    void* class_cache;           // 解析后类缓存 (j2me_class_cache_t*，持有一个引用)
+    
+    // 按类名索引的开放寻址哈希表（线性探测）
+    j2me_class_t** class_table;  // 槽位数组，空槽为NULL
+    size_t class_table_capacity; // 槽位数 (2的幂)
+    size_t class_count;          // 已加载类数
+    
+    // 查找统计
+    uint64_t lookup_count;       // 查找次数
+    uint64_t lookup_hits;        // 命中次数
+    uint64_t lookup_probes;      // 探测的槽位总数
 };
 
 /**
@@ -210,6 +270,32 @@ j2me_class_t* j2me_class_loader_load_class(j2me_class_loader_t* loader, const ch
  */
 j2me_class_t* j2me_class_loader_find_class(j2me_class_loader_t* loader, const char* class_name);
 
+/**
+ * @brief 按堆对象的class_id查找已加载的类（实例的class_id是类指针的低32位）
+ * @param loader 类加载器
+ * @param class_id 类ID
+ * @return 类指针，未找到返回NULL
+ */
+j2me_class_t* j2me_class_loader_find_class_by_id(j2me_class_loader_t* loader, uint32_t class_id);
+
+/**
+ * @brief 把已解析的类加入类加载器（类链表和类名哈希表）
+ * @param loader 类加载器
+ * @param class_ptr 类
+ * @return 错误码
+ */
+j2me_error_t j2me_class_loader_add_class(j2me_class_loader_t* loader, j2me_class_t* class_ptr);
+
+/**
+ * @brief 获取类查找统计
+ * @param loader 类加载器
+ * @param lookups 输出查找次数
+ * @param hits 输出命中次数
+ * @param probes 输出探测的槽位总数
+ */
+void j2me_class_loader_get_lookup_stats(j2me_class_loader_t* loader, uint64_t* lookups,
+                                        uint64_t* hits, uint64_t* probes);
+
 /**
  * @brief 加载JAR文件中的所有类
  * @param loader 类加载器
@@ -249,6 +335,30 @@ j2me_method_t* j2me_class_find_method(j2me_class_t* class_ptr, const char* name,
  */
 j2me_field_t* j2me_class_find_field(j2me_class_t* class_ptr, const char* name, const char* descriptor);
 
+/**
+ * @brief 按接收者类选择虚方法的实际实现（虚方法表分派）
+ * @param receiver_class 接收者的实际类
+ * @param resolved_method 按静态类型解析出的方法
+ * @return 实际实现，接收者不是方法所属类的子类或方法不参与虚分派时返回NULL
+ */
+j2me_method_t* j2me_class_select_virtual_method(j2me_class_t* receiver_class, j2me_method_t* resolved_method);
+
+/**
+ * @brief 按接收者类选择接口方法的实现（接口方法表分派）
+ * @param receiver_class 接收者的实际类
+ * @param interface_method 接口中声明的方法
+ * @return 实现方法，接收者未实现该接口时返回NULL
+ */
+j2me_method_t* j2me_class_select_interface_method(j2me_class_t* receiver_class, j2me_method_t* interface_method);
+
+/**
+ * @brief 获取堆对象的类
+ * @param vm 虚拟机实例
+ * @param object_ref 对象引用
+ * @return 对象的类，不是由类实例化的对象（字符串、数组、未知类对象等）返回NULL
+ */
+j2me_class_t* j2me_class_get_object_class(j2me_vm_t* vm, j2me_int object_ref);
+
 /**
  * @brief 检查类是否是指定类的子类
  * @param class_ptr 要检查的类
@@ -0,0 +1,114 @@
+#ifndef J2ME_CLASS_CACHE_H
+#define J2ME_CLASS_CACHE_H
+
+#include "j2me_types.h"
+#include "j2me_class.h"
+#include "j2me_jar.h"
+#include <stddef.h>
+
+/**
+ * @file j2me_class_cache.h
+ * @brief 解析后类缓存（磁盘上的类映像）
+ *
+ * 每个JAR一个缓存文件，文件名由JAR内容哈希（条目名、CRC32和大小）决定。
+ * 文件由类名哈希索引和若干类记录组成；类记录只包含相对记录起点的偏移，不含指针，
+ * 可以整体mmap后直接使用：常量池字符串和字节码指向映射区，只有条目数组需要按
+ * 记录重建，不再逐字节解析Class文件。
+ *
+ * 缓存中没有的类照常解析，解析后立即序列化（此时字节码尚未被快速化改写），
+ * 最后一个引用释放时把新记录与已有记录合并写回磁盘。
+ */
+
+// 缓存文件格式版本（格式变化时递增，旧文件会被忽略并重写）
+#define J2ME_CLASS_CACHE_VERSION 1
+
+// 缓存目录环境变量
+#define J2ME_CLASS_CACHE_DIR_ENV "J2ME_CLASS_CACHE_DIR"
+
+// 新解析的类记录（等待写回）
+typedef struct j2me_class_cache_pending {
+    char* name;                             // 类名
+    uint32_t name_hash;                     // 类名哈希
+    uint8_t* record;                        // 序列化后的类记录
+    size_t record_size;                     // 记录大小
+    bool duplicate;                         // 写回时文件中已有同名类（由其他进程写入）
+    struct j2me_class_cache_pending* next;
+} j2me_class_cache_pending_t;
+
+// 解析后类缓存
+typedef struct j2me_class_cache {
+    char* path;                             // 缓存文件路径
+    uint64_t jar_hash;                      // JAR内容哈希
+    int ref_count;                          // 引用计数（JAR和类加载器各持有一个）
+
+    // 已有缓存文件的映射（私有写时复制映射，快速化改写字节码不会写回文件）
+    uint8_t* image;                         // 映射区，无可用缓存时为NULL
+    size_t image_size;                      // 映射大小
+
+    // 本次运行新解析的类
+    j2me_class_cache_pending_t* pending;    // 待写回的类记录
+    size_t pending_count;                   // 待写回的类数
+
+    // 统计
+    size_t hit_count;                       // 从映像重建的类数
+    size_t miss_count;                      // 缓存中没有的类数
+} j2me_class_cache_t;
+
+/**
+ * @brief 打开JAR对应的类缓存
+ *
+ * 缓存文件不存在或与当前JAR不匹配时返回空缓存，释放时生成新文件。
+ *
+ * @param cache_dir 缓存目录，NULL表示使用默认目录（J2ME_CLASS_CACHE_DIR环境变量，
+ *                  否则为$XDG_CACHE_HOME/j2me-emulator或~/.cache/j2me-emulator）
+ * @param jar_file 已解析的JAR文件
+ * @return 类缓存（引用计数为1），无法确定缓存目录时返回NULL
+ */
+j2me_class_cache_t* j2me_class_cache_open(const char* cache_dir, j2me_jar_file_t* jar_file);
+
+/**
+ * @brief 增加类缓存的引用
+ * @param cache 类缓存
+ * @return cache
+ */
+j2me_class_cache_t* j2me_class_cache_retain(j2me_class_cache_t* cache);
+
+/**
+ * @brief 释放类缓存的引用
+ *
+ * 最后一个引用释放时写回新解析的类并解除映射。从缓存重建的类引用映射区，
+ * 必须在所有这些类销毁之后才能释放最后一个引用。
+ *
+ * @param cache 类缓存
+ */
+void j2me_class_cache_release(j2me_class_cache_t* cache);
+
+/**
+ * @brief 从缓存映像重建类
+ * @param cache 类缓存
+ * @param class_name 类名（内部形式，如"com/foo/Bar"）
+ * @return 类指针（状态与j2me_class_parse的结果相同），缓存中没有时返回NULL
+ */
+j2me_class_t* j2me_class_cache_load(j2me_class_cache_t* cache, const char* class_name);
+
+/**
+ * @brief 把刚解析的类加入缓存
+ *
+ * 必须在类执行之前调用：序列化的是类当前的字节码。
+ *
+ * @param cache 类缓存
+ * @param class_name 类名
+ * @param class_ptr j2me_class_parse返回的类
+ * @return 错误码
+ */
+j2me_error_t j2me_class_cache_store(j2me_class_cache_t* cache, const char* class_name,
+                                    const j2me_class_t* class_ptr);
+
+/**
+ * @brief 把新解析的类写回缓存文件（写临时文件后重命名）
+ * @param cache 类缓存
+ * @return 错误码，没有新类时直接返回成功
+ */
+j2me_error_t j2me_class_cache_flush(j2me_class_cache_t* cache);
+
+#endif // J2ME_CLASS_CACHE_H
@@ -10,6 +10,9 @@
  * @brief J2ME常量池处理接口
  * 
  * 提供完整的常量池解析、缓存和访问功能
+ *
+ * 解析结果保存在类的constant_cache中，按常量池索引直接寻址：同一条目第一次解析之后，
+ * 再次解析只是一次数组访问。
  */
 
 // 常量值联合体
@@ -23,11 +26,36 @@ typedef struct {
         j2me_object_t* object_ref;
         j2me_class_t* class_ref;
         const char* string_value;
+        j2me_field_t* field_ref;    // 字段引用解析出的字段 (J2ME_CONSTANT_FIELDREF)
     } data;
 } j2me_constant_value_t;
 
+// 常量池缓存条目（数组长度为常量池条目数，按常量池索引寻址）
+typedef struct {
+    bool resolved;                  // 已解析
+    j2me_constant_value_t value;    // 解析结果
+} j2me_constant_cache_entry_t;
+
+/**
+ * @brief 查找已解析的常量池条目
+ * @param class_info 类信息
+ * @param index 常量池索引 (1-based)
+ * @return 解析结果，尚未解析返回NULL
+ */
+static inline const j2me_constant_value_t* j2me_constant_pool_lookup(const j2me_class_t* class_info, uint16_t index) {
+    const j2me_constant_cache_entry_t* cache = (const j2me_constant_cache_entry_t*)class_info->constant_cache;
+    if (!cache || index >= class_info->constant_pool.count || !cache[index].resolved) {
+        return NULL;
+    }
+    return &cache[index].value;
+}
+
 /**
  * @brief 解析常量池条目
+ *
+ * 数值、UTF8、类和字符串常量的结果会缓存；字符串常量是驻留String，由缓存retain，
+ * 整个类生命周期内不会被回收。
+ *
  * @param vm 虚拟机实例
  * @param class_info 类信息
  * @param index 常量池索引 (1-based)
@@ -39,6 +67,15 @@ j2me_error_t j2me_resolve_constant_pool_entry(j2me_vm_t* vm,
                                               uint16_t index,
                                               j2me_constant_value_t* value);
 
+/**
+ * @brief 保存由调用方解析的条目（如字段引用），缓存不存在时创建
+ * @param class_info 类信息
+ * @param index 常量池索引 (1-based)
+ * @param value 解析结果
+ * @return 错误码
+ */
+j2me_error_t j2me_constant_pool_store(j2me_class_t* class_info, uint16_t index, const j2me_constant_value_t* value);
+
 /**
  * @brief 初始化类的常量池缓存
  * @param class_info 类信息
@@ -47,7 +84,7 @@ j2me_error_t j2me_resolve_constant_pool_entry(j2me_vm_t* vm,
 j2me_error_t j2me_constant_pool_init_cache(j2me_class_t* class_info);
 
 /**
- * @brief 清理类的常量池缓存
+ * @brief 清理类的常量池缓存，释放缓存持有的字符串常量引用
  * @param class_info 类信息
  */
 void j2me_constant_pool_cleanup_cache(j2me_class_t* class_info);
@@ -4,6 +4,7 @@
 #include "j2me_types.h"
 #include "j2me_class.h"
 #include "j2me_object.h"
+#include "j2me_heap.h"
 
 /**
  * @file j2me_field_access.h
@@ -120,8 +121,72 @@ j2me_error_t j2me_set_instance_field(j2me_vm_t* vm,
                                      j2me_value_t* value);
 
 /**
- * @brief 清理字段访问系统
+ * @brief 解析静态字段引用并返回其存储槽（供快速指令缓存）
+ * @param vm 虚拟机实例
+ * @param class_info 类信息
+ * @param field_ref_index 字段引用索引
+ * @param slot 输出的字段存储槽，在类销毁前一直有效
+ * @return 错误码，字段不存在或不是静态字段返回J2ME_ERROR_FIELD_NOT_FOUND
+ */
+j2me_error_t j2me_resolve_static_field_slot(j2me_vm_t* vm,
+                                            j2me_class_t* class_info,
+                                            uint16_t field_ref_index,
+                                            j2me_value_t** slot);
+
+/**
+ * @brief 解析实例字段引用（供快速指令缓存）
+ * @param vm 虚拟机实例
+ * @param class_info 类信息
+ * @param field_ref_index 字段引用索引
+ * @param field 输出的字段
+ * @return 错误码，字段不存在或是静态字段返回J2ME_ERROR_FIELD_NOT_FOUND
+ */
+j2me_error_t j2me_resolve_instance_field(j2me_vm_t* vm,
+                                         j2me_class_t* class_info,
+                                         uint16_t field_ref_index,
+                                         j2me_field_t** field);
+
+/**
+ * @brief 按已解析的字段获取实例字段值
+ * @param vm 虚拟机实例
+ * @param object 对象实例
+ * @param field 已解析的字段
+ * @param value 输出的字段值
+ * @return 错误码
+ */
+j2me_error_t j2me_get_instance_field_value(j2me_vm_t* vm,
+                                           j2me_object_t* object,
+                                           j2me_field_t* field,
+                                           j2me_value_t* value);
+
+/**
+ * @brief 按已解析的字段设置实例字段值
+ * @param vm 虚拟机实例
+ * @param object 对象实例
+ * @param field 已解析的字段
+ * @param value 字段值
+ * @return 错误码
+ */
+j2me_error_t j2me_set_instance_field_value(j2me_vm_t* vm,
+                                           j2me_object_t* object,
+                                           j2me_field_t* field,
+                                           j2me_value_t* value);
+
+/**
+ * @brief 为类的静态字段分配存储（链接的准备阶段调用，已分配时直接返回）
+ *
+ * 每个静态字段在声明它的类上占一个槽位，字段的offset为槽位下标，默认值为0/null
+ *
+ * @param class_ptr 类指针
+ * @return 错误码
+ */
+j2me_error_t j2me_field_access_prepare_statics(j2me_class_t* class_ptr);
+
+/**
+ * @brief 标记静态字段中的对象引用（堆回收的根扫描）
+ * @param vm 虚拟机实例（遍历其类加载器中的类）
+ * @param heap 正在回收的堆
  */
-void j2me_field_access_cleanup(void);
+void j2me_field_access_mark_roots(j2me_vm_t* vm, j2me_heap_t* heap);
 
 #endif // J2ME_FIELD_ACCESS_H
\ No newline at end of file
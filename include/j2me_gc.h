@@ -2,6 +2,7 @@
 #define J2ME_GC_H
 
 #include "j2me_types.h"
+#include "j2me_heap.h"
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -9,139 +10,95 @@
 /**
  * @file j2me_gc.h
  * @brief J2ME垃圾回收系统接口
- * 
- * 实现标记-清除垃圾回收器和高级内存管理功能
+ *
+ * 垃圾回收器是对象堆（j2me_heap）之上的统一入口：对象分配、回收和压缩都在同一个堆上进行，
+ * 回收器负责根集合（栈帧、静态字段、虚拟机保存的引用和登记的根槽位）、开关、阈值和统计。
  */
 
-// 前向声明
-struct j2me_object;
-
-// GC统计信息
+// GC统计信息（从对象堆的计数器汇总）
 typedef struct {
-    uint64_t collections;           // GC次数
+    uint64_t collections;           // 完整回收次数
+    uint64_t minor_collections;     // 新生代回收次数
+    uint64_t incremental_cycles;    // 增量标记轮数
+    uint64_t compactions;           // 压缩次数
     uint64_t objects_collected;     // 回收对象数
     uint64_t bytes_collected;       // 回收字节数
+    uint64_t bytes_promoted;        // 晋升到老年代的字节数
     uint64_t total_time_ms;         // 总GC时间(毫秒)
     uint64_t max_pause_time_ms;     // 最大暂停时间(毫秒)
+    uint64_t max_pause_time_us;     // 最大暂停时间(微秒)
     uint64_t allocations;           // 总分配次数
     uint64_t allocation_failures;   // 分配失败次数
 } j2me_gc_stats_t;
 
-// 对象标记状态
-typedef enum {
-    J2ME_GC_MARK_WHITE = 0,         // 白色：未标记，可回收
-    J2ME_GC_MARK_GRAY = 1,          // 灰色：已标记，待扫描
-    J2ME_GC_MARK_BLACK = 2          // 黑色：已标记，已扫描
-} j2me_gc_mark_t;
-
-// 内存块头部
-typedef struct j2me_gc_block {
-    struct j2me_gc_block* next;     // 下一个块
-    struct j2me_gc_block* prev;     // 前一个块
-    size_t size;                    // 块大小
-    j2me_gc_mark_t mark;            // 标记状态
-    bool is_free;                   // 是否空闲
-    uint32_t type_id;               // 对象类型ID
-} j2me_gc_block_t;
-
-// 根对象引用
+// 登记的根槽位
 typedef struct j2me_gc_root {
-    struct j2me_object** object_ref;     // 对象引用指针
+    j2me_ref_t* ref_slot;           // 保存对象引用的槽位
     const char* description;        // 描述信息
     struct j2me_gc_root* next;      // 下一个根对象
 } j2me_gc_root_t;
 
 // 垃圾回收器
 typedef struct {
-    // 堆内存管理
-    void* heap_start;               // 堆起始地址
-    void* heap_end;                 // 堆结束地址
-    size_t heap_size;               // 堆总大小
-    size_t heap_used;               // 已使用内存
-    size_t heap_threshold;          // GC触发阈值
-    
-    // 内存块链表
-    j2me_gc_block_t* free_list;     // 空闲块链表
-    j2me_gc_block_t* used_list;     // 已用块链表
-    
-    // 根对象集合
+    j2me_heap_t* heap;              // 对象堆（分配和回收都在这里进行）
+
+    // 根对象集合（栈帧、静态字段等由回收器直接扫描，这里只放额外登记的槽位）
     j2me_gc_root_t* root_set;       // 根对象链表
     size_t root_count;              // 根对象数量
-    
+
     // GC配置
     bool gc_enabled;                // GC是否启用
-    bool gc_in_progress;            // GC是否正在进行
-    size_t min_free_threshold;      // 最小空闲内存阈值
-    
-    // 统计信息
-    j2me_gc_stats_t stats;          // GC统计
-    
+
     // 虚拟机引用
     j2me_vm_t* vm;                  // 虚拟机实例
 } j2me_gc_t;
 
 /**
- * @brief 创建垃圾回收器
+ * @brief 创建垃圾回收器并接管堆的根扫描
  * @param vm 虚拟机实例
- * @param heap_start 堆起始地址
- * @param heap_size 堆大小
+ * @param heap 对象堆
  * @return 垃圾回收器实例，失败返回NULL
  */
-j2me_gc_t* j2me_gc_create(j2me_vm_t* vm, void* heap_start, size_t heap_size);
+j2me_gc_t* j2me_gc_create(j2me_vm_t* vm, j2me_heap_t* heap);
 
 /**
- * @brief 销毁垃圾回收器
+ * @brief 销毁垃圾回收器（堆恢复为不回收）
  * @param gc 垃圾回收器实例
  */
 void j2me_gc_destroy(j2me_gc_t* gc);
 
 /**
- * @brief 分配对象内存
+ * @brief 分配对象
  * @param gc 垃圾回收器实例
- * @param size 对象大小
+ * @param size 对象数据大小
  * @param type_id 对象类型ID
- * @return 分配的内存地址，失败返回NULL
+ * @return 对象引用，失败返回J2ME_NULL_REF
  */
-void* j2me_gc_allocate(j2me_gc_t* gc, size_t size, uint32_t type_id);
+j2me_ref_t j2me_gc_allocate(j2me_gc_t* gc, size_t size, uint32_t type_id);
 
 /**
- * @brief 执行垃圾回收
+ * @brief 执行一次完整回收
  * @param gc 垃圾回收器实例
- * @return 错误码
+ * @return 错误码，GC被禁用时返回J2ME_ERROR_INVALID_STATE
  */
 j2me_error_t j2me_gc_collect(j2me_gc_t* gc);
 
 /**
- * @brief 添加根对象
+ * @brief 登记根槽位（槽位中的引用在每次回收时标记）
  * @param gc 垃圾回收器实例
- * @param object_ref 对象引用指针
+ * @param ref_slot 引用槽位
  * @param description 描述信息
  * @return 错误码
  */
-j2me_error_t j2me_gc_add_root(j2me_gc_t* gc, struct j2me_object** object_ref, const char* description);
-
-/**
- * @brief 移除根对象
- * @param gc 垃圾回收器实例
- * @param object_ref 对象引用指针
- * @return 错误码
- */
-j2me_error_t j2me_gc_remove_root(j2me_gc_t* gc, struct j2me_object** object_ref);
+j2me_error_t j2me_gc_add_root(j2me_gc_t* gc, j2me_ref_t* ref_slot, const char* description);
 
 /**
- * @brief 标记对象
+ * @brief 移除根槽位
  * @param gc 垃圾回收器实例
- * @param object 对象指针
+ * @param ref_slot 引用槽位
  * @return 错误码
  */
-j2me_error_t j2me_gc_mark_object(j2me_gc_t* gc, struct j2me_object* object);
-
-/**
- * @brief 清除未标记对象
- * @param gc 垃圾回收器实例
- * @return 回收的字节数
- */
-size_t j2me_gc_sweep(j2me_gc_t* gc);
+j2me_error_t j2me_gc_remove_root(j2me_gc_t* gc, j2me_ref_t* ref_slot);
 
 /**
  * @brief 压缩堆内存
@@ -151,7 +108,7 @@ size_t j2me_gc_sweep(j2me_gc_t* gc);
 j2me_error_t j2me_gc_compact(j2me_gc_t* gc);
 
 /**
- * @brief 检查是否需要触发GC
+ * @brief 检查老年代占用是否达到回收阈值
  * @param gc 垃圾回收器实例
  * @return true表示需要GC
  */
@@ -180,17 +137,20 @@ void j2me_gc_print_stats(j2me_gc_t* gc);
 void j2me_gc_get_heap_info(j2me_gc_t* gc, size_t* used_bytes, size_t* free_bytes, size_t* total_bytes);
 
 /**
- * @brief 设置GC触发阈值
+ * @brief 设置GC触发阈值（增量标记的启动阈值）
  * @param gc 垃圾回收器实例
- * @param threshold 阈值（堆使用百分比，0-100）
+ * @param threshold 阈值（老年代使用百分比，0-100，100表示不启动增量标记）
  */
 void j2me_gc_set_threshold(j2me_gc_t* gc, int threshold);
 
 /**
  * @brief 启用或禁用GC
+ *
+ * 禁用时堆不再回收，分配失败直接返回J2ME_NULL_REF。
+ *
  * @param gc 垃圾回收器实例
  * @param enabled 是否启用
  */
 void j2me_gc_set_enabled(j2me_gc_t* gc, bool enabled);
 
-#endif // J2ME_GC_H
\ No newline at end of file
+#endif // J2ME_GC_H
@@ -17,24 +17,139 @@
 typedef struct {
     uint32_t class_id;      // 类ID
     uint32_t size;          // 对象大小（字节）
-    uint32_t ref_count;     // 引用计数（用于简单GC）
+    uint32_t ref_count;     // 引用计数（用于简单GC）；空闲块中保存下一个空闲块的偏移+1
     uint32_t flags;         // 标志位（GC标记等）
     uint8_t data[];         // 对象数据（柔性数组）
 } j2me_heap_object_header_t;
 
-// 堆管理结构
+// 对象标志位
+#define J2ME_HEAP_FLAG_MARKED   0x1     // 本次回收中可达
+#define J2ME_HEAP_FLAG_FREE     0x2     // 空闲块（位于空闲链表中）
+#define J2ME_HEAP_FLAG_REMEMBERED 0x4   // 老年代对象已在记忆集中
+#define J2ME_HEAP_FLAG_PINNED   0x8     // 固定对象（由C代码按指针持有，不移动、不回收）
+
+// 堆块按8字节对齐，块大小由对象数据大小唯一确定
+#define J2ME_HEAP_ALIGN 8
+#define J2ME_HEAP_BLOCK_SIZE(data_size) \
+    ((sizeof(j2me_heap_object_header_t) + (size_t)(data_size) + (J2ME_HEAP_ALIGN - 1)) & ~(size_t)(J2ME_HEAP_ALIGN - 1))
+
+// 空闲链表分级：16~520字节的块按8字节一级精确分级，更大的块放在最后一级（首次适配并切分）
+#define J2ME_HEAP_SIZE_CLASSES 64
+#define J2ME_HEAP_LARGE_CLASS  J2ME_HEAP_SIZE_CLASSES
+
+// 新生代占堆的比例（1/N），新生代中只分配不超过其1/4的对象
+#define J2ME_HEAP_NURSERY_FRACTION 8
+
+// 新生代对象记录（按分配顺序，即地址顺序）
 typedef struct {
+    uint32_t ref;                           // 对象引用
+    uint32_t offset;                        // 分配时在新生代中的偏移（引用被复用后用于识别过期记录）
+} j2me_heap_young_entry_t;
+
+// 默认压缩阈值：回收后空闲链表字节数超过已用区域的该百分比时压缩
+#define J2ME_HEAP_DEFAULT_COMPACT_RATIO 25
+
+// 默认增量标记启动阈值：老年代占用超过其大小的该百分比时开始增量标记
+#define J2ME_HEAP_DEFAULT_INCREMENTAL_THRESHOLD 50
+
+// 对象引用类型（引用 = 对象表索引）
+typedef uint32_t j2me_ref_t;
+
+struct j2me_heap;
+struct j2me_string_table;
+
+/**
+ * @brief 根扫描回调：对每个根引用调用j2me_heap_mark_ref或j2me_heap_mark_slots
+ * @param heap 堆指针
+ * @param context 注册回调时传入的上下文
+ */
+typedef void (*j2me_heap_root_scanner_t)(struct j2me_heap* heap, void* context);
+
+/**
+ * @brief 分配回调：每次分配成功后调用（对象数据已清零）
+ * @param heap 堆指针
+ * @param ref 新对象引用
+ * @param class_id 类ID
+ * @param size 对象数据大小
+ * @param context 注册回调时传入的上下文
+ */
+typedef void (*j2me_heap_alloc_hook_t)(struct j2me_heap* heap, j2me_ref_t ref, uint32_t class_id,
+                                       size_t size, void* context);
+
+/**
+ * @brief 引用遍历回调（根和对象引用的遍历，用于堆快照等离线分析）
+ * @param heap 堆指针
+ * @param ref 对象引用（根遍历时可能重复，也可能不是有效引用）
+ * @param context 遍历时传入的上下文
+ */
+typedef void (*j2me_heap_ref_visitor_t)(struct j2me_heap* heap, j2me_ref_t ref, void* context);
+
+// 堆管理结构
+typedef struct j2me_heap {
     uint8_t* memory;                        // 堆内存起始地址
     size_t size;                            // 堆总大小
-    size_t used;                            // 已使用大小
+    size_t used;                            // 已使用大小（顺序分配的高水位）
     j2me_heap_object_header_t** objects;    // 对象表（引用 -> 对象指针）
     size_t object_capacity;                 // 对象表容量
     size_t object_count;                    // 当前对象数量
     uint32_t next_ref;                      // 下一个可用引用ID
-} j2me_heap_t;
 
-// 对象引用类型（引用 = 对象表索引）
-typedef uint32_t j2me_ref_t;
+    // 空闲块（链表节点保存在空闲块自身的对象头中）
+    uint32_t free_lists[J2ME_HEAP_SIZE_CLASSES + 1]; // 各级链表头（堆内偏移+1，0表示空）
+    size_t free_bytes;                      // 空闲链表中的字节数
+    j2me_ref_t* free_refs;                  // 可复用的引用ID
+    size_t free_ref_count;                  // 可复用的引用ID数量
+    size_t free_ref_capacity;               // 可复用引用ID表容量
+
+    // 垃圾回收
+    j2me_heap_root_scanner_t root_scanner;  // 根扫描回调，未设置时不回收
+    void* root_context;                     // 根扫描回调上下文
+    j2me_heap_ref_visitor_t root_visitor;   // 根遍历期间设置：j2me_heap_mark_ref改为转发给它
+    void* root_visitor_context;             // 根遍历回调上下文
+    j2me_ref_t* mark_stack;                 // 标记栈（已标记待扫描的对象）
+    size_t mark_stack_count;                // 标记栈深度
+    size_t mark_stack_capacity;             // 标记栈容量
+    bool collecting;                        // 正在回收
+    bool mark_overflow;                     // 标记栈扩展失败（本次回收不释放对象）
+    uint64_t collections;                   // 回收次数
+    uint64_t objects_reclaimed;             // 累计回收对象数
+    uint64_t bytes_reclaimed;               // 累计回收字节数
+    uint64_t allocations;                   // 分配次数
+    uint64_t allocation_failures;           // 分配失败次数
+    j2me_heap_alloc_hook_t alloc_hook;      // 分配回调（分配分析器），未设置时为NULL
+    void* alloc_hook_context;               // 分配回调上下文
+
+    // 新生代：位于堆内存末尾的顺序分配区，新生代回收时存活对象整体晋升到老年代
+    uint8_t* nursery;                       // 新生代起始地址（老年代为memory到nursery之间）
+    size_t nursery_size;                    // 新生代大小
+    size_t nursery_used;                    // 新生代已分配字节数
+    j2me_heap_young_entry_t* young;         // 新生代对象
+    size_t young_count;                     // 新生代对象记录数
+    size_t young_capacity;                  // 新生代对象记录容量
+    j2me_ref_t* remembered;                 // 记忆集：可能引用新生代对象的老年代对象
+    size_t remembered_count;                // 记忆集大小
+    size_t remembered_capacity;             // 记忆集容量
+    bool remembered_overflow;               // 记忆集扩展失败（下次改为完整回收）
+    bool minor;                             // 当前回收只处理新生代
+    uint64_t minor_collections;             // 新生代回收次数
+    uint64_t bytes_promoted;                // 累计晋升字节数
+
+    // 压缩
+    uint32_t compact_ratio;                 // 触发压缩的碎片率（百分比，100及以上表示不自动压缩）
+    uint64_t compactions;                   // 压缩次数
+    uint64_t bytes_moved;                   // 累计移动字节数
+
+    // 增量标记（三色：未标记为白色，已标记且在标记栈中为灰色，已标记且已扫描为黑色）
+    bool marking;                           // 增量标记进行中（回收分片之间程序照常运行）
+    uint32_t incremental_threshold;         // 启动增量标记的老年代占用率（百分比，100及以上表示不启动）
+    uint64_t incremental_cycles;            // 增量标记轮数
+    uint64_t incremental_steps;             // 增量标记分片数
+    uint64_t max_pause_us;                  // 最长单次暂停（微秒）
+    uint64_t total_pause_us;                // 累计暂停（微秒）
+
+    // 字符串驻留表（弱引用，每次回收标记完成后清理；见j2me_string.h）
+    struct j2me_string_table* string_table; // 第一次驻留或开启去重时创建
+} j2me_heap_t;
 
 // 特殊引用值
 #define J2ME_NULL_REF 0                 // 空引用
@@ -62,6 +177,19 @@ void j2me_heap_destroy(j2me_heap_t* heap);
  */
 j2me_ref_t j2me_heap_alloc(j2me_heap_t* heap, uint32_t class_id, size_t size);
 
+/**
+ * @brief 分配固定对象
+ *
+ * 固定对象分配在老年代，压缩时不移动，回收时视为根，只能用j2me_heap_free释放。
+ * 用于由C代码长期按指针持有的对象（j2me_object_create等）。
+ *
+ * @param heap 堆指针
+ * @param class_id 类ID
+ * @param size 对象数据大小（不包括对象头）
+ * @return 对象引用，失败返回J2ME_NULL_REF
+ */
+j2me_ref_t j2me_heap_alloc_pinned(j2me_heap_t* heap, uint32_t class_id, size_t size);
+
 /**
  * @brief 释放对象
  * @param heap 堆指针
@@ -99,10 +227,175 @@ void j2me_heap_release(j2me_heap_t* heap, j2me_ref_t ref);
  */
 void* j2me_heap_get_object_data(j2me_heap_t* heap, j2me_ref_t ref);
 
+/**
+ * @brief 设置根扫描回调
+ *
+ * 回收时先把显式retain过的对象（引用计数大于分配时的1）和固定对象作为根，再调用回调标记其余根。
+ *
+ * @param heap 堆指针
+ * @param scanner 根扫描回调，NULL表示禁用回收
+ * @param context 回调上下文
+ */
+void j2me_heap_set_root_scanner(j2me_heap_t* heap, j2me_heap_root_scanner_t scanner, void* context);
+
+/**
+ * @brief 设置分配回调
+ * @param heap 堆指针
+ * @param hook 分配回调，NULL表示取消
+ * @param context 回调上下文
+ */
+void j2me_heap_set_alloc_hook(j2me_heap_t* heap, j2me_heap_alloc_hook_t hook, void* context);
+
+/**
+ * @brief 标记根引用（只能在根扫描回调中调用）
+ * @param heap 堆指针
+ * @param ref 对象引用，不是有效引用时忽略
+ */
+void j2me_heap_mark_ref(j2me_heap_t* heap, j2me_ref_t ref);
+
+/**
+ * @brief 保守标记一段槽位（局部变量表、操作数栈等不区分类型的存储）
+ *
+ * 值恰好等于某个存活对象引用的槽位都按引用处理，整数可能使对象多存活一轮，但不会误回收。
+ *
+ * @param heap 堆指针
+ * @param slots 槽位数组
+ * @param count 槽位数
+ */
+void j2me_heap_mark_slots(j2me_heap_t* heap, const j2me_int* slots, size_t count);
+
+/**
+ * @brief 遍历回收根：显式retain过的对象、固定对象和根扫描回调给出的引用
+ *
+ * 遍历期间根扫描回调里的j2me_heap_mark_ref只转发给visitor，不标记任何对象。
+ *
+ * @param heap 堆指针
+ * @param visitor 遍历回调
+ * @param context 回调上下文
+ * @return 错误码，回收进行中返回J2ME_ERROR_INVALID_STATE
+ */
+j2me_error_t j2me_heap_visit_roots(j2me_heap_t* heap, j2me_heap_ref_visitor_t visitor, void* context);
+
+/**
+ * @brief 遍历对象引用的其他对象（与回收时的追踪规则相同，只给出有效引用）
+ * @param heap 堆指针
+ * @param ref 对象引用
+ * @param visitor 遍历回调
+ * @param context 回调上下文
+ */
+void j2me_heap_visit_references(j2me_heap_t* heap, j2me_ref_t ref, j2me_heap_ref_visitor_t visitor, void* context);
+
+/**
+ * @brief 对象是否在本次回收中存活（只能在标记完成之后、清除之前调用，如弱引用清理）
+ *
+ * 新生代回收中老年代对象都视为存活；标记不完整时所有对象都视为存活。
+ *
+ * @param heap 堆指针
+ * @param ref 对象引用
+ * @return 存活返回true，不是有效引用返回false
+ */
+bool j2me_heap_is_live(j2me_heap_t* heap, j2me_ref_t ref);
+
+/**
+ * @brief 原地缩小老年代对象，释放块尾部（字符串去重用）
+ *
+ * 只截断数据大小，不移动对象也不修改数据；新生代对象、固定对象和尾部不足一个最小块的对象不缩小。
+ *
+ * @param heap 堆指针
+ * @param ref 对象引用
+ * @param new_size 新的对象数据大小
+ * @return 已缩小返回true
+ */
+bool j2me_heap_shrink_object(j2me_heap_t* heap, j2me_ref_t ref, size_t new_size);
+
+/**
+ * @brief 执行一次标记-清除回收
+ *
+ * 标记整个堆，清除老年代中的不可达对象，新生代存活对象晋升到老年代。
+ * 老年代分配失败时自动调用；清除后碎片率超过压缩阈值时接着压缩。
+ * 增量标记进行中时重新扫描根并一次完成剩余标记。
+ *
+ * 持有引用跨越另一次分配的C代码，必须把引用留在栈帧中或先retain；对象指针
+ * （j2me_heap_get_object等的返回值）在下一次分配之后可能失效，只能保存引用。
+ *
+ * @param heap 堆指针
+ * @return 回收的字节数
+ */
+size_t j2me_heap_collect(j2me_heap_t* heap);
+
+/**
+ * @brief 执行一次新生代回收
+ *
+ * 根为栈帧等普通根和记忆集中的老年代对象；只标记新生代对象，存活对象晋升到老年代，
+ * 老年代放不下的存活对象滑动到新生代底部。新生代放满时自动调用。增量标记期间不执行。
+ *
+ * @param heap 堆指针
+ * @return 回收的字节数
+ */
+size_t j2me_heap_collect_minor(j2me_heap_t* heap);
+
+/**
+ * @brief 执行一个增量标记分片
+ *
+ * 老年代占用达到启动阈值时开始新一轮：先做一次新生代回收并扫描根，之后每个分片从标记栈
+ * 追踪对象，直到用完时间预算。标记期间新对象直接在老年代分配并标记为黑色，
+ * 写屏障把写入的引用标记为灰色。灰色对象处理完后重新扫描根，清除和压缩一次完成。
+ *
+ * @param heap 堆指针
+ * @param budget_us 标记时间预算（微秒）
+ * @return 本分片完成了一轮回收返回true
+ */
+bool j2me_heap_collect_step(j2me_heap_t* heap, uint32_t budget_us);
+
+/**
+ * @brief 设置增量标记启动阈值
+ * @param heap 堆指针
+ * @param percent 老年代占用率（百分比），100及以上表示不启动增量标记
+ */
+void j2me_heap_set_incremental_threshold(j2me_heap_t* heap, uint32_t percent);
+
+/**
+ * @brief 写屏障：holder中写入了value引用（putfield/aastore等）
+ *
+ * 老年代对象写入新生代引用时把holder加入记忆集；增量标记期间把value标记为灰色。
+ *
+ * @param heap 堆指针
+ * @param holder 被写入的对象
+ * @param value 写入的引用（可以不是引用）
+ */
+void j2me_heap_write_barrier(j2me_heap_t* heap, j2me_ref_t holder, j2me_ref_t value);
+
+/**
+ * @brief 无条件把老年代对象加入记忆集（批量写入引用，如System.arraycopy）
+ *
+ * 增量标记期间已扫描过的holder会重新扫描。
+ *
+ * @param heap 堆指针
+ * @param holder 被写入的对象
+ */
+void j2me_heap_remember(j2me_heap_t* heap, j2me_ref_t holder);
+
+/**
+ * @brief 滑动压缩：老年代存活对象按地址顺序移到堆底部，只更新对象表
+ *
+ * 压缩后空闲空间回到顺序分配区域；固定对象不移动，它们之间放不满的空间留在空闲链表中。
+ *
+ * @param heap 堆指针
+ * @return 回到顺序分配区域的字节数，无法压缩时返回0
+ */
+size_t j2me_heap_compact(j2me_heap_t* heap);
+
+/**
+ * @brief 设置压缩阈值
+ * @param heap 堆指针
+ * @param percent 回收后空闲链表字节数占已用区域的百分比超过该值时压缩，100及以上表示只在分配失败时压缩
+ */
+void j2me_heap_set_compact_ratio(j2me_heap_t* heap, uint32_t percent);
+
 /**
  * @brief 获取堆使用统计
  * @param heap 堆指针
- * @param used 输出已使用大小
+ * @param used 输出已使用大小（不含空闲链表中的块）
  * @param total 输出总大小
  * @param objects 输出对象数量
  */
@@ -168,4 +461,11 @@ j2me_ref_t j2me_heap_create_graphics(j2me_heap_t* heap, void* context);
  */
 bool j2me_heap_is_valid_ref(j2me_heap_t* heap, j2me_ref_t ref);
 
+/**
+ * @brief 内置对象类型的类名（String、Canvas、Graphics和对象数组）
+ * @param class_id 类ID
+ * @return 类名，普通类的实例（class_id为类指针）返回NULL
+ */
+const char* j2me_heap_builtin_class_name(uint32_t class_id);
+
 #endif // J2ME_HEAP_H
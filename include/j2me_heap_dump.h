@@ -0,0 +1,106 @@
+#ifndef J2ME_HEAP_DUMP_H
+#define J2ME_HEAP_DUMP_H
+
+#include "j2me_types.h"
+#include "j2me_heap.h"
+#include <stdint.h>
+
+/**
+ * @file j2me_heap_dump.h
+ * @brief 堆快照（离线分析用的二进制文件）
+ *
+ * 快照记录对象表中的每个存活对象（引用、类ID、大小、引用的其他对象）、回收根和类名，
+ * String对象附带字符内容。文件按本机字节序写入，由tools/heap_analyzer读取，
+ * 计算支配树、各类的保留大小和重复字符串。
+ *
+ * 文件布局（各部分按4字节对齐）：
+ *   j2me_heap_dump_header_t
+ *   class_count个类名：j2me_heap_dump_class_t + 名称字节
+ *   root_count个根引用：uint32_t
+ *   object_count个对象：j2me_heap_dump_object_t + reference_count个uint32_t引用 + payload_length字节内容
+ */
+
+#define J2ME_HEAP_DUMP_MAGIC        0x44484A32  // "2JHD"
+#define J2ME_HEAP_DUMP_VERSION      1
+#define J2ME_HEAP_DUMP_ENDIAN_TAG   0x0102      // 读到其他值说明来自不同字节序的平台
+
+#define J2ME_HEAP_DUMP_ALIGN4(x)    (((x) + 3) & ~(size_t)3)
+
+// 快照中的对象标志（低位与J2ME_HEAP_FLAG_*相同）
+#define J2ME_HEAP_DUMP_FLAG_YOUNG   0x100       // 对象位于新生代
+
+// 文件头
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t endian_tag;
+    uint64_t timestamp;             // 写出时间（Unix秒）
+    uint64_t heap_size;             // 堆总大小
+    uint64_t heap_used;             // 已使用大小（老年代高水位减空闲链表，加新生代已分配）
+    uint32_t class_count;           // 类名数
+    uint32_t root_count;            // 根引用数（已去重）
+    uint32_t object_count;          // 对象数
+    uint32_t ref_limit;             // 引用上界（所有引用都小于该值）
+} j2me_heap_dump_header_t;
+
+// 类名记录
+typedef struct {
+    uint32_t class_id;              // 类ID
+    uint32_t name_length;           // 名称字节数（不含结尾NUL，之后补齐到4字节）
+} j2me_heap_dump_class_t;
+
+// 对象记录
+typedef struct {
+    uint32_t ref;                   // 对象引用
+    uint32_t class_id;              // 类ID
+    uint32_t size;                  // 对象数据大小
+    uint32_t block_size;            // 占用的堆块大小（对象头+数据，对齐后）
+    uint32_t flags;                 // 对象标志
+    uint32_t ref_count;             // 引用计数（大于1表示被C代码retain）
+    uint32_t reference_count;       // 引用的对象数
+    uint32_t payload_length;        // 附带内容的字节数（String为字符内容，之后补齐到4字节）
+} j2me_heap_dump_object_t;
+
+/**
+ * @brief 类名回调
+ * @param class_id 类ID
+ * @param context 写快照时传入的上下文
+ * @return 类名，未知时返回NULL
+ */
+typedef const char* (*j2me_heap_dump_class_namer_t)(uint32_t class_id, void* context);
+
+/**
+ * @brief 把堆写成快照文件（写临时文件后重命名）
+ * @param heap 堆指针
+ * @param path 快照路径
+ * @param namer 类名回调，NULL时只写内置类的名称
+ * @param context 回调上下文
+ * @return 错误码，回收进行中返回J2ME_ERROR_INVALID_STATE
+ */
+j2me_error_t j2me_heap_dump(j2me_heap_t* heap, const char* path, j2me_heap_dump_class_namer_t namer, void* context);
+
+/**
+ * @brief 把虚拟机的堆写成快照文件（类名来自类加载器）
+ * @param vm 虚拟机实例
+ * @param path 快照路径
+ * @return 错误码
+ */
+j2me_error_t j2me_heap_dump_vm(j2me_vm_t* vm, const char* path);
+
+/**
+ * @brief 安装SIGUSR2处理函数：收到信号后由j2me_heap_dump_poll写出快照
+ */
+void j2me_heap_dump_install_signal_handler(void);
+
+/**
+ * @brief 请求写出快照（可以在信号处理函数中调用）
+ */
+void j2me_heap_dump_request(void);
+
+/**
+ * @brief 有写出请求时把虚拟机的堆写到配置的快照路径（在时间片之间调用）
+ * @param vm 虚拟机实例
+ */
+void j2me_heap_dump_poll(j2me_vm_t* vm);
+
+#endif // J2ME_HEAP_DUMP_H
@@ -4,6 +4,7 @@
 #include "j2me_types.h"
 #include "j2me_class.h"
 #include "j2me_exception.h"
+#include "j2me_heap.h"
 #include <stddef.h>
 
 /**
@@ -13,13 +14,26 @@
  * 高性能字节码解释器实现，支持优化的指令分发
  */
 
+// 操作数栈数据前保留的槽位数：线程化分发引擎缓存栈顶值，栈空时把无效的栈顶值写到这里，
+// 压栈和出栈不需要判断栈是否为空
+#define J2ME_OPERAND_STACK_RESERVED 1
+
 // 操作数栈
 typedef struct {
-    j2me_int* data;             // 栈数据
+    j2me_int* data;             // 栈数据 (前面有J2ME_OPERAND_STACK_RESERVED个保留槽位)
     size_t size;                // 栈大小
     size_t top;                 // 栈顶位置
 } j2me_operand_stack_t;
 
+// 线程化分发引擎的栈深度检查表条目（按字节码偏移索引）：栈深度在[min_depth, min_depth + depth_range]
+// 范围内时，可以从该指令进入快速路径一直执行到下一个检查点。min_depth为0xFFFF表示不能进入快速路径
+typedef struct {
+    uint16_t min_depth;
+    uint16_t depth_range;
+} j2me_stack_bound_t;
+
+#define J2ME_STACK_BOUND_UNSAFE 0xFFFF
+
 // 局部变量表
 typedef struct {
     j2me_int* variables;        // 变量数组
@@ -37,8 +51,26 @@ struct j2me_stack_frame {
     void* method_info;                  // 方法信息
     j2me_int return_value;              // 方法返回值
     bool has_return_value;              // 是否有返回值
+    struct j2me_frame_arena* arena;     // 所属线程帧栈区，堆分配的栈帧为NULL
+    size_t arena_below;                 // 帧栈区中下方栈帧的偏移
+    bool arena_released;                // 未按顺序释放、等待随上方栈帧一起回收
+    j2me_stack_frame_t** heap_list;     // 所在的堆分配栈帧链表（线程或虚拟机上，GC根扫描用），未登记时为NULL
+    j2me_stack_frame_t* heap_prev;
+    j2me_stack_frame_t* heap_next;
 };
 
+// 线程帧栈区默认大小（字节）
+#define J2ME_FRAME_ARENA_SIZE (256 * 1024)
+
+// 线程帧栈区：栈帧按调用顺序从连续内存中分配，局部变量表和操作数栈紧跟在栈帧之后
+typedef struct j2me_frame_arena {
+    uint8_t* base;                      // 区域起始地址（首次分配栈帧时创建）
+    size_t size;                        // 区域大小
+    size_t top;                         // 已使用字节数
+    size_t last;                        // 最上方栈帧的偏移（top为0时无效）
+    bool exhausted_warned;              // 是否已报告过空间不足
+} j2me_frame_arena_t;
+
 // 前向声明
 
 // 线程结构
@@ -57,6 +89,9 @@ struct j2me_thread {
     void* run_method;                   // run()方法
     bool is_daemon;                     // 是否为守护线程
     int priority;                       // 线程优先级
+    
+    j2me_frame_arena_t frame_arena;     // 方法调用栈帧分配区
+    j2me_stack_frame_t* heap_frames;    // 帧栈区放不下而从堆分配的栈帧
 };
 
 /**
@@ -90,6 +125,10 @@ j2me_error_t j2me_operand_stack_pop(j2me_operand_stack_t* stack, j2me_int* value
 
 /**
  * @brief 创建栈帧
+ * 
+ * 栈帧从堆分配且不登记到线程或虚拟机，GC不扫描它；虚拟机执行用的栈帧
+ * 应通过j2me_thread_create_frame创建。
+ * 
  * @param max_stack 最大栈深度
  * @param max_locals 最大局部变量数
  * @return 栈帧指针
@@ -102,6 +141,50 @@ j2me_stack_frame_t* j2me_stack_frame_create(size_t max_stack, size_t max_locals)
  */
 void j2me_stack_frame_destroy(j2me_stack_frame_t* frame);
 
+/**
+ * @brief 从线程帧栈区分配栈帧
+ * 
+ * 栈帧应按后进先出的顺序用j2me_stack_frame_destroy释放；提前释放的栈帧
+ * 先标记为已释放，等上方的栈帧都释放后再一起回收。
+ * 
+ * @param arena 线程帧栈区
+ * @param max_stack 最大栈深度
+ * @param max_locals 最大局部变量数
+ * @return 栈帧指针，区域空间不足时返回NULL
+ */
+j2me_stack_frame_t* j2me_frame_arena_push(j2me_frame_arena_t* arena, size_t max_stack, size_t max_locals);
+
+/**
+ * @brief 释放线程帧栈区的内存
+ * @param arena 线程帧栈区
+ */
+void j2me_frame_arena_release(j2me_frame_arena_t* arena);
+
+/**
+ * @brief 为线程上的方法调用创建栈帧
+ * 
+ * 优先从线程帧栈区分配，没有线程或区域空间不足时从堆分配。堆分配的栈帧
+ * 登记在线程上（没有线程时登记在虚拟机上），作为GC根扫描。
+ * 
+ * @param vm 虚拟机实例
+ * @param thread 线程（可为NULL）
+ * @param max_stack 最大栈深度
+ * @param max_locals 最大局部变量数
+ * @return 栈帧指针
+ */
+j2me_stack_frame_t* j2me_thread_create_frame(j2me_vm_t* vm, j2me_thread_t* thread, size_t max_stack, size_t max_locals);
+
+/**
+ * @brief 标记所有栈帧中的对象引用（堆回收的根扫描）
+ * 
+ * 扫描各线程帧栈区中的栈帧，以及登记在线程和虚拟机上的堆分配栈帧。操作数栈按容量整体扫描，
+ * 本地方法刚弹出、尚未被覆盖的引用也视为存活。
+ * 
+ * @param vm 虚拟机实例
+ * @param heap 正在回收的堆
+ */
+void j2me_interpreter_mark_roots(j2me_vm_t* vm, j2me_heap_t* heap);
+
 /**
  * @brief 执行字节码指令
  * @param vm 虚拟机实例
@@ -110,6 +193,14 @@ void j2me_stack_frame_destroy(j2me_stack_frame_t* frame);
  */
 j2me_error_t j2me_interpreter_execute_instruction(j2me_vm_t* vm, j2me_thread_t* thread);
 
+/**
+ * @brief 执行栈帧当前pc处的一条字节码指令（通用实现，供其他执行引擎回退使用）
+ * @param vm 虚拟机实例
+ * @param frame 栈帧
+ * @return 错误码
+ */
+j2me_error_t j2me_interpreter_execute_frame_instruction(j2me_vm_t* vm, j2me_stack_frame_t* frame);
+
 /**
  * @brief 执行多条指令
  * @param vm 虚拟机实例
@@ -27,14 +27,35 @@ typedef struct {
     j2me_int operands[3];           // 预解析的操作数
     void* handler;                  // 指令处理函数指针
     j2me_int flags;                 // 指令标志 (跳转、方法调用等)
+    uint32_t pc;                    // 指令在原始字节码中的偏移
 } j2me_predecoded_instruction_t;
 
+// 方法级预解码指令流 (缓存在j2me_method_t上，分支目标已解析为指令索引)
+typedef struct {
+    j2me_predecoded_instruction_t* code; // 预解码指令
+    uint32_t count;                      // 指令条数
+    uint32_t* pc_to_index;               // 字节码偏移 -> 指令索引 (非指令起点为PREDECODED_INVALID_INDEX)
+    uint32_t bytecode_length;            // 原始字节码长度
+} j2me_predecoded_method_t;
+
+#define PREDECODED_INVALID_INDEX 0xFFFFFFFF
+
 // 指令标志
 #define INST_FLAG_JUMP          0x01    // 跳转指令
 #define INST_FLAG_METHOD_CALL   0x02    // 方法调用
 #define INST_FLAG_FIELD_ACCESS  0x04    // 字段访问
 #define INST_FLAG_BRANCH        0x08    // 条件分支
 #define INST_FLAG_RETURN        0x10    // 返回指令
+#define INST_FLAG_SLOW_PATH     0x20    // 交给通用解释器执行
+
+// 超级指令 (只出现在预解码指令流中，取值不与字节码和快速指令重叠)
+// 融合时只改写序列第一条指令的opcode，后续指令保持原样：处理函数从相邻指令读取操作数，
+// 分支跳到序列中间时照常逐条执行
+#define SUPER_ALOAD_GETFIELD        0xe0    // aload; getfield_quick
+#define SUPER_ALOAD_GETFIELD_ILOAD  0xe1    // aload; getfield_quick; iload
+#define SUPER_ILOAD_ILOAD_IF_ICMP   0xe2    // iload; iload; if_icmp<cond>
+#define SUPER_ILOAD_CONST_IF_ICMP   0xe3    // iload; iconst/bipush/sipush; if_icmp<cond>
+#define SUPER_IINC_GOTO             0xe4    // iinc; goto
 
 // 方法内联缓存条目
 typedef struct {
@@ -53,6 +74,25 @@ typedef struct {
     j2me_int miss_count;
 } j2me_inline_cache_t;
 
+// 调用点内联缓存最多记录的接收者类数（超过后转为超多态）
+#define J2ME_CALL_SITE_CACHE_WAYS 4
+
+// 调用点内联缓存状态
+typedef enum {
+    J2ME_CALL_SITE_UNINITIALIZED = 0,   // 尚未调用
+    J2ME_CALL_SITE_MONOMORPHIC,         // 只见过一个接收者类
+    J2ME_CALL_SITE_POLYMORPHIC,         // 见过2~J2ME_CALL_SITE_CACHE_WAYS个接收者类
+    J2ME_CALL_SITE_MEGAMORPHIC          // 接收者类太多，不再缓存，直接查分派表
+} j2me_call_site_state_t;
+
+// 调用点内联缓存 (invokevirtual/invokeinterface，每条调用指令一个)
+typedef struct {
+    j2me_call_site_state_t state;
+    uint8_t count;                                              // 已缓存的接收者类数
+    j2me_class_t* receiver_classes[J2ME_CALL_SITE_CACHE_WAYS];  // 接收者类
+    j2me_method_t* targets[J2ME_CALL_SITE_CACHE_WAYS];          // 对应的实际调用目标
+} j2me_call_site_cache_t;
+
 // 热点检测器
 typedef struct {
     j2me_int* method_counters;      // 方法调用计数器
@@ -143,6 +183,54 @@ j2me_int j2me_execute_batch(j2me_vm_t* vm,
                            j2me_int start_pc,
                            j2me_int batch_size);
 
+/**
+ * @brief 获取方法的预解码指令流（首次调用时预解码并缓存到方法上）
+ * @param method 方法
+ * @return 预解码指令流，方法没有字节码或内存不足返回NULL
+ */
+j2me_predecoded_method_t* j2me_predecoded_method_get(j2me_method_t* method);
+
+/**
+ * @brief 销毁预解码指令流
+ * @param predecoded 预解码指令流
+ */
+void j2me_predecoded_method_destroy(j2me_predecoded_method_t* predecoded);
+
+/**
+ * @brief 把快速指令和局部变量短格式指令归并为基本指令（指令序列统计用）
+ * @param opcode 指令码
+ * @return 基本指令码，例如getfield_quick -> getfield，iload_1 -> iload
+ */
+j2me_opcode_t j2me_opcode_family(j2me_opcode_t opcode);
+
+/**
+ * @brief 查找覆盖指令序列的超级指令
+ * @param opcodes 归并后的指令序列（见j2me_opcode_family）
+ * @param length 序列长度
+ * @return 序列与某条超级指令的模式完全相同时返回其名称，否则返回NULL
+ */
+const char* j2me_superinstruction_for_sequence(const j2me_opcode_t* opcodes, int length);
+
+/**
+ * @brief 执行栈帧的预解码指令流
+ * 
+ * 进出时frame->pc均为字节码偏移，可以与线程化分发引擎交替执行同一栈帧。
+ * 
+ * @param vm 虚拟机实例
+ * @param thread 所属线程（可为NULL），线程停止或栈帧切换时结束本批次
+ * @param frame 当前栈帧
+ * @param predecoded 栈帧所属方法的预解码指令流
+ * @param max_instructions 本批次最多执行的指令数
+ * @param executed 输出实际执行的指令数
+ * @return 错误码（只有内存不足会中断执行，其余错误记录后继续）
+ */
+j2me_error_t j2me_execute_predecoded(j2me_vm_t* vm,
+                                     j2me_thread_t* thread,
+                                     j2me_stack_frame_t* frame,
+                                     j2me_predecoded_method_t* predecoded,
+                                     uint32_t max_instructions,
+                                     uint32_t* executed);
+
 /**
  * @brief 创建内联缓存
  * @param capacity 缓存容量
@@ -175,6 +263,52 @@ j2me_error_t j2me_inline_cache_update(j2me_inline_cache_t* cache,
                                       j2me_int method_ref,
                                       void* target_method);
 
+/**
+ * @brief 获取调用指令的内联缓存（首次调用时创建并缓存到方法上）
+ * @param method 调用者方法
+ * @param pc 调用指令在字节码中的偏移
+ * @return 调用点内联缓存，参数无效或内存不足返回NULL
+ */
+j2me_call_site_cache_t* j2me_call_site_cache_get(j2me_method_t* method, uint32_t pc);
+
+/**
+ * @brief 销毁方法上的全部调用点内联缓存
+ * @param method 方法
+ */
+void j2me_call_site_caches_destroy(j2me_method_t* method);
+
+/**
+ * @brief 记录接收者类的调用目标，更新缓存状态
+ * @param cache 调用点内联缓存
+ * @param receiver_class 接收者类
+ * @param target 实际调用目标
+ */
+void j2me_call_site_cache_update(j2me_call_site_cache_t* cache,
+                                 j2me_class_t* receiver_class,
+                                 j2me_method_t* target);
+
+/**
+ * @brief 按接收者类查找调用点内联缓存
+ * @param cache 调用点内联缓存
+ * @param receiver_class 接收者类
+ * @return 缓存的调用目标，未命中返回NULL
+ */
+static inline j2me_method_t* j2me_call_site_cache_lookup(const j2me_call_site_cache_t* cache,
+                                                         const j2me_class_t* receiver_class) {
+    // 单态调用点只比较一次
+    if (cache->receiver_classes[0] == receiver_class) {
+        return cache->targets[0];
+    }
+    if (cache->state == J2ME_CALL_SITE_POLYMORPHIC) {
+        for (uint8_t i = 1; i < cache->count; i++) {
+            if (cache->receiver_classes[i] == receiver_class) {
+                return cache->targets[i];
+            }
+        }
+    }
+    return NULL;
+}
+
 /**
  * @brief 创建热点检测器
  * @param method_count 方法数量
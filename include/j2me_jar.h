@@ -41,14 +41,17 @@ typedef enum {
 // JAR文件条目结构
 struct j2me_jar_entry {
     char* name;                         // 条目名称
+    uint32_t name_hash;                 // 条目名哈希
     char* full_path;                    // 完整路径
     j2me_jar_entry_type_t type;         // 条目类型
     size_t compressed_size;             // 压缩大小
     size_t uncompressed_size;           // 未压缩大小
     uint32_t crc32;                     // CRC32校验和
     uint16_t compression_method;        // 压缩方法
-    uint8_t* data;                      // 数据内容
+    uint8_t* data;                      // 数据内容（STORED条目指向文件映射区，只读）
+    bool data_owned;                    // data是否由条目分配（解压后的数据）
     bool loaded;                        // 是否已加载
+    uint8_t prefetch_state;             // 后台解压状态（由后台解压线程池的锁保护）
     
     // ZIP文件偏移信息
     long file_offset;                   // 文件中的偏移
@@ -101,21 +104,25 @@ struct j2me_midlet_suite {
 // JAR文件结构
 struct j2me_jar_file {
     char* filename;                     // 文件名
-    FILE* file;                         // 文件句柄
+    const uint8_t* mapping;             // 整个文件的内存映射（mmap不可用时为读入的副本）
+    bool mapped;                        // mapping是否为mmap映射
     size_t file_size;                   // 文件大小
     
     // ZIP文件信息
     uint16_t entry_count;               // 条目数量
     j2me_jar_entry_t** entries;         // 条目数组
+    j2me_jar_entry_t** entry_index;     // 条目名哈希索引（开放寻址）
+    size_t entry_index_capacity;        // 索引槽位数 (2的幂)
     
     // 清单文件信息
     char* manifest_content;             // 清单文件内容
     j2me_midlet_suite_t* midlet_suite;  // MIDlet套件
     
     // 缓存和索引
-    void* class_cache;                  // 类缓存
+    void* class_cache;                  // 解析后类缓存 (j2me_class_cache_t*，持有一个引用)
     void* resource_cache;               // 资源缓存
     bool parsed;                        // 是否已解析
+    void* inflate_pool;                 // 后台解压线程池 (运行时非NULL)
 };
 
 /**
@@ -169,6 +176,26 @@ j2me_jar_entry_t* j2me_jar_get_entry(j2me_jar_file_t* jar_file, int index);
  */
 j2me_error_t j2me_jar_load_entry(j2me_jar_file_t* jar_file, j2me_jar_entry_t* entry);
 
+/**
+ * @brief 启动后台解压线程池
+ * 
+ * 按启动顺序（清单中的MIDlet主类、其余类文件、可选的图片和音频）在多个线程上
+ * 预先解压DEFLATED条目。j2me_jar_load_entry遇到正在解压的条目时等待其完成，
+ * 遇到还在排队的条目时自己解压。
+ * 
+ * @param jar_file 已解析的JAR文件对象
+ * @param thread_count 工作线程数，0表示按CPU核数选择
+ * @param include_resources 是否同时预解压图片和音频资源
+ * @return 错误码
+ */
+j2me_error_t j2me_jar_start_prefetch(j2me_jar_file_t* jar_file, int thread_count, bool include_resources);
+
+/**
+ * @brief 停止后台解压线程池（等待正在解压的条目完成）
+ * @param jar_file JAR文件对象
+ */
+void j2me_jar_stop_prefetch(j2me_jar_file_t* jar_file);
+
 /**
  * @brief 提取JAR条目到文件
  * @param jar_file JAR文件对象
@@ -0,0 +1,138 @@
+#ifndef J2ME_JIT_H
+#define J2ME_JIT_H
+
+#include "j2me_types.h"
+#include "j2me_interpreter.h"
+#include "j2me_interpreter_optimized.h"
+#include "j2me_method_invocation.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file j2me_jit.h
+ * @brief 热点方法的模板JIT编译器 (x86-64 / AArch64 Linux)
+ *
+ * 方法的进入次数（调用和时间片之间的恢复）达到阈值后，按字节码逐条套用机器码模板编译：
+ * 操作数栈和局部变量仍然保存在栈帧中，编译时已知每条指令的栈深度，栈槽位直接按固定偏移访问。
+ * 快速化后的常量、静态字段槽、实例字段和调用目标在编译时从解析表取出嵌入代码，
+ * 运行时不再查表。
+ *
+ * 不支持的指令（对象创建、未快速化的指令等）编译为退出：编译代码把pc和栈深度写回栈帧后
+ * 返回，由解释器执行这一条指令，之后栈深度与编译时一致就重新进入编译代码。
+ * 编译后又被快速化的指令会让方法在下次进入时重新编译。
+ *
+ * 机器码放在mmap分配的代码缓存中，写入时可写、执行时只读可执行。启用perf映射时
+ * 每个编译的方法写一行到/tmp/perf-<pid>.map，perf可以据此解析编译代码的符号。
+ */
+
+#define J2ME_JIT_DEFAULT_THRESHOLD  1000                // 默认编译阈值（方法进入次数）
+#define J2ME_JIT_CODE_CACHE_SIZE    (8 * 1024 * 1024)   // 代码缓存大小（字节）
+#define J2ME_JIT_MAX_RECOMPILES     3                   // 每个方法最多重新编译次数
+#define J2ME_JIT_MAX_FRAME_SLOTS    4095                // 可编译方法的max_stack/max_locals上限
+#define J2ME_JIT_NO_ENTRY           0xFFFFFFFF          // 不能从该字节码偏移进入编译代码
+
+// 编译代码的退出原因（运行时辅助函数返回J2ME_JIT_EXIT_CONTINUE表示继续执行编译代码）
+typedef enum {
+    J2ME_JIT_EXIT_CONTINUE = 0,     // 继续执行
+    J2ME_JIT_EXIT_RETURN,           // 方法已返回
+    J2ME_JIT_EXIT_BUDGET,           // 本批次的指令数已用完
+    J2ME_JIT_EXIT_DEOPT,            // 由解释器执行frame->pc处的指令
+    J2ME_JIT_EXIT_RESUME,           // 调用后栈帧状态与编译时不同，从frame->pc重新选择执行方式
+    J2ME_JIT_EXIT_STOP              // 线程停止、栈帧切换或内存不足，结束本批次
+} j2me_jit_exit_t;
+
+// 编译代码的执行上下文
+typedef struct {
+    j2me_vm_t* vm;                  // 虚拟机实例
+    j2me_thread_t* thread;          // 所属线程（可为NULL）
+    int32_t budget;                 // 剩余指令数（每条指令减1，只在向后跳转时检查，可能略微透支）
+    j2me_error_t error;             // 以J2ME_JIT_EXIT_STOP结束时的错误码
+} j2me_jit_context_t;
+
+// 编译时解析的调用点
+typedef struct {
+    const j2me_resolved_call_t* call;   // 调用目标（所属类解析表中的条目）
+    j2me_call_site_cache_t* site;       // 调用点内联缓存，不按接收者分派时为NULL
+    uint32_t next_pc;                   // 调用指令之后的字节码偏移
+    uint32_t depth_after;               // 调用返回后编译代码预期的栈深度
+} j2me_jit_call_t;
+
+// 编译后的方法
+typedef struct j2me_jit_method {
+    uint8_t* code;                      // 代码缓存中的机器码，方法不能编译时为NULL
+    size_t code_size;                   // 机器码长度
+    uint32_t* entries;                  // 按字节码偏移索引的入口（相对code），J2ME_JIT_NO_ENTRY表示不能进入
+    uint16_t* depths;                   // 从各入口进入时要求的操作数栈深度
+    uint32_t length;                    // 字节码长度
+    j2me_jit_call_t* calls;             // 编译代码引用的调用点
+    uint32_t call_count;                // 调用点数
+    bool stale;                         // 编译后有指令被快速化，下次进入时重新编译
+    uint8_t recompiles;                 // 已重新编译次数
+    struct j2me_jit_method* previous;   // 重新编译前的版本（可能仍在外层执行，随方法一起释放）
+} j2me_jit_method_t;
+
+// JIT编译器（每个虚拟机一个）
+typedef struct j2me_jit {
+    uint8_t* cache;                     // 代码缓存
+    size_t cache_size;                  // 代码缓存大小
+    size_t cache_used;                  // 已使用字节数（只追加，方法销毁时不回收）
+    size_t page_size;                   // 内存页大小
+    uint32_t threshold;                 // 编译阈值
+    FILE* perf_map;                     // perf符号映射文件，未启用时为NULL
+
+    // 统计
+    uint64_t compiled_methods;          // 编译的方法数（包括重新编译）
+    uint64_t failed_methods;            // 不能编译的方法数
+    uint64_t deopts;                    // 退出到解释器执行的指令数
+    bool cache_full;                    // 代码缓存已满，不再编译
+} j2me_jit_t;
+
+/**
+ * @brief 创建JIT编译器
+ * @param threshold 编译阈值（方法进入次数），0表示使用默认值
+ * @param perf_map 是否写出/tmp/perf-<pid>.map
+ * @return JIT编译器，当前平台不支持或代码缓存分配失败时返回NULL
+ */
+j2me_jit_t* j2me_jit_create(uint32_t threshold, bool perf_map);
+
+/**
+ * @brief 销毁JIT编译器并释放代码缓存
+ *
+ * 必须在所有类（以及其中编译后的方法）销毁之后调用
+ *
+ * @param jit JIT编译器
+ */
+void j2me_jit_destroy(j2me_jit_t* jit);
+
+/**
+ * @brief 记录一次方法进入，方法已编译或达到阈值时返回编译后的方法
+ * @param vm 虚拟机实例
+ * @param frame 将要执行的栈帧
+ * @return 编译后的方法，栈帧不能用编译代码执行时返回NULL
+ */
+j2me_jit_method_t* j2me_jit_prepare(j2me_vm_t* vm, j2me_stack_frame_t* frame);
+
+/**
+ * @brief 用编译代码批量执行栈帧，不能进入编译代码的指令由解释器逐条执行
+ *
+ * 批次结束条件与线程化分发引擎相同：批次用完、方法返回、线程停止或栈帧切换。
+ *
+ * @param vm 虚拟机实例
+ * @param thread 所属线程（可为NULL）
+ * @param frame 当前栈帧
+ * @param compiled j2me_jit_prepare返回的编译后方法
+ * @param max_instructions 本批次最多执行的指令数
+ * @param executed 输出实际执行的指令数
+ * @return 错误码（只有内存不足会中断执行，其余错误记录后继续）
+ */
+j2me_error_t j2me_jit_execute(j2me_vm_t* vm, j2me_thread_t* thread, j2me_stack_frame_t* frame,
+                              j2me_jit_method_t* compiled, uint32_t max_instructions, uint32_t* executed);
+
+/**
+ * @brief 释放方法的编译结果（包括重新编译前的版本）
+ * @param compiled 编译后的方法 (method->jit_code)
+ */
+void j2me_jit_method_destroy(void* compiled);
+
+#endif // J2ME_JIT_H
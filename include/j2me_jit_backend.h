@@ -0,0 +1,160 @@
+#ifndef J2ME_JIT_BACKEND_H
+#define J2ME_JIT_BACKEND_H
+
+#include "j2me_jit.h"
+#include "j2me_field_access.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file j2me_jit_backend.h
+ * @brief 模板JIT的机器码生成接口（JIT内部使用）
+ *
+ * 字节码模板由j2me_jit.c用这里的基本操作拼成，每种体系结构实现一份
+ * (j2me_jit_x86_64.c / j2me_jit_aarch64.c)。编译代码只使用两个临时寄存器A和B，
+ * 它们的值不跨越字节码指令；栈帧、局部变量表、操作数栈和剩余指令数放在被调用者保存的寄存器中。
+ *
+ * 生成的代码与位置无关（调用运行时函数使用绝对地址），可以先写入临时缓冲区再复制到代码缓存。
+ * 跳转位置（patch）是跳转指令在缓冲区中的偏移，由j2me_jit_patch填写目标。
+ */
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define J2ME_JIT_SUPPORTED 1
+#else
+#define J2ME_JIT_SUPPORTED 0
+#endif
+
+// 机器码缓冲区
+typedef struct {
+    uint8_t* data;              // 机器码
+    size_t length;              // 已写入字节数
+    size_t capacity;            // 容量
+    bool failed;                // 内存不足，之后的写入都被忽略
+} j2me_jit_buffer_t;
+
+// 临时寄存器
+typedef enum {
+    J2ME_JIT_REG_A = 0,
+    J2ME_JIT_REG_B
+} j2me_jit_reg_t;
+
+// 二元运算 (A = A op B)。DIV/REM要求B不为0也不为-1，由模板预先处理
+typedef enum {
+    J2ME_JIT_ALU_ADD = 0,
+    J2ME_JIT_ALU_SUB,
+    J2ME_JIT_ALU_MUL,
+    J2ME_JIT_ALU_DIV,
+    J2ME_JIT_ALU_REM,
+    J2ME_JIT_ALU_AND,
+    J2ME_JIT_ALU_OR,
+    J2ME_JIT_ALU_XOR,
+    J2ME_JIT_ALU_SHL,
+    J2ME_JIT_ALU_SHR,
+    J2ME_JIT_ALU_USHR
+} j2me_jit_alu_t;
+
+// 有符号比较条件
+typedef enum {
+    J2ME_JIT_COND_EQ = 0,
+    J2ME_JIT_COND_NE,
+    J2ME_JIT_COND_LT,
+    J2ME_JIT_COND_GE,
+    J2ME_JIT_COND_GT,
+    J2ME_JIT_COND_LE
+} j2me_jit_cond_t;
+
+// 编译代码入口：从target开始执行，返回j2me_jit_exit_t
+typedef uint32_t (*j2me_jit_entry_t)(j2me_stack_frame_t* frame, j2me_jit_context_t* context, const void* target);
+
+// 编译代码调用的运行时函数，返回值写入A
+typedef j2me_int (*j2me_jit_helper_t)(j2me_stack_frame_t* frame, j2me_jit_context_t* context,
+                                      const void* arg, j2me_int a, j2me_int b);
+
+/**
+ * @brief 向缓冲区追加字节
+ */
+void j2me_jit_buffer_emit(j2me_jit_buffer_t* buffer, const void* bytes, size_t size);
+
+/**
+ * @brief 生成入口和公共出口，编译代码从偏移0进入 (j2me_jit_entry_t)
+ * @return 公共出口的偏移：跳到这里时A中是退出原因
+ */
+size_t j2me_jit_emit_prologue(j2me_jit_buffer_t* buffer);
+
+// 局部变量、操作数栈槽位（按栈深度编号，0为栈底）和立即数
+void j2me_jit_emit_load_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index);
+void j2me_jit_emit_store_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index);
+void j2me_jit_emit_load_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot);
+void j2me_jit_emit_store_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot);
+void j2me_jit_emit_load_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_int value);
+// 局部变量加立即数 (iinc)
+void j2me_jit_emit_add_local(j2me_jit_buffer_t* buffer, uint32_t index, j2me_int value);
+
+// 运算：A = A op B、A = -A
+void j2me_jit_emit_alu(j2me_jit_buffer_t* buffer, j2me_jit_alu_t op);
+void j2me_jit_emit_neg(j2me_jit_buffer_t* buffer);
+
+// 静态字段槽 (j2me_value_t) 的整数值：读到A、把A写入（同时把类型设为int）
+void j2me_jit_emit_load_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot);
+void j2me_jit_emit_store_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot);
+
+/**
+ * @brief 比较A和B，条件成立时跳转
+ * @return 跳转位置
+ */
+size_t j2me_jit_emit_branch(j2me_jit_buffer_t* buffer, j2me_jit_cond_t cond);
+
+/**
+ * @brief 比较寄存器和立即数，条件成立时跳转
+ * @return 跳转位置
+ */
+size_t j2me_jit_emit_branch_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_jit_cond_t cond, j2me_int value);
+
+/**
+ * @brief 无条件跳转
+ * @return 跳转位置
+ */
+size_t j2me_jit_emit_jump(j2me_jit_buffer_t* buffer);
+
+/**
+ * @brief 剩余指令数大于0时跳转
+ * @return 跳转位置
+ */
+size_t j2me_jit_emit_branch_budget(j2me_jit_buffer_t* buffer);
+
+/**
+ * @brief 填写跳转目标
+ * @param buffer 缓冲区
+ * @param patch 跳转位置
+ * @param target 目标偏移
+ */
+void j2me_jit_patch(j2me_jit_buffer_t* buffer, size_t patch, size_t target);
+
+// 剩余指令数减1
+void j2me_jit_emit_tick(j2me_jit_buffer_t* buffer);
+
+/**
+ * @brief 写回pc和栈深度后退出编译代码
+ * @param buffer 缓冲区
+ * @param pc 写入frame->pc的字节码偏移
+ * @param depth 写入frame->operand_stack.top的栈深度
+ * @param reason 退出原因
+ * @param epilogue 公共出口偏移
+ */
+void j2me_jit_emit_exit(j2me_jit_buffer_t* buffer, uint32_t pc, uint32_t depth, j2me_jit_exit_t reason,
+                        size_t epilogue);
+
+// 把A保存为方法返回值 (frame->return_value/has_return_value)
+void j2me_jit_emit_set_return(j2me_jit_buffer_t* buffer);
+
+/**
+ * @brief 调用运行时函数：helper(frame, context, arg, A, B)，返回值写入A
+ *
+ * 调用前把frame->operand_stack.top设为depth，使垃圾回收和被调用的方法能看到正确的操作数栈
+ */
+void j2me_jit_emit_call(j2me_jit_buffer_t* buffer, j2me_jit_helper_t helper, const void* arg, uint32_t depth);
+
+// A不为0时以A为退出原因退出（运行时函数已写回栈帧状态）
+void j2me_jit_emit_exit_if_nonzero(j2me_jit_buffer_t* buffer, size_t epilogue);
+
+#endif // J2ME_JIT_BACKEND_H
@@ -7,6 +7,7 @@
 #include "j2me_interpreter.h"
 #include "j2me_exception.h"
 #include "j2me_field_access.h"
+#include "j2me_native_methods.h"
 
 /**
  * @file j2me_method_invocation.h
@@ -32,6 +33,34 @@ typedef struct {
     j2me_exception_t* exception;            /**< 异常信息 */
 } j2me_method_invocation_context_t;
 
+/**
+ * @brief 调用目标类型
+ */
+typedef enum {
+    J2ME_CALL_UNRESOLVED = 0,   /**< 目标未找到，只按描述符弹出参数 */
+    J2ME_CALL_BUILTIN,          /**< 内建或本地方法实现，直接操作调用者栈 */
+    J2ME_CALL_METHOD            /**< 解释执行的Java方法 */
+} j2me_call_kind_t;
+
+// 调用标志
+#define J2ME_CALL_FLAG_TRACK_CANVAS 0x01    // 记录返回的Canvas对象引用
+#define J2ME_CALL_FLAG_VIRTUAL      0x02    // 按接收者的虚方法表分派
+#define J2ME_CALL_FLAG_INTERFACE    0x04    // 按接收者的接口方法表分派（method为接口方法）
+
+/**
+ * @brief 已解析的调用目标
+ * 
+ * 由j2me_method_invocation_resolve_call填充，可以缓存后重复调用
+ */
+typedef struct {
+    j2me_call_kind_t kind;                  /**< 调用目标类型 */
+    j2me_native_method_func_t builtin;      /**< 内建或本地方法实现 (J2ME_CALL_BUILTIN) */
+    j2me_method_t* method;                  /**< 目标方法 (J2ME_CALL_METHOD) */
+    uint16_t arg_slots;                     /**< 参数槽位数（不包括this） */
+    bool has_receiver;                      /**< 是否有this引用 */
+    uint8_t flags;                          /**< 调用标志 */
+} j2me_resolved_call_t;
+
 /**
  * @brief 创建方法调用上下文
  * @param vm 虚拟机实例
@@ -142,6 +171,38 @@ j2me_error_t j2me_method_invocation_invoke_interface(
     uint16_t method_ref_index,
     uint8_t count);
 
+/**
+ * @brief 解析方法引用为调用目标
+ * @param vm 虚拟机实例
+ * @param caller_class 调用者所在类（提供常量池）
+ * @param opcode 调用指令 (OPCODE_INVOKEVIRTUAL等)
+ * @param method_ref_index 方法引用索引
+ * @param count invokeinterface的参数数量，其他指令忽略
+ * @param call 输出调用目标
+ * @return 错误码
+ */
+j2me_error_t j2me_method_invocation_resolve_call(
+    j2me_vm_t* vm,
+    j2me_class_t* caller_class,
+    uint8_t opcode,
+    uint16_t method_ref_index,
+    uint8_t count,
+    j2me_resolved_call_t* call);
+
+/**
+ * @brief 按已解析的调用目标执行调用
+ * @param vm 虚拟机实例
+ * @param caller_frame 调用者栈帧
+ * @param call 调用目标
+ * @param site 调用点内联缓存（可为NULL），虚分派和接口分派时先按接收者类查缓存
+ * @return 错误码
+ */
+j2me_error_t j2me_method_invocation_invoke_resolved(
+    j2me_vm_t* vm,
+    j2me_stack_frame_t* caller_frame,
+    const j2me_resolved_call_t* call,
+    j2me_call_site_cache_t* site);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@ typedef struct {
     const char* method_name;    // 方法名 (如 "getDisplay")
     const char* signature;      // 方法签名 (如 "()Ljavax/microedition/lcdui/Display;")
     j2me_native_method_func_t func; // 本地方法实现
+    uint32_t hash;              // 类名、方法名和签名的哈希
 } j2me_native_method_entry_t;
 
 // 本地方法注册表
@@ -31,6 +32,10 @@ typedef struct j2me_native_method_registry {
     j2me_native_method_entry_t* entries;  // 注册项数组
     size_t count;                         // 注册项数量
     size_t capacity;                      // 容量
+    
+    // 按(类名, 方法名, 签名)索引的开放寻址哈希表（线性探测），槽位存注册项下标+1，0为空槽
+    uint32_t* table;                      // 槽位数组
+    size_t table_capacity;                // 槽位数 (2的幂)
 } j2me_native_method_registry_t;
 
 /**
@@ -73,6 +78,31 @@ j2me_native_method_func_t j2me_native_method_find(j2me_native_method_registry_t*
                                                   const char* method_name,
                                                   const char* signature);
 
+/**
+ * @brief 在虚拟机的注册表中查找本地方法
+ * @param vm 虚拟机实例
+ * @param class_name 类名
+ * @param method_name 方法名
+ * @param signature 方法签名
+ * @return 本地方法函数指针，未找到返回NULL
+ */
+j2me_native_method_func_t j2me_native_method_lookup(j2me_vm_t* vm,
+                                                    const char* class_name,
+                                                    const char* method_name,
+                                                    const char* signature);
+
+/**
+ * @brief 获取方法绑定的本地实现
+ * 
+ * 第一次调用时按所属类名、方法名和描述符查找注册表，结果保存在method->native_function，
+ * 之后直接返回。
+ * 
+ * @param vm 虚拟机实例
+ * @param method 本地方法 (ACC_NATIVE)
+ * @return 本地方法函数指针，未注册返回NULL
+ */
+j2me_native_method_func_t j2me_native_method_bind(j2me_vm_t* vm, j2me_method_t* method);
+
 /**
  * @brief 调用本地方法
  * @param vm 虚拟机实例
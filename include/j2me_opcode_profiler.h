@@ -0,0 +1,87 @@
+#ifndef J2ME_OPCODE_PROFILER_H
+#define J2ME_OPCODE_PROFILER_H
+
+#include "j2me_types.h"
+#include "j2me_interpreter.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file j2me_opcode_profiler.h
+ * @brief 指令序列分析器
+ *
+ * 统计实际执行的连续指令序列（长度2~4的n-gram）的执行次数，用来选取预解码解释器的
+ * 超级指令。序列只在同一栈帧内顺序执行的指令之间延续，跳转、调用和返回都会截断序列；
+ * 快速指令和局部变量短格式指令按j2me_opcode_family归并。报告在虚拟机退出时写出，
+ * 列出每种长度执行次数最多的序列，并标出已经融合为超级指令的序列。
+ *
+ * 分析期间所有栈帧都由通用解释器逐条执行，速度明显低于正常运行。
+ */
+
+#define J2ME_OPCODE_PROFILER_MIN_NGRAM  2       // 统计的最短序列
+#define J2ME_OPCODE_PROFILER_MAX_NGRAM  4       // 统计的最长序列
+
+// 报告格式
+typedef enum {
+    J2ME_OPCODE_REPORT_TEXT = 0,    // 文本
+    J2ME_OPCODE_REPORT_JSON         // JSON
+} j2me_opcode_report_format_t;
+
+// 指令序列统计
+typedef struct {
+    uint32_t opcodes;               // 序列中的指令（第一条在最高字节，不足4条时低字节为0）
+    uint8_t length;                 // 序列长度，0表示槽位未使用
+    uint64_t count;                 // 执行次数
+} j2me_opcode_ngram_t;
+
+// 指令序列分析器
+typedef struct j2me_opcode_profiler {
+    char* report_path;                          // 报告路径
+    j2me_opcode_report_format_t format;         // 报告格式
+    uint8_t lengths[256];                       // 指令长度，变长指令为0（之后的指令不与它连成序列）
+
+    // 序列统计（开放寻址哈希表，线性探测）
+    j2me_opcode_ngram_t* ngrams;                // 槽位数组
+    size_t ngram_capacity;                      // 槽位数 (2的幂)
+    size_t ngram_count;                         // 已统计的序列数
+
+    // 当前正在延续的序列
+    const j2me_stack_frame_t* last_frame;       // 上一条指令所在的栈帧
+    uint32_t next_pc;                           // 上一条指令顺序执行时的下一条指令偏移
+    uint32_t history;                           // 最近执行的指令（最近的在最低字节）
+    uint32_t history_length;                    // 可以与下一条指令连成序列的指令数
+
+    uint64_t total_instructions;                // 执行的指令总数
+} j2me_opcode_profiler_t;
+
+/**
+ * @brief 创建指令序列分析器
+ * @param report_path 报告路径，以.json结尾时输出JSON，否则输出文本
+ * @return 指令序列分析器，失败返回NULL
+ */
+j2me_opcode_profiler_t* j2me_opcode_profiler_create(const char* report_path);
+
+/**
+ * @brief 写出最终报告并销毁分析器
+ * @param profiler 指令序列分析器
+ */
+void j2me_opcode_profiler_destroy(j2me_opcode_profiler_t* profiler);
+
+/**
+ * @brief 记录一条即将执行的指令
+ * @param profiler 指令序列分析器
+ * @param frame 指令所在栈帧
+ * @param pc 指令的字节码偏移
+ * @param opcode 指令码
+ */
+void j2me_opcode_profiler_record(j2me_opcode_profiler_t* profiler, const j2me_stack_frame_t* frame,
+                                 uint32_t pc, j2me_opcode_t opcode);
+
+/**
+ * @brief 写出当前统计（覆盖报告文件）
+ * @param profiler 指令序列分析器
+ * @return 错误码
+ */
+j2me_error_t j2me_opcode_profiler_write_report(j2me_opcode_profiler_t* profiler);
+
+#endif // J2ME_OPCODE_PROFILER_H
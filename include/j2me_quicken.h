@@ -0,0 +1,123 @@
+#ifndef J2ME_QUICKEN_H
+#define J2ME_QUICKEN_H
+
+#include "j2me_types.h"
+#include "j2me_class.h"
+#include "j2me_bytecode.h"
+#include "j2me_interpreter.h"
+#include "j2me_method_invocation.h"
+
+/**
+ * @file j2me_quicken.h
+ * @brief 字节码快速化（quickening）
+ *
+ * ldc/getstatic/putstatic/getfield/putfield/invoke*指令第一次执行时解析常量池引用，
+ * 解析结果保存在所属类的quick_entries表中（按常量池索引），并把指令原地改写为
+ * 对应的*_quick指令。之后执行快速指令时直接使用缓存的常量值、静态字段槽、
+ * 字段或调用目标，不再查找常量池和比较字符串。
+ *
+ * 快速指令的操作数保持为常量池索引：原指令只有1~2字节操作数，放不下指针。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 快速指令解析结果类型
+ */
+typedef enum {
+    J2ME_QUICK_NONE = 0,            /**< 未解析 */
+    J2ME_QUICK_CONSTANT,            /**< 常量值 (ldc/ldc_w) */
+    J2ME_QUICK_STATIC_FIELD,        /**< 静态字段存储槽 (getstatic/putstatic) */
+    J2ME_QUICK_INSTANCE_FIELD,      /**< 实例字段 (getfield/putfield) */
+    J2ME_QUICK_CALL                 /**< 调用目标 (invoke*) */
+} j2me_quick_kind_t;
+
+/**
+ * @brief 快速指令解析结果，每个常量池条目一项
+ */
+typedef struct {
+    j2me_quick_kind_t kind;                 /**< 解析结果类型 */
+    j2me_opcode_t opcode;                   /**< 解析时的原始指令（调用目标依赖指令类型） */
+    union {
+        j2me_int constant;                  /**< 常量压栈值 */
+        j2me_value_t* static_slot;          /**< 静态字段存储槽 */
+        j2me_field_t* field;                /**< 实例字段 */
+        j2me_resolved_call_t call;          /**< 调用目标 */
+    } u;
+} j2me_quick_entry_t;
+
+/**
+ * @brief 解析指令并原地改写为快速指令
+ * @param vm 虚拟机实例
+ * @param frame 当前栈帧（提供所属方法和字节码）
+ * @param pc 指令在字节码中的偏移
+ * @return 改写成功返回J2ME_SUCCESS；无法解析时返回错误码，指令保持不变
+ */
+j2me_error_t j2me_quicken_instruction(j2me_vm_t* vm, j2me_stack_frame_t* frame, uint32_t pc);
+
+/**
+ * @brief 查找已解析的调用目标（不触发解析）
+ *
+ * 通用调用路径（未能改写为快速指令的位置）先查解析表，命中时不再解析方法引用
+ *
+ * @param owner 常量池所属类
+ * @param opcode 原始调用指令
+ * @param index 方法引用索引
+ * @return 同一调用指令已解析的调用目标，没有时返回NULL
+ */
+const j2me_resolved_call_t* j2me_quicken_find_call(j2me_class_t* owner, j2me_opcode_t opcode, uint16_t index);
+
+/**
+ * @brief 把通用调用路径解析出的调用目标写入解析表（条目已有结果时不覆盖）
+ * @param owner 常量池所属类
+ * @param opcode 原始调用指令
+ * @param index 方法引用索引
+ * @param call 调用目标，未解析的调用不写入
+ */
+void j2me_quicken_remember_call(j2me_class_t* owner, j2me_opcode_t opcode, uint16_t index,
+                                const j2me_resolved_call_t* call);
+
+/**
+ * @brief 执行已解析的调用并把返回值压入调用者栈（快速调用指令和JIT编译代码共用）
+ *
+ * 调用失败且有待处理的异常时交给异常处理（可能改变frame->pc）
+ *
+ * @param vm 虚拟机实例
+ * @param frame 调用者栈帧，参数在操作数栈顶
+ * @param call 调用目标
+ * @param site 调用点内联缓存（可为NULL）
+ * @return 错误码
+ */
+j2me_error_t j2me_interpreter_invoke_resolved(j2me_vm_t* vm, j2me_stack_frame_t* frame,
+                                              const j2me_resolved_call_t* call, j2me_call_site_cache_t* site);
+
+/**
+ * @brief 判断指令是否为快速指令
+ * @param opcode 指令码
+ * @return 是快速指令返回true
+ */
+static inline bool j2me_quicken_is_quick_opcode(j2me_opcode_t opcode) {
+    return opcode >= OPCODE_LDC_QUICK && opcode <= OPCODE_INVOKEINTERFACE_QUICK;
+}
+
+/**
+ * @brief 获取快速指令的解析结果
+ *
+ * 只对已改写为快速指令的位置调用，此时所属类的解析表一定存在
+ *
+ * @param frame 当前栈帧
+ * @param index 常量池索引
+ * @return 解析结果
+ */
+static inline j2me_quick_entry_t* j2me_quicken_entry(const j2me_stack_frame_t* frame, uint16_t index) {
+    j2me_class_t* owner = ((j2me_method_t*)frame->method_info)->owner_class;
+    return &((j2me_quick_entry_t*)owner->quick_entries)[index];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // J2ME_QUICKEN_H
@@ -9,17 +9,45 @@
  * @brief J2ME String对象实现
  * 
  * 实现Java String对象的创建、存储和访问
+ *
+ * 驻留表按内容哈希保存规范String（ldc字符串常量和String.intern()），表项是弱引用：
+ * 每次回收标记完成后删除不再存活的字符串。开启去重后，完整回收还会把内容相同的
+ * 老年代String改为共享同一份字符：对象引用（身份）不变，只是缩小成指向规范String的引用。
  */
 
 // String对象数据结构
 typedef struct {
-    uint32_t length;        // 字符串长度
+    uint32_t length;        // 字符串长度；带J2ME_STRING_SHARED时字符在chars开头记录的String中
     char chars[];           // 字符数据（UTF-8编码）
 } j2me_string_data_t;
 
 // String类ID
 #define J2ME_CLASS_STRING 1
 
+// 去重后的String：length带该标志，chars开头是共享字符的String引用
+#define J2ME_STRING_SHARED 0x80000000u
+
+// 去重只处理不短于该长度的字符串（更短的字符串缩小后腾不出一个最小块）
+#define J2ME_STRING_DEDUP_MIN_LENGTH 12
+
+// 驻留表项
+typedef struct {
+    j2me_ref_t ref;         // String引用，J2ME_NULL_REF表示空槽
+    uint32_t hash;          // 内容哈希
+} j2me_string_table_entry_t;
+
+// 字符串驻留表（开放寻址哈希表，线性探测）
+typedef struct j2me_string_table {
+    j2me_string_table_entry_t* entries; // 槽位数组
+    size_t capacity;                    // 槽位数 (2的幂)
+    size_t count;                       // 驻留的字符串数
+    bool dedup;                         // 完整回收时对老年代字符串去重
+    uint64_t hits;                      // 驻留命中次数
+    uint64_t misses;                    // 驻留未命中（新建String）次数
+    uint64_t strings_deduplicated;      // 累计去重的字符串数
+    uint64_t bytes_deduplicated;        // 累计去重释放的字节数
+} j2me_string_table_t;
+
 /**
  * @brief 创建String对象
  * @param heap 堆指针
@@ -37,6 +65,49 @@ j2me_ref_t j2me_heap_string_create(j2me_heap_t* heap, const char* str);
  */
 j2me_ref_t j2me_heap_string_create_n(j2me_heap_t* heap, const char* str, size_t length);
 
+/**
+ * @brief 获取内容相同的驻留String，没有时创建并驻留
+ *
+ * 驻留表不持有引用：返回的String和普通新建的String一样，需要调用方保持可达。
+ *
+ * @param heap 堆指针
+ * @param str 字符数据
+ * @param length 字符串长度
+ * @return String对象引用，失败返回J2ME_NULL_REF
+ */
+j2me_ref_t j2me_heap_string_intern(j2me_heap_t* heap, const char* str, size_t length);
+
+/**
+ * @brief String.intern()：返回内容相同的驻留String，没有时驻留ref本身
+ * @param heap 堆指针
+ * @param ref String对象引用
+ * @return 驻留String的引用，ref不是String时原样返回
+ */
+j2me_ref_t j2me_heap_string_intern_ref(j2me_heap_t* heap, j2me_ref_t ref);
+
+/**
+ * @brief 开启或关闭回收时的字符串去重
+ * @param heap 堆指针
+ * @param enabled 是否去重
+ * @return 错误码
+ */
+j2me_error_t j2me_heap_string_set_dedup(j2me_heap_t* heap, bool enabled);
+
+/**
+ * @brief 清理驻留表中不再存活的字符串，开启去重时对老年代字符串去重
+ *
+ * 由堆在标记完成之后、清除之前调用。
+ *
+ * @param heap 堆指针
+ */
+void j2me_string_table_sweep(j2me_heap_t* heap);
+
+/**
+ * @brief 销毁驻留表（由j2me_heap_destroy调用）
+ * @param table 驻留表，可以为NULL
+ */
+void j2me_string_table_destroy(j2me_string_table_t* table);
+
 /**
  * @brief 获取String对象的C字符串
  * @param heap 堆指针
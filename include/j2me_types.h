@@ -70,7 +70,8 @@ typedef enum {
     J2ME_ERROR_UNCAUGHT_EXCEPTION,
     J2ME_ERROR_INVALID_CONSTANT_TYPE,
     J2ME_ERROR_INVALID_DESCRIPTOR,
-    J2ME_ERROR_INCOMPATIBLE_CLASS_CHANGE
+    J2ME_ERROR_INCOMPATIBLE_CLASS_CHANGE,
+    J2ME_ERROR_FIELD_NOT_FOUND
 } j2me_error_t;
 
 // 常量定义
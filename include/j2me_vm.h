@@ -16,17 +16,36 @@
  * 定义虚拟机的主要结构和接口函数
  */
 
+// 字节码执行模式
+typedef enum {
+    J2ME_EXEC_MODE_THREADED = 0,    // 线程化分发解释器 (默认)
+    J2ME_EXEC_MODE_PREDECODED       // 按方法缓存的预解码解释器
+} j2me_execution_mode_t;
+
 // 虚拟机配置
 typedef struct {
     size_t heap_size;           // 堆大小 (字节)
     size_t stack_size;          // 栈大小 (字节)
     size_t max_threads;         // 最大线程数
     bool enable_gc;             // 是否启用垃圾回收
-    bool enable_jit;            // 是否启用JIT编译
+    uint32_t heap_compact_ratio; // 回收后触发堆压缩的碎片率（百分比）
+    uint32_t gc_step_budget_us; // 每个时间片的增量标记预算（微秒），0表示只在分配失败时停顿回收
+    bool enable_jit;            // 是否启用JIT编译（热点方法编译为机器码，只支持x86-64/AArch64 Linux）
+    uint32_t jit_threshold;     // JIT编译阈值（方法进入次数），0表示使用默认值
+    bool jit_perf_map;          // 为编译的方法写出/tmp/perf-<pid>.map
+    j2me_execution_mode_t execution_mode; // 字节码执行模式
+    const char* alloc_profile_path; // 分配分析报告路径（以.json结尾时输出JSON），NULL表示不分析
+    size_t alloc_sample_interval; // 分配点采样间隔（字节），0表示使用默认值
+    const char* heap_dump_path; // 堆快照路径（收到SIGUSR2时写出），NULL表示不启用
+    bool string_dedup;          // 完整回收时对内容相同的字符串去重
+    const char* opcode_profile_path; // 指令序列分析报告路径（以.json结尾时输出JSON），NULL表示不分析
 } j2me_vm_config_t;
 
 // 前向声明
 struct j2me_native_method_registry;
+struct j2me_alloc_profiler;
+struct j2me_opcode_profiler;
+struct j2me_jit;
 
 // 虚拟机实例
 struct j2me_vm {
@@ -34,11 +53,11 @@ struct j2me_vm {
     j2me_vm_config_t config;    // 配置信息
     
     // 内存管理
-    void* heap_start;           // 堆起始地址（旧系统，保留兼容）
-    void* heap_end;             // 堆结束地址（旧系统，保留兼容）
-    void* heap_current;         // 当前堆指针（旧系统，保留兼容）
-    j2me_heap_t* heap;          // 新的对象堆系统
-    j2me_gc_t* gc;              // 垃圾回收器
+    j2me_heap_t* heap;          // 对象堆（所有对象都在这里分配）
+    j2me_gc_t* gc;              // 垃圾回收器（根扫描、开关和统计）
+    struct j2me_alloc_profiler* alloc_profiler; // 分配分析器（未启用时为NULL）
+    struct j2me_opcode_profiler* opcode_profiler; // 指令序列分析器（未启用时为NULL）
+    struct j2me_jit* jit;       // JIT编译器（未启用时为NULL）
     
     // 线程管理
     j2me_thread_t* main_thread; // 主线程
@@ -46,6 +65,7 @@ struct j2me_vm {
     j2me_thread_t* thread_list; // 所有线程的链表
     uint32_t next_thread_id;    // 下一个线程ID
     size_t thread_count;        // 线程数量
+    j2me_stack_frame_t* heap_frames; // 不属于任何线程的堆分配栈帧（GC根扫描用）
     
     // 类加载器
     void* class_loader;         // 类加载器实例
@@ -74,10 +94,13 @@ struct j2me_vm {
     
     // 优化解释器
     j2me_optimized_interpreter_t* optimized_interpreter; // 优化解释器实例
+    j2me_stack_frame_t* executing_frame; // 解释器正在执行的栈帧（不在字节码中时为NULL）
     
     // 统计信息
     uint64_t instructions_executed; // 执行的指令数
     uint64_t gc_collections;    // GC次数
+    j2me_performance_stats_t* perf_stats; // 主解释器性能统计（指令数、执行时间、方法调用）
+    uint32_t execution_depth;   // 解释器嵌套深度（只对最外层执行计时）
 };
 
 /**
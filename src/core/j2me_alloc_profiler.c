@@ -0,0 +1,429 @@
+#include "j2me_alloc_profiler.h"
+#include "j2me_vm.h"
+#include "j2me_heap.h"
+#include "j2me_interpreter.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <signal.h>
+
+/**
+ * @file j2me_alloc_profiler.c
+ * @brief 堆分配分析器实现
+ *
+ * 分配回调里只做哈希表计数：按类统计每次分配，分配点每跨过一个采样间隔记一个样本。
+ * 分配点取虚拟机正在执行的栈帧的方法和pc；NEW等指令走慢速路径时pc已同步，
+ * 本地方法中的分配记在调用它的invoke指令上。类名和方法名只在写报告时解析。
+ */
+
+#define ALLOC_PROFILER_MIN_CAPACITY 64      // 哈希表初始槽位数
+#define ALLOC_REPORT_TEXT_SITES     50      // 文本报告列出的分配点数
+
+// 信号处理函数设置，时间片之间检查
+static volatile sig_atomic_t g_alloc_report_requested = 0;
+
+static uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint32_t site_hash(const j2me_method_t* method, uint32_t pc, uint32_t class_id) {
+    uint64_t m = (uint64_t)(uintptr_t)method;
+    return hash_u32((uint32_t)m ^ (uint32_t)(m >> 32) ^ hash_u32(pc) ^ (class_id * 0x9e3779b9U));
+}
+
+static j2me_alloc_class_stats_t* find_class_slot(j2me_alloc_class_stats_t* table, size_t capacity, uint32_t class_id) {
+    size_t mask = capacity - 1;
+    size_t i = hash_u32(class_id) & mask;
+    while (table[i].used && table[i].class_id != class_id) {
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+static j2me_alloc_site_t* find_site_slot(j2me_alloc_site_t* table, size_t capacity,
+                                         const j2me_method_t* method, uint32_t pc, uint32_t class_id) {
+    size_t mask = capacity - 1;
+    size_t i = site_hash(method, pc, class_id) & mask;
+    while (table[i].used &&
+           (table[i].method != method || table[i].pc != pc || table[i].class_id != class_id)) {
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+/**
+ * @brief 装载率超过3/4时把类统计表扩大一倍
+ */
+static bool grow_classes(j2me_alloc_profiler_t* profiler) {
+    if ((profiler->class_count + 1) * 4 <= profiler->class_capacity * 3) {
+        return true;
+    }
+    
+    size_t capacity = profiler->class_capacity * 2;
+    j2me_alloc_class_stats_t* table = (j2me_alloc_class_stats_t*)calloc(capacity, sizeof(j2me_alloc_class_stats_t));
+    if (!table) {
+        return false;
+    }
+    for (size_t i = 0; i < profiler->class_capacity; i++) {
+        if (profiler->classes[i].used) {
+            *find_class_slot(table, capacity, profiler->classes[i].class_id) = profiler->classes[i];
+        }
+    }
+    free(profiler->classes);
+    profiler->classes = table;
+    profiler->class_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief 装载率超过3/4时把分配点表扩大一倍
+ */
+static bool grow_sites(j2me_alloc_profiler_t* profiler) {
+    if ((profiler->site_count + 1) * 4 <= profiler->site_capacity * 3) {
+        return true;
+    }
+    
+    size_t capacity = profiler->site_capacity * 2;
+    j2me_alloc_site_t* table = (j2me_alloc_site_t*)calloc(capacity, sizeof(j2me_alloc_site_t));
+    if (!table) {
+        return false;
+    }
+    for (size_t i = 0; i < profiler->site_capacity; i++) {
+        j2me_alloc_site_t* site = &profiler->sites[i];
+        if (site->used) {
+            *find_site_slot(table, capacity, site->method, site->pc, site->class_id) = *site;
+        }
+    }
+    free(profiler->sites);
+    profiler->sites = table;
+    profiler->site_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief 记录一个分配点样本
+ */
+static void record_sample(j2me_alloc_profiler_t* profiler, uint32_t class_id, uint64_t samples) {
+    const j2me_method_t* method = NULL;
+    uint32_t pc = 0;
+    j2me_stack_frame_t* frame = profiler->vm->executing_frame;
+    if (frame) {
+        method = (const j2me_method_t*)frame->method_info;
+        pc = frame->pc;
+    }
+    
+    j2me_alloc_site_t* site = find_site_slot(profiler->sites, profiler->site_capacity, method, pc, class_id);
+    if (!site->used) {
+        if (!grow_sites(profiler)) {
+            return;
+        }
+        site = find_site_slot(profiler->sites, profiler->site_capacity, method, pc, class_id);
+        site->method = method;
+        site->pc = pc;
+        site->class_id = class_id;
+        site->used = true;
+        profiler->site_count++;
+    }
+    site->samples += samples;
+    profiler->total_samples += samples;
+}
+
+/**
+ * @brief 堆分配回调
+ */
+static void alloc_profiler_hook(j2me_heap_t* heap, j2me_ref_t ref, uint32_t class_id, size_t size, void* context) {
+    (void)heap;
+    (void)ref;
+    j2me_alloc_profiler_t* profiler = (j2me_alloc_profiler_t*)context;
+    
+    profiler->total_objects++;
+    profiler->total_bytes += size;
+    
+    j2me_alloc_class_stats_t* stats = find_class_slot(profiler->classes, profiler->class_capacity, class_id);
+    if (!stats->used) {
+        if (grow_classes(profiler)) {
+            stats = find_class_slot(profiler->classes, profiler->class_capacity, class_id);
+            stats->class_id = class_id;
+            stats->used = true;
+            profiler->class_count++;
+        } else {
+            stats = NULL;
+        }
+    }
+    if (stats) {
+        stats->objects++;
+        stats->bytes += size;
+    }
+    
+    // 每跨过一个采样间隔记一个样本，大对象一次可以跨过多个间隔
+    profiler->bytes_until_sample -= (int64_t)size;
+    if (profiler->bytes_until_sample <= 0) {
+        uint64_t samples = 1 + (uint64_t)(-profiler->bytes_until_sample) / profiler->sample_interval;
+        profiler->bytes_until_sample += (int64_t)(samples * profiler->sample_interval);
+        record_sample(profiler, class_id, samples);
+    }
+}
+
+j2me_alloc_profiler_t* j2me_alloc_profiler_create(j2me_vm_t* vm, const char* report_path, size_t sample_interval) {
+    if (!vm || !vm->heap || !report_path) {
+        return NULL;
+    }
+    
+    j2me_alloc_profiler_t* profiler = (j2me_alloc_profiler_t*)calloc(1, sizeof(j2me_alloc_profiler_t));
+    if (!profiler) {
+        return NULL;
+    }
+    
+    profiler->vm = vm;
+    profiler->report_path = strdup(report_path);
+    profiler->class_capacity = ALLOC_PROFILER_MIN_CAPACITY;
+    profiler->classes = (j2me_alloc_class_stats_t*)calloc(profiler->class_capacity, sizeof(j2me_alloc_class_stats_t));
+    profiler->site_capacity = ALLOC_PROFILER_MIN_CAPACITY;
+    profiler->sites = (j2me_alloc_site_t*)calloc(profiler->site_capacity, sizeof(j2me_alloc_site_t));
+    if (!profiler->report_path || !profiler->classes || !profiler->sites) {
+        free(profiler->report_path);
+        free(profiler->classes);
+        free(profiler->sites);
+        free(profiler);
+        return NULL;
+    }
+    
+    size_t path_length = strlen(report_path);
+    profiler->format = (path_length >= 5 && strcmp(report_path + path_length - 5, ".json") == 0)
+                       ? J2ME_ALLOC_REPORT_JSON : J2ME_ALLOC_REPORT_TEXT;
+    profiler->sample_interval = sample_interval > 0 ? sample_interval : J2ME_ALLOC_PROFILER_DEFAULT_INTERVAL;
+    profiler->bytes_until_sample = (int64_t)profiler->sample_interval;
+    
+    j2me_heap_set_alloc_hook(vm->heap, alloc_profiler_hook, profiler);
+    
+    LOG_INFO("[分配分析] 已启用，采样间隔: %zu bytes，报告: %s", profiler->sample_interval, profiler->report_path);
+    return profiler;
+}
+
+void j2me_alloc_profiler_destroy(j2me_alloc_profiler_t* profiler) {
+    if (!profiler) {
+        return;
+    }
+    
+    j2me_heap_set_alloc_hook(profiler->vm->heap, NULL, NULL);
+    j2me_alloc_profiler_write_report(profiler);
+    
+    free(profiler->report_path);
+    free(profiler->classes);
+    free(profiler->sites);
+    free(profiler);
+}
+
+static const char* class_name_or_id(j2me_alloc_profiler_t* profiler, uint32_t class_id, char* buffer, size_t size) {
+    const char* name = j2me_heap_builtin_class_name(class_id);
+    if (name) {
+        return name;
+    }
+    j2me_class_t* cls = j2me_class_loader_find_class_by_id((j2me_class_loader_t*)profiler->vm->class_loader, class_id);
+    if (cls) {
+        return cls->name;
+    }
+    snprintf(buffer, size, "<class 0x%08x>", class_id);
+    return buffer;
+}
+
+static void format_method(const j2me_method_t* method, char* buffer, size_t size) {
+    if (!method) {
+        snprintf(buffer, size, "<vm>");
+        return;
+    }
+    snprintf(buffer, size, "%s.%s%s",
+             method->owner_class && method->owner_class->name ? method->owner_class->name : "?",
+             method->name ? method->name : "?",
+             method->descriptor ? method->descriptor : "");
+}
+
+static void write_json_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(file, "\\%c", *p);
+        } else if (*p < 0x20) {
+            fprintf(file, "\\u%04x", *p);
+        } else {
+            fputc(*p, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static int compare_class_bytes(const void* a, const void* b) {
+    const j2me_alloc_class_stats_t* x = *(const j2me_alloc_class_stats_t* const*)a;
+    const j2me_alloc_class_stats_t* y = *(const j2me_alloc_class_stats_t* const*)b;
+    return x->bytes < y->bytes ? 1 : (x->bytes > y->bytes ? -1 : 0);
+}
+
+static int compare_site_samples(const void* a, const void* b) {
+    const j2me_alloc_site_t* x = *(const j2me_alloc_site_t* const*)a;
+    const j2me_alloc_site_t* y = *(const j2me_alloc_site_t* const*)b;
+    return x->samples < y->samples ? 1 : (x->samples > y->samples ? -1 : 0);
+}
+
+static void write_text_report(j2me_alloc_profiler_t* profiler, FILE* file,
+                              j2me_alloc_class_stats_t** classes, j2me_alloc_site_t** sites) {
+    char class_buffer[32];
+    char method_buffer[256];
+    
+    fprintf(file, "=== 分配分析报告 ===\n");
+    fprintf(file, "分配对象数: %llu\n", (unsigned long long)profiler->total_objects);
+    fprintf(file, "分配字节数: %llu\n", (unsigned long long)profiler->total_bytes);
+    fprintf(file, "采样间隔: %zu bytes，样本数: %llu\n\n",
+            profiler->sample_interval, (unsigned long long)profiler->total_samples);
+    
+    fprintf(file, "按类统计（按字节数排序）:\n");
+    fprintf(file, "%14s %7s %12s  %s\n", "字节数", "占比", "对象数", "类");
+    for (size_t i = 0; i < profiler->class_count; i++) {
+        j2me_alloc_class_stats_t* stats = classes[i];
+        double percent = profiler->total_bytes ? (double)stats->bytes * 100.0 / (double)profiler->total_bytes : 0.0;
+        fprintf(file, "%14llu %6.1f%% %12llu  %s\n",
+                (unsigned long long)stats->bytes, percent, (unsigned long long)stats->objects,
+                class_name_or_id(profiler, stats->class_id, class_buffer, sizeof(class_buffer)));
+    }
+    
+    size_t site_limit = profiler->site_count < ALLOC_REPORT_TEXT_SITES ? profiler->site_count : ALLOC_REPORT_TEXT_SITES;
+    fprintf(file, "\n分配点（按样本数排序，前%zu/%zu个，估计字节数 = 样本数 × 采样间隔）:\n",
+            site_limit, profiler->site_count);
+    fprintf(file, "%10s %14s  %s\n", "样本数", "估计字节数", "方法@pc -> 类");
+    for (size_t i = 0; i < site_limit; i++) {
+        j2me_alloc_site_t* site = sites[i];
+        format_method(site->method, method_buffer, sizeof(method_buffer));
+        fprintf(file, "%10llu %14llu  %s@%u -> %s\n",
+                (unsigned long long)site->samples,
+                (unsigned long long)(site->samples * profiler->sample_interval),
+                method_buffer, site->pc,
+                class_name_or_id(profiler, site->class_id, class_buffer, sizeof(class_buffer)));
+    }
+}
+
+static void write_json_report(j2me_alloc_profiler_t* profiler, FILE* file,
+                              j2me_alloc_class_stats_t** classes, j2me_alloc_site_t** sites) {
+    char class_buffer[32];
+    char method_buffer[256];
+    
+    fprintf(file, "{\n  \"total_objects\": %llu,\n  \"total_bytes\": %llu,\n",
+            (unsigned long long)profiler->total_objects, (unsigned long long)profiler->total_bytes);
+    fprintf(file, "  \"sample_interval\": %zu,\n  \"total_samples\": %llu,\n",
+            profiler->sample_interval, (unsigned long long)profiler->total_samples);
+    
+    fprintf(file, "  \"classes\": [");
+    for (size_t i = 0; i < profiler->class_count; i++) {
+        j2me_alloc_class_stats_t* stats = classes[i];
+        fprintf(file, "%s\n    {\"class_id\": %u, \"name\": ", i ? "," : "", stats->class_id);
+        write_json_string(file, class_name_or_id(profiler, stats->class_id, class_buffer, sizeof(class_buffer)));
+        fprintf(file, ", \"objects\": %llu, \"bytes\": %llu}",
+                (unsigned long long)stats->objects, (unsigned long long)stats->bytes);
+    }
+    fprintf(file, "\n  ],\n");
+    
+    fprintf(file, "  \"sites\": [");
+    for (size_t i = 0; i < profiler->site_count; i++) {
+        j2me_alloc_site_t* site = sites[i];
+        format_method(site->method, method_buffer, sizeof(method_buffer));
+        fprintf(file, "%s\n    {\"method\": ", i ? "," : "");
+        write_json_string(file, method_buffer);
+        fprintf(file, ", \"pc\": %u, \"class_id\": %u, \"class\": ", site->pc, site->class_id);
+        write_json_string(file, class_name_or_id(profiler, site->class_id, class_buffer, sizeof(class_buffer)));
+        fprintf(file, ", \"samples\": %llu, \"estimated_bytes\": %llu}",
+                (unsigned long long)site->samples,
+                (unsigned long long)(site->samples * profiler->sample_interval));
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+j2me_error_t j2me_alloc_profiler_write_report(j2me_alloc_profiler_t* profiler) {
+    if (!profiler) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    // 排序用的指针数组（多分配一个元素，避免计数为0时calloc返回NULL）
+    j2me_alloc_class_stats_t** classes = (j2me_alloc_class_stats_t**)calloc(profiler->class_count + 1, sizeof(*classes));
+    j2me_alloc_site_t** sites = (j2me_alloc_site_t**)calloc(profiler->site_count + 1, sizeof(*sites));
+    if (!classes || !sites) {
+        free(classes);
+        free(sites);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    size_t n = 0;
+    for (size_t i = 0; i < profiler->class_capacity; i++) {
+        if (profiler->classes[i].used) {
+            classes[n++] = &profiler->classes[i];
+        }
+    }
+    qsort(classes, n, sizeof(*classes), compare_class_bytes);
+    
+    n = 0;
+    for (size_t i = 0; i < profiler->site_capacity; i++) {
+        if (profiler->sites[i].used) {
+            sites[n++] = &profiler->sites[i];
+        }
+    }
+    qsort(sites, n, sizeof(*sites), compare_site_samples);
+    
+    j2me_error_t result = J2ME_SUCCESS;
+    FILE* file = fopen(profiler->report_path, "w");
+    if (file) {
+        if (profiler->format == J2ME_ALLOC_REPORT_JSON) {
+            write_json_report(profiler, file, classes, sites);
+        } else {
+            write_text_report(profiler, file, classes, sites);
+        }
+        if (fclose(file) != 0) {
+            result = J2ME_ERROR_IO_EXCEPTION;
+        }
+    } else {
+        result = J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    free(classes);
+    free(sites);
+    
+    if (result == J2ME_SUCCESS) {
+        profiler->reports_written++;
+        LOG_INFO("[分配分析] 报告已写入: %s (%zu个类, %zu个分配点)",
+                 profiler->report_path, profiler->class_count, profiler->site_count);
+    } else {
+        LOG_ERROR("[分配分析] 无法写入报告: %s", profiler->report_path);
+    }
+    return result;
+}
+
+static void alloc_report_signal_handler(int signo) {
+    (void)signo;
+    g_alloc_report_requested = 1;
+}
+
+void j2me_alloc_profiler_install_signal_handler(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = alloc_report_signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR1, &action, NULL) != 0) {
+        LOG_WARN("[分配分析] 无法安装SIGUSR1处理函数");
+    }
+}
+
+void j2me_alloc_profiler_request_report(void) {
+    g_alloc_report_requested = 1;
+}
+
+void j2me_alloc_profiler_poll(j2me_alloc_profiler_t* profiler) {
+    if (!profiler || !g_alloc_report_requested) {
+        return;
+    }
+    
+    g_alloc_report_requested = 0;
+    j2me_alloc_profiler_write_report(profiler);
+}
@@ -0,0 +1,892 @@
+#include "j2me_class_cache.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @file j2me_class_cache.c
+ * @brief 解析后类缓存实现
+ *
+ * 文件布局：文件头、类名哈希索引（开放寻址）、类名字符串、8字节对齐的类记录。
+ * 类记录内部：记录头、接口索引、常量池条目、字段、方法，之后是UTF-8字符串
+ * （带结尾NUL）和字节码。所有偏移都相对记录起点，记录可以原样复制到新文件。
+ */
+
+#define CLASS_CACHE_MAGIC           0x43434A32  // "2JCC"
+#define CLASS_CACHE_ENDIAN_TAG      0x0102      // 按本机字节序写入，读到其他值说明来自不同平台
+#define CLASS_CACHE_MIN_INDEX       16          // 索引最少槽位数
+
+#define CLASS_CACHE_ALIGN8(x)       (((x) + 7) & ~(size_t)7)
+
+// 文件头
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t endian_tag;
+    uint64_t jar_hash;              // JAR内容哈希
+    uint64_t file_size;             // 文件总大小（检测截断）
+    uint32_t class_count;           // 类数
+    uint32_t index_capacity;        // 索引槽位数 (2的幂)
+    uint32_t index_offset;          // 索引偏移
+    uint32_t reserved;
+} class_cache_header_t;
+
+// 索引槽位，record_offset为0表示空槽
+typedef struct {
+    uint32_t name_hash;
+    uint32_t name_offset;
+    uint32_t record_offset;
+    uint32_t record_size;
+} class_cache_index_entry_t;
+
+// 类记录头
+typedef struct {
+    uint16_t minor_version;
+    uint16_t major_version;
+    uint16_t access_flags;
+    uint16_t this_class;
+    uint16_t super_class;
+    uint16_t interfaces_count;
+    uint16_t constant_pool_count;
+    uint16_t fields_count;
+    uint16_t methods_count;
+    uint16_t reserved;
+    uint32_t interfaces_offset;
+    uint32_t constant_pool_offset;
+    uint32_t fields_offset;
+    uint32_t methods_offset;
+} class_cache_record_t;
+
+// 常量池条目
+typedef struct {
+    uint8_t tag;
+    uint8_t reserved;
+    uint16_t index1;                // class/string/ref/name_and_type的第一个索引
+    uint16_t index2;                // ref/name_and_type的第二个索引
+    uint16_t utf8_length;           // UTF-8长度
+    uint32_t utf8_offset;           // UTF-8字节偏移（以NUL结尾）
+    uint32_t reserved2;
+    uint64_t value;                 // 数值常量的原始位
+} class_cache_constant_t;
+
+// 字段
+typedef struct {
+    uint16_t access_flags;
+    uint16_t name_index;
+    uint16_t descriptor_index;
+    uint16_t attributes_count;
+} class_cache_field_t;
+
+// 方法
+typedef struct {
+    uint16_t access_flags;
+    uint16_t name_index;
+    uint16_t descriptor_index;
+    uint16_t attributes_count;
+    uint16_t max_stack;
+    uint16_t max_locals;
+    uint32_t bytecode_length;
+    uint32_t bytecode_offset;
+} class_cache_method_t;
+
+/**
+ * @brief 计算类名哈希 (FNV-1a)
+ */
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 向64位FNV-1a哈希追加数据
+ */
+static uint64_t hash64_update(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 计算JAR内容哈希
+ *
+ * 中央目录里的CRC32已经覆盖了每个条目的内容，不需要读取整个文件
+ */
+static uint64_t hash_jar(j2me_jar_file_t* jar_file) {
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t file_size = jar_file->file_size;
+    hash = hash64_update(hash, &file_size, sizeof(file_size));
+
+    for (int i = 0; i < jar_file->entry_count; i++) {
+        j2me_jar_entry_t* entry = jar_file->entries[i];
+        uint64_t sizes[2] = { entry->compressed_size, entry->uncompressed_size };
+        hash = hash64_update(hash, entry->name, strlen(entry->name) + 1);
+        hash = hash64_update(hash, &entry->crc32, sizeof(entry->crc32));
+        hash = hash64_update(hash, sizes, sizeof(sizes));
+    }
+    return hash;
+}
+
+/**
+ * @brief 逐级创建目录
+ */
+static bool make_directories(const char* dir) {
+    char path[1024];
+    size_t len = strlen(dir);
+    if (len == 0 || len >= sizeof(path)) {
+        return false;
+    }
+    memcpy(path, dir, len + 1);
+
+    for (size_t i = 1; i <= len; i++) {
+        if (path[i] == '/' || path[i] == '\0') {
+            char saved = path[i];
+            path[i] = '\0';
+            if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+            path[i] = saved;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 确定缓存目录
+ */
+static bool default_cache_dir(char* buffer, size_t size) {
+    const char* dir = getenv(J2ME_CLASS_CACHE_DIR_ENV);
+    if (dir && *dir) {
+        return snprintf(buffer, size, "%s", dir) < (int)size;
+    }
+    dir = getenv("XDG_CACHE_HOME");
+    if (dir && *dir) {
+        return snprintf(buffer, size, "%s/j2me-emulator", dir) < (int)size;
+    }
+    dir = getenv("HOME");
+    if (dir && *dir) {
+        return snprintf(buffer, size, "%s/.cache/j2me-emulator", dir) < (int)size;
+    }
+    return false;
+}
+
+/**
+ * @brief 检查记录内的区间是否越界
+ */
+static bool range_ok(uint64_t offset, uint64_t length, size_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+/**
+ * @brief 校验缓存映像（文件头、索引和类名）
+ */
+static bool validate_image(const uint8_t* image, size_t size, uint64_t jar_hash) {
+    if (size < sizeof(class_cache_header_t)) {
+        return false;
+    }
+
+    const class_cache_header_t* header = (const class_cache_header_t*)image;
+    if (header->magic != CLASS_CACHE_MAGIC || header->version != J2ME_CLASS_CACHE_VERSION ||
+        header->endian_tag != CLASS_CACHE_ENDIAN_TAG || header->jar_hash != jar_hash ||
+        header->file_size != size) {
+        return false;
+    }
+
+    uint32_t capacity = header->index_capacity;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || header->class_count > capacity ||
+        (header->index_offset & 3) != 0 ||
+        !range_ok(header->index_offset, (uint64_t)capacity * sizeof(class_cache_index_entry_t), size)) {
+        return false;
+    }
+
+    const class_cache_index_entry_t* index = (const class_cache_index_entry_t*)(image + header->index_offset);
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (index[i].record_offset == 0) {
+            continue;
+        }
+        used++;
+        if ((index[i].record_offset & 7) != 0 || index[i].record_size < sizeof(class_cache_record_t) ||
+            !range_ok(index[i].record_offset, index[i].record_size, size) ||
+            index[i].name_offset >= size ||
+            !memchr(image + index[i].name_offset, '\0', size - index[i].name_offset)) {
+            return false;
+        }
+    }
+    return used == header->class_count && used < capacity;
+}
+
+/**
+ * @brief 在映像索引中查找类
+ */
+static const class_cache_index_entry_t* find_index_entry(const uint8_t* image, const char* name, uint32_t hash) {
+    const class_cache_header_t* header = (const class_cache_header_t*)image;
+    const class_cache_index_entry_t* index = (const class_cache_index_entry_t*)(image + header->index_offset);
+    uint32_t mask = header->index_capacity - 1;
+
+    for (uint32_t slot = hash & mask; index[slot].record_offset != 0; slot = (slot + 1) & mask) {
+        if (index[slot].name_hash == hash && strcmp((const char*)image + index[slot].name_offset, name) == 0) {
+            return &index[slot];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 释放待写回的类记录
+ */
+static void free_pending(j2me_class_cache_t* cache) {
+    j2me_class_cache_pending_t* p = cache->pending;
+    while (p) {
+        j2me_class_cache_pending_t* next = p->next;
+        free(p->name);
+        free(p->record);
+        free(p);
+        p = next;
+    }
+    cache->pending = NULL;
+    cache->pending_count = 0;
+}
+
+j2me_class_cache_t* j2me_class_cache_open(const char* cache_dir, j2me_jar_file_t* jar_file) {
+    if (!jar_file || !jar_file->parsed) {
+        return NULL;
+    }
+
+    char dir[1024];
+    if (cache_dir) {
+        snprintf(dir, sizeof(dir), "%s", cache_dir);
+    } else if (!default_cache_dir(dir, sizeof(dir))) {
+        LOG_DEBUG("[类缓存] 无法确定缓存目录，不使用类缓存\n");
+        return NULL;
+    }
+
+    if (!make_directories(dir)) {
+        LOG_WARN("[类缓存] 无法创建缓存目录: %s", dir);
+        return NULL;
+    }
+
+    j2me_class_cache_t* cache = (j2me_class_cache_t*)calloc(1, sizeof(j2me_class_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+
+    cache->jar_hash = hash_jar(jar_file);
+    cache->ref_count = 1;
+
+    size_t path_size = strlen(dir) + 32;
+    cache->path = (char*)malloc(path_size);
+    if (!cache->path) {
+        free(cache);
+        return NULL;
+    }
+    snprintf(cache->path, path_size, "%s/%016llx.jcc", dir, (unsigned long long)cache->jar_hash);
+
+    // 映射已有的缓存文件（私有映射：字节码会被快速化原地改写）
+    int fd = open(cache->path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(class_cache_header_t)) {
+            void* image = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (image != MAP_FAILED) {
+                if (validate_image((const uint8_t*)image, (size_t)st.st_size, cache->jar_hash)) {
+                    cache->image = (uint8_t*)image;
+                    cache->image_size = (size_t)st.st_size;
+                } else {
+                    LOG_WARN("[类缓存] 缓存文件无效，将重新生成: %s", cache->path);
+                    munmap(image, (size_t)st.st_size);
+                }
+            }
+        }
+        close(fd);
+    }
+
+    LOG_DEBUG("[类缓存] 打开: %s (%u个类)\n", cache->path,
+              cache->image ? ((const class_cache_header_t*)cache->image)->class_count : 0);
+    return cache;
+}
+
+j2me_class_cache_t* j2me_class_cache_retain(j2me_class_cache_t* cache) {
+    if (cache) {
+        cache->ref_count++;
+    }
+    return cache;
+}
+
+void j2me_class_cache_release(j2me_class_cache_t* cache) {
+    if (!cache || --cache->ref_count > 0) {
+        return;
+    }
+
+    j2me_class_cache_flush(cache);
+    free_pending(cache);
+
+    LOG_DEBUG("[类缓存] 关闭: 命中%zu个类, 未命中%zu个类\n", cache->hit_count, cache->miss_count);
+
+    if (cache->image) {
+        munmap(cache->image, cache->image_size);
+    }
+    free(cache->path);
+    free(cache);
+}
+
+/**
+ * @brief 从类记录重建类
+ * @param record 记录起点（位于映射区，字符串和字节码直接引用）
+ * @param size 记录大小
+ * @return 类指针，记录损坏时返回NULL
+ */
+static j2me_class_t* materialize_class(uint8_t* record, size_t size) {
+    const class_cache_record_t* header = (const class_cache_record_t*)record;
+    uint16_t cp_slots = header->constant_pool_count > 0 ? header->constant_pool_count - 1 : 0;
+
+    if (!range_ok(header->interfaces_offset, (uint64_t)header->interfaces_count * sizeof(uint16_t), size) ||
+        (header->constant_pool_offset & 7) != 0 ||
+        !range_ok(header->constant_pool_offset, (uint64_t)cp_slots * sizeof(class_cache_constant_t), size) ||
+        (header->fields_offset & 1) != 0 ||
+        !range_ok(header->fields_offset, (uint64_t)header->fields_count * sizeof(class_cache_field_t), size) ||
+        (header->methods_offset & 3) != 0 ||
+        !range_ok(header->methods_offset, (uint64_t)header->methods_count * sizeof(class_cache_method_t), size)) {
+        return NULL;
+    }
+
+    j2me_class_t* class_ptr = (j2me_class_t*)calloc(1, sizeof(j2me_class_t));
+    if (!class_ptr) {
+        return NULL;
+    }
+
+    class_ptr->image_backed = true;
+    class_ptr->magic = 0xCAFEBABE;
+    class_ptr->minor_version = header->minor_version;
+    class_ptr->major_version = header->major_version;
+    class_ptr->access_flags = header->access_flags;
+    class_ptr->this_class = header->this_class;
+    class_ptr->super_class = header->super_class;
+
+    // 常量池：字符串直接引用映射区
+    j2me_constant_pool_t* pool = &class_ptr->constant_pool;
+    pool->count = header->constant_pool_count;
+    if (cp_slots > 0) {
+        pool->entries = (j2me_constant_pool_entry_t*)calloc(cp_slots, sizeof(j2me_constant_pool_entry_t));
+        if (!pool->entries) {
+            goto fail;
+        }
+    }
+
+    const class_cache_constant_t* constants = (const class_cache_constant_t*)(record + header->constant_pool_offset);
+    for (uint16_t i = 0; i < cp_slots; i++) {
+        const class_cache_constant_t* constant = &constants[i];
+        j2me_constant_pool_entry_t* entry = &pool->entries[i];
+        entry->tag = (j2me_constant_type_t)constant->tag;
+
+        switch (constant->tag) {
+            case J2ME_CONSTANT_UTF8:
+                if (!range_ok(constant->utf8_offset, (uint64_t)constant->utf8_length + 1, size) ||
+                    record[constant->utf8_offset + constant->utf8_length] != '\0') {
+                    goto fail;
+                }
+                entry->info.utf8.length = constant->utf8_length;
+                entry->info.utf8.bytes = (char*)(record + constant->utf8_offset);
+                break;
+
+            case J2ME_CONSTANT_INTEGER:
+            case J2ME_CONSTANT_FLOAT:
+            case J2ME_CONSTANT_LONG:
+            case J2ME_CONSTANT_DOUBLE:
+                memcpy(&entry->info, &constant->value, sizeof(constant->value));
+                break;
+
+            case J2ME_CONSTANT_CLASS:
+                entry->info.class_info.name_index = constant->index1;
+                break;
+
+            case J2ME_CONSTANT_STRING:
+                entry->info.string_info.string_index = constant->index1;
+                break;
+
+            case J2ME_CONSTANT_FIELDREF:
+            case J2ME_CONSTANT_METHODREF:
+            case J2ME_CONSTANT_INTERFACE_METHODREF:
+                entry->info.ref_info.class_index = constant->index1;
+                entry->info.ref_info.name_and_type_index = constant->index2;
+                break;
+
+            case J2ME_CONSTANT_NAME_AND_TYPE:
+                entry->info.name_and_type_info.name_index = constant->index1;
+                entry->info.name_and_type_info.descriptor_index = constant->index2;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    class_ptr->name = j2me_constant_pool_get_class_name(pool, class_ptr->this_class);
+    if (class_ptr->super_class != 0) {
+        class_ptr->super_name = j2me_constant_pool_get_class_name(pool, class_ptr->super_class);
+    }
+
+    // 接口
+    class_ptr->interfaces_count = header->interfaces_count;
+    if (class_ptr->interfaces_count > 0) {
+        class_ptr->interfaces = (uint16_t*)malloc(sizeof(uint16_t) * class_ptr->interfaces_count);
+        if (!class_ptr->interfaces) {
+            goto fail;
+        }
+        memcpy(class_ptr->interfaces, record + header->interfaces_offset,
+               sizeof(uint16_t) * class_ptr->interfaces_count);
+    }
+
+    // 字段
+    class_ptr->fields_count = header->fields_count;
+    if (class_ptr->fields_count > 0) {
+        class_ptr->fields = (j2me_field_t*)calloc(class_ptr->fields_count, sizeof(j2me_field_t));
+        if (!class_ptr->fields) {
+            goto fail;
+        }
+    }
+    const class_cache_field_t* fields = (const class_cache_field_t*)(record + header->fields_offset);
+    for (uint16_t i = 0; i < class_ptr->fields_count; i++) {
+        j2me_field_t* field = &class_ptr->fields[i];
+        field->access_flags = fields[i].access_flags;
+        field->name_index = fields[i].name_index;
+        field->descriptor_index = fields[i].descriptor_index;
+        field->attributes_count = fields[i].attributes_count;
+        field->name = j2me_constant_pool_get_utf8(pool, field->name_index);
+        field->descriptor = j2me_constant_pool_get_utf8(pool, field->descriptor_index);
+        field->owner_class = class_ptr;
+    }
+
+    // 方法：字节码直接引用映射区（私有映射，快速化改写只影响本进程）
+    class_ptr->methods_count = header->methods_count;
+    if (class_ptr->methods_count > 0) {
+        class_ptr->methods = (j2me_method_t*)calloc(class_ptr->methods_count, sizeof(j2me_method_t));
+        if (!class_ptr->methods) {
+            goto fail;
+        }
+    }
+    const class_cache_method_t* methods = (const class_cache_method_t*)(record + header->methods_offset);
+    for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
+        j2me_method_t* method = &class_ptr->methods[i];
+        method->access_flags = methods[i].access_flags;
+        method->name_index = methods[i].name_index;
+        method->descriptor_index = methods[i].descriptor_index;
+        method->attributes_count = methods[i].attributes_count;
+        method->max_stack = methods[i].max_stack;
+        method->max_locals = methods[i].max_locals;
+        method->name = j2me_constant_pool_get_utf8(pool, method->name_index);
+        method->descriptor = j2me_constant_pool_get_utf8(pool, method->descriptor_index);
+        method->owner_class = class_ptr;
+        method->is_native = (method->access_flags & ACC_NATIVE) != 0;
+
+        if (methods[i].bytecode_length > 0) {
+            if (!range_ok(methods[i].bytecode_offset, methods[i].bytecode_length, size)) {
+                goto fail;
+            }
+            method->bytecode = record + methods[i].bytecode_offset;
+            method->bytecode_length = methods[i].bytecode_length;
+        }
+
+        if (method->name && strcmp(method->name, "<clinit>") == 0) {
+            class_ptr->clinit = method;
+        }
+    }
+
+    return class_ptr;
+
+fail:
+    j2me_class_destroy(class_ptr);
+    return NULL;
+}
+
+j2me_class_t* j2me_class_cache_load(j2me_class_cache_t* cache, const char* class_name) {
+    if (!cache || !class_name) {
+        return NULL;
+    }
+
+    const class_cache_index_entry_t* entry = NULL;
+    if (cache->image) {
+        entry = find_index_entry(cache->image, class_name, hash_name(class_name));
+    }
+    if (!entry) {
+        cache->miss_count++;
+        return NULL;
+    }
+
+    j2me_class_t* class_ptr = materialize_class(cache->image + entry->record_offset, entry->record_size);
+    if (!class_ptr) {
+        LOG_WARN("[类缓存] 类记录损坏: %s", class_name);
+        cache->miss_count++;
+        return NULL;
+    }
+
+    cache->hit_count++;
+    LOG_DEBUG("[类缓存] 命中: %s\n", class_name);
+    return class_ptr;
+}
+
+/**
+ * @brief 序列化类记录
+ * @param class_ptr 刚解析的类
+ * @param out_size 输出记录大小（8字节对齐）
+ * @return 记录，失败返回NULL
+ */
+static uint8_t* serialize_class(const j2me_class_t* class_ptr, size_t* out_size) {
+    const j2me_constant_pool_t* pool = &class_ptr->constant_pool;
+    uint16_t cp_slots = pool->count > 0 ? pool->count - 1 : 0;
+
+    // 计算布局
+    size_t size = sizeof(class_cache_record_t);
+    size_t interfaces_offset = size;
+    size += sizeof(uint16_t) * class_ptr->interfaces_count;
+    size = CLASS_CACHE_ALIGN8(size);
+    size_t constant_pool_offset = size;
+    size += sizeof(class_cache_constant_t) * cp_slots;
+    size_t fields_offset = size;
+    size += sizeof(class_cache_field_t) * class_ptr->fields_count;
+    size_t methods_offset = size;
+    size += sizeof(class_cache_method_t) * class_ptr->methods_count;
+
+    for (uint16_t i = 0; i < cp_slots; i++) {
+        if (pool->entries[i].tag == J2ME_CONSTANT_UTF8) {
+            size += pool->entries[i].info.utf8.length + 1;
+        }
+    }
+    for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
+        if (class_ptr->methods[i].bytecode) {
+            size += class_ptr->methods[i].bytecode_length;
+        }
+    }
+    size = CLASS_CACHE_ALIGN8(size);
+    if (size > UINT32_MAX) {
+        return NULL;
+    }
+
+    uint8_t* record = (uint8_t*)calloc(1, size);
+    if (!record) {
+        return NULL;
+    }
+
+    class_cache_record_t* header = (class_cache_record_t*)record;
+    header->minor_version = class_ptr->minor_version;
+    header->major_version = class_ptr->major_version;
+    header->access_flags = class_ptr->access_flags;
+    header->this_class = class_ptr->this_class;
+    header->super_class = class_ptr->super_class;
+    header->interfaces_count = class_ptr->interfaces_count;
+    header->constant_pool_count = pool->count;
+    header->fields_count = class_ptr->fields_count;
+    header->methods_count = class_ptr->methods_count;
+    header->interfaces_offset = (uint32_t)interfaces_offset;
+    header->constant_pool_offset = (uint32_t)constant_pool_offset;
+    header->fields_offset = (uint32_t)fields_offset;
+    header->methods_offset = (uint32_t)methods_offset;
+
+    if (class_ptr->interfaces_count > 0) {
+        memcpy(record + interfaces_offset, class_ptr->interfaces, sizeof(uint16_t) * class_ptr->interfaces_count);
+    }
+
+    size_t data_offset = methods_offset + sizeof(class_cache_method_t) * class_ptr->methods_count;
+
+    class_cache_constant_t* constants = (class_cache_constant_t*)(record + constant_pool_offset);
+    for (uint16_t i = 0; i < cp_slots; i++) {
+        const j2me_constant_pool_entry_t* entry = &pool->entries[i];
+        class_cache_constant_t* constant = &constants[i];
+        constant->tag = (uint8_t)entry->tag;
+
+        switch (entry->tag) {
+            case J2ME_CONSTANT_UTF8:
+                constant->utf8_length = entry->info.utf8.length;
+                constant->utf8_offset = (uint32_t)data_offset;
+                if (entry->info.utf8.bytes) {
+                    memcpy(record + data_offset, entry->info.utf8.bytes, entry->info.utf8.length);
+                }
+                data_offset += entry->info.utf8.length + 1;
+                break;
+
+            case J2ME_CONSTANT_INTEGER:
+            case J2ME_CONSTANT_FLOAT:
+            case J2ME_CONSTANT_LONG:
+            case J2ME_CONSTANT_DOUBLE:
+                memcpy(&constant->value, &entry->info, sizeof(constant->value));
+                break;
+
+            case J2ME_CONSTANT_CLASS:
+                constant->index1 = entry->info.class_info.name_index;
+                break;
+
+            case J2ME_CONSTANT_STRING:
+                constant->index1 = entry->info.string_info.string_index;
+                break;
+
+            case J2ME_CONSTANT_FIELDREF:
+            case J2ME_CONSTANT_METHODREF:
+            case J2ME_CONSTANT_INTERFACE_METHODREF:
+                constant->index1 = entry->info.ref_info.class_index;
+                constant->index2 = entry->info.ref_info.name_and_type_index;
+                break;
+
+            case J2ME_CONSTANT_NAME_AND_TYPE:
+                constant->index1 = entry->info.name_and_type_info.name_index;
+                constant->index2 = entry->info.name_and_type_info.descriptor_index;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    class_cache_field_t* fields = (class_cache_field_t*)(record + fields_offset);
+    for (uint16_t i = 0; i < class_ptr->fields_count; i++) {
+        fields[i].access_flags = class_ptr->fields[i].access_flags;
+        fields[i].name_index = class_ptr->fields[i].name_index;
+        fields[i].descriptor_index = class_ptr->fields[i].descriptor_index;
+        fields[i].attributes_count = class_ptr->fields[i].attributes_count;
+    }
+
+    class_cache_method_t* methods = (class_cache_method_t*)(record + methods_offset);
+    for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
+        const j2me_method_t* method = &class_ptr->methods[i];
+        methods[i].access_flags = method->access_flags;
+        methods[i].name_index = method->name_index;
+        methods[i].descriptor_index = method->descriptor_index;
+        methods[i].attributes_count = method->attributes_count;
+        methods[i].max_stack = method->max_stack;
+        methods[i].max_locals = method->max_locals;
+        if (method->bytecode && method->bytecode_length > 0) {
+            methods[i].bytecode_length = method->bytecode_length;
+            methods[i].bytecode_offset = (uint32_t)data_offset;
+            memcpy(record + data_offset, method->bytecode, method->bytecode_length);
+            data_offset += method->bytecode_length;
+        }
+    }
+
+    *out_size = size;
+    return record;
+}
+
+j2me_error_t j2me_class_cache_store(j2me_class_cache_t* cache, const char* class_name,
+                                    const j2me_class_t* class_ptr) {
+    if (!cache || !class_name || !class_ptr) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    j2me_class_cache_pending_t* pending = (j2me_class_cache_pending_t*)calloc(1, sizeof(j2me_class_cache_pending_t));
+    if (!pending) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+
+    pending->name = strdup(class_name);
+    pending->record = serialize_class(class_ptr, &pending->record_size);
+    if (!pending->name || !pending->record) {
+        free(pending->name);
+        free(pending->record);
+        free(pending);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    pending->name_hash = hash_name(class_name);
+
+    pending->next = cache->pending;
+    cache->pending = pending;
+    cache->pending_count++;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 读取磁盘上缓存文件的原始内容
+ *
+ * 映射区中的字节码可能已经被快速化改写，写回时必须使用文件中的原始记录
+ */
+static uint8_t* read_original_image(j2me_class_cache_t* cache) {
+    int fd = open(cache->path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(class_cache_header_t)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    uint8_t* data = (uint8_t*)malloc(size);
+    size_t total = 0;
+    while (data && total < size) {
+        ssize_t n = read(fd, data + total, size - total);
+        if (n <= 0) {
+            break;
+        }
+        total += (size_t)n;
+    }
+    close(fd);
+
+    // 文件可能已被其他进程替换或已经写回过，只要仍然有效就合并其中的记录
+    if (data && (total != size || !validate_image(data, total, cache->jar_hash))) {
+        free(data);
+        data = NULL;
+    }
+    return data;
+}
+
+j2me_error_t j2me_class_cache_flush(j2me_class_cache_t* cache) {
+    if (!cache) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    if (cache->pending_count == 0) {
+        return J2ME_SUCCESS;
+    }
+
+    // 已有记录
+    uint8_t* original = read_original_image(cache);
+    const class_cache_header_t* old_header = (const class_cache_header_t*)original;
+    const class_cache_index_entry_t* old_index = original ?
+        (const class_cache_index_entry_t*)(original + old_header->index_offset) : NULL;
+    uint32_t old_capacity = original ? old_header->index_capacity : 0;
+    size_t class_count = original ? old_header->class_count : 0;
+
+    // 其他进程可能已经写回了同一个类，以文件中的记录为准
+    for (j2me_class_cache_pending_t* p = cache->pending; p; p = p->next) {
+        p->duplicate = original && find_index_entry(original, p->name, p->name_hash);
+        if (!p->duplicate) {
+            class_count++;
+        }
+    }
+
+    uint32_t capacity = CLASS_CACHE_MIN_INDEX;
+    while (capacity < class_count * 2) {
+        capacity <<= 1;
+    }
+
+    // 计算布局：文件头、索引、类名、记录
+    size_t index_offset = sizeof(class_cache_header_t);
+    size_t names_size = 0;
+    size_t records_size = 0;
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old_index[i].record_offset != 0) {
+            names_size += strlen((const char*)original + old_index[i].name_offset) + 1;
+            records_size += CLASS_CACHE_ALIGN8(old_index[i].record_size);
+        }
+    }
+    for (j2me_class_cache_pending_t* p = cache->pending; p; p = p->next) {
+        if (p->duplicate) {
+            continue;
+        }
+        names_size += strlen(p->name) + 1;
+        records_size += p->record_size;
+    }
+    size_t names_offset = index_offset + sizeof(class_cache_index_entry_t) * capacity;
+    size_t records_offset = CLASS_CACHE_ALIGN8(names_offset + names_size);
+    size_t file_size = records_offset + records_size;
+
+    if (file_size > UINT32_MAX) {
+        free(original);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint8_t* buffer = (uint8_t*)calloc(1, file_size);
+    if (!buffer) {
+        free(original);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+
+    class_cache_header_t* header = (class_cache_header_t*)buffer;
+    header->magic = CLASS_CACHE_MAGIC;
+    header->version = J2ME_CLASS_CACHE_VERSION;
+    header->endian_tag = CLASS_CACHE_ENDIAN_TAG;
+    header->jar_hash = cache->jar_hash;
+    header->file_size = file_size;
+    header->class_count = (uint32_t)class_count;
+    header->index_capacity = capacity;
+    header->index_offset = (uint32_t)index_offset;
+
+    class_cache_index_entry_t* index = (class_cache_index_entry_t*)(buffer + index_offset);
+    size_t name_pos = names_offset;
+    size_t record_pos = records_offset;
+
+    // 写入一个类（索引槽位、类名和记录）
+    #define CLASS_CACHE_EMIT(NAME, HASH, RECORD, RECORD_SIZE) do { \
+        uint32_t slot = (HASH) & (capacity - 1); \
+        while (index[slot].record_offset != 0) { \
+            slot = (slot + 1) & (capacity - 1); \
+        } \
+        size_t name_length = strlen(NAME) + 1; \
+        memcpy(buffer + name_pos, (NAME), name_length); \
+        memcpy(buffer + record_pos, (RECORD), (RECORD_SIZE)); \
+        index[slot].name_hash = (HASH); \
+        index[slot].name_offset = (uint32_t)name_pos; \
+        index[slot].record_offset = (uint32_t)record_pos; \
+        index[slot].record_size = (uint32_t)(RECORD_SIZE); \
+        name_pos += name_length; \
+        record_pos += CLASS_CACHE_ALIGN8(RECORD_SIZE); \
+    } while (0)
+
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old_index[i].record_offset != 0) {
+            CLASS_CACHE_EMIT((const char*)original + old_index[i].name_offset, old_index[i].name_hash,
+                             original + old_index[i].record_offset, old_index[i].record_size);
+        }
+    }
+    for (j2me_class_cache_pending_t* p = cache->pending; p; p = p->next) {
+        if (!p->duplicate) {
+            CLASS_CACHE_EMIT(p->name, p->name_hash, p->record, p->record_size);
+        }
+    }
+
+    #undef CLASS_CACHE_EMIT
+
+    free(original);
+
+    // 写临时文件后重命名，其他进程不会读到写了一半的文件
+    size_t tmp_size = strlen(cache->path) + 32;
+    char* tmp_path = (char*)malloc(tmp_size);
+    if (!tmp_path) {
+        free(buffer);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    snprintf(tmp_path, tmp_size, "%s.tmp.%ld", cache->path, (long)getpid());
+
+    j2me_error_t result = J2ME_SUCCESS;
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        result = J2ME_ERROR_IO_EXCEPTION;
+    } else {
+        size_t written = 0;
+        while (written < file_size) {
+            ssize_t n = write(fd, buffer + written, file_size - written);
+            if (n <= 0) {
+                break;
+            }
+            written += (size_t)n;
+        }
+        if (close(fd) != 0 || written != file_size || rename(tmp_path, cache->path) != 0) {
+            result = J2ME_ERROR_IO_EXCEPTION;
+            unlink(tmp_path);
+        }
+    }
+
+    if (result == J2ME_SUCCESS) {
+        LOG_DEBUG("[类缓存] 写回: %s (%zu个类, 新增%zu个, %zu bytes)\n",
+                  cache->path, class_count, cache->pending_count, file_size);
+
+        free_pending(cache);
+    } else {
+        LOG_WARN("[类缓存] 写回失败: %s", cache->path);
+    }
+
+    free(tmp_path);
+    free(buffer);
+    return result;
+}
@@ -2,6 +2,8 @@
 #include "j2me_log.h"
 #include "j2me_vm.h"
 #include "j2me_jar.h"
+#include "j2me_class_cache.h"
+#include "j2me_field_access.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -13,6 +15,54 @@
  * 实现Java类的加载、链接和初始化功能
  */
 
+// 类名哈希表初始槽位数（负载超过一半时加倍）
+#define CLASS_TABLE_INITIAL_CAPACITY 64
+
+/**
+ * @brief 计算类名哈希 (FNV-1a)
+ */
+static uint32_t hash_class_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 把类放入哈希表的空槽（调用者保证有空槽且类名不重复）
+ */
+static void class_table_insert(j2me_class_t** table, size_t capacity, j2me_class_t* class_ptr) {
+    size_t mask = capacity - 1;
+    size_t slot = class_ptr->name_hash & mask;
+    while (table[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = class_ptr;
+}
+
+/**
+ * @brief 哈希表扩容到new_capacity个槽位
+ */
+static j2me_error_t class_table_grow(j2me_class_loader_t* loader, size_t new_capacity) {
+    j2me_class_t** table = (j2me_class_t**)calloc(new_capacity, sizeof(j2me_class_t*));
+    if (!table) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    for (size_t i = 0; i < loader->class_table_capacity; i++) {
+        if (loader->class_table[i]) {
+            class_table_insert(table, new_capacity, loader->class_table[i]);
+        }
+    }
+    
+    free(loader->class_table);
+    loader->class_table = table;
+    loader->class_table_capacity = new_capacity;
+    return J2ME_SUCCESS;
+}
+
 j2me_class_loader_t* j2me_class_loader_create(j2me_vm_t* vm, const char* classpath) {
     if (!vm) {
         return NULL;
@@ -26,6 +76,11 @@ j2me_class_loader_t* j2me_class_loader_create(j2me_vm_t* vm, const char* classpa
     memset(loader, 0, sizeof(j2me_class_loader_t));
     loader->vm = vm;
     
+    if (class_table_grow(loader, CLASS_TABLE_INITIAL_CAPACITY) != J2ME_SUCCESS) {
+        free(loader);
+        return NULL;
+    }
+    
     if (classpath) {
         loader->classpath = (char*)malloc(strlen(classpath) + 1);
         if (loader->classpath) {
@@ -43,6 +98,12 @@ j2me_error_t j2me_class_loader_set_jar_file(j2me_class_loader_t* loader, void* j
     }
     
     loader->jar_file = jar_file;
+    
+    // 使用JAR的解析后类缓存
+    j2me_class_cache_release((j2me_class_cache_t*)loader->class_cache);
+    loader->class_cache = jar_file ?
+        j2me_class_cache_retain((j2me_class_cache_t*)((j2me_jar_file_t*)jar_file)->class_cache) : NULL;
+    
     LOG_DEBUG("[类加载器] 设置JAR文件: %p\n", jar_file);
     return J2ME_SUCCESS;
 }
@@ -60,10 +121,14 @@ void j2me_class_loader_destroy(j2me_class_loader_t* loader) {
         current = next;
     }
     
+    // 类缓存映像被上面的类引用，类销毁之后才能释放
+    j2me_class_cache_release((j2me_class_cache_t*)loader->class_cache);
+    
     if (loader->classpath) {
         free(loader->classpath);
     }
     
+    free(loader->class_table);
     free(loader);
     LOG_DEBUG("[类加载器] 已销毁\n");
 }
@@ -73,25 +138,79 @@ j2me_class_t* j2me_class_loader_find_class(j2me_class_loader_t* loader, const ch
         return NULL;
     }
     
-    j2me_class_t* current = loader->loaded_classes;
-    while (current) {
-        if (current->name && strcmp(current->name, class_name) == 0) {
+    uint32_t hash = hash_class_name(class_name);
+    size_t mask = loader->class_table_capacity - 1;
+    size_t slot = hash & mask;
+    
+    loader->lookup_count++;
+    j2me_class_t* current;
+    while ((current = loader->class_table[slot]) != NULL) {
+        loader->lookup_probes++;
+        if (current->name_hash == hash && strcmp(current->name, class_name) == 0) {
+            loader->lookup_hits++;
             return current;
         }
-        current = current->next;
+        slot = (slot + 1) & mask;
     }
     
     return NULL;
 }
 
+j2me_class_t* j2me_class_loader_find_class_by_id(j2me_class_loader_t* loader, uint32_t class_id) {
+    if (!loader || !loader->class_table) {
+        return NULL;
+    }
+    
+    // 只在写报告、堆快照等离线场景使用，直接扫描整个哈希表
+    for (size_t i = 0; i < loader->class_table_capacity; i++) {
+        j2me_class_t* cls = loader->class_table[i];
+        if (cls && (uint32_t)(uintptr_t)cls == class_id) {
+            return cls;
+        }
+    }
+    return NULL;
+}
+
+j2me_error_t j2me_class_loader_add_class(j2me_class_loader_t* loader, j2me_class_t* class_ptr) {
+    if (!loader || !class_ptr || !class_ptr->name) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    // 负载因子保持在1/2以下
+    if ((loader->class_count + 1) * 2 > loader->class_table_capacity) {
+        j2me_error_t result = class_table_grow(loader, loader->class_table_capacity * 2);
+        if (result != J2ME_SUCCESS) {
+            return result;
+        }
+    }
+    
+    class_ptr->name_hash = hash_class_name(class_ptr->name);
+    class_table_insert(loader->class_table, loader->class_table_capacity, class_ptr);
+    loader->class_count++;
+    
+    class_ptr->next = loader->loaded_classes;
+    loader->loaded_classes = class_ptr;
+    return J2ME_SUCCESS;
+}
+
+void j2me_class_loader_get_lookup_stats(j2me_class_loader_t* loader, uint64_t* lookups,
+                                        uint64_t* hits, uint64_t* probes) {
+    if (!loader) {
+        return;
+    }
+    if (lookups) *lookups = loader->lookup_count;
+    if (hits) *hits = loader->lookup_hits;
+    if (probes) *probes = loader->lookup_probes;
+}
+
 /**
  * @brief 从JAR文件加载Class数据
  * @param jar_file JAR文件对象
  * @param class_name 类名
  * @param size 输出数据大小
- * @return Class文件数据，失败返回NULL
+ * @return Class文件数据（属于JAR条目，调用者不释放），失败返回NULL
  */
-static uint8_t* load_class_from_jar(j2me_jar_file_t* jar_file, const char* class_name, size_t* size) {
+static const uint8_t* load_class_from_jar(j2me_jar_file_t* jar_file, const char* class_name, size_t* size) {
     if (!jar_file || !class_name || !size) {
         return NULL;
     }
@@ -127,15 +246,13 @@ static uint8_t* load_class_from_jar(j2me_jar_file_t* jar_file, const char* class
         return NULL;
     }
     
-    // 复制数据
+    // 直接使用条目数据（STORED条目指向JAR映射区），解析器会复制需要保留的内容
     *size = entry->uncompressed_size;
-    uint8_t* data = (uint8_t*)malloc(*size);
-    if (data && entry->data) {
-        memcpy(data, entry->data, *size);
+    if (entry->data) {
         LOG_DEBUG("[类加载器] 从JAR加载类文件成功: %s (%zu bytes)\n", class_path, *size);
     }
     
-    return data;
+    return entry->data;
 }
 
 /**
@@ -210,32 +327,46 @@ j2me_class_t* j2me_class_loader_load_class(j2me_class_loader_t* loader, const ch
     
     // printf("[类加载器] 加载类: %s\n", class_name);
     
-    // 加载Class文件数据
-    size_t data_size;
-    uint8_t* class_data = NULL;
-    
-    // 首先尝试从JAR文件加载 (如果有的话)
-    if (loader->jar_file) {
-        class_data = load_class_from_jar(loader->jar_file, class_name, &data_size);
-    }
-    
-    // 如果JAR文件中没有找到，尝试从文件系统加载
-    if (!class_data) {
-        class_data = load_class_file(class_name, &data_size);
-    }
-    
-    if (!class_data) {
-        LOG_ERROR("[类加载器] 错误: 无法找到类文件 %s", class_name);
-        return NULL;
-    }
-    
-    // 解析Class文件
-    j2me_class_t* class_ptr = j2me_class_parse(class_data, data_size);
-    free(class_data);
+    // 首先查找解析后类缓存
+    j2me_class_cache_t* class_cache = (j2me_class_cache_t*)loader->class_cache;
+    j2me_class_t* class_ptr = j2me_class_cache_load(class_cache, class_name);
     
     if (!class_ptr) {
-        LOG_ERROR("[类加载器] 错误: 解析类文件失败 %s", class_name);
-        return NULL;
+        // 加载Class文件数据
+        size_t data_size;
+        const uint8_t* class_data = NULL;
+        uint8_t* file_data = NULL;
+        
+        // 首先尝试从JAR文件加载 (如果有的话)
+        if (loader->jar_file) {
+            class_data = load_class_from_jar(loader->jar_file, class_name, &data_size);
+        }
+        
+        // 如果JAR文件中没有找到，尝试从文件系统加载
+        if (!class_data) {
+            file_data = load_class_file(class_name, &data_size);
+            class_data = file_data;
+        }
+        
+        if (!class_data) {
+            LOG_ERROR("[类加载器] 错误: 无法找到类文件 %s", class_name);
+            return NULL;
+        }
+        
+        // 解析Class文件
+        class_ptr = j2me_class_parse(class_data, data_size);
+        
+        if (!class_ptr) {
+            free(file_data);
+            LOG_ERROR("[类加载器] 错误: 解析类文件失败 %s", class_name);
+            return NULL;
+        }
+        
+        // JAR中的类在执行前写入缓存（之后字节码会被快速化改写）
+        if (class_cache && !file_data) {
+            j2me_class_cache_store(class_cache, class_name, class_ptr);
+        }
+        free(file_data);
     }
     
     // 设置类加载器
@@ -243,8 +374,11 @@ j2me_class_t* j2me_class_loader_load_class(j2me_class_loader_t* loader, const ch
     class_ptr->state = CLASS_LOADED;
     
     // 添加到已加载类列表
-    class_ptr->next = loader->loaded_classes;
-    loader->loaded_classes = class_ptr;
+    if (j2me_class_loader_add_class(loader, class_ptr) != J2ME_SUCCESS) {
+        LOG_ERROR("[类加载器] 错误: 无法登记类 %s", class_name);
+        j2me_class_destroy(class_ptr);
+        return NULL;
+    }
     
     LOG_DEBUG("[类加载器] 类加载成功: %s (方法数: %d, 字段数: %d)\n", class_name, class_ptr->methods_count, class_ptr->fields_count);
     
@@ -286,6 +420,239 @@ j2me_class_t* j2me_class_loader_load_class(j2me_class_loader_t* loader, const ch
     return class_ptr;
 }
 
+/**
+ * @brief 判断方法是否参与虚分派（非静态、非私有、非构造/类初始化方法）
+ */
+static bool is_virtual_method(const j2me_method_t* method) {
+    if (!method->name || !method->descriptor || method->name[0] == '<') {
+        return false;
+    }
+    return (method->access_flags & (ACC_STATIC | ACC_PRIVATE)) == 0;
+}
+
+/**
+ * @brief 在虚方法表中查找同名同描述符的槽位
+ * @return 槽位下标，未找到返回J2ME_VTABLE_INDEX_NONE
+ */
+static uint16_t find_vtable_slot(j2me_method_t** vtable, uint16_t size, const j2me_method_t* method) {
+    for (uint16_t i = 0; i < size; i++) {
+        if (strcmp(vtable[i]->name, method->name) == 0 &&
+            strcmp(vtable[i]->descriptor, method->descriptor) == 0) {
+            return i;
+        }
+    }
+    return J2ME_VTABLE_INDEX_NONE;
+}
+
+/**
+ * @brief 构建虚方法表
+ *
+ * 先复制父类的虚方法表，再用本类方法覆盖同签名槽位，新方法追加到表尾
+ */
+static j2me_error_t build_vtable(j2me_class_t* class_ptr) {
+    for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
+        class_ptr->methods[i].vtable_index = J2ME_VTABLE_INDEX_NONE;
+    }
+
+    // 接口方法通过接口方法表分派
+    if (class_ptr->access_flags & ACC_INTERFACE) {
+        return J2ME_SUCCESS;
+    }
+
+    j2me_class_t* super_class = class_ptr->super_class_ptr;
+    uint16_t super_size = super_class ? super_class->vtable_size : 0;
+    size_t capacity = (size_t)super_size + class_ptr->methods_count;
+    if (capacity == 0) {
+        return J2ME_SUCCESS;
+    }
+    if (capacity >= J2ME_VTABLE_INDEX_NONE) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    j2me_method_t** vtable = (j2me_method_t**)malloc(sizeof(j2me_method_t*) * capacity);
+    if (!vtable) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    if (super_size > 0) {
+        memcpy(vtable, super_class->vtable, sizeof(j2me_method_t*) * super_size);
+    }
+
+    uint16_t size = super_size;
+    for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
+        j2me_method_t* method = &class_ptr->methods[i];
+        if (!is_virtual_method(method)) {
+            continue;
+        }
+
+        uint16_t slot = find_vtable_slot(vtable, super_size, method);
+        if (slot == J2ME_VTABLE_INDEX_NONE) {
+            slot = size++;
+        }
+        vtable[slot] = method;
+        method->vtable_index = slot;
+    }
+
+    class_ptr->vtable = vtable;
+    class_ptr->vtable_size = size;
+    LOG_DEBUG("[类加载器] 虚方法表: %s, %d个槽位 (继承%d个)\n", class_ptr->name, size, super_size);
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 查找接口方法表条目
+ */
+static j2me_itable_entry_t* find_itable_entry(j2me_class_t* class_ptr, j2me_class_t* interface_class) {
+    for (uint16_t i = 0; i < class_ptr->itable_size; i++) {
+        if (class_ptr->itable[i].interface_class == interface_class) {
+            return &class_ptr->itable[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 解析类直接声明的第index个接口
+ *
+ * 系统接口（java/、javax/）由本地实现提供，不加载
+ */
+static j2me_class_t* resolve_declared_interface(j2me_class_t* class_ptr, uint16_t index) {
+    const char* interface_name = j2me_constant_pool_get_class_name(&class_ptr->constant_pool,
+                                                                   class_ptr->interfaces[index]);
+    if (!interface_name || !class_ptr->loader) {
+        return NULL;
+    }
+    if (strncmp(interface_name, "java/", 5) == 0 || strncmp(interface_name, "javax/", 6) == 0) {
+        return NULL;
+    }
+
+    j2me_class_t* interface_class = j2me_class_loader_find_class(class_ptr->loader, interface_name);
+    if (!interface_class) {
+        interface_class = j2me_class_loader_load_class(class_ptr->loader, interface_name);
+    }
+    if (!interface_class) {
+        LOG_DEBUG("[类加载器] 警告: 无法加载接口 %s (当前类: %s)\n", interface_name, class_ptr->name);
+    }
+    return interface_class;
+}
+
+/**
+ * @brief 向接口方法表添加接口及其父接口，实现方法从虚方法表中按签名选取
+ */
+static j2me_error_t add_itable_interface(j2me_class_t* class_ptr, j2me_class_t* interface_class) {
+    if (find_itable_entry(class_ptr, interface_class)) {
+        return J2ME_SUCCESS;
+    }
+
+    j2me_itable_entry_t* itable = (j2me_itable_entry_t*)realloc(
+        class_ptr->itable, sizeof(j2me_itable_entry_t) * (class_ptr->itable_size + 1));
+    if (!itable) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    class_ptr->itable = itable;
+
+    j2me_method_t** methods = NULL;
+    if (interface_class->methods_count > 0) {
+        methods = (j2me_method_t**)calloc(interface_class->methods_count, sizeof(j2me_method_t*));
+        if (!methods) {
+            return J2ME_ERROR_OUT_OF_MEMORY;
+        }
+        for (uint16_t i = 0; i < interface_class->methods_count; i++) {
+            j2me_method_t* interface_method = &interface_class->methods[i];
+            if (!is_virtual_method(interface_method)) {
+                continue;
+            }
+            uint16_t slot = find_vtable_slot(class_ptr->vtable, class_ptr->vtable_size, interface_method);
+            if (slot != J2ME_VTABLE_INDEX_NONE) {
+                methods[i] = class_ptr->vtable[slot];
+            }
+        }
+    }
+
+    itable[class_ptr->itable_size].interface_class = interface_class;
+    itable[class_ptr->itable_size].methods = methods;
+    class_ptr->itable_size++;
+
+    // 父接口
+    for (uint16_t i = 0; i < interface_class->interfaces_count; i++) {
+        j2me_class_t* super_interface = resolve_declared_interface(interface_class, i);
+        if (super_interface) {
+            j2me_error_t result = add_itable_interface(class_ptr, super_interface);
+            if (result != J2ME_SUCCESS) {
+                return result;
+            }
+        }
+    }
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 构建接口方法表（本类和父类实现的全部接口）
+ */
+static j2me_error_t build_itable(j2me_class_t* class_ptr) {
+    // 接口本身不需要接口方法表
+    if (class_ptr->access_flags & ACC_INTERFACE) {
+        return J2ME_SUCCESS;
+    }
+
+    for (uint16_t i = 0; i < class_ptr->interfaces_count; i++) {
+        j2me_class_t* interface_class = resolve_declared_interface(class_ptr, i);
+        if (interface_class) {
+            j2me_error_t result = add_itable_interface(class_ptr, interface_class);
+            if (result != J2ME_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    // 父类实现的接口，实现方法可能被本类覆盖，需要按本类虚方法表重新选取
+    j2me_class_t* super_class = class_ptr->super_class_ptr;
+    if (super_class) {
+        for (uint16_t i = 0; i < super_class->itable_size; i++) {
+            j2me_error_t result = add_itable_interface(class_ptr, super_class->itable[i].interface_class);
+            if (result != J2ME_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    if (class_ptr->itable_size > 0) {
+        LOG_DEBUG("[类加载器] 接口方法表: %s, %d个接口\n", class_ptr->name, class_ptr->itable_size);
+    }
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 计算实例字段布局
+ *
+ * 父类字段在前（从父类的instance_size开始），本类字段按8、4、2、1字节分组排列，
+ * 每组按自身大小对齐，byte/short/char紧凑存放，除第一组前的对齐外没有空隙。
+ */
+static void layout_instance_fields(j2me_class_t* class_ptr) {
+    static const size_t group_sizes[] = { 8, 4, 2, 1 };
+    
+    j2me_class_t* super_class = class_ptr->super_class_ptr;
+    size_t offset = super_class && super_class->instance_size >= J2ME_INSTANCE_HEADER_SIZE ?
+                    super_class->instance_size : J2ME_INSTANCE_HEADER_SIZE;
+    uint16_t instance_fields = 0;
+    
+    for (size_t group = 0; group < sizeof(group_sizes) / sizeof(group_sizes[0]); group++) {
+        size_t size = group_sizes[group];
+        for (uint16_t i = 0; i < class_ptr->fields_count; i++) {
+            j2me_field_t* field = &class_ptr->fields[i];
+            if ((field->access_flags & ACC_STATIC) || j2me_field_storage_size(field->descriptor) != size) {
+                continue;
+            }
+            offset = (offset + size - 1) & ~(size - 1);
+            field->offset = offset;
+            offset += size;
+            instance_fields++;
+        }
+    }
+    
+    class_ptr->instance_size = offset;
+    LOG_DEBUG("[类加载器] 实例布局: %s, %d个字段, 实例大小%zu字节\n", class_ptr->name, instance_fields, offset);
+}
+
 j2me_error_t j2me_class_link(j2me_class_t* class_ptr) {
     if (!class_ptr) {
         return J2ME_ERROR_INVALID_PARAMETER;
@@ -306,14 +673,32 @@ j2me_error_t j2me_class_link(j2me_class_t* class_ptr) {
     // 实际实现应该进行字节码验证
     
     // 准备阶段：为静态字段分配内存并设置默认值
-    for (uint16_t i = 0; i < class_ptr->fields_count; i++) {
-        j2me_field_t* field = &class_ptr->fields[i];
-        if (field->access_flags & ACC_STATIC) {
-            // 为静态字段分配内存 (简化实现)
-            LOG_DEBUG("[类加载器] 准备静态字段: %s\n", field->name ? field->name : "unknown");
+    j2me_error_t result = j2me_field_access_prepare_statics(class_ptr);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    
+    // 父类必须先链接，虚方法表从父类继承
+    if (class_ptr->super_class_ptr && class_ptr->super_class_ptr->state == CLASS_LOADED) {
+        j2me_error_t super_result = j2me_class_link(class_ptr->super_class_ptr);
+        if (super_result != J2ME_SUCCESS) {
+            return super_result;
         }
     }
     
+    // 实例字段布局，父类已先完成布局
+    layout_instance_fields(class_ptr);
+    
+    // 构建分派表
+    result = build_vtable(class_ptr);
+    if (result == J2ME_SUCCESS) {
+        result = build_itable(class_ptr);
+    }
+    if (result != J2ME_SUCCESS) {
+        LOG_ERROR("[类加载器] 构建分派表失败: %s (错误: %d)\n", class_ptr->name, result);
+        return result;
+    }
+    
     // 解析阶段：解析符号引用
     // 实际实现应该解析常量池中的符号引用
     
@@ -441,6 +826,61 @@ j2me_method_t* j2me_class_find_method(j2me_class_t* class_ptr, const char* name,
     return NULL;
 }
 
+j2me_method_t* j2me_class_select_virtual_method(j2me_class_t* receiver_class, j2me_method_t* resolved_method) {
+    if (!receiver_class || !resolved_method) {
+        return NULL;
+    }
+
+    uint16_t index = resolved_method->vtable_index;
+    if (index == J2ME_VTABLE_INDEX_NONE || index >= receiver_class->vtable_size) {
+        return NULL;
+    }
+
+    // 槽位只在声明方法的类的子类中有效
+    for (j2me_class_t* c = receiver_class; c; c = c->super_class_ptr) {
+        if (c == resolved_method->owner_class) {
+            return receiver_class->vtable[index];
+        }
+    }
+    return NULL;
+}
+
+j2me_method_t* j2me_class_select_interface_method(j2me_class_t* receiver_class, j2me_method_t* interface_method) {
+    if (!receiver_class || !interface_method || !interface_method->owner_class) {
+        return NULL;
+    }
+
+    j2me_class_t* interface_class = interface_method->owner_class;
+    j2me_itable_entry_t* entry = find_itable_entry(receiver_class, interface_class);
+    if (!entry || !entry->methods) {
+        return NULL;
+    }
+
+    ptrdiff_t index = interface_method - interface_class->methods;
+    if (index < 0 || index >= interface_class->methods_count) {
+        return NULL;
+    }
+    return entry->methods[index];
+}
+
+j2me_class_t* j2me_class_get_object_class(j2me_vm_t* vm, j2me_int object_ref) {
+    if (!vm || !vm->heap || object_ref == 0) {
+        return NULL;
+    }
+
+    j2me_heap_object_header_t* obj = j2me_heap_get_object(vm->heap, (j2me_ref_t)object_ref);
+    if (!obj || obj->size < sizeof(j2me_class_t*)) {
+        return NULL;
+    }
+
+    // 类实例的class_id是类指针的低32位，数据区开头保存类指针
+    j2me_class_t* class_ptr = *((j2me_class_t**)obj->data);
+    if (!class_ptr || obj->class_id != (uint32_t)(uintptr_t)class_ptr) {
+        return NULL;
+    }
+    return class_ptr;
+}
+
 j2me_field_t* j2me_class_find_field(j2me_class_t* class_ptr, const char* name, const char* descriptor) {
     if (!class_ptr || !name) {
         return NULL;
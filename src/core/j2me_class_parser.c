@@ -1,4 +1,7 @@
 #include "j2me_class.h"
+#include "j2me_interpreter_optimized.h"
+#include "j2me_jit.h"
+#include "j2me_constant_pool.h"
 #include "j2me_log.h"
 #include <stdlib.h>
 #include <string.h>
@@ -472,9 +475,9 @@ void j2me_class_destroy(j2me_class_t* class_ptr) {
         return;
     }
     
-    // 释放常量池
+    // 释放常量池（来自类缓存的字符串属于映像）
     if (class_ptr->constant_pool.entries) {
-        for (uint16_t i = 0; i < class_ptr->constant_pool.count - 1; i++) {
+        for (uint16_t i = 0; !class_ptr->image_backed && i < class_ptr->constant_pool.count - 1; i++) {
             j2me_constant_pool_entry_t* entry = &class_ptr->constant_pool.entries[i];
             if (entry->tag == J2ME_CONSTANT_UTF8 && entry->info.utf8.bytes) {
                 free(entry->info.utf8.bytes);
@@ -491,9 +494,15 @@ void j2me_class_destroy(j2me_class_t* class_ptr) {
     // 释放方法
     if (class_ptr->methods) {
         for (uint16_t i = 0; i < class_ptr->methods_count; i++) {
-            if (class_ptr->methods[i].bytecode) {
+            if (class_ptr->methods[i].bytecode && !class_ptr->image_backed) {
                 free(class_ptr->methods[i].bytecode);
             }
+            if (class_ptr->methods[i].predecoded) {
+                j2me_predecoded_method_destroy(class_ptr->methods[i].predecoded);
+            }
+            free(class_ptr->methods[i].stack_bounds);
+            j2me_call_site_caches_destroy(&class_ptr->methods[i]);
+            j2me_jit_method_destroy(class_ptr->methods[i].jit_code);
         }
         free(class_ptr->methods);
     }
@@ -503,5 +512,25 @@ void j2me_class_destroy(j2me_class_t* class_ptr) {
         free(class_ptr->interfaces);
     }
     
+    // 释放分派表
+    if (class_ptr->vtable) {
+        free(class_ptr->vtable);
+    }
+    if (class_ptr->itable) {
+        for (uint16_t i = 0; i < class_ptr->itable_size; i++) {
+            free(class_ptr->itable[i].methods);
+        }
+        free(class_ptr->itable);
+    }
+    
+    // 释放快速指令解析表和常量池缓存（常量池缓存同时释放它持有的字符串）
+    if (class_ptr->quick_entries) {
+        free(class_ptr->quick_entries);
+    }
+    if (class_ptr->static_values) {
+        free(class_ptr->static_values);
+    }
+    j2me_constant_pool_cleanup_cache(class_ptr);
+    
     free(class_ptr);
 }
\ No newline at end of file
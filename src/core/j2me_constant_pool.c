@@ -15,104 +15,14 @@
  * 完整的常量池解析、缓存和访问机制
  */
 
-// 常量池缓存条目
-typedef struct {
-    uint16_t index;
-    j2me_constant_type_t type;
-    union {
-        j2me_int int_value;
-        j2me_float float_value;
-        j2me_object_t* object_ref;
-        j2me_class_t* class_ref;
-    } cached_value;
-    bool is_resolved;
-} j2me_constant_cache_entry_t;
-
-// 常量池缓存
-typedef struct {
-    j2me_constant_cache_entry_t* entries;
-    size_t size;
-    size_t capacity;
-} j2me_constant_cache_t;
-
 /**
- * @brief 创建常量池缓存
+ * @brief 获取类的常量池缓存，不存在时创建
  */
-static j2me_constant_cache_t* j2me_constant_cache_create(size_t capacity) {
-    j2me_constant_cache_t* cache = (j2me_constant_cache_t*)malloc(sizeof(j2me_constant_cache_t));
-    if (!cache) {
-        return NULL;
-    }
-    
-    cache->entries = (j2me_constant_cache_entry_t*)calloc(capacity, sizeof(j2me_constant_cache_entry_t));
-    if (!cache->entries) {
-        free(cache);
+static j2me_constant_cache_entry_t* get_constant_cache(j2me_class_t* class_info) {
+    if (!class_info->constant_cache && j2me_constant_pool_init_cache(class_info) != J2ME_SUCCESS) {
         return NULL;
     }
-    
-    cache->size = 0;
-    cache->capacity = capacity;
-    
-    return cache;
-}
-
-/**
- * @brief 销毁常量池缓存
- */
-static void j2me_constant_cache_destroy(j2me_constant_cache_t* cache) {
-    if (cache) {
-        if (cache->entries) {
-            free(cache->entries);
-        }
-        free(cache);
-    }
-}
-
-/**
- * @brief 从缓存中查找常量
- */
-static j2me_constant_cache_entry_t* j2me_constant_cache_find(j2me_constant_cache_t* cache, uint16_t index) {
-    for (size_t i = 0; i < cache->size; i++) {
-        if (cache->entries[i].index == index) {
-            return &cache->entries[i];
-        }
-    }
-    return NULL;
-}
-
-/**
- * @brief 向缓存中添加常量
- */
-static j2me_error_t j2me_constant_cache_add(j2me_constant_cache_t* cache, 
-                                            uint16_t index, 
-                                            j2me_constant_type_t type,
-                                            void* value) {
-    if (cache->size >= cache->capacity) {
-        return J2ME_ERROR_OUT_OF_MEMORY;
-    }
-    
-    j2me_constant_cache_entry_t* entry = &cache->entries[cache->size++];
-    entry->index = index;
-    entry->type = type;
-    entry->is_resolved = true;
-    
-    switch (type) {
-        case J2ME_CONSTANT_INTEGER:
-            entry->cached_value.int_value = *(j2me_int*)value;
-            break;
-        case J2ME_CONSTANT_FLOAT:
-            entry->cached_value.float_value = *(j2me_float*)value;
-            break;
-        case J2ME_CONSTANT_STRING:
-        case J2ME_CONSTANT_CLASS:
-            entry->cached_value.object_ref = (j2me_object_t*)value;
-            break;
-        default:
-            entry->is_resolved = false;
-            return J2ME_ERROR_INVALID_PARAMETER;
-    }
-    
-    return J2ME_SUCCESS;
+    return (j2me_constant_cache_entry_t*)class_info->constant_cache;
 }
 
 /**
@@ -216,7 +126,14 @@ j2me_error_t j2me_resolve_constant_pool_entry(j2me_vm_t* vm,
         return J2ME_ERROR_INVALID_PARAMETER;
     }
     
+    const j2me_constant_value_t* cached = j2me_constant_pool_lookup(class_info, index);
+    if (cached) {
+        *value = *cached;
+        return J2ME_SUCCESS;
+    }
+    
     j2me_constant_pool_entry_t* entry = &class_info->constant_pool.entries[index - 1];
+    bool cacheable = true;
     
     // 根据常量类型解析
     switch (entry->tag) {
@@ -261,29 +178,21 @@ j2me_error_t j2me_resolve_constant_pool_entry(j2me_vm_t* vm,
                     const char* str_value = string_entry->info.utf8.bytes;
                     LOG_DEBUG("[常量池] 解析字符串常量: %s\n", str_value ? str_value : "NULL");
                     
-                    // 在堆上创建真实的String对象
+                    // 相同内容的字符串常量共用一个驻留String
                     if (vm->heap && str_value) {
-                        // 使用新的堆String系统创建String对象
-                        j2me_ref_t string_ref = j2me_heap_alloc(vm->heap, J2ME_CLASS_STRING, 
-                                                                sizeof(j2me_string_data_t) + strlen(str_value) + 1);
+                        j2me_ref_t string_ref = j2me_heap_string_intern(vm->heap, str_value, strlen(str_value));
                         if (string_ref != J2ME_NULL_REF) {
-                            j2me_string_data_t* str_data = (j2me_string_data_t*)j2me_heap_get_object_data(vm->heap, string_ref);
-                            if (str_data) {
-                                str_data->length = strlen(str_value);
-                                strcpy(str_data->chars, str_value);
-                                value->data.object_ref = (void*)(intptr_t)string_ref;
-                                LOG_DEBUG("[常量池] 创建String对象: ref=0x%x, 内容=\"%s\"\n", string_ref, str_value);
-                            } else {
-                                LOG_WARN("[常量池] 警告: 无法获取String对象数据");
-                                value->data.object_ref = NULL;
-                            }
+                            value->data.object_ref = (void*)(intptr_t)string_ref;
+                            LOG_DEBUG("[常量池] 驻留String对象: ref=0x%x, 内容=\"%s\"\n", string_ref, str_value);
                         } else {
                             LOG_WARN("[常量池] 警告: String对象创建失败");
                             value->data.object_ref = NULL;
+                            cacheable = false;
                         }
                     } else {
                         LOG_WARN("[常量池] 警告: 堆未初始化或字符串为空");
                         value->data.object_ref = NULL;
+                        cacheable = false;
                     }
                 } else {
                     value->data.object_ref = NULL;
@@ -315,9 +224,39 @@ j2me_error_t j2me_resolve_constant_pool_entry(j2me_vm_t* vm,
             LOG_ERROR("[常量池] 不支持的常量类型: %d，返回默认值", entry->tag);
             value->type = J2ME_CONSTANT_INTEGER;
             value->data.int_value = index; // 使用索引作为默认值
+            cacheable = false;
             break;
     }
     
+    if (cacheable) {
+        j2me_constant_cache_entry_t* cache = get_constant_cache(class_info);
+        if (cache) {
+            cache[index].value = *value;
+            cache[index].resolved = true;
+            // 缓存持有字符串，驻留表中的表项随之一直存活（清理缓存时释放）
+            if (value->type == J2ME_CONSTANT_STRING && value->data.object_ref) {
+                j2me_heap_retain(vm->heap, (j2me_ref_t)(intptr_t)value->data.object_ref);
+            }
+        }
+    }
+    
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 保存由调用方解析的条目
+ */
+j2me_error_t j2me_constant_pool_store(j2me_class_t* class_info, uint16_t index, const j2me_constant_value_t* value) {
+    if (!class_info || !value || index == 0 || index >= class_info->constant_pool.count) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    j2me_constant_cache_entry_t* cache = get_constant_cache(class_info);
+    if (!cache) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    cache[index].value = *value;
+    cache[index].resolved = true;
     return J2ME_SUCCESS;
 }
 
@@ -333,7 +272,8 @@ j2me_error_t j2me_constant_pool_init_cache(j2me_class_t* class_info) {
         return J2ME_SUCCESS; // 已经初始化
     }
     
-    class_info->constant_cache = j2me_constant_cache_create(class_info->constant_pool.count);
+    // 按常量池索引直接寻址（索引0不使用）
+    class_info->constant_cache = calloc(class_info->constant_pool.count, sizeof(j2me_constant_cache_entry_t));
     if (!class_info->constant_cache) {
         return J2ME_ERROR_OUT_OF_MEMORY;
     }
@@ -347,7 +287,18 @@ j2me_error_t j2me_constant_pool_init_cache(j2me_class_t* class_info) {
  */
 void j2me_constant_pool_cleanup_cache(j2me_class_t* class_info) {
     if (class_info && class_info->constant_cache) {
-        j2me_constant_cache_destroy(class_info->constant_cache);
+        // 释放缓存持有的字符串（虚拟机销毁时堆先于类释放，这时不用再释放）
+        j2me_heap_t* heap = class_info->loader && class_info->loader->vm ? class_info->loader->vm->heap : NULL;
+        if (heap) {
+            j2me_constant_cache_entry_t* cache = (j2me_constant_cache_entry_t*)class_info->constant_cache;
+            for (uint16_t i = 1; i < class_info->constant_pool.count; i++) {
+                if (cache[i].resolved && cache[i].value.type == J2ME_CONSTANT_STRING &&
+                    cache[i].value.data.object_ref) {
+                    j2me_heap_release(heap, (j2me_ref_t)(intptr_t)cache[i].value.data.object_ref);
+                }
+            }
+        }
+        free(class_info->constant_cache);
         class_info->constant_cache = NULL;
     }
 }
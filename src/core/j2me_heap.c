@@ -1,16 +1,237 @@
 #include "j2me_heap.h"
+#include "j2me_string.h"
 #include <stdlib.h>
 #include <string.h>
 #include "j2me_log.h"
 #include <stdio.h>
+#include <time.h>
 
 /**
  * @file j2me_heap.c
  * @brief J2ME堆内存管理实现
  */
 
+// 对象表和辅助栈的初始容量
+#define HEAP_INITIAL_TABLE_CAPACITY 256
+
+// 增量标记每追踪这么多对象检查一次时间
+#define HEAP_MARK_BATCH 64
+
+/**
+ * @brief 老年代大小（新生代之前的部分）
+ */
+static size_t old_space_size(const j2me_heap_t* heap) {
+    return (size_t)(heap->nursery - heap->memory);
+}
+
+/**
+ * @brief 对象是否位于新生代
+ */
+static bool is_young(const j2me_heap_t* heap, const j2me_heap_object_header_t* obj) {
+    return (const uint8_t*)obj >= heap->nursery;
+}
+
+/**
+ * @brief 块大小对应的空闲链表级别
+ */
+static size_t free_list_class(size_t block_size) {
+    size_t index = (block_size - sizeof(j2me_heap_object_header_t)) / J2ME_HEAP_ALIGN;
+    return index < J2ME_HEAP_SIZE_CLASSES ? index : J2ME_HEAP_LARGE_CLASS;
+}
+
+/**
+ * @brief 堆内偏移处的块
+ */
+static j2me_heap_object_header_t* block_at(j2me_heap_t* heap, uint32_t offset) {
+    return (j2me_heap_object_header_t*)(heap->memory + offset);
+}
+
+/**
+ * @brief 把块放入空闲链表（位于顺序分配高水位末尾的块直接退回）
+ */
+static void free_block(j2me_heap_t* heap, j2me_heap_object_header_t* block, size_t block_size) {
+    size_t offset = (size_t)((uint8_t*)block - heap->memory);
+    if (offset + block_size == heap->used) {
+        heap->used = offset;
+        return;
+    }
+
+    size_t list = free_list_class(block_size);
+    block->class_id = 0;
+    block->size = (uint32_t)(block_size - sizeof(j2me_heap_object_header_t));
+    block->flags = J2ME_HEAP_FLAG_FREE;
+    block->ref_count = heap->free_lists[list];
+    heap->free_lists[list] = (uint32_t)offset + 1;
+    heap->free_bytes += block_size;
+}
+
+/**
+ * @brief 从指定链表摘下块，link指向该块在链表中的前驱链接
+ */
+static j2me_heap_object_header_t* unlink_block(j2me_heap_t* heap, uint32_t* link) {
+    j2me_heap_object_header_t* block = block_at(heap, *link - 1);
+    *link = block->ref_count;
+    heap->free_bytes -= J2ME_HEAP_BLOCK_SIZE(block->size);
+    return block;
+}
+
+/**
+ * @brief 切下块的前block_size字节，剩余部分放回空闲链表
+ */
+static j2me_heap_object_header_t* split_block(j2me_heap_t* heap, j2me_heap_object_header_t* block,
+                                              size_t block_size) {
+    size_t remainder = J2ME_HEAP_BLOCK_SIZE(block->size) - block_size;
+    if (remainder > 0) {
+        free_block(heap, (j2me_heap_object_header_t*)((uint8_t*)block + block_size), remainder);
+    }
+    return block;
+}
+
+/**
+ * @brief 在空闲链表中查找块
+ *
+ * 先找同级链表；再在大块链表中首次适配；最后切分更大的小块。
+ * 切分后剩余部分至少要能放下一个对象头。
+ */
+static j2me_heap_object_header_t* take_free_block(j2me_heap_t* heap, size_t block_size, bool split_small) {
+    size_t list = free_list_class(block_size);
+    if (list != J2ME_HEAP_LARGE_CLASS && heap->free_lists[list]) {
+        return unlink_block(heap, &heap->free_lists[list]);
+    }
+
+    const size_t min_remainder = sizeof(j2me_heap_object_header_t);
+    uint32_t* link = &heap->free_lists[J2ME_HEAP_LARGE_CLASS];
+    while (*link) {
+        j2me_heap_object_header_t* block = block_at(heap, *link - 1);
+        size_t available = J2ME_HEAP_BLOCK_SIZE(block->size);
+        if (available == block_size || available >= block_size + min_remainder) {
+            return split_block(heap, unlink_block(heap, link), block_size);
+        }
+        link = &block->ref_count;
+    }
+
+    if (split_small && list != J2ME_HEAP_LARGE_CLASS) {
+        for (size_t larger = list + min_remainder / J2ME_HEAP_ALIGN; larger < J2ME_HEAP_LARGE_CLASS; larger++) {
+            if (heap->free_lists[larger]) {
+                return split_block(heap, unlink_block(heap, &heap->free_lists[larger]), block_size);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 从空闲链表或顺序分配区域取得块
+ */
+static j2me_heap_object_header_t* allocate_block(j2me_heap_t* heap, size_t block_size) {
+    j2me_heap_object_header_t* block = take_free_block(heap, block_size, false);
+    if (block) {
+        return block;
+    }
+
+    if (block_size <= old_space_size(heap) - heap->used) {
+        block = block_at(heap, (uint32_t)heap->used);
+        heap->used += block_size;
+        return block;
+    }
+
+    return take_free_block(heap, block_size, true);
+}
+
+/**
+ * @brief 分配引用ID（优先复用已释放的ID）
+ * @return 引用ID，对象表无法扩展时返回J2ME_NULL_REF
+ */
+static j2me_ref_t allocate_ref(j2me_heap_t* heap) {
+    if (heap->free_ref_count > 0) {
+        return heap->free_refs[--heap->free_ref_count];
+    }
+
+    // 扩展对象表（如果需要）- 使用next_ref而非object_count，因为释放后object_count会减少但next_ref不会
+    if (heap->next_ref >= heap->object_capacity) {
+        size_t new_capacity = heap->object_capacity * 2;
+        j2me_heap_object_header_t** new_objects = (j2me_heap_object_header_t**)realloc(
+            heap->objects, new_capacity * sizeof(j2me_heap_object_header_t*));
+        
+        if (!new_objects) {
+            LOG_DEBUG("[堆] 错误: 无法扩展对象表\n");
+            return J2ME_NULL_REF;
+        }
+        
+        // 清零新分配的部分
+        memset(new_objects + heap->object_capacity, 0, 
+               (new_capacity - heap->object_capacity) * sizeof(j2me_heap_object_header_t*));
+        
+        heap->objects = new_objects;
+        heap->object_capacity = new_capacity;
+        
+        LOG_DEBUG("[堆] 对象表扩展: %zu -> %zu\n", heap->object_capacity / 2, new_capacity);
+    }
+
+    return heap->next_ref++;
+}
+
+/**
+ * @brief 确保数组还能再放一个元素
+ * @return 数组已满且无法扩展返回false
+ */
+static bool reserve_slot(void** array, size_t count, size_t* capacity, size_t element_size) {
+    if (count < *capacity) {
+        return true;
+    }
+    size_t new_capacity = *capacity ? *capacity * 2 : HEAP_INITIAL_TABLE_CAPACITY;
+    void* new_array = realloc(*array, new_capacity * element_size);
+    if (!new_array) {
+        return false;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * @brief 释放引用ID：对象表槽位清空，ID留待复用
+ */
+static void release_ref(j2me_heap_t* heap, j2me_ref_t ref) {
+    heap->objects[ref] = NULL;
+    heap->object_count--;
+
+    // 无法扩展时引用ID不复用，只浪费对象表的一个槽
+    if (reserve_slot((void**)&heap->free_refs, heap->free_ref_count, &heap->free_ref_capacity,
+                     sizeof(j2me_ref_t))) {
+        heap->free_refs[heap->free_ref_count++] = ref;
+    }
+}
+
+/**
+ * @brief 释放对象：老年代的块进入空闲链表，新生代的空间在下次新生代回收时整体回收
+ */
+static void release_object(j2me_heap_t* heap, j2me_ref_t ref) {
+    j2me_heap_object_header_t* obj = heap->objects[ref];
+    if (!is_young(heap, obj)) {
+        free_block(heap, obj, J2ME_HEAP_BLOCK_SIZE(obj->size));
+    }
+    release_ref(heap, ref);
+}
+
+/**
+ * @brief 在新生代中顺序分配
+ * @return 块指针，新生代已满或对象记录表无法扩展时返回NULL
+ */
+static j2me_heap_object_header_t* nursery_bump(j2me_heap_t* heap, size_t block_size) {
+    if (block_size > heap->nursery_size - heap->nursery_used ||
+        !reserve_slot((void**)&heap->young, heap->young_count, &heap->young_capacity,
+                      sizeof(j2me_heap_young_entry_t))) {
+        return NULL;
+    }
+    j2me_heap_object_header_t* block = (j2me_heap_object_header_t*)(heap->nursery + heap->nursery_used);
+    heap->nursery_used += block_size;
+    return block;
+}
+
 j2me_heap_t* j2me_heap_create(size_t size) {
-    j2me_heap_t* heap = (j2me_heap_t*)malloc(sizeof(j2me_heap_t));
+    j2me_heap_t* heap = (j2me_heap_t*)calloc(1, sizeof(j2me_heap_t));
     if (!heap) {
         LOG_DEBUG("[堆] 错误: 无法分配堆结构\n");
         return NULL;
@@ -27,8 +248,13 @@ j2me_heap_t* j2me_heap_create(size_t size) {
     heap->size = size;
     heap->used = 0;
     
+    // 新生代位于堆内存末尾
+    heap->nursery_size = (size / J2ME_HEAP_NURSERY_FRACTION) & ~(size_t)(J2ME_HEAP_ALIGN - 1);
+    heap->nursery = heap->memory + (size - heap->nursery_size);
+    heap->nursery_used = 0;
+    
     // 初始化对象表（初始容量256）
-    heap->object_capacity = 256;
+    heap->object_capacity = HEAP_INITIAL_TABLE_CAPACITY;
     heap->objects = (j2me_heap_object_header_t**)calloc(heap->object_capacity, sizeof(j2me_heap_object_header_t*));
     if (!heap->objects) {
         LOG_DEBUG("[堆] 错误: 无法分配对象表\n");
@@ -39,8 +265,11 @@ j2me_heap_t* j2me_heap_create(size_t size) {
     
     heap->object_count = 0;
     heap->next_ref = 1; // 引用从1开始，0表示NULL
+    heap->compact_ratio = J2ME_HEAP_DEFAULT_COMPACT_RATIO;
+    heap->incremental_threshold = J2ME_HEAP_DEFAULT_INCREMENTAL_THRESHOLD;
     
-    LOG_DEBUG("[堆] 创建堆成功: 大小=%zu bytes, 对象表容量=%zu\n", size, heap->object_capacity);
+    LOG_DEBUG("[堆] 创建堆成功: 大小=%zu bytes, 新生代=%zu bytes, 对象表容量=%zu\n",
+              size, heap->nursery_size, heap->object_capacity);
     return heap;
 }
 
@@ -49,13 +278,20 @@ void j2me_heap_destroy(j2me_heap_t* heap) {
         return;
     }
     
-    LOG_DEBUG("[堆] 销毁堆: 已使用=%zu/%zu bytes, 对象数=%zu\n", 
-           heap->used, heap->size, heap->object_count);
+    LOG_DEBUG("[堆] 销毁堆: 已使用=%zu/%zu bytes, 对象数=%zu, 回收%llu次, 新生代回收%llu次\n", 
+           heap->used - heap->free_bytes + heap->nursery_used, heap->size, heap->object_count,
+           (unsigned long long)heap->collections, (unsigned long long)heap->minor_collections);
     
     if (heap->objects) {
         free(heap->objects);
     }
     
+    j2me_string_table_destroy(heap->string_table);
+    free(heap->free_refs);
+    free(heap->mark_stack);
+    free(heap->young);
+    free(heap->remembered);
+    
     if (heap->memory) {
         free(heap->memory);
     }
@@ -63,57 +299,78 @@ void j2me_heap_destroy(j2me_heap_t* heap) {
     free(heap);
 }
 
-j2me_ref_t j2me_heap_alloc(j2me_heap_t* heap, uint32_t class_id, size_t size) {
-    if (!heap) {
+/**
+ * @brief 分配对象
+ * @param pinned 固定对象：直接分配在老年代，不移动、不回收
+ */
+static j2me_ref_t alloc_object(j2me_heap_t* heap, uint32_t class_id, size_t size, bool pinned) {
+    if (!heap || size > UINT32_MAX) {
         return J2ME_NULL_REF;
     }
     
-    // 计算总大小（对象头 + 数据）
-    size_t total_size = sizeof(j2me_heap_object_header_t) + size;
+    // 计算块大小（对象头 + 数据，按8字节对齐）
+    size_t total_size = J2ME_HEAP_BLOCK_SIZE(size);
+    heap->allocations++;
+    
+    // 小对象先在新生代顺序分配，新生代满时做一次新生代回收；
+    // 增量标记期间新生代停用，新对象直接分配在老年代
+    j2me_heap_object_header_t* obj = NULL;
+    if (total_size <= heap->nursery_size / 4 && !heap->marking && !pinned) {
+        obj = nursery_bump(heap, total_size);
+        if (!obj && heap->root_scanner && !heap->collecting) {
+            j2me_heap_collect_minor(heap);
+            obj = nursery_bump(heap, total_size);
+        }
+    }
     
-    // 检查堆空间
-    if (heap->used + total_size > heap->size) {
-        LOG_DEBUG("[堆] 错误: 堆空间不足 (需要=%zu, 可用=%zu)\n", 
-               total_size, heap->size - heap->used);
+    if (!obj) {
+        obj = allocate_block(heap, total_size);
+    }
+    if (!obj && heap->root_scanner && !heap->collecting) {
+        j2me_heap_collect(heap);
+        obj = allocate_block(heap, total_size);
+    }
+    if (!obj && heap->free_bytes >= total_size && !heap->collecting) {
+        // 空闲总量足够但没有足够大的连续块
+        j2me_heap_compact(heap);
+        obj = allocate_block(heap, total_size);
+    }
+    if (!obj) {
+        LOG_DEBUG("[堆] 错误: 堆空间不足 (需要=%zu, 可用=%zu, 空闲链表=%zu)\n", 
+               total_size, old_space_size(heap) - heap->used, heap->free_bytes);
+        heap->allocation_failures++;
         return J2ME_NULL_REF;
     }
     
-    // 扩展对象表（如果需要）- 使用next_ref而非object_count，因为释放后object_count会减少但next_ref不会
-    if (heap->next_ref >= heap->object_capacity) {
-        size_t new_capacity = heap->object_capacity * 2;
-        j2me_heap_object_header_t** new_objects = (j2me_heap_object_header_t**)realloc(
-            heap->objects, new_capacity * sizeof(j2me_heap_object_header_t*));
-        
-        if (!new_objects) {
-            LOG_DEBUG("[堆] 错误: 无法扩展对象表\n");
-            return J2ME_NULL_REF;
+    // 分配引用ID
+    j2me_ref_t ref = allocate_ref(heap);
+    if (ref == J2ME_NULL_REF) {
+        if (is_young(heap, obj)) {
+            heap->nursery_used -= total_size;
+        } else {
+            free_block(heap, obj, total_size);
         }
-        
-        // 清零新分配的部分
-        memset(new_objects + heap->object_capacity, 0, 
-               (new_capacity - heap->object_capacity) * sizeof(j2me_heap_object_header_t*));
-        
-        heap->objects = new_objects;
-        heap->object_capacity = new_capacity;
-        
-        LOG_DEBUG("[堆] 对象表扩展: %zu -> %zu\n", heap->object_capacity / 2, new_capacity);
+        heap->allocation_failures++;
+        return J2ME_NULL_REF;
+    }
+    
+    if (is_young(heap, obj)) {
+        heap->young[heap->young_count].ref = ref;
+        heap->young[heap->young_count].offset = (uint32_t)((uint8_t*)obj - heap->nursery);
+        heap->young_count++;
     }
     
-    // 在堆上分配对象
-    j2me_heap_object_header_t* obj = (j2me_heap_object_header_t*)(heap->memory + heap->used);
     obj->class_id = class_id;
-    obj->size = size;
+    obj->size = (uint32_t)size;
     obj->ref_count = 1;
-    obj->flags = 0;
+    obj->flags = pinned ? J2ME_HEAP_FLAG_PINNED : 0;
+    if (heap->marking) {
+        obj->flags |= J2ME_HEAP_FLAG_MARKED;  // 标记期间分配的对象直接为黑色
+    }
     
     // 清零对象数据
     memset(obj->data, 0, size);
     
-    heap->used += total_size;
-    
-    // 分配引用ID
-    j2me_ref_t ref = heap->next_ref++;
-    
     // 存储到对象表
     heap->objects[ref] = obj;
     heap->object_count++;
@@ -121,9 +378,21 @@ j2me_ref_t j2me_heap_alloc(j2me_heap_t* heap, uint32_t class_id, size_t size) {
     // LOG_DEBUG("[堆] 分配对象: ref=0x%x, class_id=%u, size=%zu, 总大小=%zu\n", 
     //        ref, class_id, size, total_size);
     
+    if (heap->alloc_hook) {
+        heap->alloc_hook(heap, ref, class_id, size, heap->alloc_hook_context);
+    }
+    
     return ref;
 }
 
+j2me_ref_t j2me_heap_alloc(j2me_heap_t* heap, uint32_t class_id, size_t size) {
+    return alloc_object(heap, class_id, size, false);
+}
+
+j2me_ref_t j2me_heap_alloc_pinned(j2me_heap_t* heap, uint32_t class_id, size_t size) {
+    return alloc_object(heap, class_id, size, true);
+}
+
 void j2me_heap_free(j2me_heap_t* heap, j2me_ref_t ref) {
     if (!heap || ref == J2ME_NULL_REF || ref >= heap->next_ref) {
         return;
@@ -137,12 +406,8 @@ void j2me_heap_free(j2me_heap_t* heap, j2me_ref_t ref) {
     // LOG_DEBUG("[堆] 释放对象: ref=0x%x, class_id=%u, size=%u\n", 
     //        ref, obj->class_id, obj->size);
     
-    // 从对象表中移除
-    heap->objects[ref] = NULL;
-    heap->object_count--;
-    
-    // 注意: 这里简化实现，不实际回收内存
-    // 真实的GC会在垃圾回收时统一回收
+    // 从对象表中移除，老年代空间放回空闲链表
+    release_object(heap, ref);
 }
 
 j2me_heap_object_header_t* j2me_heap_get_object(j2me_heap_t* heap, j2me_ref_t ref) {
@@ -188,7 +453,7 @@ void j2me_heap_get_stats(j2me_heap_t* heap, size_t* used, size_t* total, size_t*
         return;
     }
     
-    if (used) *used = heap->used;
+    if (used) *used = heap->used - heap->free_bytes + heap->nursery_used;
     if (total) *total = heap->size;
     if (objects) *objects = heap->object_count;
 }
@@ -200,14 +465,723 @@ void j2me_heap_print_stats(j2me_heap_t* heap) {
     
     LOG_DEBUG("\n=== 堆统计信息 ===\n");
     LOG_DEBUG("  总大小: %zu bytes\n", heap->size);
-    LOG_DEBUG("  已使用: %zu bytes (%.1f%%)\n", heap->used, 
-           (double)heap->used / heap->size * 100.0);
-    LOG_DEBUG("  可用: %zu bytes\n", heap->size - heap->used);
+    LOG_DEBUG("  老年代: %zu / %zu bytes (空闲链表 %zu bytes)\n", heap->used - heap->free_bytes,
+           old_space_size(heap), heap->free_bytes);
+    LOG_DEBUG("  新生代: %zu / %zu bytes, %zu个对象\n", heap->nursery_used, heap->nursery_size, heap->young_count);
     LOG_DEBUG("  对象数: %zu / %zu\n", heap->object_count, heap->object_capacity);
-    LOG_DEBUG("  下一个引用ID: 0x%x\n", heap->next_ref);
+    LOG_DEBUG("  下一个引用ID: 0x%x (可复用 %zu)\n", heap->next_ref, heap->free_ref_count);
+    LOG_DEBUG("  分配: %llu次, 失败 %llu次\n", (unsigned long long)heap->allocations,
+           (unsigned long long)heap->allocation_failures);
+    LOG_DEBUG("  回收: %llu次, %llu个对象, %llu bytes\n", (unsigned long long)heap->collections,
+           (unsigned long long)heap->objects_reclaimed, (unsigned long long)heap->bytes_reclaimed);
+    LOG_DEBUG("  新生代回收: %llu次, 晋升 %llu bytes, 记忆集 %zu\n", (unsigned long long)heap->minor_collections,
+           (unsigned long long)heap->bytes_promoted, heap->remembered_count);
+    LOG_DEBUG("  压缩: %llu次, 移动 %llu bytes\n", (unsigned long long)heap->compactions,
+           (unsigned long long)heap->bytes_moved);
+    LOG_DEBUG("  增量标记: %llu轮, %llu个分片\n", (unsigned long long)heap->incremental_cycles,
+           (unsigned long long)heap->incremental_steps);
+    LOG_DEBUG("  暂停: 最长 %llu us, 累计 %llu us\n", (unsigned long long)heap->max_pause_us,
+           (unsigned long long)heap->total_pause_us);
     LOG_DEBUG("==================\n\n");
 }
 
+// ============================================================================
+// 标记-清除回收
+// ============================================================================
+
+/**
+ * @brief 引用对应的存活对象，不是有效引用时返回NULL
+ */
+static j2me_heap_object_header_t* live_object(j2me_heap_t* heap, j2me_ref_t ref) {
+    if (ref == J2ME_NULL_REF || ref >= heap->next_ref) {
+        return NULL;
+    }
+    return heap->objects[ref];
+}
+
+/**
+ * @brief 单调时钟（微秒）
+ */
+static uint64_t heap_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief 记录一次暂停
+ */
+static void record_pause(j2me_heap_t* heap, uint64_t start_us) {
+    uint64_t pause = heap_time_us() - start_us;
+    heap->total_pause_us += pause;
+    if (pause > heap->max_pause_us) {
+        heap->max_pause_us = pause;
+    }
+}
+
+void j2me_heap_set_root_scanner(j2me_heap_t* heap, j2me_heap_root_scanner_t scanner, void* context) {
+    if (!heap) {
+        return;
+    }
+    heap->root_scanner = scanner;
+    heap->root_context = context;
+}
+
+void j2me_heap_set_alloc_hook(j2me_heap_t* heap, j2me_heap_alloc_hook_t hook, void* context) {
+    if (!heap) {
+        return;
+    }
+    heap->alloc_hook = hook;
+    heap->alloc_hook_context = context;
+}
+
+void j2me_heap_mark_ref(j2me_heap_t* heap, j2me_ref_t ref) {
+    if (heap && heap->root_visitor) {
+        heap->root_visitor(heap, ref, heap->root_visitor_context);
+        return;
+    }
+    if (!heap || (!heap->collecting && !heap->marking)) {
+        return;
+    }
+    
+    j2me_heap_object_header_t* obj = live_object(heap, ref);
+    if (!obj || (obj->flags & J2ME_HEAP_FLAG_MARKED)) {
+        return;
+    }
+    // 新生代回收不追踪老年代对象，老年代到新生代的引用由记忆集提供
+    if (heap->minor && !is_young(heap, obj)) {
+        return;
+    }
+    obj->flags |= J2ME_HEAP_FLAG_MARKED;
+    
+    if (!reserve_slot((void**)&heap->mark_stack, heap->mark_stack_count, &heap->mark_stack_capacity,
+                      sizeof(j2me_ref_t))) {
+        // 标记栈无法扩展时本次不再回收任何对象（见j2me_heap_collect）
+        LOG_ERROR("[堆] 标记栈扩展失败");
+        heap->mark_overflow = true;
+        return;
+    }
+    heap->mark_stack[heap->mark_stack_count++] = ref;
+}
+
+void j2me_heap_mark_slots(j2me_heap_t* heap, const j2me_int* slots, size_t count) {
+    if (!heap || !slots) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        j2me_heap_mark_ref(heap, (j2me_ref_t)slots[i]);
+    }
+}
+
+/**
+ * @brief 对对象引用的其他对象调用visitor
+ *
+ * Graphics不含引用；String只有去重后指向的共享字符串；Canvas只有graphics_ref；
+ * 其余对象的数据按4字节槽保守扫描，开头的类指针（与class_id相同的那个指针）跳过。
+ */
+static inline void visit_object(j2me_heap_t* heap, j2me_heap_object_header_t* obj,
+                                j2me_heap_ref_visitor_t visitor, void* context) {
+    switch (obj->class_id) {
+        case J2ME_CLASS_ID_STRING:
+            if (obj->size >= sizeof(j2me_string_data_t) + sizeof(j2me_ref_t) &&
+                (((j2me_string_data_t*)obj->data)->length & J2ME_STRING_SHARED)) {
+                j2me_ref_t target;
+                memcpy(&target, ((j2me_string_data_t*)obj->data)->chars, sizeof(j2me_ref_t));
+                visitor(heap, target, context);
+            }
+            return;
+    
+        case J2ME_CLASS_ID_GRAPHICS:
+            return;
+            
+        case J2ME_CLASS_ID_CANVAS:
+            if (obj->size >= sizeof(j2me_canvas_object_t)) {
+                visitor(heap, ((j2me_canvas_object_t*)obj->data)->graphics_ref, context);
+            }
+            return;
+            
+        default:
+            break;
+    }
+    
+    size_t offset = 0;
+    if (obj->size >= sizeof(void*)) {
+        void* class_ptr;
+        memcpy(&class_ptr, obj->data, sizeof(void*));
+        if ((uint32_t)(uintptr_t)class_ptr == obj->class_id) {
+            offset = sizeof(void*);
+        }
+    }
+    
+    for (; offset + sizeof(j2me_ref_t) <= obj->size; offset += sizeof(j2me_ref_t)) {
+        j2me_ref_t slot;
+        memcpy(&slot, obj->data + offset, sizeof(j2me_ref_t));
+        visitor(heap, slot, context);
+    }
+}
+
+static void mark_visitor(j2me_heap_t* heap, j2me_ref_t ref, void* context) {
+    (void)context;
+    j2me_heap_mark_ref(heap, ref);
+}
+
+/**
+ * @brief 标记对象引用的其他对象
+ */
+static void trace_object(j2me_heap_t* heap, j2me_heap_object_header_t* obj) {
+    visit_object(heap, obj, mark_visitor, NULL);
+}
+
+static size_t compact_old_space(j2me_heap_t* heap);
+
+/**
+ * @brief 开始一次回收
+ */
+static void begin_collection(j2me_heap_t* heap, bool minor) {
+    heap->collecting = true;
+    heap->minor = minor;
+    heap->mark_overflow = false;
+    heap->mark_stack_count = 0;
+}
+
+/**
+ * @brief 弹出一个灰色对象并扫描（增量标记期间对象可能已被显式释放）
+ */
+static void pop_and_trace(j2me_heap_t* heap) {
+    j2me_heap_object_header_t* obj = live_object(heap, heap->mark_stack[--heap->mark_stack_count]);
+    if (obj) {
+        trace_object(heap, obj);
+    }
+}
+
+/**
+ * @brief 标记根：显式retain过的对象（如快速化ldc持有的字符串）、固定对象和根扫描回调给出的引用
+ */
+static void mark_roots(j2me_heap_t* heap) {
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        j2me_heap_object_header_t* obj = heap->objects[ref];
+        if (obj && (obj->ref_count > 1 || (obj->flags & J2ME_HEAP_FLAG_PINNED))) {
+            j2me_heap_mark_ref(heap, ref);
+        }
+    }
+    heap->root_scanner(heap, heap->root_context);
+}
+
+j2me_error_t j2me_heap_visit_roots(j2me_heap_t* heap, j2me_heap_ref_visitor_t visitor, void* context) {
+    if (!heap || !visitor) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    if (heap->collecting || heap->root_visitor) {
+        return J2ME_ERROR_INVALID_STATE;
+    }
+    
+    heap->root_visitor = visitor;
+    heap->root_visitor_context = context;
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        j2me_heap_object_header_t* obj = heap->objects[ref];
+        if (obj && (obj->ref_count > 1 || (obj->flags & J2ME_HEAP_FLAG_PINNED))) {
+            visitor(heap, ref, context);
+        }
+    }
+    if (heap->root_scanner) {
+        heap->root_scanner(heap, heap->root_context);
+    }
+    heap->root_visitor = NULL;
+    heap->root_visitor_context = NULL;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 只转发有效引用
+ */
+typedef struct {
+    j2me_heap_ref_visitor_t visitor;
+    void* context;
+} live_ref_filter_t;
+
+static void live_ref_visitor(j2me_heap_t* heap, j2me_ref_t ref, void* context) {
+    live_ref_filter_t* filter = (live_ref_filter_t*)context;
+    if (live_object(heap, ref)) {
+        filter->visitor(heap, ref, filter->context);
+    }
+}
+
+void j2me_heap_visit_references(j2me_heap_t* heap, j2me_ref_t ref, j2me_heap_ref_visitor_t visitor, void* context) {
+    if (!heap || !visitor) {
+        return;
+    }
+    j2me_heap_object_header_t* obj = live_object(heap, ref);
+    if (!obj) {
+        return;
+    }
+    
+    live_ref_filter_t filter = { visitor, context };
+    visit_object(heap, obj, live_ref_visitor, &filter);
+}
+
+/**
+ * @brief 追踪标记栈中的对象直到栈空
+ */
+static void drain_mark_stack(j2me_heap_t* heap) {
+    while (heap->mark_stack_count > 0) {
+        pop_and_trace(heap);
+    }
+}
+
+/**
+ * @brief 新生代对象记录对应的对象，引用已释放或被复用时返回NULL
+ */
+static j2me_heap_object_header_t* current_young(j2me_heap_t* heap, const j2me_heap_young_entry_t* entry) {
+    j2me_heap_object_header_t* obj = live_object(heap, entry->ref);
+    return (uint8_t*)obj == heap->nursery + entry->offset ? obj : NULL;
+}
+
+/**
+ * @brief 清空记忆集
+ */
+static void clear_remembered(j2me_heap_t* heap) {
+    for (size_t i = 0; i < heap->remembered_count; i++) {
+        j2me_heap_object_header_t* obj = live_object(heap, heap->remembered[i]);
+        if (obj && !is_young(heap, obj)) {
+            obj->flags &= ~J2ME_HEAP_FLAG_REMEMBERED;
+        }
+    }
+    heap->remembered_count = 0;
+    heap->remembered_overflow = false;
+}
+
+bool j2me_heap_is_live(j2me_heap_t* heap, j2me_ref_t ref) {
+    if (!heap) {
+        return false;
+    }
+    j2me_heap_object_header_t* obj = live_object(heap, ref);
+    if (!obj) {
+        return false;
+    }
+    if (!heap->collecting || heap->mark_overflow || (heap->minor && !is_young(heap, obj))) {
+        return true;
+    }
+    return (obj->flags & J2ME_HEAP_FLAG_MARKED) != 0;
+}
+
+bool j2me_heap_shrink_object(j2me_heap_t* heap, j2me_ref_t ref, size_t new_size) {
+    if (!heap) {
+        return false;
+    }
+    j2me_heap_object_header_t* obj = live_object(heap, ref);
+    if (!obj || is_young(heap, obj) || (obj->flags & J2ME_HEAP_FLAG_PINNED) || new_size > obj->size) {
+        return false;
+    }
+    
+    size_t block_size = J2ME_HEAP_BLOCK_SIZE(obj->size);
+    size_t new_block_size = J2ME_HEAP_BLOCK_SIZE(new_size);
+    if (block_size - new_block_size < J2ME_HEAP_BLOCK_SIZE(0)) {
+        return false;
+    }
+    
+    obj->size = (uint32_t)new_size;
+    free_block(heap, (j2me_heap_object_header_t*)((uint8_t*)obj + new_block_size), block_size - new_block_size);
+    return true;
+}
+
+/**
+ * @brief 清空新生代：未标记对象释放，存活对象复制到老年代
+ *
+ * 老年代放不下的存活对象滑动到新生代底部。这些对象可能被刚晋升的对象引用，
+ * 而晋升对象不在记忆集中，因此下一次新生代回收改为完整回收。
+ *
+ * @param complete 标记是否完整，不完整时所有对象都按存活处理
+ * @return 释放的字节数
+ */
+static size_t evacuate_nursery(j2me_heap_t* heap, bool complete) {
+    size_t top = 0;
+    size_t kept = 0;
+    size_t reclaimed = 0;
+    size_t promoted = 0;
+    
+    // 记录按地址顺序排列，留在新生代的对象只会向低地址移动，不会覆盖尚未处理的对象
+    for (size_t i = 0; i < heap->young_count; i++) {
+        j2me_heap_young_entry_t entry = heap->young[i];
+        j2me_heap_object_header_t* obj = current_young(heap, &entry);
+        if (!obj) {
+            continue;
+        }
+        
+        size_t block_size = J2ME_HEAP_BLOCK_SIZE(obj->size);
+        if (complete && !(obj->flags & J2ME_HEAP_FLAG_MARKED)) {
+            reclaimed += block_size;
+            release_ref(heap, entry.ref);
+            continue;
+        }
+        obj->flags &= ~J2ME_HEAP_FLAG_MARKED;
+        
+        j2me_heap_object_header_t* target = allocate_block(heap, block_size);
+        if (target) {
+            memcpy(target, obj, block_size);
+            heap->objects[entry.ref] = target;
+            promoted += block_size;
+            continue;
+        }
+        
+        if (entry.offset != top) {
+            memmove(heap->nursery + top, obj, block_size);
+            heap->objects[entry.ref] = (j2me_heap_object_header_t*)(heap->nursery + top);
+        }
+        heap->young[kept].ref = entry.ref;
+        heap->young[kept].offset = (uint32_t)top;
+        kept++;
+        top += block_size;
+    }
+    
+    heap->young_count = kept;
+    heap->nursery_used = top;
+    heap->bytes_promoted += promoted;
+    
+    if (kept == 0) {
+        clear_remembered(heap);
+    } else {
+        LOG_DEBUG("[堆] 老年代空间不足，%zu个对象留在新生代\n", kept);
+        heap->remembered_overflow = true;
+    }
+    return reclaimed;
+}
+
+/**
+ * @brief 标记完成后清除老年代、按需压缩并清空新生代
+ */
+static size_t finish_collection(j2me_heap_t* heap) {
+    size_t reclaimed_bytes = 0;
+    size_t reclaimed_objects = 0;
+    
+    // 标记栈扩展失败时可达集合不完整，只清除标记
+    bool complete = !heap->mark_overflow;
+    
+    // 清除前处理弱引用（驻留表）和字符串去重
+    j2me_string_table_sweep(heap);
+    
+    // 清除老年代；新生代对象保留标记，留给晋升时判断
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        j2me_heap_object_header_t* obj = heap->objects[ref];
+        if (!obj || is_young(heap, obj)) {
+            continue;
+        }
+        if ((obj->flags & J2ME_HEAP_FLAG_MARKED) || !complete) {
+            obj->flags &= ~J2ME_HEAP_FLAG_MARKED;
+            continue;
+        }
+        reclaimed_bytes += J2ME_HEAP_BLOCK_SIZE(obj->size);
+        reclaimed_objects++;
+        release_object(heap, ref);
+    }
+    
+    // 先压缩老年代，为新生代存活对象腾出连续空间
+    if (heap->compact_ratio < 100 && heap->used > 0 &&
+        heap->free_bytes * 100 > (size_t)heap->compact_ratio * heap->used) {
+        compact_old_space(heap);
+    }
+    
+    size_t young_before = heap->object_count;
+    reclaimed_bytes += evacuate_nursery(heap, complete);
+    reclaimed_objects += young_before - heap->object_count;
+    
+    heap->collecting = false;
+    heap->marking = false;
+    heap->collections++;
+    heap->objects_reclaimed += reclaimed_objects;
+    heap->bytes_reclaimed += reclaimed_bytes;
+    
+    LOG_DEBUG("[堆] 第%llu次回收: 释放%zu个对象, %zu bytes, 存活%zu个对象\n",
+              (unsigned long long)heap->collections, reclaimed_objects, reclaimed_bytes, heap->object_count);
+    return reclaimed_bytes;
+}
+
+/**
+ * @brief 完整回收；增量标记进行中时重新扫描根，一次完成剩余标记
+ */
+static size_t collect_full(j2me_heap_t* heap) {
+    if (heap->marking) {
+        heap->collecting = true;
+    } else {
+        begin_collection(heap, false);
+    }
+    mark_roots(heap);
+    drain_mark_stack(heap);
+    return finish_collection(heap);
+}
+
+size_t j2me_heap_collect(j2me_heap_t* heap) {
+    if (!heap || !heap->root_scanner || heap->collecting) {
+        return 0;
+    }
+    
+    uint64_t start = heap_time_us();
+    size_t reclaimed = collect_full(heap);
+    record_pause(heap, start);
+    return reclaimed;
+}
+
+/**
+ * @brief 新生代回收
+ */
+static size_t collect_minor(j2me_heap_t* heap) {
+    // 记忆集不完整时只能完整回收
+    if (heap->remembered_overflow) {
+        return collect_full(heap);
+    }
+    
+    begin_collection(heap, true);
+    size_t objects_before = heap->object_count;
+    
+    for (size_t i = 0; i < heap->young_count; i++) {
+        j2me_heap_object_header_t* obj = current_young(heap, &heap->young[i]);
+        if (obj && obj->ref_count > 1) {
+            j2me_heap_mark_ref(heap, heap->young[i].ref);
+        }
+    }
+    
+    heap->root_scanner(heap, heap->root_context);
+    
+    for (size_t i = 0; i < heap->remembered_count; i++) {
+        j2me_heap_object_header_t* obj = live_object(heap, heap->remembered[i]);
+        if (obj && !is_young(heap, obj) && (obj->flags & J2ME_HEAP_FLAG_REMEMBERED)) {
+            trace_object(heap, obj);
+        }
+    }
+    drain_mark_stack(heap);
+    j2me_string_table_sweep(heap);
+    
+    size_t reclaimed_bytes = evacuate_nursery(heap, !heap->mark_overflow);
+    size_t reclaimed_objects = objects_before - heap->object_count;
+    
+    heap->minor = false;
+    heap->collecting = false;
+    heap->minor_collections++;
+    heap->objects_reclaimed += reclaimed_objects;
+    heap->bytes_reclaimed += reclaimed_bytes;
+    
+    LOG_DEBUG("[堆] 第%llu次新生代回收: 释放%zu个对象, %zu bytes, 新生代剩余%zu bytes\n",
+              (unsigned long long)heap->minor_collections, reclaimed_objects, reclaimed_bytes, heap->nursery_used);
+    return reclaimed_bytes;
+}
+
+size_t j2me_heap_collect_minor(j2me_heap_t* heap) {
+    // 增量标记期间新生代停用
+    if (!heap || !heap->root_scanner || heap->collecting || heap->marking) {
+        return 0;
+    }
+    
+    uint64_t start = heap_time_us();
+    size_t reclaimed = collect_minor(heap);
+    record_pause(heap, start);
+    return reclaimed;
+}
+
+/**
+ * @brief 老年代占用是否达到增量标记启动阈值
+ */
+static bool should_start_marking(const j2me_heap_t* heap) {
+    size_t old_live = heap->used - heap->free_bytes;
+    return heap->incremental_threshold < 100 &&
+           old_live * 100 >= (size_t)heap->incremental_threshold * old_space_size(heap);
+}
+
+bool j2me_heap_collect_step(j2me_heap_t* heap, uint32_t budget_us) {
+    if (!heap || !heap->root_scanner || heap->collecting) {
+        return false;
+    }
+    
+    uint64_t start = heap_time_us();
+    if (!heap->marking) {
+        if (!should_start_marking(heap)) {
+            return false;
+        }
+        
+        // 先清空新生代：标记期间新生代停用，晋升到老年代的对象随老年代一起标记。
+        // 记忆集不完整时新生代回收会改为完整回收，本轮不再需要标记
+        if (heap->young_count > 0) {
+            uint64_t collections = heap->collections;
+            collect_minor(heap);
+            if (heap->young_count > 0 || heap->collections != collections) {
+                record_pause(heap, start);
+                return false;
+            }
+        }
+        
+        // 根扫描一次完成，之后由写屏障维护“黑色对象不指向白色对象”
+        begin_collection(heap, false);
+        mark_roots(heap);
+        heap->collecting = false;
+        heap->marking = true;
+        heap->incremental_cycles++;
+        LOG_DEBUG("[堆] 开始第%llu轮增量标记: 灰色对象%zu个\n",
+                  (unsigned long long)heap->incremental_cycles, heap->mark_stack_count);
+    }
+    
+    heap->incremental_steps++;
+    uint64_t deadline = start + budget_us;
+    while (heap->mark_stack_count > 0) {
+        for (int i = 0; i < HEAP_MARK_BATCH && heap->mark_stack_count > 0; i++) {
+            pop_and_trace(heap);
+        }
+        if (heap_time_us() >= deadline) {
+            record_pause(heap, start);
+            return false;
+        }
+    }
+    
+    // 灰色对象已处理完：栈帧和静态字段的写入没有屏障，重新扫描根后完成回收
+    collect_full(heap);
+    record_pause(heap, start);
+    return true;
+}
+
+void j2me_heap_set_incremental_threshold(j2me_heap_t* heap, uint32_t percent) {
+    if (heap) {
+        heap->incremental_threshold = percent;
+    }
+}
+
+/**
+ * @brief 把老年代对象加入记忆集
+ */
+static void remember_object(j2me_heap_t* heap, j2me_ref_t ref, j2me_heap_object_header_t* obj) {
+    if (obj->flags & J2ME_HEAP_FLAG_REMEMBERED) {
+        return;
+    }
+    if (!reserve_slot((void**)&heap->remembered, heap->remembered_count, &heap->remembered_capacity,
+                      sizeof(j2me_ref_t))) {
+        heap->remembered_overflow = true;
+        return;
+    }
+    obj->flags |= J2ME_HEAP_FLAG_REMEMBERED;
+    heap->remembered[heap->remembered_count++] = ref;
+}
+
+void j2me_heap_remember(j2me_heap_t* heap, j2me_ref_t holder) {
+    if (!heap) {
+        return;
+    }
+    j2me_heap_object_header_t* obj = live_object(heap, holder);
+    if (!obj) {
+        return;
+    }
+    // 增量标记期间已扫描过的对象重新扫描，写入的引用都变为灰色
+    if (heap->marking && (obj->flags & J2ME_HEAP_FLAG_MARKED)) {
+        trace_object(heap, obj);
+    }
+    if (heap->young_count > 0 && !is_young(heap, obj)) {
+        remember_object(heap, holder, obj);
+    }
+}
+
+void j2me_heap_write_barrier(j2me_heap_t* heap, j2me_ref_t holder, j2me_ref_t value) {
+    if (!heap) {
+        return;
+    }
+    // 增量标记期间写入的引用标记为灰色（插入屏障）
+    if (heap->marking) {
+        j2me_heap_mark_ref(heap, value);
+    }
+    if (heap->young_count == 0) {
+        return;
+    }
+    j2me_heap_object_header_t* target = live_object(heap, value);
+    if (target && is_young(heap, target)) {
+        j2me_heap_remember(heap, holder);
+    }
+}
+
+// ============================================================================
+// 滑动压缩
+// ============================================================================
+
+// 压缩时按地址排序的存活对象
+typedef struct {
+    size_t offset;          // 对象在堆内的偏移
+    j2me_ref_t ref;         // 对象引用
+} compact_entry_t;
+
+static int compare_compact_entry(const void* a, const void* b) {
+    size_t offset_a = ((const compact_entry_t*)a)->offset;
+    size_t offset_b = ((const compact_entry_t*)b)->offset;
+    return offset_a < offset_b ? -1 : (offset_a > offset_b ? 1 : 0);
+}
+
+void j2me_heap_set_compact_ratio(j2me_heap_t* heap, uint32_t percent) {
+    if (heap) {
+        heap->compact_ratio = percent;
+    }
+}
+
+/**
+ * @brief 压缩老年代（新生代对象不移动）
+ */
+static size_t compact_old_space(j2me_heap_t* heap) {
+    if (heap->free_bytes == 0) {
+        return 0;
+    }
+    
+    compact_entry_t* entries = NULL;
+    if (heap->object_count > 0) {
+        entries = (compact_entry_t*)malloc(heap->object_count * sizeof(compact_entry_t));
+        if (!entries) {
+            LOG_ERROR("[堆] 压缩失败: 无法分配排序表");
+            return 0;
+        }
+    }
+    
+    size_t count = 0;
+    for (j2me_ref_t ref = 1; ref < heap->next_ref && count < heap->object_count; ref++) {
+        if (heap->objects[ref] && !is_young(heap, heap->objects[ref])) {
+            entries[count].offset = (size_t)((uint8_t*)heap->objects[ref] - heap->memory);
+            entries[count].ref = ref;
+            count++;
+        }
+    }
+    qsort(entries, count, sizeof(compact_entry_t), compare_compact_entry);
+    
+    // 按地址从低到高移动，目标位置不会越过尚未移动的对象。
+    // 固定对象原地不动，它前面放不满的空间重新放回空闲链表
+    size_t old_used = heap->used;
+    size_t top = 0;
+    size_t moved = 0;
+    memset(heap->free_lists, 0, sizeof(heap->free_lists));
+    heap->free_bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        j2me_heap_object_header_t* obj = heap->objects[entries[i].ref];
+        size_t block_size = J2ME_HEAP_BLOCK_SIZE(obj->size);
+        if (obj->flags & J2ME_HEAP_FLAG_PINNED) {
+            if (entries[i].offset > top) {
+                free_block(heap, block_at(heap, (uint32_t)top), entries[i].offset - top);
+            }
+            top = entries[i].offset + block_size;
+            continue;
+        }
+        if (entries[i].offset != top) {
+            memmove(heap->memory + top, obj, block_size);
+            heap->objects[entries[i].ref] = (j2me_heap_object_header_t*)(heap->memory + top);
+            moved += block_size;
+        }
+        top += block_size;
+    }
+    free(entries);
+    
+    heap->used = top;
+    heap->compactions++;
+    heap->bytes_moved += moved;
+    
+    LOG_DEBUG("[堆] 第%llu次压缩: 移动%zu bytes, 已用区域 %zu -> %zu bytes\n",
+              (unsigned long long)heap->compactions, moved, old_used, top);
+    return old_used - top;
+}
+
+size_t j2me_heap_compact(j2me_heap_t* heap) {
+    if (!heap || heap->collecting) {
+        return 0;
+    }
+    return compact_old_space(heap);
+}
+
 // ============================================================================
 // MIDP对象创建函数
 // ============================================================================
@@ -293,3 +1267,14 @@ bool j2me_heap_is_valid_ref(j2me_heap_t* heap, j2me_ref_t ref) {
     
     return true;
 }
+
+const char* j2me_heap_builtin_class_name(uint32_t class_id) {
+    switch (class_id) {
+        case 0: return "<array>";  // j2me_object_t数组
+        case J2ME_CLASS_ID_STRING: return "java/lang/String";
+        case J2ME_CLASS_ID_CANVAS: return "javax/microedition/lcdui/Canvas";
+        case J2ME_CLASS_ID_GRAPHICS: return "javax/microedition/lcdui/Graphics";
+        case 0xFFFFFFFF: return "<unresolved>";  // NEW无法加载的类
+        default: return NULL;
+    }
+}
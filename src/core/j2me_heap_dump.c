@@ -0,0 +1,289 @@
+#include "j2me_heap_dump.h"
+#include "j2me_vm.h"
+#include "j2me_class.h"
+#include "j2me_string.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @file j2me_heap_dump.c
+ * @brief 堆快照写出
+ *
+ * 写快照不移动、不标记对象：根通过j2me_heap_visit_roots遍历，对象引用按回收时的
+ * 追踪规则给出（其余对象的数据槽是保守扫描的，快照中的引用可能多于真实引用）。
+ */
+
+// 信号处理函数设置，时间片之间检查
+static volatile sig_atomic_t g_heap_dump_requested = 0;
+
+// 写快照时的临时状态
+typedef struct {
+    FILE* file;
+    uint8_t* is_root;               // 按引用索引的根标记
+    uint32_t root_count;            // 已去重的根数
+    uint32_t* references;           // 当前对象引用的对象
+    size_t reference_count;
+    size_t reference_capacity;
+    bool out_of_memory;
+} heap_dump_state_t;
+
+static void root_visitor(j2me_heap_t* heap, j2me_ref_t ref, void* context) {
+    heap_dump_state_t* state = (heap_dump_state_t*)context;
+    if (j2me_heap_get_object(heap, ref) && !state->is_root[ref]) {
+        state->is_root[ref] = 1;
+        state->root_count++;
+    }
+}
+
+static void reference_visitor(j2me_heap_t* heap, j2me_ref_t ref, void* context) {
+    (void)heap;
+    heap_dump_state_t* state = (heap_dump_state_t*)context;
+    if (state->reference_count == state->reference_capacity) {
+        size_t capacity = state->reference_capacity ? state->reference_capacity * 2 : 64;
+        uint32_t* references = (uint32_t*)realloc(state->references, capacity * sizeof(uint32_t));
+        if (!references) {
+            state->out_of_memory = true;
+            return;
+        }
+        state->references = references;
+        state->reference_capacity = capacity;
+    }
+    state->references[state->reference_count++] = ref;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * @brief 写入数据并补齐到4字节
+ */
+static void write_padded(FILE* file, const void* data, size_t length) {
+    static const uint8_t zeros[4] = {0};
+    if (length > 0) {
+        fwrite(data, 1, length, file);
+    }
+    fwrite(zeros, 1, J2ME_HEAP_DUMP_ALIGN4(length) - length, file);
+}
+
+/**
+ * @brief 写出类名表（只包含快照中出现的类）
+ */
+static uint32_t write_classes(j2me_heap_t* heap, FILE* file, j2me_heap_dump_class_namer_t namer, void* context,
+                              bool* out_of_memory) {
+    uint32_t* class_ids = (uint32_t*)malloc((heap->object_count + 1) * sizeof(uint32_t));
+    if (!class_ids) {
+        *out_of_memory = true;
+        return 0;
+    }
+    
+    size_t count = 0;
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        j2me_heap_object_header_t* obj = heap->objects[ref];
+        if (obj) {
+            class_ids[count++] = obj->class_id;
+        }
+    }
+    qsort(class_ids, count, sizeof(uint32_t), compare_u32);
+    
+    uint32_t written = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && class_ids[i] == class_ids[i - 1]) {
+            continue;
+        }
+        const char* name = j2me_heap_builtin_class_name(class_ids[i]);
+        if (!name && namer) {
+            name = namer(class_ids[i], context);
+        }
+        if (!name) {
+            continue;
+        }
+    
+        j2me_heap_dump_class_t record = { class_ids[i], (uint32_t)strlen(name) };
+        fwrite(&record, sizeof(record), 1, file);
+        write_padded(file, name, record.name_length);
+        written++;
+    }
+    
+    free(class_ids);
+    return written;
+}
+
+j2me_error_t j2me_heap_dump(j2me_heap_t* heap, const char* path, j2me_heap_dump_class_namer_t namer, void* context) {
+    if (!heap || !path) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    if (heap->collecting) {
+        return J2ME_ERROR_INVALID_STATE;
+    }
+    
+    heap_dump_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.is_root = (uint8_t*)calloc(heap->next_ref + 1, 1);
+    if (!state.is_root) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    j2me_error_t result = j2me_heap_visit_roots(heap, root_visitor, &state);
+    if (result != J2ME_SUCCESS) {
+        free(state.is_root);
+        return result;
+    }
+    
+    size_t tmp_size = strlen(path) + 32;
+    char* tmp_path = (char*)malloc(tmp_size);
+    if (!tmp_path) {
+        free(state.is_root);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    snprintf(tmp_path, tmp_size, "%s.tmp.%ld", path, (long)getpid());
+    
+    state.file = fopen(tmp_path, "wb");
+    if (!state.file) {
+        LOG_ERROR("[堆快照] 无法创建文件: %s", tmp_path);
+        free(tmp_path);
+        free(state.is_root);
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    // 文件头最后回填类名数
+    j2me_heap_dump_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = J2ME_HEAP_DUMP_MAGIC;
+    header.version = J2ME_HEAP_DUMP_VERSION;
+    header.endian_tag = J2ME_HEAP_DUMP_ENDIAN_TAG;
+    header.timestamp = (uint64_t)time(NULL);
+    size_t used = 0, total = 0;
+    j2me_heap_get_stats(heap, &used, &total, NULL);
+    header.heap_size = total;
+    header.heap_used = used;
+    header.root_count = state.root_count;
+    header.object_count = (uint32_t)heap->object_count;
+    header.ref_limit = heap->next_ref;
+    fwrite(&header, sizeof(header), 1, state.file);
+    
+    header.class_count = write_classes(heap, state.file, namer, context, &state.out_of_memory);
+    
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        if (state.is_root[ref]) {
+            fwrite(&ref, sizeof(ref), 1, state.file);
+        }
+    }
+    
+    for (j2me_ref_t ref = 1; ref < heap->next_ref && !state.out_of_memory; ref++) {
+        j2me_heap_object_header_t* obj = heap->objects[ref];
+        if (!obj) {
+            continue;
+        }
+    
+        state.reference_count = 0;
+        j2me_heap_visit_references(heap, ref, reference_visitor, &state);
+    
+        // String附带字符内容（重复字符串分析用）；去重后的String不存放字符，只引用规范String
+        const void* payload = NULL;
+        uint32_t payload_length = 0;
+        if (obj->class_id == J2ME_CLASS_STRING && obj->size >= sizeof(j2me_string_data_t)) {
+            j2me_string_data_t* string_data = (j2me_string_data_t*)obj->data;
+            if (string_data->length <= obj->size - sizeof(j2me_string_data_t)) {
+                payload = string_data->chars;
+                payload_length = string_data->length;
+            }
+        }
+    
+        j2me_heap_dump_object_t record;
+        record.ref = ref;
+        record.class_id = obj->class_id;
+        record.size = obj->size;
+        record.block_size = (uint32_t)J2ME_HEAP_BLOCK_SIZE(obj->size);
+        record.flags = obj->flags & ~J2ME_HEAP_FLAG_MARKED;
+        if ((uint8_t*)obj >= heap->nursery && (uint8_t*)obj < heap->nursery + heap->nursery_size) {
+            record.flags |= J2ME_HEAP_DUMP_FLAG_YOUNG;
+        }
+        record.ref_count = obj->ref_count;
+        record.reference_count = (uint32_t)state.reference_count;
+        record.payload_length = payload_length;
+        fwrite(&record, sizeof(record), 1, state.file);
+        if (state.reference_count > 0) {
+            fwrite(state.references, sizeof(uint32_t), state.reference_count, state.file);
+        }
+        write_padded(state.file, payload, payload_length);
+    }
+    
+    // 回填类名数
+    if (!state.out_of_memory) {
+        fseek(state.file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, state.file);
+    }
+    
+    bool write_failed = ferror(state.file) != 0;
+    if (fclose(state.file) != 0) {
+        write_failed = true;
+    }
+    
+    if (state.out_of_memory) {
+        result = J2ME_ERROR_OUT_OF_MEMORY;
+    } else if (write_failed || rename(tmp_path, path) != 0) {
+        result = J2ME_ERROR_IO_EXCEPTION;
+    }
+    if (result != J2ME_SUCCESS) {
+        unlink(tmp_path);
+        LOG_ERROR("[堆快照] 写入失败: %s", path);
+    } else {
+        LOG_INFO("[堆快照] 已写入: %s (%u个对象, %u个根, %u个类)",
+                 path, header.object_count, header.root_count, header.class_count);
+    }
+    
+    free(tmp_path);
+    free(state.references);
+    free(state.is_root);
+    return result;
+}
+
+static const char* vm_class_namer(uint32_t class_id, void* context) {
+    j2me_vm_t* vm = (j2me_vm_t*)context;
+    j2me_class_t* cls = j2me_class_loader_find_class_by_id((j2me_class_loader_t*)vm->class_loader, class_id);
+    return cls ? cls->name : NULL;
+}
+
+j2me_error_t j2me_heap_dump_vm(j2me_vm_t* vm, const char* path) {
+    if (!vm || !vm->heap) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    return j2me_heap_dump(vm->heap, path, vm_class_namer, vm);
+}
+
+static void heap_dump_signal_handler(int signo) {
+    (void)signo;
+    g_heap_dump_requested = 1;
+}
+
+void j2me_heap_dump_install_signal_handler(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = heap_dump_signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR2, &action, NULL) != 0) {
+        LOG_WARN("[堆快照] 无法安装SIGUSR2处理函数");
+    }
+}
+
+void j2me_heap_dump_request(void) {
+    g_heap_dump_requested = 1;
+}
+
+void j2me_heap_dump_poll(j2me_vm_t* vm) {
+    if (!vm || !vm->config.heap_dump_path || !g_heap_dump_requested) {
+        return;
+    }
+    
+    g_heap_dump_requested = 0;
+    j2me_heap_dump_vm(vm, vm->config.heap_dump_path);
+}
@@ -1,8 +1,10 @@
 #include "j2me_method_invocation.h"
 #include "j2me_vm.h"
 #include "j2me_interpreter.h"
+#include "j2me_quicken.h"
 #include "j2me_native_methods.h"
 #include "j2me_string.h"
+#include "j2me_bytecode.h"
 #include "j2me_log.h"
 #include <stdlib.h>
 #include <string.h>
@@ -47,6 +49,7 @@ static bool j2me_stringbuilder_set_value_ref(j2me_vm_t* vm, j2me_ref_t builder_r
     uint8_t* base = (uint8_t*)obj->data;
     j2me_ref_t* value_slot = (j2me_ref_t*)(base + sizeof(void*));
     *value_slot = value_ref;
+    j2me_heap_write_barrier(vm->heap, builder_ref, value_ref);
     return true;
 }
 
@@ -54,894 +57,939 @@ static bool j2me_stringbuilder_set_value_ref(j2me_vm_t* vm, j2me_ref_t builder_r
  * @file j2me_method_invocation_simple.c
  * @brief J2ME方法调用系统简化实现
  * 
- * 简化的方法调用机制，用于测试和基本功能
+ * 简化的方法调用机制，用于测试和基本功能。
+ * 调用分为两步：j2me_method_invocation_resolve_call把方法引用解析为调用目标
+ * （内建实现、Java方法或未解析），j2me_method_invocation_invoke_resolved
+ * 按解析结果执行调用；快速指令缓存解析结果，之后只执行第二步。
  */
 
+// 内建实现参数栈上缓冲区大小，超过时才分配堆内存
+#define INVOKE_ARGS_INLINE_SLOTS 16
+
 /**
- * @brief 调用虚方法（简化实现）
- * @param vm 虚拟机实例
- * @param caller_frame 调用者栈帧
- * @param method_ref_index 方法引用索引
- * @return 错误码
+ * @brief 从常量池方法引用中取出类名、方法名和描述符
+ * @return 方法引用条目无效返回false
  */
-j2me_error_t j2me_method_invocation_invoke_virtual(
-    j2me_vm_t* vm,
-    j2me_stack_frame_t* caller_frame,
-    uint16_t method_ref_index) {
-    
-    if (!vm || !caller_frame) {
-        return J2ME_ERROR_INVALID_PARAMETER;
-    }
-    
-    LOG_DEBUG("[方法调用] invokevirtual: 方法引用索引 #%d\n", method_ref_index);
-    
-    // 获取当前方法信息以访问常量池
-    j2me_method_t* current_method = (j2me_method_t*)caller_frame->method_info;
-    if (!current_method || !current_method->owner_class) {
-        LOG_ERROR("[方法调用] invokevirtual: 无法获取类信息");
-        return J2ME_ERROR_INVALID_PARAMETER;
+static bool get_method_ref_names(j2me_class_t* class_info,
+                                 uint16_t method_ref_index,
+                                 bool allow_interface,
+                                 const char** class_name,
+                                 const char** method_name,
+                                 const char** method_descriptor) {
+    j2me_constant_pool_t* pool = &class_info->constant_pool;
+    *class_name = NULL;
+    *method_name = NULL;
+    *method_descriptor = NULL;
+    
+    if (method_ref_index == 0 || method_ref_index >= pool->count) {
+        return false;
     }
     
-    // 解析方法引用
-    j2me_constant_pool_entry_t* method_ref = 
-        &current_method->owner_class->constant_pool.entries[method_ref_index - 1];
-    
-    if (method_ref->tag != J2ME_CONSTANT_METHODREF) {
-        LOG_ERROR("[方法调用] invokevirtual: 不是方法引用 (类型: %d)", method_ref->tag);
-        return J2ME_ERROR_INVALID_PARAMETER;
+    j2me_constant_pool_entry_t* method_ref = &pool->entries[method_ref_index - 1];
+    if (method_ref->tag != J2ME_CONSTANT_METHODREF &&
+        !(allow_interface && method_ref->tag == J2ME_CONSTANT_INTERFACE_METHODREF)) {
+        return false;
     }
     
     // 解析类名
     uint16_t class_index = method_ref->info.ref_info.class_index;
-    j2me_constant_pool_entry_t* class_entry = 
-        &current_method->owner_class->constant_pool.entries[class_index - 1];
-    
-    const char* class_name = NULL;
-    if (class_entry->tag == J2ME_CONSTANT_CLASS) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[class_entry->info.class_info.name_index - 1];
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            class_name = name_entry->info.utf8.bytes;
+    if (class_index > 0 && class_index < pool->count) {
+        j2me_constant_pool_entry_t* class_entry = &pool->entries[class_index - 1];
+        if (class_entry->tag == J2ME_CONSTANT_CLASS) {
+            j2me_constant_pool_entry_t* name_entry = &pool->entries[class_entry->info.class_info.name_index - 1];
+            if (name_entry->tag == J2ME_CONSTANT_UTF8) {
+                *class_name = name_entry->info.utf8.bytes;
+            }
         }
     }
     
     // 解析方法名和描述符
     uint16_t name_and_type_index = method_ref->info.ref_info.name_and_type_index;
-    j2me_constant_pool_entry_t* name_and_type = 
-        &current_method->owner_class->constant_pool.entries[name_and_type_index - 1];
+    if (name_and_type_index > 0 && name_and_type_index < pool->count) {
+        j2me_constant_pool_entry_t* name_and_type = &pool->entries[name_and_type_index - 1];
+        if (name_and_type->tag == J2ME_CONSTANT_NAME_AND_TYPE) {
+            j2me_constant_pool_entry_t* name_entry = 
+                &pool->entries[name_and_type->info.name_and_type_info.name_index - 1];
+            j2me_constant_pool_entry_t* desc_entry = 
+                &pool->entries[name_and_type->info.name_and_type_info.descriptor_index - 1];
+            
+            if (name_entry->tag == J2ME_CONSTANT_UTF8) {
+                *method_name = name_entry->info.utf8.bytes;
+            }
+            if (desc_entry->tag == J2ME_CONSTANT_UTF8) {
+                *method_descriptor = desc_entry->info.utf8.bytes;
+            }
+        }
+    }
     
-    const char* method_name = NULL;
-    const char* method_descriptor = NULL;
+    return true;
+}
+
+/**
+ * @brief 根据方法描述符计算参数占用的槽位数（不包括this）
+ */
+static int count_argument_slots(const char* method_descriptor) {
+    int param_count = 0;
+    if (!method_descriptor) {
+        return 0;
+    }
     
-    if (name_and_type->tag == J2ME_CONSTANT_NAME_AND_TYPE) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.name_index - 1];
-        j2me_constant_pool_entry_t* desc_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.descriptor_index - 1];
-        
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_name = name_entry->info.utf8.bytes;
+    const char* p = strchr(method_descriptor, '(');
+    if (!p) {
+        return 0;
+    }
+    
+    p++; // 跳过'('
+    while (*p && *p != ')') {
+        switch (*p) {
+            case 'I': case 'Z': case 'B': case 'C': case 'S': case 'F':
+                param_count++;
+                p++;
+                break;
+            case 'J': case 'D': // long和double占用两个槽位
+                param_count += 2;
+                p++;
+                break;
+            case 'L': // 对象引用
+                param_count++;
+                while (*p && *p != ';') p++;
+                if (*p == ';') p++;
+                break;
+            case '[': // 数组
+                param_count++;
+                p++;
+                while (*p == '[') p++;
+                if (*p == 'L') {
+                    while (*p && *p != ';') p++;
+                    if (*p == ';') p++;
+                } else {
+                    p++;
+                }
+                break;
+            default:
+                p++;
+                break;
         }
-        if (desc_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_descriptor = desc_entry->info.utf8.bytes;
+    }
+    
+    return param_count;
+}
+
+// ============================================================================
+// 内建实现：直接操作调用者操作数栈，签名与本地方法一致
+// ============================================================================
+
+/**
+ * @brief Display.setCurrent(Displayable)
+ */
+static j2me_error_t builtin_display_set_current(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    LOG_DEBUG("[方法调用] Display.setCurrent: 栈深度=%d\n", caller_frame->operand_stack.top);
+    
+    // 弹出Displayable参数（Canvas）
+    j2me_int canvas_ref = 0;
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &canvas_ref);
+        LOG_DEBUG("[方法调用] Display.setCurrent: 弹出Canvas参数=0x%x\n", canvas_ref);
+    }
+    
+    // 弹出Display的this引用
+    j2me_int display_ref = 0;
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &display_ref);
+        LOG_DEBUG("[方法调用] Display.setCurrent: 弹出Display引用=0x%x\n", display_ref);
+    }
+    
+    // 如果Canvas引用是假引用或0，尝试使用VM中最后创建的Canvas对象
+    if (canvas_ref == 0 || canvas_ref == 0x87654321 || canvas_ref == 0x12345678 || canvas_ref == 0x11223344) {
+        LOG_DEBUG("[方法调用] Display.setCurrent: Canvas引用无效，使用VM中最后创建的Canvas对象\n");
+        if (vm && vm->last_canvas_object_ref != 0) {
+            canvas_ref = vm->last_canvas_object_ref;
+            LOG_DEBUG("[方法调用] Display.setCurrent: 使用Canvas对象引用 0x%x\n", canvas_ref);
         }
     }
     
-    LOG_DEBUG("[方法调用] invokevirtual: %s.%s%s\n",
-              class_name ? class_name : "未知类",
-              method_name ? method_name : "未知方法",
-              method_descriptor ? method_descriptor : "");
+    // 保存当前Canvas到VM
+    vm->current_canvas_ref = canvas_ref;
     
-    // 特殊处理Display.setCurrent()
-    if (class_name && method_name &&
-        strcmp(class_name, "javax/microedition/lcdui/Display") == 0 &&
-        strcmp(method_name, "setCurrent") == 0) {
-        
-        LOG_DEBUG("[方法调用] Display.setCurrent: 栈深度=%d\n", caller_frame->operand_stack.top);
-        
-        // 弹出Displayable参数（Canvas）
-        j2me_int canvas_ref = 0;
-        if (caller_frame->operand_stack.top > 0) {
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &canvas_ref);
-            LOG_DEBUG("[方法调用] Display.setCurrent: 弹出Canvas参数=0x%x\n", canvas_ref);
+    LOG_DEBUG("[方法调用] Display.setCurrent: Canvas=0x%x\n", canvas_ref);
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief Display.getDisplay(MIDlet)
+ */
+static j2me_error_t builtin_display_get_display(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    // 弹出MIDlet参数
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_int midlet_ref;
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &midlet_ref);
+    }
+    
+    // 返回Display对象引用（使用vm->display的地址）
+    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)(uintptr_t)vm->display);
+}
+
+/**
+ * @brief 未实现的Graphics方法：只弹出this引用
+ */
+static j2me_error_t builtin_graphics_unknown(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_int this_ref;
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+    }
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 未实现的方法：不改变操作数栈
+ */
+static j2me_error_t builtin_noop(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief StringBuilder.append(String)
+ */
+static j2me_error_t builtin_stringbuilder_append_string(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int arg_ref_int = 0;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &arg_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+
+    j2me_int this_ref_int = 0;
+    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+
+    j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
+    j2me_ref_t current = J2ME_NULL_REF;
+    j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
+    if (current == J2ME_NULL_REF) {
+        current = j2me_heap_string_create(vm->heap, "");
+    }
+    // 后面的分配可能触发回收，只被这里持有的临时字符串先retain
+    j2me_heap_retain(vm->heap, current);
+
+    j2me_ref_t arg_ref = (j2me_ref_t)arg_ref_int;
+    if (arg_ref == J2ME_NULL_REF) {
+        arg_ref = j2me_heap_string_create(vm->heap, "null");
+    }
+    j2me_heap_retain(vm->heap, arg_ref);
+
+    j2me_ref_t combined = j2me_heap_string_concat(vm->heap, current, arg_ref);
+    j2me_stringbuilder_set_value_ref(vm, this_ref, combined);
+    j2me_heap_release(vm->heap, arg_ref);
+    j2me_heap_release(vm->heap, current);
+
+    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)this_ref);
+}
+
+/**
+ * @brief StringBuilder.append(int)
+ */
+static j2me_error_t builtin_stringbuilder_append_int(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int int_value = 0;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &int_value);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+
+    j2me_int this_ref_int = 0;
+    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%d", int_value);
+    j2me_ref_t arg_ref = j2me_heap_string_create(vm->heap, buf);
+    // 后面的分配可能触发回收，只被这里持有的临时字符串先retain
+    j2me_heap_retain(vm->heap, arg_ref);
+
+    j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
+    j2me_ref_t current = J2ME_NULL_REF;
+    j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
+    if (current == J2ME_NULL_REF) {
+        current = j2me_heap_string_create(vm->heap, "");
+    }
+    j2me_heap_retain(vm->heap, current);
+
+    j2me_ref_t combined = j2me_heap_string_concat(vm->heap, current, arg_ref);
+    j2me_stringbuilder_set_value_ref(vm, this_ref, combined);
+    j2me_heap_release(vm->heap, current);
+    j2me_heap_release(vm->heap, arg_ref);
+
+    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)this_ref);
+}
+
+/**
+ * @brief StringBuilder.toString()
+ */
+static j2me_error_t builtin_stringbuilder_to_string(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref_int = 0;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
+    j2me_ref_t current = J2ME_NULL_REF;
+    j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
+    if (current == J2ME_NULL_REF) {
+        current = j2me_heap_string_create(vm->heap, "");
+        j2me_stringbuilder_set_value_ref(vm, this_ref, current);
+    }
+    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)current);
+}
+
+/**
+ * @brief StringBuilder.<init>() 及未识别的构造方法
+ */
+static j2me_error_t builtin_stringbuilder_init(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref_int = 0;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    j2me_ref_t empty = j2me_heap_string_create(vm->heap, "");
+    j2me_stringbuilder_set_value_ref(vm, (j2me_ref_t)this_ref_int, empty);
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief StringBuilder.<init>(String)
+ */
+static j2me_error_t builtin_stringbuilder_init_string(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int arg_ref_int = 0;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &arg_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    j2me_int this_ref_int = 0;
+    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    j2me_ref_t initial = (j2me_ref_t)arg_ref_int;
+    if (initial == J2ME_NULL_REF) {
+        initial = j2me_heap_string_create(vm->heap, "null");
+    }
+    j2me_stringbuilder_set_value_ref(vm, (j2me_ref_t)this_ref_int, initial);
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief String.length()（简化实现）
+ */
+static j2me_error_t builtin_string_length(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    
+    // 返回一个假的字符串长度
+    j2me_int length = 10; // 假的字符串长度
+    return j2me_operand_stack_push(&caller_frame->operand_stack, length);
+}
+
+/**
+ * @brief String.charAt(int)（简化实现）
+ */
+static j2me_error_t builtin_string_char_at(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    
+    // 弹出索引参数
+    j2me_int index;
+    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &index);
+    if (result == J2ME_SUCCESS) {
+        // 返回一个假的字符
+        j2me_int ch = 'A'; // 假的字符
+        result = j2me_operand_stack_push(&caller_frame->operand_stack, ch);
+    }
+    return result;
+}
+
+/**
+ * @brief String.substring(int, int)（简化实现）
+ */
+static j2me_error_t builtin_string_substring(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref;
+    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    
+    // 弹出endIndex和startIndex参数
+    j2me_int end_index, start_index;
+    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &end_index);
+    if (result == J2ME_SUCCESS) {
+        result = j2me_operand_stack_pop(&caller_frame->operand_stack, &start_index);
+        if (result == J2ME_SUCCESS) {
+            // 返回一个假的字符串引用
+            j2me_int substring_ref = 0x30000001;
+            result = j2me_operand_stack_push(&caller_frame->operand_stack, substring_ref);
         }
+    }
+    return result;
+}
+
+/**
+ * @brief 未实现的String方法：只弹出this引用
+ */
+static j2me_error_t builtin_string_unknown(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    j2me_int this_ref;
+    return j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+}
+
+/**
+ * @brief Thread.<init>(Runnable)
+ */
+static j2me_error_t builtin_thread_init_runnable(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    // 弹出Runnable参数
+    j2me_int runnable_ref = 0;
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &runnable_ref);
+        LOG_DEBUG("[方法调用] Thread.<init>: Runnable=0x%x (从栈)\n", runnable_ref);
         
-        // 弹出Display的this引用
-        j2me_int display_ref = 0;
-        if (caller_frame->operand_stack.top > 0) {
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &display_ref);
-            LOG_DEBUG("[方法调用] Display.setCurrent: 弹出Display引用=0x%x\n", display_ref);
+        // 如果从栈弹出的是0，尝试使用VM中保存的最后一个对象引用
+        if (runnable_ref == 0 && vm && vm->last_method_has_return_value) {
+            runnable_ref = vm->last_method_return_value;
+            LOG_DEBUG("[方法调用] Thread.<init>: 使用VM中的对象引用 0x%x\n", runnable_ref);
         }
         
-        // 如果Canvas引用是假引用或0，尝试使用VM中最后创建的Canvas对象
-        if (canvas_ref == 0 || canvas_ref == 0x87654321 || canvas_ref == 0x12345678 || canvas_ref == 0x11223344) {
-            LOG_DEBUG("[方法调用] Display.setCurrent: Canvas引用无效，使用VM中最后创建的Canvas对象\n");
-            if (vm && vm->last_canvas_object_ref != 0) {
-                canvas_ref = vm->last_canvas_object_ref;
-                LOG_DEBUG("[方法调用] Display.setCurrent: 使用Canvas对象引用 0x%x\n", canvas_ref);
-            }
+        // 保存Runnable引用到VM的专用字段，以便Thread.start()使用
+        if (vm && runnable_ref != 0) {
+            vm->current_runnable_ref = runnable_ref;
+            LOG_DEBUG("[方法调用] Thread.<init>: 保存Runnable到VM (0x%x)\n", runnable_ref);
         }
-        
-        // 保存当前Canvas到VM
-        vm->current_canvas_ref = canvas_ref;
-        
-        LOG_DEBUG("[方法调用] Display.setCurrent: Canvas=0x%x\n", canvas_ref);
-        return J2ME_SUCCESS;
     }
     
-    // 特殊处理PrintStream.println()
-    if (class_name && method_name &&
-        strcmp(class_name, "java/io/PrintStream") == 0 &&
-        strcmp(method_name, "println") == 0) {
-        
-        LOG_DEBUG("[方法调用] PrintStream.println: 调用本地方法\n");
-        // 调用本地方法实现
-        return java_system_out_println(vm, caller_frame, NULL);
+    // 弹出Thread的this引用
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_int thread_ref;
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &thread_ref);
     }
     
-    // 特殊处理PrintStream.print()
-    if (class_name && method_name &&
-        strcmp(class_name, "java/io/PrintStream") == 0 &&
-        strcmp(method_name, "print") == 0) {
-        
-        LOG_DEBUG("[方法调用] PrintStream.print: 调用本地方法\n");
-        // 调用本地方法实现
-        return java_system_out_print(vm, caller_frame, NULL);
+    LOG_DEBUG("[方法调用] Thread.<init>: 线程初始化完成\n");
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief Thread.<init>()：只弹出this引用
+ */
+static j2me_error_t builtin_thread_init(j2me_vm_t* vm, j2me_stack_frame_t* caller_frame, void* args) {
+    if (caller_frame->operand_stack.top > 0) {
+        j2me_int thread_ref;
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &thread_ref);
     }
     
-    // 如果是Graphics方法，调用相应的本地方法
-    if (class_name && strstr(class_name, "Graphics")) {
+    LOG_DEBUG("[方法调用] Thread.<init>: 线程初始化完成\n");
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 查找invokevirtual的内建实现
+ * @return 内建实现，没有返回NULL
+ */
+static j2me_native_method_func_t find_virtual_builtin(const char* class_name,
+                                                      const char* method_name,
+                                                      const char* method_descriptor) {
+    if (!class_name) {
+        return NULL;
+    }
+    
+    if (method_name && strcmp(class_name, "javax/microedition/lcdui/Display") == 0 &&
+        strcmp(method_name, "setCurrent") == 0) {
+        return builtin_display_set_current;
+    }
+    
+    if (method_name && strcmp(class_name, "java/io/PrintStream") == 0) {
+        if (strcmp(method_name, "println") == 0) {
+            return java_system_out_println;
+        }
+        if (strcmp(method_name, "print") == 0) {
+            return java_system_out_print;
+        }
+    }
+    
+    // Graphics方法，调用相应的本地方法
+    if (strstr(class_name, "Graphics")) {
         if (method_name && method_descriptor) {
-            // 根据方法名调用相应的Graphics本地方法
             if (strcmp(method_name, "setColor") == 0) {
                 if (strcmp(method_descriptor, "(III)V") == 0) {
-                    return midp_graphics_set_color_rgb(vm, caller_frame, NULL);
+                    return midp_graphics_set_color_rgb;
                 } else if (strcmp(method_descriptor, "(I)V") == 0) {
-                    return midp_graphics_set_color(vm, caller_frame, NULL);
+                    return midp_graphics_set_color;
                 }
             } else if (strcmp(method_name, "drawLine") == 0 && strcmp(method_descriptor, "(IIII)V") == 0) {
-                return midp_graphics_draw_line(vm, caller_frame, NULL);
+                return midp_graphics_draw_line;
             } else if (strcmp(method_name, "drawRect") == 0 && strcmp(method_descriptor, "(IIII)V") == 0) {
-                return midp_graphics_draw_rect(vm, caller_frame, NULL);
+                return midp_graphics_draw_rect;
             } else if (strcmp(method_name, "fillRect") == 0 && strcmp(method_descriptor, "(IIII)V") == 0) {
-                return midp_graphics_fill_rect(vm, caller_frame, NULL);
+                return midp_graphics_fill_rect;
             } else if (strcmp(method_name, "drawString") == 0 && strcmp(method_descriptor, "(Ljava/lang/String;II)V") == 0) {
-                return midp_graphics_draw_string(vm, caller_frame, NULL);
+                return midp_graphics_draw_string;
             } else if (strcmp(method_name, "drawOval") == 0 && strcmp(method_descriptor, "(IIII)V") == 0) {
-                return midp_graphics_draw_oval(vm, caller_frame, NULL);
+                return midp_graphics_draw_oval;
             } else if (strcmp(method_name, "fillOval") == 0 && strcmp(method_descriptor, "(IIII)V") == 0) {
-                return midp_graphics_fill_oval(vm, caller_frame, NULL);
+                return midp_graphics_fill_oval;
             } else if (strcmp(method_name, "drawArc") == 0 && strcmp(method_descriptor, "(IIIII)V") == 0) {
-                return midp_graphics_draw_arc(vm, caller_frame, NULL);
+                return midp_graphics_draw_arc;
             } else if (strcmp(method_name, "drawImage") == 0 && strcmp(method_descriptor, "(Ljavax/microedition/lcdui/Image;III)V") == 0) {
-                return midp_graphics_draw_image(vm, caller_frame, NULL);
+                return midp_graphics_draw_image;
             }
         }
         
         // 未知的Graphics方法，弹出this引用并返回成功
-        if (caller_frame->operand_stack.top > 0) {
-            j2me_int this_ref;
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
-            // printf("[方法调用] invokevirtual: 弹出Graphics引用 0x%x\n", this_ref);
-        }
-        // printf("[方法调用] invokevirtual: Graphics方法调用完成 (简化实现)\n");
-        return J2ME_SUCCESS;
+        return builtin_graphics_unknown;
     }
     
-    // 如果是String方法，调用相应的本地方法
-    if (class_name && strcmp(class_name, "java/lang/StringBuilder") == 0) {
+    if (strcmp(class_name, "java/lang/StringBuilder") == 0) {
         if (method_name && method_descriptor) {
             if (strcmp(method_name, "append") == 0) {
                 if (strcmp(method_descriptor, "(Ljava/lang/String;)Ljava/lang/StringBuilder;") == 0) {
-                    j2me_int arg_ref_int = 0;
-                    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &arg_ref_int);
-                    if (result != J2ME_SUCCESS) {
-                        return result;
-                    }
-
-                    j2me_int this_ref_int = 0;
-                    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-                    if (result != J2ME_SUCCESS) {
-                        return result;
-                    }
-
-                    j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
-                    j2me_ref_t current = J2ME_NULL_REF;
-                    j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
-                    if (current == J2ME_NULL_REF) {
-                        current = j2me_heap_string_create(vm->heap, "");
-                    }
-
-                    j2me_ref_t arg_ref = (j2me_ref_t)arg_ref_int;
-                    if (arg_ref == J2ME_NULL_REF) {
-                        arg_ref = j2me_heap_string_create(vm->heap, "null");
-                    }
-
-                    j2me_ref_t combined = j2me_heap_string_concat(vm->heap, current, arg_ref);
-                    j2me_stringbuilder_set_value_ref(vm, this_ref, combined);
-
-                    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)this_ref);
+                    return builtin_stringbuilder_append_string;
                 }
-
                 if (strcmp(method_descriptor, "(I)Ljava/lang/StringBuilder;") == 0) {
-                    j2me_int int_value = 0;
-                    j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &int_value);
-                    if (result != J2ME_SUCCESS) {
-                        return result;
-                    }
-
-                    j2me_int this_ref_int = 0;
-                    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-                    if (result != J2ME_SUCCESS) {
-                        return result;
-                    }
-
-                    char buf[32];
-                    snprintf(buf, sizeof(buf), "%d", int_value);
-                    j2me_ref_t arg_ref = j2me_heap_string_create(vm->heap, buf);
-
-                    j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
-                    j2me_ref_t current = J2ME_NULL_REF;
-                    j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
-                    if (current == J2ME_NULL_REF) {
-                        current = j2me_heap_string_create(vm->heap, "");
-                    }
-
-                    j2me_ref_t combined = j2me_heap_string_concat(vm->heap, current, arg_ref);
-                    j2me_stringbuilder_set_value_ref(vm, this_ref, combined);
-
-                    return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)this_ref);
+                    return builtin_stringbuilder_append_int;
                 }
             }
-
             if (strcmp(method_name, "toString") == 0 && strcmp(method_descriptor, "()Ljava/lang/String;") == 0) {
-                j2me_int this_ref_int = 0;
-                j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-                if (result != J2ME_SUCCESS) {
-                    return result;
-                }
-                j2me_ref_t this_ref = (j2me_ref_t)this_ref_int;
-                j2me_ref_t current = J2ME_NULL_REF;
-                j2me_stringbuilder_get_value_ref(vm, this_ref, &current);
-                if (current == J2ME_NULL_REF) {
-                    current = j2me_heap_string_create(vm->heap, "");
-                    j2me_stringbuilder_set_value_ref(vm, this_ref, current);
-                }
-                return j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)current);
+                return builtin_stringbuilder_to_string;
             }
         }
-        return J2ME_SUCCESS;
+        return builtin_noop;
     }
-
-    if (class_name && strcmp(class_name, "java/lang/String") == 0) {
+    
+    if (strcmp(class_name, "java/lang/String") == 0) {
         if (method_name && method_descriptor) {
-            // 弹出this引用
-            j2me_int this_ref;
-            j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
-            if (result != J2ME_SUCCESS) {
-                return result;
-            }
-            
-            // 根据方法名调用相应的String本地方法
             if (strcmp(method_name, "length") == 0 && strcmp(method_descriptor, "()I") == 0) {
-                // 返回一个假的字符串长度
-                j2me_int length = 10; // 假的字符串长度
-                result = j2me_operand_stack_push(&caller_frame->operand_stack, length);
-                // printf("[方法调用] invokevirtual: String.length() 返回 %d\n", length);
-                return result;
+                return builtin_string_length;
             } else if (strcmp(method_name, "charAt") == 0 && strcmp(method_descriptor, "(I)C") == 0) {
-                // 弹出索引参数
-                j2me_int index;
-                result = j2me_operand_stack_pop(&caller_frame->operand_stack, &index);
-                if (result == J2ME_SUCCESS) {
-                    // 返回一个假的字符
-                    j2me_int ch = 'A'; // 假的字符
-                    result = j2me_operand_stack_push(&caller_frame->operand_stack, ch);
-                    // printf("[方法调用] invokevirtual: String.charAt(%d) 返回 '%c'\n", index, ch);
-                }
-                return result;
+                return builtin_string_char_at;
             } else if (strcmp(method_name, "substring") == 0 && strcmp(method_descriptor, "(II)Ljava/lang/String;") == 0) {
-                // 弹出endIndex和startIndex参数
-                j2me_int end_index, start_index;
-                result = j2me_operand_stack_pop(&caller_frame->operand_stack, &end_index);
-                if (result == J2ME_SUCCESS) {
-                    result = j2me_operand_stack_pop(&caller_frame->operand_stack, &start_index);
-                    if (result == J2ME_SUCCESS) {
-                        // 返回一个假的字符串引用
-                        j2me_int substring_ref = 0x30000001;
-                        result = j2me_operand_stack_push(&caller_frame->operand_stack, substring_ref);
-                        // printf("[方法调用] invokevirtual: String.substring(%d,%d) 返回 0x%x\n", 
-                        //        start_index, end_index, substring_ref);
-                    }
-                }
-                return result;
+                return builtin_string_substring;
             }
+            return builtin_string_unknown;
         }
-        
-        // 未知的String方法，返回成功
-        // printf("[方法调用] invokevirtual: String方法调用完成 (简化实现)\n");
-        return J2ME_SUCCESS;
-    }
-    
-    // 其他方法，尝试查找并执行
-    // 首先弹出this引用
-    j2me_int this_ref = 0;
-    if (caller_frame->operand_stack.top > 0) {
-        j2me_error_t pop_result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
-        if (pop_result != J2ME_SUCCESS) {
-            return pop_result;
-        }
+        return builtin_noop;
     }
     
-    // 解析方法描述符，确定参数数量（不包括this）
-    int param_count = 0;
-    if (method_descriptor) {
-        const char* p = strchr(method_descriptor, '(');
-        if (p) {
-            p++; // 跳过'('
-            while (*p && *p != ')') {
-                switch (*p) {
-                    case 'I': case 'Z': case 'B': case 'C': case 'S': case 'F':
-                        param_count++;
-                        p++;
-                        break;
-                    case 'J': case 'D': // long和double占用两个槽位
-                        param_count += 2;
-                        p++;
-                        break;
-                    case 'L': // 对象引用
-                        param_count++;
-                        while (*p && *p != ';') p++;
-                        if (*p == ';') p++;
-                        break;
-                    case '[': // 数组
-                        param_count++;
-                        p++;
-                        while (*p == '[') p++;
-                        if (*p == 'L') {
-                            while (*p && *p != ';') p++;
-                            if (*p == ';') p++;
-                        } else {
-                            p++;
-                        }
-                        break;
-                    default:
-                        p++;
-                        break;
-                }
-            }
-        }
+    return NULL;
+}
+
+/**
+ * @brief 查找invokespecial的内建实现
+ * @return 内建实现，没有返回NULL
+ */
+static j2me_native_method_func_t find_special_builtin(const char* class_name,
+                                                      const char* method_name,
+                                                      const char* method_descriptor) {
+    if (!class_name || !method_name || strcmp(method_name, "<init>") != 0) {
+        return NULL;
     }
     
-    // 从调用者栈中弹出参数
-    j2me_int* args = NULL;
-    if (param_count > 0) {
-        args = (j2me_int*)malloc(sizeof(j2me_int) * param_count);
-        if (args) {
-            // 从栈中弹出参数（注意顺序：最后一个参数在栈顶）
-            for (int i = param_count - 1; i >= 0; i--) {
-                if (j2me_operand_stack_pop(&caller_frame->operand_stack, &args[i]) != J2ME_SUCCESS) {
-                    LOG_WARN("[方法调用] invokevirtual: 警告：弹出参数失败");
-                    args[i] = 0;
-                }
-            }
-            LOG_DEBUG("[方法调用] invokevirtual: 从栈弹出%d个参数\n", param_count);
+    if (strcmp(class_name, "java/lang/Thread") == 0) {
+        if (method_descriptor && strstr(method_descriptor, "Runnable")) {
+            return builtin_thread_init_runnable;
         }
+        return builtin_thread_init;
     }
     
-    // 查找并调用方法
-    j2me_class_t* target_class = j2me_class_loader_find_class(vm->class_loader, class_name);
-    if (!target_class) {
-        LOG_DEBUG("[方法调用] invokevirtual: 类未加载，尝试加载类 %s\n", class_name);
-        target_class = j2me_class_loader_load_class(vm->class_loader, class_name);
-    }
-    
-    if (target_class) {
-        LOG_DEBUG("[方法调用] invokevirtual: 找到类 %s\n", class_name);
-        j2me_method_t* target_method = j2me_class_find_method(target_class, method_name, method_descriptor);
-        if (target_method) {
-            LOG_DEBUG("[方法调用] invokevirtual: 找到方法 %s%s，开始执行\n", method_name, method_descriptor);
-            j2me_error_t exec_result = j2me_interpreter_execute_method(vm, target_method, (void*)(intptr_t)this_ref, args);
-            
-            // 释放参数数组
-            if (args) {
-                free(args);
-            }
-            
-            if (exec_result != J2ME_SUCCESS) {
-                LOG_ERROR("[方法调用] invokevirtual: 方法执行失败 (错误: %d)", exec_result);
-                return exec_result;
-            }
-            return exec_result;
-        } else {
-            LOG_DEBUG("[方法调用] invokevirtual: 未找到方法 %s%s\n", method_name, method_descriptor);
+    if (strcmp(class_name, "java/lang/StringBuilder") == 0) {
+        if (method_descriptor && strcmp(method_descriptor, "(Ljava/lang/String;)V") == 0) {
+            return builtin_stringbuilder_init_string;
         }
-    } else {
-        LOG_ERROR("[方法调用] invokevirtual: 无法加载类 %s", class_name);
-    }
-    
-    // 释放参数数组
-    if (args) {
-        free(args);
+        return builtin_stringbuilder_init;
     }
     
-    LOG_DEBUG("[方法调用] invokevirtual: 方法调用完成 (简化实现)\n");
-    return J2ME_SUCCESS;
+    return NULL;
 }
 
 /**
- * @brief 调用静态方法（简化实现）
- * @param vm 虚拟机实例
- * @param caller_frame 调用者栈帧
- * @param method_ref_index 方法引用索引
- * @return 错误码
+ * @brief 在本地方法注册表中查找方法（依次尝试引用的类名和已加载类的父类名）
  */
-j2me_error_t j2me_method_invocation_invoke_static(
-    j2me_vm_t* vm,
-    j2me_stack_frame_t* caller_frame,
-    uint16_t method_ref_index) {
-    
-    if (!vm || !caller_frame) {
-        return J2ME_ERROR_INVALID_PARAMETER;
+static j2me_native_method_func_t find_registered_native(j2me_vm_t* vm, j2me_class_t* target_class,
+                                                        const char* class_name, const char* method_name,
+                                                        const char* method_descriptor) {
+    if (!class_name || !method_name || !method_descriptor) {
+        return NULL;
     }
     
-    // 获取当前方法信息以访问常量池
-    j2me_method_t* current_method = (j2me_method_t*)caller_frame->method_info;
-    if (!current_method || !current_method->owner_class) {
-        return J2ME_ERROR_INVALID_PARAMETER;
+    j2me_native_method_func_t native = j2me_native_method_lookup(vm, class_name, method_name, method_descriptor);
+    for (j2me_class_t* c = target_class; !native && c && c->super_name; c = c->super_class_ptr) {
+        native = j2me_native_method_lookup(vm, c->super_name, method_name, method_descriptor);
     }
-    
-    // 解析方法引用
-    j2me_constant_pool_entry_t* method_ref = 
-        &current_method->owner_class->constant_pool.entries[method_ref_index - 1];
-    
-    if (method_ref->tag != J2ME_CONSTANT_METHODREF) {
+    return native;
+}
+
+j2me_error_t j2me_method_invocation_resolve_call(j2me_vm_t* vm,
+                                                 j2me_class_t* caller_class,
+                                                 uint8_t opcode,
+                                                 uint16_t method_ref_index,
+                                                 uint8_t count,
+                                                 j2me_resolved_call_t* call) {
+    if (!vm || !caller_class || !call) {
         return J2ME_ERROR_INVALID_PARAMETER;
     }
     
-    // 解析类名
-    uint16_t class_index = method_ref->info.ref_info.class_index;
-    j2me_constant_pool_entry_t* class_entry = 
-        &current_method->owner_class->constant_pool.entries[class_index - 1];
+    memset(call, 0, sizeof(j2me_resolved_call_t));
     
     const char* class_name = NULL;
-    if (class_entry->tag == J2ME_CONSTANT_CLASS) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[class_entry->info.class_info.name_index - 1];
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            class_name = name_entry->info.utf8.bytes;
-        }
-    }
-    
-    // 解析方法名和描述符
-    uint16_t name_and_type_index = method_ref->info.ref_info.name_and_type_index;
-    j2me_constant_pool_entry_t* name_and_type = 
-        &current_method->owner_class->constant_pool.entries[name_and_type_index - 1];
-    
     const char* method_name = NULL;
     const char* method_descriptor = NULL;
     
-    if (name_and_type->tag == J2ME_CONSTANT_NAME_AND_TYPE) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.name_index - 1];
-        j2me_constant_pool_entry_t* desc_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.descriptor_index - 1];
+    if (opcode == OPCODE_INVOKEINTERFACE) {
+        // 接口方法调用：弹出this和其余count-1个参数，执行时按接收者的接口方法表分派
+        call->kind = J2ME_CALL_UNRESOLVED;
+        call->has_receiver = true;
+        call->arg_slots = count > 0 ? count - 1 : 0;
+        if (!get_method_ref_names(caller_class, method_ref_index, true, &class_name, &method_name, &method_descriptor) ||
+            !class_name || !method_name) {
+            return J2ME_SUCCESS;
+        }
+        
+        // 系统接口由本地实现提供，保持只弹出参数
+        if (strncmp(class_name, "java/", 5) == 0 || strncmp(class_name, "javax/", 6) == 0) {
+            return J2ME_SUCCESS;
+        }
         
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_name = name_entry->info.utf8.bytes;
+        j2me_class_t* interface_class = j2me_class_loader_find_class(vm->class_loader, class_name);
+        if (!interface_class) {
+            interface_class = j2me_class_loader_load_class(vm->class_loader, class_name);
         }
-        if (desc_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_descriptor = desc_entry->info.utf8.bytes;
+        j2me_method_t* interface_method = interface_class ?
+            j2me_class_find_method(interface_class, method_name, method_descriptor) : NULL;
+        if (interface_method) {
+            call->kind = J2ME_CALL_METHOD;
+            call->method = interface_method;
+            call->flags |= J2ME_CALL_FLAG_INTERFACE;
         }
+        return J2ME_SUCCESS;
     }
     
-    // printf("[方法调用] invokestatic: %s.%s%s\n", 
-    //        class_name ? class_name : "未知类",
-    //        method_name ? method_name : "未知方法",
-    //        method_descriptor ? method_descriptor : "");
+    if (!get_method_ref_names(caller_class, method_ref_index, false, &class_name, &method_name, &method_descriptor)) {
+        LOG_ERROR("[方法调用] 方法引用 #%d 无效", method_ref_index);
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
     
-    // 特殊处理Display.getDisplay()
-    if (class_name && method_name && 
-        strcmp(class_name, "javax/microedition/lcdui/Display") == 0 &&
-        strcmp(method_name, "getDisplay") == 0) {
-        
-        // 弹出MIDlet参数
-        if (caller_frame->operand_stack.top > 0) {
-            j2me_int midlet_ref;
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &midlet_ref);
-        }
-        
-        // 返回Display对象引用（使用vm->display的地址）
-        if (vm->display) {
-            j2me_operand_stack_push(&caller_frame->operand_stack, (j2me_int)(uintptr_t)vm->display);
-            return J2ME_SUCCESS;
-        }
+    LOG_DEBUG("[方法调用] 解析调用 0x%02x: %s.%s%s\n", opcode,
+              class_name ? class_name : "未知类",
+              method_name ? method_name : "未知方法",
+              method_descriptor ? method_descriptor : "");
+    
+    // 内建实现直接操作调用者栈
+    j2me_native_method_func_t builtin = NULL;
+    if (opcode == OPCODE_INVOKEVIRTUAL) {
+        builtin = find_virtual_builtin(class_name, method_name, method_descriptor);
+    } else if (opcode == OPCODE_INVOKESPECIAL) {
+        builtin = find_special_builtin(class_name, method_name, method_descriptor);
+    } else if (opcode == OPCODE_INVOKESTATIC && vm->display && class_name && method_name &&
+               strcmp(class_name, "javax/microedition/lcdui/Display") == 0 &&
+               strcmp(method_name, "getDisplay") == 0) {
+        builtin = builtin_display_get_display;
     }
     
-    // 查找并调用静态方法，如果类未找到则尝试加载
+    if (builtin) {
+        call->kind = J2ME_CALL_BUILTIN;
+        call->builtin = builtin;
+        return J2ME_SUCCESS;
+    }
+    
+    call->kind = J2ME_CALL_UNRESOLVED;
+    call->has_receiver = opcode != OPCODE_INVOKESTATIC;
+    call->arg_slots = (uint16_t)count_argument_slots(method_descriptor);
+    
+    // 查找目标类，如果类未找到则尝试加载
     j2me_class_t* target_class = j2me_class_loader_find_class(vm->class_loader, class_name);
     if (!target_class) {
-        LOG_DEBUG("[方法调用] invokestatic: 类未加载，尝试加载类 %s\n", class_name);
+        // 特殊处理java/lang/Object - 如果找不到就跳过
+        if (opcode == OPCODE_INVOKESPECIAL && class_name && strcmp(class_name, "java/lang/Object") == 0) {
+            LOG_DEBUG("[方法调用] invokespecial: java/lang/Object.<init> - 跳过\n");
+            return J2ME_SUCCESS;
+        }
+        
+        LOG_DEBUG("[方法调用] 类未加载，尝试加载类 %s\n", class_name);
         target_class = j2me_class_loader_load_class(vm->class_loader, class_name);
     }
     
-    if (target_class) {
-        // 确保类已初始化
-        if (target_class->state != CLASS_INITIALIZED) {
-            LOG_DEBUG("[方法调用] invokestatic: 类未初始化，执行初始化 %s\n", class_name);
-            j2me_error_t init_result = j2me_class_initialize(target_class);
-            if (init_result != J2ME_SUCCESS) {
-                LOG_ERROR("[方法调用] invokestatic: 类初始化失败: %d", init_result);
-            }
+    if (!target_class) {
+        // 系统类没有Class文件，由本地方法实现
+        j2me_native_method_func_t native = find_registered_native(vm, NULL, class_name, method_name, method_descriptor);
+        if (native) {
+            call->kind = J2ME_CALL_BUILTIN;
+            call->builtin = native;
+            return J2ME_SUCCESS;
         }
         
-        LOG_DEBUG("[方法调用] invokestatic: 找到类 %s\n", class_name);
-        j2me_method_t* target_method = j2me_class_find_method(target_class, method_name, method_descriptor);
-        if (target_method) {
-            LOG_DEBUG("[方法调用] invokestatic: 找到方法 %s%s，开始执行\n", method_name, method_descriptor);
-            // 解析方法描述符，确定参数数量
-            int param_count = 0;
-            if (method_descriptor) {
-                const char* p = strchr(method_descriptor, '(');
-                if (p) {
-                    p++; // 跳过'('
-                    while (*p && *p != ')') {
-                        switch (*p) {
-                            case 'I': case 'Z': case 'B': case 'C': case 'S': case 'F':
-                                param_count++;
-                                p++;
-                                break;
-                            case 'J': case 'D': // long和double占用两个槽位
-                                param_count += 2;
-                                p++;
-                                break;
-                            case 'L': // 对象引用
-                                param_count++;
-                                while (*p && *p != ';') p++;
-                                if (*p == ';') p++;
-                                break;
-                            case '[': // 数组
-                                param_count++;
-                                p++;
-                                while (*p == '[') p++;
-                                if (*p == 'L') {
-                                    while (*p && *p != ';') p++;
-                                    if (*p == ';') p++;
-                                } else {
-                                    p++;
-                                }
-                                break;
-                            default:
-                                p++;
-                                break;
-                        }
-                    }
-                }
-            }
-            
-            // 从调用者栈中弹出参数
-            j2me_int* args = NULL;
-            if (param_count > 0) {
-                args = (j2me_int*)malloc(sizeof(j2me_int) * param_count);
-                if (args) {
-                    // 从栈中弹出参数（注意顺序：最后一个参数在栈顶）
-                    for (int i = param_count - 1; i >= 0; i--) {
-                        if (j2me_operand_stack_pop(&caller_frame->operand_stack, &args[i]) != J2ME_SUCCESS) {
-                            LOG_WARN("[方法调用] invokestatic: 警告：弹出参数失败");
-                            args[i] = 0;
-                        }
-                    }
-                    LOG_DEBUG("[方法调用] invokestatic: 从栈弹出%d个参数\n", param_count);
-                }
-            }
-            
-            j2me_error_t result = j2me_interpreter_execute_method(vm, target_method, NULL, args);
-            
-            // 释放参数数组
-            if (args) {
-                free(args);
-            }
-            
-            // 检查方法是否有返回值（从VM中获取）
-            if (result == J2ME_SUCCESS && vm->last_method_has_return_value) {
-                j2me_int return_value = vm->last_method_return_value;
-                LOG_DEBUG("[方法调用] invokestatic: 方法返回值 0x%x\n", return_value);
-                // 注意：不要在这里压栈！解释器会自动处理返回值压栈
-                // 只需要检查是否是Canvas对象并保存到VM
-                
-                // 如果返回值看起来是对象引用（非0且不是小整数），保存到VM
-                if (return_value > 0 && return_value < 0x1000) {
-                    // 检查是否是y类的静态方法返回的对象（Canvas子类）
-                    if (strcmp(class_name, "y") == 0) {
-                        vm->last_canvas_object_ref = return_value;
-                        LOG_DEBUG("[方法调用] invokestatic: 保存y类对象引用到VM: 0x%x\n", return_value);
-                    }
-                }
-            }
-            
-            if (result != J2ME_SUCCESS) {
-                LOG_ERROR("[方法调用] invokestatic: 方法执行失败 (错误: %d)", result);
-                return result;
-            }
-            return result;
-        } else {
-            LOG_DEBUG("[方法调用] invokestatic: 未找到方法 %s%s\n", method_name, method_descriptor);
+        LOG_DEBUG("[方法调用] 无法加载类 %s\n", class_name);
+        if (opcode == OPCODE_INVOKESTATIC) {
+            // 静态方法未找到时保持原有行为：不弹出参数
+            call->arg_slots = 0;
         }
-    } else {
-        LOG_DEBUG("[方法调用] invokestatic: 未找到类 %s\n", class_name);
+        return J2ME_SUCCESS;
     }
     
-    // 方法未找到，返回成功（简化处理）
-    LOG_DEBUG("[方法调用] invokestatic: 方法调用完成 (简化实现)\n");
-    return J2ME_SUCCESS;
-}
-
-/**
- * @brief 调用特殊方法（简化实现）
- * @param vm 虚拟机实例
- * @param caller_frame 调用者栈帧
- * @param method_ref_index 方法引用索引
- * @return 错误码
- */
-j2me_error_t j2me_method_invocation_invoke_special(
-    j2me_vm_t* vm,
-    j2me_stack_frame_t* caller_frame,
-    uint16_t method_ref_index) {
-    
-    if (!vm || !caller_frame) {
-        return J2ME_ERROR_INVALID_PARAMETER;
+    // 静态方法调用前确保类已初始化
+    if (opcode == OPCODE_INVOKESTATIC && target_class->state != CLASS_INITIALIZED) {
+        LOG_DEBUG("[方法调用] invokestatic: 类未初始化，执行初始化 %s\n", class_name);
+        j2me_error_t init_result = j2me_class_initialize(target_class);
+        if (init_result != J2ME_SUCCESS) {
+            LOG_ERROR("[方法调用] invokestatic: 类初始化失败: %d", init_result);
+        }
     }
     
-    // printf("[方法调用] invokespecial: 方法引用索引 #%d\n", method_ref_index);
-    
-    // 获取当前方法信息以访问常量池
-    j2me_method_t* current_method = (j2me_method_t*)caller_frame->method_info;
-    if (!current_method || !current_method->owner_class) {
-        // printf("[方法调用] invokespecial: 无法获取类信息\n");
-        return J2ME_ERROR_INVALID_PARAMETER;
+    j2me_method_t* target_method = j2me_class_find_method(target_class, method_name, method_descriptor);
+    if (!target_method) {
+        // 继承自系统类的方法
+        j2me_native_method_func_t native = find_registered_native(vm, target_class, class_name,
+                                                                  method_name, method_descriptor);
+        if (native) {
+            call->kind = J2ME_CALL_BUILTIN;
+            call->builtin = native;
+            return J2ME_SUCCESS;
+        }
+        
+        LOG_DEBUG("[方法调用] 未找到方法 %s%s\n", method_name, method_descriptor);
+        if (opcode == OPCODE_INVOKESTATIC) {
+            call->arg_slots = 0;
+        }
+        return J2ME_SUCCESS;
     }
     
-    // 解析方法引用
-    j2me_constant_pool_entry_t* method_ref = 
-        &current_method->owner_class->constant_pool.entries[method_ref_index - 1];
+    call->kind = J2ME_CALL_METHOD;
+    call->method = target_method;
     
-    if (method_ref->tag != J2ME_CONSTANT_METHODREF) {
-        // printf("[方法调用] invokespecial: 不是方法引用 (类型: %d)\n", method_ref->tag);
-        return J2ME_ERROR_INVALID_PARAMETER;
+    // 可被覆盖的方法执行时按接收者的实际类分派
+    if (opcode == OPCODE_INVOKEVIRTUAL && target_method->vtable_index != J2ME_VTABLE_INDEX_NONE) {
+        call->flags |= J2ME_CALL_FLAG_VIRTUAL;
     }
     
-    // 解析类名
-    uint16_t class_index = method_ref->info.ref_info.class_index;
-    j2me_constant_pool_entry_t* class_entry = 
-        &current_method->owner_class->constant_pool.entries[class_index - 1];
-    
-    const char* class_name = NULL;
-    if (class_entry->tag == J2ME_CONSTANT_CLASS) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[class_entry->info.class_info.name_index - 1];
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            class_name = name_entry->info.utf8.bytes;
+    // 不需要分派的本地方法直接调用绑定的实现
+    if (target_method->is_native && !(call->flags & J2ME_CALL_FLAG_VIRTUAL)) {
+        j2me_native_method_func_t native = j2me_native_method_bind(vm, target_method);
+        if (native) {
+            call->kind = J2ME_CALL_BUILTIN;
+            call->builtin = native;
+            call->method = NULL;
+            return J2ME_SUCCESS;
         }
     }
     
-    // 解析方法名和描述符
-    uint16_t name_and_type_index = method_ref->info.ref_info.name_and_type_index;
-    j2me_constant_pool_entry_t* name_and_type = 
-        &current_method->owner_class->constant_pool.entries[name_and_type_index - 1];
-    
-    const char* method_name = NULL;
-    const char* method_descriptor = NULL;
+    // 记录y类（Canvas子类）静态工厂方法返回的对象
+    if (opcode == OPCODE_INVOKESTATIC && strcmp(class_name, "y") == 0) {
+        call->flags |= J2ME_CALL_FLAG_TRACK_CANVAS;
+    }
     
-    if (name_and_type->tag == J2ME_CONSTANT_NAME_AND_TYPE) {
-        j2me_constant_pool_entry_t* name_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.name_index - 1];
-        j2me_constant_pool_entry_t* desc_entry = 
-            &current_method->owner_class->constant_pool.entries[name_and_type->info.name_and_type_info.descriptor_index - 1];
-        
-        if (name_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_name = name_entry->info.utf8.bytes;
-        }
-        if (desc_entry->tag == J2ME_CONSTANT_UTF8) {
-            method_descriptor = desc_entry->info.utf8.bytes;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 按接收者的实际类选择调用目标
+ * @return 实际执行的方法，接口方法没有可执行的实现时返回NULL（只弹出参数）
+ */
+static j2me_method_t* select_target_method(j2me_vm_t* vm, const j2me_resolved_call_t* call,
+                                           j2me_call_site_cache_t* site, j2me_int this_ref) {
+    j2me_class_t* receiver_class = j2me_class_get_object_class(vm, this_ref);
+    
+    // 调用点内联缓存：同一接收者类的调用目标不变
+    bool use_site = site && receiver_class && site->state != J2ME_CALL_SITE_MEGAMORPHIC;
+    if (use_site) {
+        j2me_method_t* cached = j2me_call_site_cache_lookup(site, receiver_class);
+        j2me_performance_stats_record_cache_access(vm->perf_stats, cached != NULL);
+        if (cached) {
+            return cached;
         }
     }
     
-    // printf("[方法调用] invokespecial: %s.%s%s\n", 
-    //        class_name ? class_name : "未知类",
-    //        method_name ? method_name : "未知方法",
-    //        method_descriptor ? method_descriptor : "");
-    
-    // 特殊处理Thread.<init>
-    if (class_name && method_name &&
-        strcmp(class_name, "java/lang/Thread") == 0 &&
-        strcmp(method_name, "<init>") == 0) {
-        
-        // 弹出Runnable参数（如果有）
-        j2me_int runnable_ref = 0;
-        if (caller_frame->operand_stack.top > 0 && 
-            method_descriptor && strstr(method_descriptor, "Runnable")) {
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &runnable_ref);
-            LOG_DEBUG("[方法调用] Thread.<init>: Runnable=0x%x (从栈)\n", runnable_ref);
-            
-            // 如果从栈弹出的是0，尝试使用VM中保存的最后一个对象引用
-            if (runnable_ref == 0 && vm && vm->last_method_has_return_value) {
-                runnable_ref = vm->last_method_return_value;
-                LOG_DEBUG("[方法调用] Thread.<init>: 使用VM中的对象引用 0x%x\n", runnable_ref);
-            }
-            
-            // 保存Runnable引用到VM的专用字段，以便Thread.start()使用
-            if (vm && runnable_ref != 0) {
-                vm->current_runnable_ref = runnable_ref;
-                LOG_DEBUG("[方法调用] Thread.<init>: 保存Runnable到VM (0x%x)\n", runnable_ref);
-            }
-        }
-        
-        // 弹出Thread的this引用
-        if (caller_frame->operand_stack.top > 0) {
-            j2me_int thread_ref;
-            j2me_operand_stack_pop(&caller_frame->operand_stack, &thread_ref);
+    j2me_method_t* selected;
+    if (call->flags & J2ME_CALL_FLAG_VIRTUAL) {
+        // 接收者不是类实例（字符串、数组等）时按静态解析结果执行
+        selected = j2me_class_select_virtual_method(receiver_class, call->method);
+        if (!selected) {
+            selected = call->method;
         }
-        
-        LOG_DEBUG("[方法调用] Thread.<init>: 线程初始化完成\n");
-        return J2ME_SUCCESS;
-    }
-
-    if (class_name && method_name &&
-        strcmp(class_name, "java/lang/StringBuilder") == 0 &&
-        strcmp(method_name, "<init>") == 0) {
-        if (method_descriptor && strcmp(method_descriptor, "()V") == 0) {
-            j2me_int this_ref_int = 0;
-            j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-            if (result != J2ME_SUCCESS) {
-                return result;
-            }
-            j2me_ref_t empty = j2me_heap_string_create(vm->heap, "");
-            j2me_stringbuilder_set_value_ref(vm, (j2me_ref_t)this_ref_int, empty);
-            return J2ME_SUCCESS;
+    } else {
+        selected = j2me_class_select_interface_method(receiver_class, call->method);
+        if (!selected && receiver_class) {
+            selected = j2me_class_find_method(receiver_class, call->method->name, call->method->descriptor);
         }
-
-        if (method_descriptor && strcmp(method_descriptor, "(Ljava/lang/String;)V") == 0) {
-            j2me_int arg_ref_int = 0;
-            j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &arg_ref_int);
-            if (result != J2ME_SUCCESS) {
-                return result;
-            }
-            j2me_int this_ref_int = 0;
-            result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-            if (result != J2ME_SUCCESS) {
-                return result;
-            }
-            j2me_ref_t initial = (j2me_ref_t)arg_ref_int;
-            if (initial == J2ME_NULL_REF) {
-                initial = j2me_heap_string_create(vm->heap, "null");
-            }
-            j2me_stringbuilder_set_value_ref(vm, (j2me_ref_t)this_ref_int, initial);
-            return J2ME_SUCCESS;
+        if (!selected || (!selected->bytecode && !(selected->access_flags & ACC_NATIVE))) {
+            LOG_DEBUG("[方法调用] invokeinterface: 接收者 0x%x 没有 %s%s 的实现\n",
+                      this_ref, call->method->name, call->method->descriptor);
+            return NULL;
         }
+    }
+    
+    if (use_site) {
+        j2me_call_site_cache_update(site, receiver_class, selected);
+    }
+    return selected;
+}
 
-        j2me_int this_ref_int = 0;
-        j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref_int);
-        if (result != J2ME_SUCCESS) {
-            return result;
-        }
-        j2me_ref_t empty = j2me_heap_string_create(vm->heap, "");
-        j2me_stringbuilder_set_value_ref(vm, (j2me_ref_t)this_ref_int, empty);
-        return J2ME_SUCCESS;
+j2me_error_t j2me_method_invocation_invoke_resolved(j2me_vm_t* vm,
+                                                    j2me_stack_frame_t* caller_frame,
+                                                    const j2me_resolved_call_t* call,
+                                                    j2me_call_site_cache_t* site) {
+    if (!vm || !caller_frame || !call) {
+        return J2ME_ERROR_INVALID_PARAMETER;
     }
     
-    // 弹出this引用 (如果栈不为空)
-    j2me_int this_ref = 0;
-    if (caller_frame->operand_stack.top > 0) {
-        j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
+    if (call->kind == J2ME_CALL_BUILTIN) {
+        return call->builtin(vm, caller_frame, NULL);
     }
     
-    // 解析方法描述符，确定参数数量（不包括this）
-    int param_count = 0;
-    if (method_descriptor) {
-        const char* p = strchr(method_descriptor, '(');
-        if (p) {
-            p++; // 跳过'('
-            while (*p && *p != ')') {
-                switch (*p) {
-                    case 'I': case 'Z': case 'B': case 'C': case 'S': case 'F':
-                        param_count++;
-                        p++;
-                        break;
-                    case 'J': case 'D': // long和double占用两个槽位
-                        param_count += 2;
-                        p++;
-                        break;
-                    case 'L': // 对象引用
-                        param_count++;
-                        while (*p && *p != ';') p++;
-                        if (*p == ';') p++;
-                        break;
-                    case '[': // 数组
-                        param_count++;
-                        p++;
-                        while (*p == '[') p++;
-                        if (*p == 'L') {
-                            while (*p && *p != ';') p++;
-                            if (*p == ';') p++;
-                        } else {
-                            p++;
-                        }
-                        break;
-                    default:
-                        p++;
-                        break;
-                }
-            }
+    // 先查看参数之下的接收者选择实际目标，选中本地方法时参数留在调用者栈上交给本地实现
+    j2me_method_t* target_method = call->method;
+    if (call->kind == J2ME_CALL_METHOD && (call->flags & (J2ME_CALL_FLAG_VIRTUAL | J2ME_CALL_FLAG_INTERFACE))) {
+        j2me_operand_stack_t* stack = &caller_frame->operand_stack;
+        j2me_int receiver = stack->top > call->arg_slots ? stack->data[stack->top - call->arg_slots - 1] : 0;
+        target_method = select_target_method(vm, call, site, receiver);
+    }
+    
+    if (target_method && target_method->is_native) {
+        j2me_native_method_func_t native = j2me_native_method_bind(vm, target_method);
+        if (native) {
+            return native(vm, caller_frame, NULL);
         }
     }
     
-    // 从调用者栈中弹出参数
+    // 从调用者栈中弹出参数（注意顺序：最后一个参数在栈顶，this在参数之下）
+    j2me_int inline_args[INVOKE_ARGS_INLINE_SLOTS];
     j2me_int* args = NULL;
-    if (param_count > 0) {
-        args = (j2me_int*)malloc(sizeof(j2me_int) * param_count);
+    if (call->arg_slots > 0) {
+        args = call->arg_slots <= INVOKE_ARGS_INLINE_SLOTS ?
+               inline_args : (j2me_int*)malloc(sizeof(j2me_int) * call->arg_slots);
         if (args) {
-            // 从栈中弹出参数（注意顺序：最后一个参数在栈顶）
-            for (int i = param_count - 1; i >= 0; i--) {
+            for (int i = call->arg_slots - 1; i >= 0; i--) {
                 if (j2me_operand_stack_pop(&caller_frame->operand_stack, &args[i]) != J2ME_SUCCESS) {
-                    LOG_WARN("[方法调用] invokespecial: 警告：弹出参数失败");
+                    LOG_WARN("[方法调用] 警告：弹出参数失败");
                     args[i] = 0;
                 }
             }
-            LOG_DEBUG("[方法调用] invokespecial: 从栈弹出%d个参数\n", param_count);
         }
     }
     
-    // 查找并调用方法，如果类未找到则尝试加载
-    j2me_class_t* target_class = j2me_class_loader_find_class(vm->class_loader, class_name);
-    if (!target_class) {
-        // 特殊处理java/lang/Object - 如果找不到就跳过
-        if (class_name && strcmp(class_name, "java/lang/Object") == 0) {
-            LOG_DEBUG("[方法调用] invokespecial: java/lang/Object.<init> - 跳过\n");
-            if (args) {
-                free(args);
-            }
-            return J2ME_SUCCESS;
-        }
-        
-        LOG_DEBUG("[方法调用] invokespecial: 类未加载，尝试加载类 %s\n", class_name);
-        target_class = j2me_class_loader_load_class(vm->class_loader, class_name);
+    j2me_int this_ref = 0;
+    if (call->has_receiver && caller_frame->operand_stack.top > 0) {
+        j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
     }
     
-    if (target_class) {
-        LOG_DEBUG("[方法调用] invokespecial: 找到类 %s\n", class_name);
-        j2me_method_t* target_method = j2me_class_find_method(target_class, method_name, method_descriptor);
-        if (target_method) {
-            LOG_DEBUG("[方法调用] invokespecial: 找到方法，开始执行\n");
-            j2me_error_t result = j2me_interpreter_execute_method(vm, target_method, (void*)(intptr_t)this_ref, args);
-            
-            // 释放参数数组
-            if (args) {
-                free(args);
-            }
-            
-            if (result != J2ME_SUCCESS) {
-                LOG_ERROR("[方法调用] invokespecial: 方法执行失败 (错误: %d)", result);
-                return result;
+    j2me_error_t result = J2ME_SUCCESS;
+    if (target_method) {
+        result = j2me_interpreter_execute_method(vm, target_method,
+                                                 call->has_receiver ? (void*)(intptr_t)this_ref : NULL, args);
+        
+        if (result != J2ME_SUCCESS) {
+            LOG_ERROR("[方法调用] 方法 %s%s 执行失败 (错误: %d)",
+                      target_method->name, target_method->descriptor, result);
+        } else if ((call->flags & J2ME_CALL_FLAG_TRACK_CANVAS) && vm->last_method_has_return_value) {
+            // 如果返回值看起来是对象引用（非0且不是小整数），保存到VM
+            j2me_int return_value = vm->last_method_return_value;
+            if (return_value > 0 && return_value < 0x1000) {
+                vm->last_canvas_object_ref = return_value;
+                LOG_DEBUG("[方法调用] invokestatic: 保存y类对象引用到VM: 0x%x\n", return_value);
             }
-            return result;
-        } else {
-            LOG_DEBUG("[方法调用] invokespecial: 未找到方法 %s%s\n", method_name, method_descriptor);
         }
-    } else {
-        LOG_ERROR("[方法调用] invokespecial: 无法加载类 %s", class_name);
     }
     
-    // 释放参数数组
-    if (args) {
+    if (args && args != inline_args) {
         free(args);
     }
     
-    LOG_DEBUG("[方法调用] invokespecial: 方法调用完成 (简化实现)\n");
-    return J2ME_SUCCESS;
+    return result;
 }
 
 /**
- * @brief 调用接口方法（简化实现）
+ * @brief 解析并执行一次方法调用
+ */
+static j2me_error_t invoke_by_ref(j2me_vm_t* vm,
+                                  j2me_stack_frame_t* caller_frame,
+                                  uint8_t opcode,
+                                  uint16_t method_ref_index,
+                                  uint8_t count) {
+    if (!vm || !caller_frame) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    // 获取当前方法信息以访问常量池
+    j2me_method_t* current_method = (j2me_method_t*)caller_frame->method_info;
+    if (!current_method || !current_method->owner_class) {
+        LOG_ERROR("[方法调用] 无法获取类信息");
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    // 同一方法引用已在其他位置解析过时直接使用解析表中的结果
+    const j2me_resolved_call_t* cached = j2me_quicken_find_call(current_method->owner_class, opcode, method_ref_index);
+    if (cached) {
+        return j2me_method_invocation_invoke_resolved(vm, caller_frame, cached, NULL);
+    }
+    
+    j2me_resolved_call_t call;
+    j2me_error_t result = j2me_method_invocation_resolve_call(vm, current_method->owner_class, opcode,
+                                                              method_ref_index, count, &call);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    j2me_quicken_remember_call(current_method->owner_class, opcode, method_ref_index, &call);
+    
+    return j2me_method_invocation_invoke_resolved(vm, caller_frame, &call, NULL);
+}
+
+/**
+ * @brief 调用虚方法（简化实现）
+ * @param vm 虚拟机实例
+ * @param caller_frame 调用者栈帧
+ * @param method_ref_index 方法引用索引
+ * @return 错误码
+ */
+j2me_error_t j2me_method_invocation_invoke_virtual(
+    j2me_vm_t* vm,
+    j2me_stack_frame_t* caller_frame,
+    uint16_t method_ref_index) {
+    
+    LOG_DEBUG("[方法调用] invokevirtual: 方法引用索引 #%d\n", method_ref_index);
+    return invoke_by_ref(vm, caller_frame, OPCODE_INVOKEVIRTUAL, method_ref_index, 0);
+}
+
+/**
+ * @brief 调用静态方法（简化实现）
+ * @param vm 虚拟机实例
+ * @param caller_frame 调用者栈帧
+ * @param method_ref_index 方法引用索引
+ * @return 错误码
+ */
+j2me_error_t j2me_method_invocation_invoke_static(
+    j2me_vm_t* vm,
+    j2me_stack_frame_t* caller_frame,
+    uint16_t method_ref_index) {
+    
+    return invoke_by_ref(vm, caller_frame, OPCODE_INVOKESTATIC, method_ref_index, 0);
+}
+
+/**
+ * @brief 调用特殊方法（简化实现）
+ * @param vm 虚拟机实例
+ * @param caller_frame 调用者栈帧
+ * @param method_ref_index 方法引用索引
+ * @return 错误码
+ */
+j2me_error_t j2me_method_invocation_invoke_special(
+    j2me_vm_t* vm,
+    j2me_stack_frame_t* caller_frame,
+    uint16_t method_ref_index) {
+    
+    return invoke_by_ref(vm, caller_frame, OPCODE_INVOKESPECIAL, method_ref_index, 0);
+}
+
+/**
+ * @brief 调用接口方法
  * @param vm 虚拟机实例
  * @param caller_frame 调用者栈帧
  * @param method_ref_index 方法引用索引
@@ -954,30 +1002,8 @@ j2me_error_t j2me_method_invocation_invoke_interface(
     uint16_t method_ref_index,
     uint8_t count) {
     
-    if (!vm || !caller_frame) {
-        return J2ME_ERROR_INVALID_PARAMETER;
-    }
-    
-    LOG_DEBUG("[方法调用] invokeinterface: 方法引用索引 #%d, 参数数量 %d (简化实现)\n", method_ref_index, count);
-    
-    // 弹出this引用
-    if (caller_frame->operand_stack.top > 0) {
-        j2me_int this_ref;
-        j2me_error_t result = j2me_operand_stack_pop(&caller_frame->operand_stack, &this_ref);
-        if (result == J2ME_SUCCESS) {
-            LOG_DEBUG("[方法调用] invokeinterface: 弹出this引用 0x%x\n", this_ref);
-        }
-    }
-    
-    // 弹出其他参数
-    for (int i = 1; i < count && caller_frame->operand_stack.top > 0; i++) {
-        j2me_int param;
-        j2me_operand_stack_pop(&caller_frame->operand_stack, &param);
-        LOG_DEBUG("[方法调用] invokeinterface: 弹出参数[%d] = 0x%x\n", i, param);
-    }
-    
-    LOG_DEBUG("[方法调用] invokeinterface: 接口方法调用完成 (简化实现)\n");
-    return J2ME_SUCCESS;
+    LOG_DEBUG("[方法调用] invokeinterface: 方法引用索引 #%d, 参数数量 %d\n", method_ref_index, count);
+    return invoke_by_ref(vm, caller_frame, OPCODE_INVOKEINTERFACE, method_ref_index, count);
 }
 
 // 其他函数的简化实现（暂时返回未实现错误）
@@ -183,6 +183,8 @@ j2me_error_t java_system_arraycopy(j2me_vm_t* vm, j2me_stack_frame_t* frame, voi
             if (src_start + copy_bytes <= (int)(src_len * sizeof(j2me_int)) &&
                 dst_start + copy_bytes <= (int)(dst_len * sizeof(j2me_int))) {
                 memmove(dst_data + dst_start, src_data + src_start, copy_bytes);
+                // 复制的元素可能是新生代对象的引用
+                j2me_heap_remember(vm->heap, (j2me_ref_t)dst_ref);
             }
         }
     }
@@ -341,7 +343,8 @@ j2me_error_t java_string_intern(j2me_vm_t* vm, j2me_stack_frame_t* frame, void*
     j2me_int this_ref;
     j2me_error_t result = j2me_operand_stack_pop(&frame->operand_stack, &this_ref);
     if (result != J2ME_SUCCESS) return result;
-    return j2me_operand_stack_push(&frame->operand_stack, this_ref);
+    j2me_ref_t interned = vm->heap ? j2me_heap_string_intern_ref(vm->heap, (j2me_ref_t)this_ref) : (j2me_ref_t)this_ref;
+    return j2me_operand_stack_push(&frame->operand_stack, (j2me_int)interned);
 }
 
 static j2me_error_t java_math_double_op(j2me_vm_t* vm, j2me_stack_frame_t* frame, double (*op)(double)) {
@@ -374,7 +377,7 @@ j2me_error_t java_runtime_gc(j2me_vm_t* vm, j2me_stack_frame_t* frame, void* arg
     j2me_int runtime_ref;
     j2me_error_t result = j2me_operand_stack_pop(&frame->operand_stack, &runtime_ref);
     if (result != J2ME_SUCCESS) return result;
-    if (vm->gc) vm->gc_collections++;
+    if (vm->heap) j2me_heap_collect(vm->heap);
     return J2ME_SUCCESS;
 }
 
@@ -12,19 +12,87 @@
 
 static j2me_native_method_registry_t* g_native_registry = NULL;
 
+// 哈希表初始槽位数（负载超过一半时加倍）
+#define NATIVE_TABLE_INITIAL_CAPACITY 256
+
+/**
+ * @brief 计算(类名, 方法名, 签名)的哈希 (FNV-1a，三部分之间以0分隔)
+ */
+static uint32_t hash_native_key(const char* class_name, const char* method_name, const char* signature) {
+    const char* parts[3] = { class_name, method_name, signature };
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 3; i++) {
+        for (const char* p = parts[i]; *p; p++) {
+            hash ^= (uint8_t)*p;
+            hash *= 16777619u;
+        }
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 在哈希表中查找注册项
+ */
+static j2me_native_method_entry_t* find_native_entry(j2me_native_method_registry_t* registry, uint32_t hash,
+                                                     const char* class_name, const char* method_name,
+                                                     const char* signature) {
+    if (!registry->table) return NULL;
+    size_t mask = registry->table_capacity - 1;
+    for (size_t slot = hash & mask; registry->table[slot]; slot = (slot + 1) & mask) {
+        j2me_native_method_entry_t* entry = &registry->entries[registry->table[slot] - 1];
+        if (entry->hash == hash &&
+            strcmp(entry->method_name, method_name) == 0 &&
+            strcmp(entry->signature, signature) == 0 &&
+            strcmp(entry->class_name, class_name) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 把注册项下标放入哈希表的空槽
+ */
+static void native_table_insert(uint32_t* table, size_t capacity, uint32_t hash, size_t index) {
+    size_t mask = capacity - 1;
+    size_t slot = hash & mask;
+    while (table[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = (uint32_t)(index + 1);
+}
+
+/**
+ * @brief 哈希表扩容到new_capacity个槽位
+ */
+static j2me_error_t native_table_grow(j2me_native_method_registry_t* registry, size_t new_capacity) {
+    uint32_t* table = (uint32_t*)calloc(new_capacity, sizeof(uint32_t));
+    if (!table) return J2ME_ERROR_OUT_OF_MEMORY;
+    for (size_t i = 0; i < registry->count; i++) {
+        native_table_insert(table, new_capacity, registry->entries[i].hash, i);
+    }
+    free(registry->table);
+    registry->table = table;
+    registry->table_capacity = new_capacity;
+    return J2ME_SUCCESS;
+}
+
 j2me_native_method_registry_t* j2me_native_method_registry_create(void) {
     j2me_native_method_registry_t* registry = 
-        (j2me_native_method_registry_t*)malloc(sizeof(j2me_native_method_registry_t));
+        (j2me_native_method_registry_t*)calloc(1, sizeof(j2me_native_method_registry_t));
     if (!registry) return NULL;
-    registry->entries = NULL;
-    registry->count = 0;
-    registry->capacity = 0;
+    if (native_table_grow(registry, NATIVE_TABLE_INITIAL_CAPACITY) != J2ME_SUCCESS) {
+        free(registry);
+        return NULL;
+    }
     return registry;
 }
 
 void j2me_native_method_registry_destroy(j2me_native_method_registry_t* registry) {
     if (registry) {
         if (registry->entries) free(registry->entries);
+        if (registry->table) free(registry->table);
         free(registry);
     }
 }
@@ -36,6 +104,15 @@ j2me_error_t j2me_native_method_register(j2me_native_method_registry_t* registry
                                          j2me_native_method_func_t func) {
     if (!registry || !class_name || !method_name || !signature || !func)
         return J2ME_ERROR_INVALID_PARAMETER;
+    
+    // 重复注册（如多次初始化）只更新实现
+    uint32_t hash = hash_native_key(class_name, method_name, signature);
+    j2me_native_method_entry_t* existing = find_native_entry(registry, hash, class_name, method_name, signature);
+    if (existing) {
+        existing->func = func;
+        return J2ME_SUCCESS;
+    }
+    
     if (registry->count >= registry->capacity) {
         size_t new_capacity = registry->capacity == 0 ? 16 : registry->capacity * 2;
         j2me_native_method_entry_t* new_entries = 
@@ -45,11 +122,17 @@ j2me_error_t j2me_native_method_register(j2me_native_method_registry_t* registry
         registry->entries = new_entries;
         registry->capacity = new_capacity;
     }
+    if ((registry->count + 1) * 2 > registry->table_capacity) {
+        j2me_error_t result = native_table_grow(registry, registry->table_capacity * 2);
+        if (result != J2ME_SUCCESS) return result;
+    }
     j2me_native_method_entry_t* entry = &registry->entries[registry->count];
     entry->class_name = class_name;
     entry->method_name = method_name;
     entry->signature = signature;
     entry->func = func;
+    entry->hash = hash;
+    native_table_insert(registry->table, registry->table_capacity, hash, registry->count);
     registry->count++;
     return J2ME_SUCCESS;
 }
@@ -59,15 +142,30 @@ j2me_native_method_func_t j2me_native_method_find(j2me_native_method_registry_t*
                                                   const char* method_name,
                                                   const char* signature) {
     if (!registry || !class_name || !method_name || !signature) return NULL;
-    for (size_t i = 0; i < registry->count; i++) {
-        j2me_native_method_entry_t* entry = &registry->entries[i];
-        if (strcmp(entry->class_name, class_name) == 0 &&
-            strcmp(entry->method_name, method_name) == 0 &&
-            strcmp(entry->signature, signature) == 0) {
-            return entry->func;
+    j2me_native_method_entry_t* entry = find_native_entry(registry, hash_native_key(class_name, method_name, signature),
+                                                          class_name, method_name, signature);
+    return entry ? entry->func : NULL;
+}
+
+j2me_native_method_func_t j2me_native_method_lookup(j2me_vm_t* vm,
+                                                    const char* class_name,
+                                                    const char* method_name,
+                                                    const char* signature) {
+    if (!vm) return NULL;
+    return j2me_native_method_find(vm->native_method_registry, class_name, method_name, signature);
+}
+
+j2me_native_method_func_t j2me_native_method_bind(j2me_vm_t* vm, j2me_method_t* method) {
+    if (!method) return NULL;
+    if (!method->native_function && method->owner_class) {
+        j2me_native_method_func_t func = j2me_native_method_lookup(vm, method->owner_class->name,
+                                                                    method->name, method->descriptor);
+        if (func) {
+            method->native_function = (void*)func;
+            LOG_DEBUG("[本地方法] 绑定: %s.%s%s\n", method->owner_class->name, method->name, method->descriptor);
         }
     }
-    return NULL;
+    return (j2me_native_method_func_t)method->native_function;
 }
 
 j2me_error_t j2me_native_method_invoke(j2me_vm_t* vm,
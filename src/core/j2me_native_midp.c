@@ -32,13 +32,13 @@ j2me_error_t midp_display_set_current(j2me_vm_t* vm, j2me_stack_frame_t* frame,
             if (result == J2ME_SUCCESS) {
                 if (vm && displayable_ref != 0) {
                     vm->current_canvas_ref = displayable_ref;
-                    j2me_stack_frame_t* temp_frame = j2me_stack_frame_create(10, 5);
+                    j2me_stack_frame_t* temp_frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
                     if (temp_frame) {
                         j2me_operand_stack_push(&temp_frame->operand_stack, displayable_ref);
                         midp_canvas_repaint(vm, temp_frame, NULL);
                         j2me_stack_frame_destroy(temp_frame);
                     }
-                    j2me_stack_frame_t* service_frame = j2me_stack_frame_create(10, 5);
+                    j2me_stack_frame_t* service_frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
                     if (service_frame) {
                         j2me_operand_stack_push(&service_frame->operand_stack, displayable_ref);
                         midp_canvas_service_repaints(vm, service_frame, NULL);
@@ -58,13 +58,13 @@ j2me_error_t midp_display_set_current(j2me_vm_t* vm, j2me_stack_frame_t* frame,
     if (result != J2ME_SUCCESS) return result;
     if (vm && displayable_ref != 0) {
         vm->current_canvas_ref = displayable_ref;
-        j2me_stack_frame_t* temp_frame = j2me_stack_frame_create(10, 5);
+        j2me_stack_frame_t* temp_frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
         if (temp_frame) {
             j2me_operand_stack_push(&temp_frame->operand_stack, displayable_ref);
             midp_canvas_repaint(vm, temp_frame, NULL);
             j2me_stack_frame_destroy(temp_frame);
         }
-        j2me_stack_frame_t* service_frame = j2me_stack_frame_create(10, 5);
+        j2me_stack_frame_t* service_frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
         if (service_frame) {
             j2me_operand_stack_push(&service_frame->operand_stack, displayable_ref);
             midp_canvas_service_repaints(vm, service_frame, NULL);
@@ -133,8 +133,12 @@ static j2me_error_t midp_canvas_call_paint_method(j2me_vm_t* vm, j2me_int canvas
     } else {
         graphics_ref = 0x40000001;
     }
+    // 绘制期间Graphics对象只被这里持有，retain防止paint中的分配触发回收时被释放
+    bool pinned = j2me_heap_is_valid_ref(vm->heap, graphics_ref);
+    if (pinned) j2me_heap_retain(vm->heap, graphics_ref);
     j2me_error_t result = call_canvas_paint_method(vm, canvas_ref, graphics_ref);
-    if (j2me_heap_is_valid_ref(vm->heap, graphics_ref)) {
+    if (pinned) {
+        j2me_heap_release(vm->heap, graphics_ref);
         j2me_heap_release(vm->heap, graphics_ref);
     }
     return result;
@@ -40,8 +40,10 @@ j2me_error_t java_class_new_instance(j2me_vm_t* vm, j2me_stack_frame_t* frame, v
     j2me_int obj_ref = J2ME_NULL_REF;
     if (class_ref != J2ME_NULL_REF && vm->heap) {
         j2me_class_t* cls = (j2me_class_t*)(uintptr_t)class_ref;
-        size_t obj_size = sizeof(j2me_class_t*) + (cls->instance_size > 0 ? cls->instance_size : 16);
-        j2me_ref_t ref = j2me_heap_alloc(vm->heap, 0, obj_size);
+        // instance_size已包含开头的类指针
+        size_t obj_size = cls->instance_size >= J2ME_INSTANCE_HEADER_SIZE ? cls->instance_size : sizeof(j2me_class_t*) + 16;
+        // 与new指令一致，class_id取类指针的低32位
+        j2me_ref_t ref = j2me_heap_alloc(vm->heap, (uint32_t)(uintptr_t)cls, obj_size);
         if (ref != J2ME_NULL_REF) {
             void* data = j2me_heap_get_object_data(vm->heap, ref);
             if (data) {
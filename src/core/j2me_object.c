@@ -27,29 +27,29 @@ static const uint8_t element_sizes[] = {
 };
 
 /**
- * @brief 从虚拟机堆分配内存
+ * @brief 从虚拟机堆分配固定对象
+ *
+ * 这里的对象按指针交给调用者长期持有，因此分配为固定对象（不移动、不回收），
+ * 对象引用保存在对象头的hash_code中，销毁时据此释放。
+ *
  * @param vm 虚拟机实例
+ * @param class_id 堆对象类ID
  * @param size 分配大小
+ * @param ref 输出对象引用
  * @return 内存指针，失败返回NULL
  */
-static void* vm_heap_alloc(j2me_vm_t* vm, size_t size) {
-    if (!vm || !vm->heap_start) {
+static void* vm_heap_alloc(j2me_vm_t* vm, uint32_t class_id, size_t size, j2me_ref_t* ref) {
+    if (!vm || !vm->heap) {
         return NULL;
     }
     
-    // 简单的线性分配器 (实际实现应该更复杂)
-    size_t aligned_size = (size + 7) & ~7; // 8字节对齐
-    
-    if ((char*)vm->heap_current + aligned_size > (char*)vm->heap_end) {
-        LOG_ERROR("[对象系统] 堆内存不足，需要 %zu 字节", aligned_size);
+    *ref = j2me_heap_alloc_pinned(vm->heap, class_id, size);
+    if (*ref == J2ME_NULL_REF) {
+        LOG_ERROR("[对象系统] 堆内存不足，需要 %zu 字节", size);
         return NULL;
     }
     
-    void* ptr = vm->heap_current;
-    vm->heap_current = (char*)vm->heap_current + aligned_size;
-    
-    memset(ptr, 0, aligned_size);
-    return ptr;
+    return j2me_heap_get_object_data(vm->heap, *ref);
 }
 
 size_t j2me_object_calculate_size(j2me_class_t* class_ptr) {
@@ -123,7 +123,8 @@ j2me_object_t* j2me_object_create(j2me_vm_t* vm, j2me_class_t* class_ptr) {
     }
     
     size_t object_size = j2me_object_calculate_size(class_ptr);
-    j2me_object_t* obj = (j2me_object_t*)vm_heap_alloc(vm, object_size);
+    j2me_ref_t ref;
+    j2me_object_t* obj = (j2me_object_t*)vm_heap_alloc(vm, (uint32_t)(uintptr_t)class_ptr, object_size, &ref);
     
     if (!obj) {
         LOG_ERROR("[对象系统] 对象创建失败，内存不足");
@@ -132,7 +133,7 @@ j2me_object_t* j2me_object_create(j2me_vm_t* vm, j2me_class_t* class_ptr) {
     
     // 初始化对象头
     obj->header.class_ptr = class_ptr;
-    obj->header.hash_code = (uint32_t)(uintptr_t)obj; // 简单的哈希码
+    obj->header.hash_code = ref; // 对象引用兼作哈希码
     obj->header.flags = 0;
     obj->header.lock_count = 0;
     
@@ -147,13 +148,17 @@ void j2me_object_destroy(j2me_vm_t* vm, j2me_object_t* obj) {
         return;
     }
     
-    // 在实际的GC实现中，这里会被GC管理
-    // 现在只是标记为已销毁
     obj->header.flags |= OBJECT_FLAG_FINALIZED;
     
     LOG_DEBUG("[对象系统] 销毁对象: %s\n",
            obj->header.class_ptr && obj->header.class_ptr->name ?
            obj->header.class_ptr->name : "unknown");
+    
+    // 固定对象不会被回收，只能在这里释放
+    j2me_ref_t ref = (j2me_ref_t)obj->header.hash_code;
+    if (j2me_heap_get_object_data(vm->heap, ref) == obj) {
+        j2me_heap_free(vm->heap, ref);
+    }
 }
 
 j2me_class_t* j2me_object_get_class(j2me_object_t* obj) {
@@ -274,7 +279,8 @@ j2me_array_t* j2me_array_create(j2me_vm_t* vm, j2me_array_type_t element_type, u
     }
     
     size_t array_size = j2me_array_calculate_size(element_type, length);
-    j2me_array_t* array = (j2me_array_t*)vm_heap_alloc(vm, array_size);
+    j2me_ref_t ref;
+    j2me_array_t* array = (j2me_array_t*)vm_heap_alloc(vm, 0, array_size, &ref);
     
     if (!array) {
         LOG_ERROR("[对象系统] 数组创建失败，内存不足");
@@ -283,7 +289,7 @@ j2me_array_t* j2me_array_create(j2me_vm_t* vm, j2me_array_type_t element_type, u
     
     // 初始化数组头
     array->header.class_ptr = NULL; // TODO: 设置数组类
-    array->header.hash_code = (uint32_t)(uintptr_t)array;
+    array->header.hash_code = ref;
     array->header.flags = OBJECT_FLAG_ARRAY;
     array->header.lock_count = 0;
     
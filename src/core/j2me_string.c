@@ -9,6 +9,23 @@
  * @brief J2ME String对象实现
  */
 
+// 驻留表初始槽位数
+#define STRING_TABLE_INITIAL_CAPACITY 256
+
+/**
+ * @brief String的字符数据（去重后的String沿共享引用找到存放字符的String）
+ */
+static j2me_string_data_t* string_data(j2me_heap_t* heap, j2me_ref_t ref) {
+    j2me_heap_object_header_t* obj = j2me_heap_get_object(heap, ref);
+    while (obj && obj->class_id == J2ME_CLASS_STRING &&
+           (((j2me_string_data_t*)obj->data)->length & J2ME_STRING_SHARED)) {
+        j2me_ref_t target;
+        memcpy(&target, ((j2me_string_data_t*)obj->data)->chars, sizeof(j2me_ref_t));
+        obj = j2me_heap_get_object(heap, target);
+    }
+    return obj ? (j2me_string_data_t*)obj->data : NULL;
+}
+
 j2me_ref_t j2me_heap_string_create(j2me_heap_t* heap, const char* str) {
     if (!heap || !str) {
         return J2ME_NULL_REF;
@@ -57,12 +74,12 @@ const char* j2me_heap_string_get_chars(j2me_heap_t* heap, j2me_ref_t ref) {
         return NULL;
     }
     
-    j2me_string_data_t* string_data = (j2me_string_data_t*)j2me_heap_get_object_data(heap, ref);
-    if (!string_data) {
+    j2me_string_data_t* data = string_data(heap, ref);
+    if (!data) {
         return NULL;
     }
     
-    return string_data->chars;
+    return data->chars;
 }
 
 uint32_t j2me_heap_string_get_length(j2me_heap_t* heap, j2me_ref_t ref) {
@@ -70,12 +87,12 @@ uint32_t j2me_heap_string_get_length(j2me_heap_t* heap, j2me_ref_t ref) {
         return 0;
     }
     
-    j2me_string_data_t* string_data = (j2me_string_data_t*)j2me_heap_get_object_data(heap, ref);
-    if (!string_data) {
+    j2me_string_data_t* data = string_data(heap, ref);
+    if (!data) {
         return 0;
     }
     
-    return string_data->length;
+    return data->length;
 }
 
 char j2me_heap_string_char_at(j2me_heap_t* heap, j2me_ref_t ref, uint32_t index) {
@@ -83,12 +100,12 @@ char j2me_heap_string_char_at(j2me_heap_t* heap, j2me_ref_t ref, uint32_t index)
         return 0;
     }
     
-    j2me_string_data_t* string_data = (j2me_string_data_t*)j2me_heap_get_object_data(heap, ref);
-    if (!string_data || index >= string_data->length) {
+    j2me_string_data_t* data = string_data(heap, ref);
+    if (!data || index >= data->length) {
         return 0;
     }
     
-    return string_data->chars[index];
+    return data->chars[index];
 }
 
 j2me_ref_t j2me_heap_string_concat(j2me_heap_t* heap, j2me_ref_t ref1, j2me_ref_t ref2) {
@@ -132,22 +149,31 @@ j2me_ref_t j2me_heap_string_substring(j2me_heap_t* heap, j2me_ref_t ref, uint32_
         return J2ME_NULL_REF;
     }
     
-    j2me_string_data_t* string_data = (j2me_string_data_t*)j2me_heap_get_object_data(heap, ref);
-    if (!string_data) {
+    j2me_string_data_t* data = string_data(heap, ref);
+    if (!data) {
         return J2ME_NULL_REF;
     }
     
     // 检查边界
-    if (start > end || end > string_data->length) {
+    if (start > end || end > data->length) {
         LOG_ERROR("[String] substring索引越界 (start=%u, end=%u, length=%u)",
-               start, end, string_data->length);
+               start, end, data->length);
         return J2ME_NULL_REF;
     }
     
     uint32_t sub_len = end - start;
     
+    // 分配可能触发回收和压缩，源字符串会移动，先复制出来
+    char* buffer = (char*)malloc(sub_len + 1);
+    if (!buffer) {
+        return J2ME_NULL_REF;
+    }
+    memcpy(buffer, data->chars + start, sub_len);
+    
     // 创建新的String对象
-    j2me_ref_t result = j2me_heap_string_create_n(heap, string_data->chars + start, sub_len);
+    j2me_ref_t result = j2me_heap_string_create_n(heap, buffer, sub_len);
+    
+    free(buffer);
     
     LOG_DEBUG("[String] 子串: 0x%x[%u:%u] = 0x%x\n", ref, start, end, result);
     
@@ -195,3 +221,327 @@ void j2me_heap_string_print(j2me_heap_t* heap, j2me_ref_t ref) {
         LOG_DEBUG("[String] ref=0x%x (invalid)\n", ref);
     }
 }
+
+// ============================================================================
+// 驻留表和去重
+// ============================================================================
+
+/**
+ * @brief 内容哈希（FNV-1a）
+ */
+static uint32_t hash_chars(const char* str, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 获取驻留表，不存在时创建
+ */
+static j2me_string_table_t* ensure_table(j2me_heap_t* heap) {
+    if (heap->string_table) {
+        return heap->string_table;
+    }
+    
+    j2me_string_table_t* table = (j2me_string_table_t*)calloc(1, sizeof(j2me_string_table_t));
+    if (!table) {
+        return NULL;
+    }
+    table->entries = (j2me_string_table_entry_t*)calloc(STRING_TABLE_INITIAL_CAPACITY,
+                                                        sizeof(j2me_string_table_entry_t));
+    if (!table->entries) {
+        free(table);
+        return NULL;
+    }
+    table->capacity = STRING_TABLE_INITIAL_CAPACITY;
+    heap->string_table = table;
+    return table;
+}
+
+/**
+ * @brief 表项是否是内容为str的String（引用被释放或复用后表项可能过期）
+ */
+static bool entry_matches(j2me_heap_t* heap, const j2me_string_table_entry_t* entry,
+                          uint32_t hash, const char* str, size_t length) {
+    if (entry->hash != hash) {
+        return false;
+    }
+    j2me_heap_object_header_t* obj = j2me_heap_get_object(heap, entry->ref);
+    if (!obj || obj->class_id != J2ME_CLASS_STRING) {
+        return false;
+    }
+    const j2me_string_data_t* data = string_data(heap, entry->ref);
+    return data && data->length == length && memcmp(data->chars, str, length) == 0;
+}
+
+/**
+ * @brief 查找内容为str的驻留String
+ */
+static j2me_ref_t table_lookup(j2me_heap_t* heap, j2me_string_table_t* table,
+                               uint32_t hash, const char* str, size_t length) {
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask; table->entries[i].ref != J2ME_NULL_REF; i = (i + 1) & mask) {
+        if (entry_matches(heap, &table->entries[i], hash, str, length)) {
+            return table->entries[i].ref;
+        }
+    }
+    return J2ME_NULL_REF;
+}
+
+/**
+ * @brief 把表项放入空槽（调用方保证有空槽）
+ */
+static void place_entry(j2me_string_table_entry_t* entries, size_t capacity, j2me_ref_t ref, uint32_t hash) {
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (entries[i].ref != J2ME_NULL_REF) {
+        i = (i + 1) & mask;
+    }
+    entries[i].ref = ref;
+    entries[i].hash = hash;
+}
+
+/**
+ * @brief 加入驻留表，装载率超过1/2时扩容
+ * @return 扩容失败返回false（字符串照常使用，只是不驻留）
+ */
+static bool table_insert(j2me_string_table_t* table, j2me_ref_t ref, uint32_t hash) {
+    if ((table->count + 1) * 2 > table->capacity) {
+        size_t capacity = table->capacity * 2;
+        j2me_string_table_entry_t* entries =
+            (j2me_string_table_entry_t*)calloc(capacity, sizeof(j2me_string_table_entry_t));
+        if (!entries) {
+            LOG_WARN("[String] 驻留表扩容失败");
+            return false;
+        }
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->entries[i].ref != J2ME_NULL_REF) {
+                place_entry(entries, capacity, table->entries[i].ref, table->entries[i].hash);
+            }
+        }
+        free(table->entries);
+        table->entries = entries;
+        table->capacity = capacity;
+    }
+    
+    place_entry(table->entries, table->capacity, ref, hash);
+    table->count++;
+    return true;
+}
+
+j2me_ref_t j2me_heap_string_intern(j2me_heap_t* heap, const char* str, size_t length) {
+    if (!heap || !str) {
+        return J2ME_NULL_REF;
+    }
+    
+    j2me_string_table_t* table = ensure_table(heap);
+    if (!table) {
+        return j2me_heap_string_create_n(heap, str, length);
+    }
+    
+    uint32_t hash = hash_chars(str, length);
+    j2me_ref_t ref = table_lookup(heap, table, hash, str, length);
+    if (ref != J2ME_NULL_REF) {
+        table->hits++;
+        return ref;
+    }
+    
+    // 分配可能触发回收并重排驻留表，之后重新找空槽
+    ref = j2me_heap_string_create_n(heap, str, length);
+    if (ref != J2ME_NULL_REF) {
+        table->misses++;
+        table_insert(table, ref, hash);
+    }
+    return ref;
+}
+
+j2me_ref_t j2me_heap_string_intern_ref(j2me_heap_t* heap, j2me_ref_t ref) {
+    if (!heap) {
+        return ref;
+    }
+    j2me_heap_object_header_t* obj = j2me_heap_get_object(heap, ref);
+    j2me_string_data_t* data = string_data(heap, ref);
+    j2me_string_table_t* table = ensure_table(heap);
+    if (!obj || obj->class_id != J2ME_CLASS_STRING || !data || !table) {
+        return ref;
+    }
+    
+    uint32_t hash = hash_chars(data->chars, data->length);
+    j2me_ref_t interned = table_lookup(heap, table, hash, data->chars, data->length);
+    if (interned != J2ME_NULL_REF) {
+        table->hits++;
+        return interned;
+    }
+    
+    table->misses++;
+    table_insert(table, ref, hash);
+    return ref;
+}
+
+j2me_error_t j2me_heap_string_set_dedup(j2me_heap_t* heap, bool enabled) {
+    if (!heap) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    j2me_string_table_t* table = ensure_table(heap);
+    if (!table) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    table->dedup = enabled;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 删除不再存活的表项（重建槽位数组，重建失败时保留过期表项，查找时会跳过）
+ */
+static void prune_table(j2me_heap_t* heap, j2me_string_table_t* table) {
+    j2me_string_table_entry_t* entries =
+        (j2me_string_table_entry_t*)calloc(table->capacity, sizeof(j2me_string_table_entry_t));
+    if (!entries) {
+        return;
+    }
+    
+    size_t count = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        j2me_string_table_entry_t* entry = &table->entries[i];
+        if (entry->ref != J2ME_NULL_REF && j2me_heap_is_live(heap, entry->ref)) {
+            place_entry(entries, table->capacity, entry->ref, entry->hash);
+            count++;
+        }
+    }
+    
+    if (count < table->count) {
+        LOG_DEBUG("[String] 驻留表清理%zu个字符串，剩余%zu个\n", table->count - count, count);
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->count = count;
+}
+
+/**
+ * @brief 可以参与去重的String：存活、未共享、位于老年代且未固定
+ */
+static j2me_string_data_t* dedup_candidate(j2me_heap_t* heap, j2me_ref_t ref) {
+    j2me_heap_object_header_t* obj = heap->objects[ref];
+    if (!obj || obj->class_id != J2ME_CLASS_STRING || (obj->flags & J2ME_HEAP_FLAG_PINNED) ||
+        (uint8_t*)obj >= heap->nursery || obj->size < sizeof(j2me_string_data_t)) {
+        return NULL;
+    }
+    j2me_string_data_t* data = (j2me_string_data_t*)obj->data;
+    if ((data->length & J2ME_STRING_SHARED) || data->length < J2ME_STRING_DEDUP_MIN_LENGTH ||
+        data->length > obj->size - sizeof(j2me_string_data_t) || !j2me_heap_is_live(heap, ref)) {
+        return NULL;
+    }
+    return data;
+}
+
+/**
+ * @brief 去重：内容相同的字符串改为引用同一个规范String，缩小对象释放字符占用的空间
+ *
+ * 驻留的String优先作为规范String，因此驻留表中的String总是自己存放字符。
+ */
+static void deduplicate(j2me_heap_t* heap, j2me_string_table_t* table) {
+    size_t candidates = 0;
+    for (j2me_ref_t ref = 1; ref < heap->next_ref; ref++) {
+        if (dedup_candidate(heap, ref)) {
+            candidates++;
+        }
+    }
+    if (candidates < 2) {
+        return;
+    }
+    
+    size_t capacity = 1;
+    while (capacity < candidates * 2) {
+        capacity <<= 1;
+    }
+    j2me_string_table_entry_t* seen =
+        (j2me_string_table_entry_t*)calloc(capacity, sizeof(j2me_string_table_entry_t));
+    if (!seen) {
+        return;
+    }
+    
+    size_t mask = capacity - 1;
+    size_t deduplicated = 0;
+    size_t saved = 0;
+    for (size_t pass = 0; pass < 2; pass++) {
+        size_t limit = pass == 0 ? table->capacity : heap->next_ref;
+        for (size_t i = 0; i < limit; i++) {
+            j2me_ref_t ref = pass == 0 ? table->entries[i].ref : (j2me_ref_t)i;
+            if (ref == J2ME_NULL_REF) {
+                continue;
+            }
+            j2me_string_data_t* data = dedup_candidate(heap, ref);
+            if (!data) {
+                continue;
+            }
+    
+            uint32_t hash = hash_chars(data->chars, data->length);
+            size_t slot = hash & mask;
+            j2me_ref_t canonical = J2ME_NULL_REF;
+            for (; seen[slot].ref != J2ME_NULL_REF; slot = (slot + 1) & mask) {
+                if (seen[slot].hash != hash) {
+                    continue;
+                }
+                const j2me_string_data_t* other = (const j2me_string_data_t*)heap->objects[seen[slot].ref]->data;
+                if (other->length == data->length && memcmp(other->chars, data->chars, data->length) == 0) {
+                    canonical = seen[slot].ref;
+                    break;
+                }
+            }
+    
+            if (canonical == J2ME_NULL_REF) {
+                seen[slot].ref = ref;
+                seen[slot].hash = hash;
+                continue;
+            }
+            if (canonical == ref) {
+                continue;
+            }
+    
+            size_t block_size = J2ME_HEAP_BLOCK_SIZE(heap->objects[ref]->size);
+            if (j2me_heap_shrink_object(heap, ref, sizeof(j2me_string_data_t) + sizeof(j2me_ref_t))) {
+                data->length |= J2ME_STRING_SHARED;
+                memcpy(data->chars, &canonical, sizeof(j2me_ref_t));
+                deduplicated++;
+                saved += block_size - J2ME_HEAP_BLOCK_SIZE(heap->objects[ref]->size);
+            }
+        }
+    }
+    free(seen);
+    
+    if (deduplicated > 0) {
+        table->strings_deduplicated += deduplicated;
+        table->bytes_deduplicated += saved;
+        LOG_DEBUG("[String] 去重%zu个字符串，释放%zu bytes\n", deduplicated, saved);
+    }
+}
+
+void j2me_string_table_sweep(j2me_heap_t* heap) {
+    if (!heap || !heap->string_table) {
+        return;
+    }
+    
+    j2me_string_table_t* table = heap->string_table;
+    if (table->count > 0 && !heap->mark_overflow) {
+        prune_table(heap, table);
+    }
+    // 新生代回收只涉及新生代对象，去重只在完整回收时进行
+    if (table->dedup && !heap->minor && !heap->mark_overflow) {
+        deduplicate(heap, table);
+    }
+}
+
+void j2me_string_table_destroy(j2me_string_table_t* table) {
+    if (!table) {
+        return;
+    }
+    
+    LOG_DEBUG("[String] 销毁驻留表: %zu个字符串, 命中%llu次, 未命中%llu次, 去重%llu个字符串(%llu bytes)\n",
+              table->count, (unsigned long long)table->hits, (unsigned long long)table->misses,
+              (unsigned long long)table->strings_deduplicated, (unsigned long long)table->bytes_deduplicated);
+    free(table->entries);
+    free(table);
+}
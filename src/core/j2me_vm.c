@@ -6,6 +6,12 @@
 #include "j2me_input.h"
 #include "j2me_gc.h"
 #include "j2me_object.h"
+#include "j2me_field_access.h"
+#include "j2me_alloc_profiler.h"
+#include "j2me_opcode_profiler.h"
+#include "j2me_jit.h"
+#include "j2me_heap_dump.h"
+#include "j2me_string.h"
 #include "j2me_log.h"
 #include <stdlib.h>
 #include <string.h>
@@ -22,6 +28,7 @@
 #define DEFAULT_HEAP_SIZE       (1024 * 1024)  // 1MB
 #define DEFAULT_STACK_SIZE      (64 * 1024)    // 64KB
 #define DEFAULT_MAX_THREADS     16
+#define DEFAULT_GC_STEP_BUDGET_US 1000         // 1ms（60fps一帧约16ms）
 
 j2me_vm_config_t j2me_vm_get_default_config(void) {
     j2me_vm_config_t config = {
@@ -29,7 +36,17 @@ j2me_vm_config_t j2me_vm_get_default_config(void) {
         .stack_size = DEFAULT_STACK_SIZE,
         .max_threads = DEFAULT_MAX_THREADS,
         .enable_gc = true,
-        .enable_jit = false  // 暂时禁用JIT
+        .heap_compact_ratio = J2ME_HEAP_DEFAULT_COMPACT_RATIO,
+        .gc_step_budget_us = DEFAULT_GC_STEP_BUDGET_US,
+        .enable_jit = false,  // 默认只解释执行
+        .jit_threshold = J2ME_JIT_DEFAULT_THRESHOLD,
+        .jit_perf_map = false,
+        .execution_mode = J2ME_EXEC_MODE_THREADED,
+        .alloc_profile_path = NULL,  // 默认不做分配分析
+        .alloc_sample_interval = J2ME_ALLOC_PROFILER_DEFAULT_INTERVAL,
+        .heap_dump_path = NULL,  // 默认不写堆快照
+        .string_dedup = false,  // 默认不去重字符串
+        .opcode_profile_path = NULL  // 默认不做指令序列分析
     };
     return config;
 }
@@ -52,34 +69,68 @@ j2me_vm_t* j2me_vm_create(const j2me_vm_config_t* config) {
     vm->current_canvas_ref = 0; // 初始化Canvas引用为0
     vm->last_canvas_object_ref = 0; // 初始化最后创建的Canvas对象引用为0
     
-    // 分配堆内存（旧系统，保留兼容）
-    vm->heap_start = malloc(config->heap_size);
-    if (!vm->heap_start) {
-        free(vm);
-        return NULL;
-    }
-    
-    vm->heap_end = (char*)vm->heap_start + config->heap_size;
-    vm->heap_current = vm->heap_start;
-    
-    // 创建新的对象堆系统
+    // 创建对象堆（所有对象都在这里分配）
     vm->heap = j2me_heap_create(config->heap_size);
     if (!vm->heap) {
         LOG_ERROR("[VM] 对象堆创建失败");
-        free(vm->heap_start);
         free(vm);
         return NULL;
     }
+    j2me_heap_set_compact_ratio(vm->heap, config->heap_compact_ratio);
+    if (config->string_dedup) {
+        j2me_heap_string_set_dedup(vm->heap, true);
+    }
 
-    // 创建垃圾回收器
-    vm->gc = j2me_gc_create(vm, vm->heap_start, config->heap_size);
+    // 创建垃圾回收器（负责堆的根扫描）
+    vm->gc = j2me_gc_create(vm, vm->heap);
     if (!vm->gc) {
         j2me_heap_destroy(vm->heap);
-        free(vm->heap_start);
+        free(vm);
+        return NULL;
+    }
+    if (!config->enable_gc) {
+        j2me_gc_set_enabled(vm->gc, false);
+    }
+
+    // 创建解释器性能统计
+    vm->perf_stats = j2me_performance_stats_create();
+    if (!vm->perf_stats) {
+        j2me_gc_destroy(vm->gc);
+        j2me_heap_destroy(vm->heap);
         free(vm);
         return NULL;
     }
 
+    // 分配分析器（可选，失败时只是不分析）
+    if (config->alloc_profile_path) {
+        vm->alloc_profiler = j2me_alloc_profiler_create(vm, config->alloc_profile_path, config->alloc_sample_interval);
+        if (vm->alloc_profiler) {
+            j2me_alloc_profiler_install_signal_handler();
+        } else {
+            LOG_WARN("[VM] 分配分析器创建失败");
+        }
+    }
+    
+    if (config->heap_dump_path) {
+        j2me_heap_dump_install_signal_handler();
+    }
+    
+    // 指令序列分析器（可选，失败时只是不分析）
+    if (config->opcode_profile_path) {
+        vm->opcode_profiler = j2me_opcode_profiler_create(config->opcode_profile_path);
+        if (!vm->opcode_profiler) {
+            LOG_WARN("[VM] 指令序列分析器创建失败");
+        }
+    }
+    
+    // JIT编译器（可选，失败时只是解释执行）
+    if (config->enable_jit) {
+        vm->jit = j2me_jit_create(config->jit_threshold, config->jit_perf_map);
+        if (!vm->jit) {
+            LOG_WARN("[VM] JIT编译器创建失败，使用解释器执行");
+        }
+    }
+    
     LOG_INFO("[VM] 虚拟机创建成功，堆大小: %zu bytes", config->heap_size);
     return vm;
 }
@@ -94,6 +145,17 @@ void j2me_vm_destroy(j2me_vm_t* vm) {
         j2me_vm_stop(vm);
     }
     
+    // 写出分配分析报告（需要类加载器中的类名和方法名，先于其他组件销毁）
+    if (vm->alloc_profiler) {
+        j2me_alloc_profiler_destroy(vm->alloc_profiler);
+        vm->alloc_profiler = NULL;
+    }
+    
+    if (vm->opcode_profiler) {
+        j2me_opcode_profiler_destroy(vm->opcode_profiler);
+        vm->opcode_profiler = NULL;
+    }
+    
     // 销毁垃圾回收器
     if (vm->gc) {
         j2me_gc_destroy(vm->gc);
@@ -127,12 +189,27 @@ void j2me_vm_destroy(j2me_vm_t* vm) {
     
     // 销毁类加载器
     if (vm->class_loader) {
+        uint64_t lookups = 0, hits = 0, probes = 0;
+        j2me_class_loader_get_lookup_stats((j2me_class_loader_t*)vm->class_loader, &lookups, &hits, &probes);
+        LOG_DEBUG("[VM] 类查找: %llu次, 命中%llu次, 平均探测%.2f个槽位\n",
+                  (unsigned long long)lookups, (unsigned long long)hits,
+                  lookups ? (double)probes / lookups : 0.0);
         j2me_class_loader_destroy((j2me_class_loader_t*)vm->class_loader);
     }
     
-    // 释放堆内存
-    if (vm->heap_start) {
-        free(vm->heap_start);
+    // 编译后的方法随类一起释放，之后才能释放代码缓存
+    if (vm->jit) {
+        j2me_jit_destroy(vm->jit);
+        vm->jit = NULL;
+    }
+    
+    // 输出并销毁解释器性能统计
+    if (vm->perf_stats) {
+        LOG_DEBUG("[VM] 执行模式: %s\n",
+                  vm->config.execution_mode == J2ME_EXEC_MODE_PREDECODED ? "预解码" : "线程化分发");
+        j2me_performance_stats_print_report(vm->perf_stats);
+        j2me_performance_stats_destroy(vm->perf_stats);
+        vm->perf_stats = NULL;
     }
     
     // 释放虚拟机结构
@@ -259,7 +336,7 @@ j2me_error_t j2me_vm_start(j2me_vm_t* vm, const char* main_class) {
     LOG_DEBUG("[VM] 找到main方法，开始执行\n");
     // 创建主线程的栈帧并执行main方法
     if (vm->main_thread) {
-        j2me_stack_frame_t* main_frame = j2me_stack_frame_create(main_method->max_stack, main_method->max_locals);
+        j2me_stack_frame_t* main_frame = j2me_thread_create_frame(vm, vm->main_thread, main_method->max_stack, main_method->max_locals);
         if (!main_frame) {
             LOG_ERROR("[VM] 错误: 主方法栈帧创建失败");
             return J2ME_ERROR_OUT_OF_MEMORY;
@@ -267,6 +344,7 @@ j2me_error_t j2me_vm_start(j2me_vm_t* vm, const char* main_class) {
         
         // 设置栈帧信息
         main_frame->bytecode = main_method->bytecode;
+        main_frame->code_length = main_method->bytecode_length;
         main_frame->pc = 0;
         main_frame->method_info = main_method;
         
@@ -306,10 +384,19 @@ j2me_error_t j2me_vm_execute_time_slice(j2me_vm_t* vm, uint32_t time_slice) {
         if (result != J2ME_SUCCESS) {
             return result;
         }
-        
-        vm->instructions_executed += instructions_to_execute;
     }
     
+    // 时间片之间做一段增量标记，避免分配失败时整堆停顿
+    if (vm->config.enable_gc && vm->config.gc_step_budget_us > 0) {
+        j2me_heap_collect_step(vm->heap, vm->config.gc_step_budget_us);
+    }
+    
+    // 收到SIGUSR1后写出分配分析报告
+    j2me_alloc_profiler_poll(vm->alloc_profiler);
+    
+    // 收到SIGUSR2后写出堆快照
+    j2me_heap_dump_poll(vm);
+    
     return J2ME_SUCCESS;
 }
 
@@ -329,7 +416,7 @@ void j2me_vm_key_event_handler(j2me_key_event_t* event, void* user_data) {
     // 这里需要找到当前活动的Canvas对象并调用相应的事件方法
     
     // 创建临时栈帧用于方法调用
-    j2me_stack_frame_t* frame = j2me_stack_frame_create(10, 5);
+    j2me_stack_frame_t* frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
     if (!frame) {
         LOG_ERROR("[VM事件] 错误: 创建栈帧失败");
         return;
@@ -376,7 +463,7 @@ void j2me_vm_pointer_event_handler(j2me_pointer_event_t* event, void* user_data)
     // TODO: 调用当前Canvas的pointerPressed/pointerReleased/pointerDragged方法
     
     // 创建临时栈帧用于方法调用
-    j2me_stack_frame_t* frame = j2me_stack_frame_create(10, 5);
+    j2me_stack_frame_t* frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
     if (!frame) {
         LOG_ERROR("[VM事件] 错误: 创建栈帧失败");
         return;
@@ -157,6 +157,7 @@ static const j2me_instruction_info_t instruction_table[] = {
     {OPCODE_LOR,         "lor",         0, -2},
     {OPCODE_IXOR,        "ixor",        0, -1},
     {OPCODE_LXOR,        "lxor",        0, -2},
+    {OPCODE_IINC,        "iinc",        2,  0},
     
     // 类型转换指令
     {OPCODE_I2L,         "i2l",         0,  1},
@@ -237,6 +238,18 @@ static const j2me_instruction_info_t instruction_table[] = {
     {OPCODE_IFNONNULL,   "ifnonnull",   2, -1},
     {OPCODE_GOTO_W,      "goto_w",      4,  0},
     {OPCODE_JSR_W,       "jsr_w",       4,  1},
+    
+    // 快速指令
+    {OPCODE_LDC_QUICK,       "ldc_quick",       1,  1},
+    {OPCODE_LDC_W_QUICK,     "ldc_w_quick",     2,  1},
+    {OPCODE_GETSTATIC_QUICK, "getstatic_quick", 2,  1},
+    {OPCODE_PUTSTATIC_QUICK, "putstatic_quick", 2, -1},
+    {OPCODE_GETFIELD_QUICK,  "getfield_quick",  2,  0},
+    {OPCODE_PUTFIELD_QUICK,  "putfield_quick",  2, -2},
+    {OPCODE_INVOKEVIRTUAL_QUICK,   "invokevirtual_quick",   2, -1},
+    {OPCODE_INVOKESPECIAL_QUICK,   "invokespecial_quick",   2, -1},
+    {OPCODE_INVOKESTATIC_QUICK,    "invokestatic_quick",    2,  0},
+    {OPCODE_INVOKEINTERFACE_QUICK, "invokeinterface_quick", 4, -1},
 };
 
 #define INSTRUCTION_COUNT (sizeof(instruction_table) / sizeof(instruction_table[0]))
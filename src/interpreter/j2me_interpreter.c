@@ -6,10 +6,14 @@
 #include "j2me_field_access.h"
 #include "j2me_method_invocation.h"
 #include "j2me_exception.h"
+#include "j2me_quicken.h"
+#include "j2me_opcode_profiler.h"
+#include "j2me_jit.h"
 #include <stdlib.h>
 #include <string.h>
 #include "j2me_log.h"
 #include <stdio.h>
+#include <time.h>
 
 /**
  * @file j2me_interpreter.c
@@ -97,12 +101,14 @@ j2me_operand_stack_t* j2me_operand_stack_create(size_t size) {
         return NULL;
     }
     
-    stack->data = (j2me_int*)malloc(sizeof(j2me_int) * size);
-    if (!stack->data) {
+    j2me_int* buffer = (j2me_int*)calloc(size + J2ME_OPERAND_STACK_RESERVED, sizeof(j2me_int));
+    if (!buffer) {
         free(stack);
         return NULL;
     }
     
+    stack->data = buffer + J2ME_OPERAND_STACK_RESERVED;
+    
     stack->size = size;
     stack->top = 0;
     
@@ -112,7 +118,7 @@ j2me_operand_stack_t* j2me_operand_stack_create(size_t size) {
 void j2me_operand_stack_destroy(j2me_operand_stack_t* stack) {
     if (stack) {
         if (stack->data) {
-            free(stack->data);
+            free(stack->data - J2ME_OPERAND_STACK_RESERVED);
         }
         free(stack);
     }
@@ -156,7 +162,7 @@ j2me_stack_frame_t* j2me_stack_frame_create(size_t max_stack, size_t max_locals)
     // 创建局部变量表
     frame->local_vars.variables = (j2me_int*)malloc(sizeof(j2me_int) * max_locals);
     if (!frame->local_vars.variables) {
-        free(frame->operand_stack.data);
+        free(frame->operand_stack.data - J2ME_OPERAND_STACK_RESERVED);
         free(frame);
         return NULL;
     }
@@ -285,10 +291,184 @@ j2me_error_t j2me_interpreter_parse_method_parameters(const char* descriptor,
     return J2ME_SUCCESS;
 }
 
+// 帧栈区内栈帧、局部变量表和操作数栈的对齐
+#define FRAME_ARENA_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/**
+ * @brief 帧栈区中一个栈帧占用的字节数
+ */
+static size_t frame_arena_footprint(size_t max_stack, size_t max_locals) {
+    return FRAME_ARENA_ALIGN(sizeof(j2me_stack_frame_t)) +
+           FRAME_ARENA_ALIGN(sizeof(j2me_int) * max_locals) +
+           FRAME_ARENA_ALIGN(sizeof(j2me_int) * (max_stack + J2ME_OPERAND_STACK_RESERVED));
+}
+
+j2me_stack_frame_t* j2me_frame_arena_push(j2me_frame_arena_t* arena, size_t max_stack, size_t max_locals) {
+    if (!arena) {
+        return NULL;
+    }
+    
+    if (!arena->base) {
+        arena->base = (uint8_t*)malloc(J2ME_FRAME_ARENA_SIZE);
+        if (!arena->base) {
+            return NULL;
+        }
+        arena->size = J2ME_FRAME_ARENA_SIZE;
+        arena->top = 0;
+    }
+    
+    size_t footprint = frame_arena_footprint(max_stack, max_locals);
+    if (footprint > arena->size - arena->top) {
+        if (!arena->exhausted_warned) {
+            LOG_WARN("[解释器] 帧栈区空间不足 (已用%zu/%zu字节)，之后放不下的栈帧改用堆分配", arena->top, arena->size);
+            arena->exhausted_warned = true;
+        }
+        return NULL;
+    }
+    
+    uint8_t* block = arena->base + arena->top;
+    
+    j2me_stack_frame_t* frame = (j2me_stack_frame_t*)block;
+    memset(frame, 0, sizeof(j2me_stack_frame_t));
+    frame->arena = arena;
+    frame->arena_below = arena->last;
+    arena->last = arena->top;
+    arena->top += footprint;
+    
+    // 局部变量表和操作数栈紧跟在栈帧之后
+    block += FRAME_ARENA_ALIGN(sizeof(j2me_stack_frame_t));
+    frame->local_vars.variables = (j2me_int*)block;
+    frame->local_vars.size = max_locals;
+    memset(frame->local_vars.variables, 0, sizeof(j2me_int) * max_locals);
+    
+    block += FRAME_ARENA_ALIGN(sizeof(j2me_int) * max_locals);
+    frame->operand_stack.data = (j2me_int*)block + J2ME_OPERAND_STACK_RESERVED;
+    frame->operand_stack.size = max_stack;
+    frame->operand_stack.top = 0;
+    
+    return frame;
+}
+
+/**
+ * @brief 把栈帧归还给帧栈区
+ */
+static void frame_arena_pop(j2me_frame_arena_t* arena, j2me_stack_frame_t* frame) {
+    size_t offset = (size_t)((uint8_t*)frame - arena->base);
+    size_t footprint = frame_arena_footprint(frame->operand_stack.size, frame->local_vars.size);
+    if (offset + footprint != arena->top) {
+        // 上方还有存活的栈帧，不能移动栈顶；先标记为已释放，等上方的栈帧释放时一起回收。
+        // 清空它的槽位使其不再作为根，并保持栈帧头完整以便按顺序遍历
+        LOG_WARN("[解释器] 帧栈区栈帧未按顺序释放 (偏移%zu, 栈顶%zu)", offset, arena->top);
+        memset(frame->local_vars.variables, 0, sizeof(j2me_int) * frame->local_vars.size);
+        memset(frame->operand_stack.data, 0, sizeof(j2me_int) * frame->operand_stack.size);
+        frame->operand_stack.top = 0;
+        frame->has_return_value = false;
+        frame->arena_released = true;
+        return;
+    }
+    
+    // 回退栈顶，并越过下方已提前释放的栈帧
+    arena->top = offset;
+    arena->last = frame->arena_below;
+    while (arena->top > 0) {
+        j2me_stack_frame_t* below = (j2me_stack_frame_t*)(arena->base + arena->last);
+        if (!below->arena_released) {
+            break;
+        }
+        arena->top = arena->last;
+        arena->last = below->arena_below;
+    }
+}
+
+void j2me_frame_arena_release(j2me_frame_arena_t* arena) {
+    if (arena) {
+        free(arena->base);
+        arena->base = NULL;
+        arena->size = 0;
+        arena->top = 0;
+        arena->last = 0;
+    }
+}
+
+j2me_stack_frame_t* j2me_thread_create_frame(j2me_vm_t* vm, j2me_thread_t* thread, size_t max_stack, size_t max_locals) {
+    if (thread) {
+        j2me_stack_frame_t* frame = j2me_frame_arena_push(&thread->frame_arena, max_stack, max_locals);
+        if (frame) {
+            return frame;
+        }
+    }
+    
+    j2me_stack_frame_t* frame = j2me_stack_frame_create(max_stack, max_locals);
+    if (!frame) {
+        return NULL;
+    }
+    
+    // 登记到所属线程（没有线程时登记到虚拟机）的堆分配栈帧链表，GC根扫描时访问
+    j2me_stack_frame_t** list = thread ? &thread->heap_frames : (vm ? &vm->heap_frames : NULL);
+    if (list) {
+        frame->heap_list = list;
+        frame->heap_next = *list;
+        if (*list) {
+            (*list)->heap_prev = frame;
+        }
+        *list = frame;
+    }
+    return frame;
+}
+
+/**
+ * @brief 标记栈帧的局部变量表和整个操作数栈
+ */
+static void mark_frame_roots(j2me_heap_t* heap, j2me_stack_frame_t* frame) {
+    j2me_heap_mark_slots(heap, frame->local_vars.variables, frame->local_vars.size);
+    j2me_heap_mark_slots(heap, frame->operand_stack.data, frame->operand_stack.size);
+    if (frame->has_return_value) {
+        j2me_heap_mark_ref(heap, (j2me_ref_t)frame->return_value);
+    }
+}
+
+void j2me_interpreter_mark_roots(j2me_vm_t* vm, j2me_heap_t* heap) {
+    if (!vm || !heap) {
+        return;
+    }
+    
+    for (j2me_thread_t* thread = vm->thread_list; thread; thread = thread->next) {
+        j2me_heap_mark_ref(heap, (j2me_ref_t)(uintptr_t)thread->thread_object);
+        j2me_heap_mark_ref(heap, (j2me_ref_t)(uintptr_t)thread->runnable_object);
+        
+        // 帧栈区中的栈帧首尾相接，按各自占用的字节数依次访问
+        j2me_frame_arena_t* arena = &thread->frame_arena;
+        size_t offset = 0;
+        while (arena->base && offset < arena->top) {
+            j2me_stack_frame_t* frame = (j2me_stack_frame_t*)(arena->base + offset);
+            mark_frame_roots(heap, frame);
+            offset += frame_arena_footprint(frame->operand_stack.size, frame->local_vars.size);
+        }
+        
+        for (j2me_stack_frame_t* frame = thread->heap_frames; frame; frame = frame->heap_next) {
+            mark_frame_roots(heap, frame);
+        }
+    }
+    
+    for (j2me_stack_frame_t* frame = vm->heap_frames; frame; frame = frame->heap_next) {
+        mark_frame_roots(heap, frame);
+    }
+}
+
 void j2me_stack_frame_destroy(j2me_stack_frame_t* frame) {
-    if (frame) {
+    if (frame && frame->arena) {
+        frame_arena_pop(frame->arena, frame);
+    } else if (frame) {
+        if (frame->heap_prev) {
+            frame->heap_prev->heap_next = frame->heap_next;
+        } else if (frame->heap_list && *frame->heap_list == frame) {
+            *frame->heap_list = frame->heap_next;
+        }
+        if (frame->heap_next) {
+            frame->heap_next->heap_prev = frame->heap_prev;
+        }
         if (frame->operand_stack.data) {
-            free(frame->operand_stack.data);
+            free(frame->operand_stack.data - J2ME_OPERAND_STACK_RESERVED);
         }
         if (frame->local_vars.variables) {
             free(frame->local_vars.variables);
@@ -297,6 +477,53 @@ void j2me_stack_frame_destroy(j2me_stack_frame_t* frame) {
     }
 }
 
+// 指令解析成功并改写为快速指令后，从快速指令重新执行
+#define TRY_QUICKEN() do { \
+        if (j2me_quicken_instruction(vm, frame, frame->pc - 1) == J2ME_SUCCESS) { \
+            frame->pc--; \
+            return execute_single_instruction(vm, frame); \
+        } \
+    } while (0)
+
+j2me_error_t j2me_interpreter_invoke_resolved(j2me_vm_t* vm, j2me_stack_frame_t* frame,
+                                              const j2me_resolved_call_t* call, j2me_call_site_cache_t* site) {
+    vm->last_method_has_return_value = false;
+    
+    j2me_error_t result = j2me_method_invocation_invoke_resolved(vm, frame, call, site);
+    if (result != J2ME_SUCCESS) {
+        LOG_DEBUG("[解释器] 快速调用失败: %d\n", result);
+        
+        // 检查是否有异常
+        if (j2me_has_pending_exception(vm)) {
+            j2me_exception_t* exception = j2me_get_current_exception(vm);
+            j2me_handle_exception(vm, exception);
+        }
+    } else if (vm->last_method_has_return_value) {
+        result = j2me_operand_stack_push(&frame->operand_stack, vm->last_method_return_value);
+        vm->last_method_has_return_value = false;
+    }
+    return result;
+}
+
+/**
+ * @brief 执行已解析的方法调用（快速调用指令）
+ * @param vm 虚拟机实例
+ * @param frame 调用者栈帧
+ * @param call 调用目标
+ * @param pc 调用指令的字节码偏移（用于定位调用点内联缓存）
+ * @return 错误码
+ */
+static j2me_error_t invoke_quick(j2me_vm_t* vm, j2me_stack_frame_t* frame,
+                                 const j2me_resolved_call_t* call, uint32_t pc) {
+    // 按接收者分派的调用使用调用点内联缓存
+    j2me_call_site_cache_t* site = NULL;
+    if (call->flags & (J2ME_CALL_FLAG_VIRTUAL | J2ME_CALL_FLAG_INTERFACE)) {
+        site = j2me_call_site_cache_get((j2me_method_t*)frame->method_info, pc);
+    }
+    
+    return j2me_interpreter_invoke_resolved(vm, frame, call, site);
+}
+
 /**
  * @brief 执行单条字节码指令 (增强版本)
  * @param vm 虚拟机实例
@@ -312,9 +539,6 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
     j2me_error_t result = J2ME_SUCCESS;
     j2me_int value1, value2, result_value;
     
-    // 获取指令信息用于调试
-    const char* inst_name = j2me_get_instruction_name(opcode);
-    
     // 使用跳转表优化指令分发
     switch (opcode) {
         case OPCODE_NOP:
@@ -354,6 +578,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case 0x12: // OPCODE_LDC
+            TRY_QUICKEN();
             // 从常量池加载常量
             {
                 uint8_t index = frame->bytecode[frame->pc++];
@@ -939,6 +1164,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             return J2ME_SUCCESS; // 特殊处理，表示方法结束
             
         case OPCODE_GETSTATIC:
+            TRY_QUICKEN();
             // 获取静态字段
             {
                 uint16_t field_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1008,6 +1234,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_PUTSTATIC:
+            TRY_QUICKEN();
             // 设置静态字段
             {
                 uint16_t field_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1083,6 +1310,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_GETFIELD:
+            TRY_QUICKEN();
             // 获取实例字段
             {
                 uint16_t field_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1129,6 +1357,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_PUTFIELD:
+            TRY_QUICKEN();
             // 设置实例字段
             {
                 uint16_t field_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1177,6 +1406,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_INVOKESPECIAL:
+            TRY_QUICKEN();
             // 调用特殊方法 (构造方法、私有方法、父类方法)
             {
                 // 获取方法引用索引 (2字节)
@@ -1208,6 +1438,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_INVOKEVIRTUAL:
+            TRY_QUICKEN();
             // 调用虚方法
             {
                 uint16_t method_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1238,6 +1469,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_INVOKESTATIC:
+            TRY_QUICKEN();
             // 调用静态方法
             {
                 uint16_t method_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1268,6 +1500,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case OPCODE_INVOKEINTERFACE:
+            TRY_QUICKEN();
             // 调用接口方法
             {
                 uint16_t method_ref_index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1275,6 +1508,9 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
                 uint8_t zero = frame->bytecode[frame->pc + 3];   // 必须为0
                 frame->pc += 4;
                 
+                // 清除之前的返回值标志
+                vm->last_method_has_return_value = false;
+                
                 // 使用新的方法调用系统
                 result = j2me_method_invocation_invoke_interface(vm, frame, method_ref_index, count);
                 if (result != J2ME_SUCCESS) {
@@ -1285,6 +1521,13 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
                         j2me_exception_t* exception = j2me_get_current_exception(vm);
                         j2me_handle_exception(vm, exception);
                     }
+                } else {
+                    // 如果方法有返回值，将其压入栈
+                    if (vm->last_method_has_return_value) {
+                        result = j2me_operand_stack_push(&frame->operand_stack, vm->last_method_return_value);
+                        LOG_DEBUG("[解释器] invokeinterface: 压入返回值 0x%x\n", vm->last_method_return_value);
+                        vm->last_method_has_return_value = false;
+                    }
                 }
             }
             break;
@@ -1332,7 +1575,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
                                 // 使用类指针地址作为class_id
                                 uint32_t class_id = (uint32_t)(uintptr_t)target_class;
                                 
-                                // 计算对象大小（简化：使用固定大小）
+                                // 对象大小来自链接时计算的实例布局，未完成链接的类使用默认大小
                                 size_t object_size = target_class->instance_size > 0 ? target_class->instance_size : 64;
                                 
                                 // 在堆上创建对象
@@ -1394,6 +1637,7 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             break;
             
         case 0x13: // OPCODE_LDC_W
+            TRY_QUICKEN();
             // 从常量池加载常量 (宽索引)
             {
                 uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
@@ -1740,8 +1984,106 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
             }
             break;
             
+        case OPCODE_LDC_QUICK:
+            // 已解析的常量
+            {
+                uint16_t index = frame->bytecode[frame->pc++];
+                result = j2me_operand_stack_push(&frame->operand_stack, j2me_quicken_entry(frame, index)->u.constant);
+            }
+            break;
+            
+        case OPCODE_LDC_W_QUICK:
+            {
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                result = j2me_operand_stack_push(&frame->operand_stack, j2me_quicken_entry(frame, index)->u.constant);
+            }
+            break;
+            
+        case OPCODE_GETSTATIC_QUICK:
+            // 直接读取已解析的静态字段槽
+            {
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                result = j2me_operand_stack_push(&frame->operand_stack,
+                                                 j2me_quicken_entry(frame, index)->u.static_slot->int_value);
+            }
+            break;
+            
+        case OPCODE_PUTSTATIC_QUICK:
+            {
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                result = j2me_operand_stack_pop(&frame->operand_stack, &value1);
+                if (result == J2ME_SUCCESS) {
+                    j2me_value_t* slot = j2me_quicken_entry(frame, index)->u.static_slot;
+                    slot->type = J2ME_TYPE_INT;
+                    slot->int_value = value1;
+                }
+            }
+            break;
+            
+        case OPCODE_GETFIELD_QUICK:
+            {
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                j2me_int object_ref;
+                result = j2me_operand_stack_pop(&frame->operand_stack, &object_ref);
+                if (result == J2ME_SUCCESS) {
+                    j2me_value_t field_value;
+                    field_value.int_value = 0;
+                    // 对象引用为null时返回0
+                    if (object_ref != 0) {
+                        j2me_get_instance_field_value(vm, (j2me_object_t*)(intptr_t)object_ref,
+                                                      j2me_quicken_entry(frame, index)->u.field, &field_value);
+                    }
+                    result = j2me_operand_stack_push(&frame->operand_stack, field_value.int_value);
+                }
+            }
+            break;
+            
+        case OPCODE_PUTFIELD_QUICK:
+            {
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                j2me_int field_value, object_ref;
+                result = j2me_operand_stack_pop(&frame->operand_stack, &field_value);
+                if (result == J2ME_SUCCESS) {
+                    result = j2me_operand_stack_pop(&frame->operand_stack, &object_ref);
+                }
+                // 对象引用为null（构造过程中）时忽略字段设置
+                if (result == J2ME_SUCCESS && object_ref != 0) {
+                    j2me_value_t value;
+                    value.type = J2ME_TYPE_INT;
+                    value.int_value = field_value;
+                    j2me_set_instance_field_value(vm, (j2me_object_t*)(intptr_t)object_ref,
+                                                  j2me_quicken_entry(frame, index)->u.field, &value);
+                }
+            }
+            break;
+            
+        case OPCODE_INVOKEVIRTUAL_QUICK:
+        case OPCODE_INVOKESPECIAL_QUICK:
+        case OPCODE_INVOKESTATIC_QUICK:
+            {
+                uint32_t pc = frame->pc - 1;
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 2;
+                result = invoke_quick(vm, frame, &j2me_quicken_entry(frame, index)->u.call, pc);
+            }
+            break;
+            
+        case OPCODE_INVOKEINTERFACE_QUICK:
+            {
+                uint32_t pc = frame->pc - 1;
+                uint16_t index = (frame->bytecode[frame->pc] << 8) | frame->bytecode[frame->pc + 1];
+                frame->pc += 4;
+                result = invoke_quick(vm, frame, &j2me_quicken_entry(frame, index)->u.call, pc);
+            }
+            break;
+            
         default:
-            LOG_DEBUG("[解释器] 未实现的指令: %s (0x%02x)\n", inst_name, opcode);
+            LOG_DEBUG("[解释器] 未实现的指令: %s (0x%02x)\n", j2me_get_instruction_name(opcode), opcode);
             result = J2ME_ERROR_RUNTIME_EXCEPTION;
             break;
     }
@@ -1749,6 +2091,861 @@ static j2me_error_t execute_single_instruction(j2me_vm_t* vm, j2me_stack_frame_t
     return result;
 }
 
+#undef TRY_QUICKEN
+
+// ============================================================================
+// 线程化指令分发引擎
+// ============================================================================
+
+// GCC/Clang支持标签地址(&&label)，使用直接线程化分发；其他编译器回退到switch分发
+#if defined(__GNUC__) && !defined(J2ME_NO_THREADED_DISPATCH)
+#define J2ME_THREADED_DISPATCH 1
+#else
+#define J2ME_THREADED_DISPATCH 0
+#endif
+
+/**
+ * @brief 获取单调时钟时间（微秒），用于解释器性能统计
+ */
+static j2me_long interpreter_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (j2me_long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief 获取线程化分发引擎快速路径中指令的栈效果
+ * 
+ * 未快速化的ldc/getstatic/putstatic也按快速指令计算，因为它们第一次执行后会被原地改写成快速指令。
+ * 
+ * @param code 字节码
+ * @param pc 指令偏移
+ * @param pops 输出执行前至少需要的栈元素数
+ * @param delta 输出栈深度变化
+ * @param length 输出指令长度
+ * @return 快速路径处理该指令返回true
+ */
+static bool fast_path_stack_effect(const uint8_t* code, uint32_t pc, int* pops, int* delta, uint32_t* length) {
+    uint8_t opcode = code[pc];
+    *pops = 0;
+    *delta = 0;
+    *length = 1;
+    
+    switch (opcode) {
+        case OPCODE_NOP:
+        case OPCODE_RETURN:
+            return true;
+        case OPCODE_ACONST_NULL:
+        case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+        case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+        case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+        case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+            *delta = 1;
+            return true;
+        case OPCODE_BIPUSH:
+        case OPCODE_ILOAD:
+        case OPCODE_ALOAD:
+        case OPCODE_LDC:
+        case OPCODE_LDC_QUICK:
+            *delta = 1;
+            *length = 2;
+            return true;
+        case OPCODE_SIPUSH:
+        case OPCODE_LDC_W:
+        case OPCODE_LDC_W_QUICK:
+        case OPCODE_GETSTATIC:
+        case OPCODE_GETSTATIC_QUICK:
+            *delta = 1;
+            *length = 3;
+            return true;
+        case OPCODE_ISTORE_0: case OPCODE_ISTORE_1: case OPCODE_ISTORE_2: case OPCODE_ISTORE_3:
+        case OPCODE_ASTORE_0: case OPCODE_ASTORE_1: case OPCODE_ASTORE_2: case OPCODE_ASTORE_3:
+        case OPCODE_POP:
+        case OPCODE_IRETURN:
+        case OPCODE_ARETURN:
+            *pops = 1;
+            *delta = -1;
+            return true;
+        case OPCODE_ISTORE:
+        case OPCODE_ASTORE:
+            *pops = 1;
+            *delta = -1;
+            *length = 2;
+            return true;
+        case OPCODE_PUTSTATIC:
+        case OPCODE_PUTSTATIC_QUICK:
+            *pops = 1;
+            *delta = -1;
+            *length = 3;
+            return true;
+        case OPCODE_POP2:
+            *pops = 2;
+            *delta = -2;
+            return true;
+        case OPCODE_DUP:
+            *pops = 1;
+            *delta = 1;
+            return true;
+        case OPCODE_SWAP:
+            *pops = 2;
+            return true;
+        case OPCODE_IADD: case OPCODE_ISUB: case OPCODE_IMUL: case OPCODE_IDIV: case OPCODE_IREM:
+        case OPCODE_ISHL: case OPCODE_ISHR: case OPCODE_IUSHR:
+        case OPCODE_IAND: case OPCODE_IOR: case OPCODE_IXOR:
+            *pops = 2;
+            *delta = -1;
+            return true;
+        case OPCODE_INEG:
+            *pops = 1;
+            return true;
+        case OPCODE_IINC:
+            *length = 3;
+            return true;
+        case OPCODE_IFEQ: case OPCODE_IFNE: case OPCODE_IFLT: case OPCODE_IFGE: case OPCODE_IFGT: case OPCODE_IFLE:
+        case OPCODE_IFNULL: case OPCODE_IFNONNULL:
+            *pops = 1;
+            *delta = -1;
+            *length = 3;
+            return true;
+        case OPCODE_IF_ICMPEQ: case OPCODE_IF_ICMPNE: case OPCODE_IF_ICMPLT:
+        case OPCODE_IF_ICMPGE: case OPCODE_IF_ICMPGT: case OPCODE_IF_ICMPLE:
+            *pops = 2;
+            *delta = -2;
+            *length = 3;
+            return true;
+        case OPCODE_GOTO:
+            *length = 3;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 构建方法的栈深度检查表
+ * 
+ * 没有字节码验证器保证栈深度，所以线程化分发引擎只在检查点（批次开始、慢速指令之后、
+ * 向后跳转）检查一次：从每条指令出发，沿向前的控制流一直到下一个检查点（慢速指令、
+ * 向后跳转或返回），计算路径上需要的最少栈元素数和最大栈增长，换算成进入时允许的栈深度范围。
+ * 字节码从后向前扫描一遍即可。局部变量索引超出max_locals、跳到代码之外或非指令开头的位置、
+ * 栈深度超出max_stack时标记为不能进入快速路径，因此快速路径不需要检查局部变量索引和pc。
+ * 
+ * @param method 方法
+ * @return 检查表，内存不足返回NULL
+ */
+static j2me_stack_bound_t* build_stack_bounds(const j2me_method_t* method) {
+    const uint8_t* code = method->bytecode;
+    uint32_t length = method->bytecode_length;
+    const int max_stack = method->max_stack;
+    j2me_stack_bound_t* bounds = (j2me_stack_bound_t*)malloc(length * sizeof(j2me_stack_bound_t));
+    uint8_t* is_start = (uint8_t*)calloc(length, 1);
+    if (!bounds || !is_start) {
+        free(bounds);
+        free(is_start);
+        return NULL;
+    }
+    
+    for (uint32_t pc = 0; pc < length; pc++) {
+        bounds[pc].min_depth = J2ME_STACK_BOUND_UNSAFE;
+        bounds[pc].depth_range = 0;
+    }
+    for (uint32_t pc = 0; pc < length; ) {
+        int pops, delta;
+        uint32_t instruction_length;
+        is_start[pc] = 1;
+        if (!fast_path_stack_effect(code, pc, &pops, &delta, &instruction_length)) {
+            int slow_length = j2me_get_instruction_length(code, pc);
+            instruction_length = slow_length > 0 ? (uint32_t)slow_length : 1;
+        }
+        pc += instruction_length;
+    }
+    
+    for (uint32_t i = length; i-- > 0; ) {
+        if (!is_start[i]) {
+            continue;
+        }
+    
+        int pops, delta;
+        uint32_t instruction_length;
+        if (!fast_path_stack_effect(code, i, &pops, &delta, &instruction_length)) {
+            // 慢速指令自己检查栈，之后是检查点
+            bounds[i].min_depth = 0;
+            bounds[i].depth_range = (uint16_t)max_stack;
+            continue;
+        }
+    
+        uint8_t opcode = code[i];
+        uint32_t successors[2];
+        int successor_count = 0;
+        if (opcode != OPCODE_GOTO && opcode != OPCODE_RETURN &&
+            opcode != OPCODE_IRETURN && opcode != OPCODE_ARETURN) {
+            successors[successor_count++] = i + instruction_length;
+        }
+        if ((opcode >= OPCODE_IFEQ && opcode <= OPCODE_GOTO) ||
+            opcode == OPCODE_IFNULL || opcode == OPCODE_IFNONNULL) {
+            if (i + 2 >= length) {
+                continue;
+            }
+            successors[successor_count++] = i + (j2me_short)((code[i + 1] << 8) | code[i + 2]);
+        }
+    
+        // 快速路径不检查局部变量索引
+        int local_index = -1;
+        if (opcode == OPCODE_ILOAD || opcode == OPCODE_ALOAD || opcode == OPCODE_ISTORE ||
+            opcode == OPCODE_ASTORE || opcode == OPCODE_IINC) {
+            local_index = i + 1 < length ? code[i + 1] : J2ME_STACK_BOUND_UNSAFE;
+        } else if (opcode >= OPCODE_ILOAD_0 && opcode <= OPCODE_ILOAD_3) {
+            local_index = opcode - OPCODE_ILOAD_0;
+        } else if (opcode >= OPCODE_ALOAD_0 && opcode <= OPCODE_ALOAD_3) {
+            local_index = opcode - OPCODE_ALOAD_0;
+        } else if (opcode >= OPCODE_ISTORE_0 && opcode <= OPCODE_ISTORE_3) {
+            local_index = opcode - OPCODE_ISTORE_0;
+        } else if (opcode >= OPCODE_ASTORE_0 && opcode <= OPCODE_ASTORE_3) {
+            local_index = opcode - OPCODE_ASTORE_0;
+        }
+        if (local_index >= (int)method->max_locals) {
+            continue;
+        }
+    
+        int min_depth = pops;
+        int max_growth = delta > 0 ? delta : 0;
+        bool safe = true;
+        for (int k = 0; k < successor_count && safe; k++) {
+            uint32_t next = successors[k];
+            // 负偏移回绕成大于length的值
+            if (next >= length || !is_start[next]) {
+                safe = false;
+            } else if (next > i) {
+                // 向后跳转的目标是检查点，不计入
+                const j2me_stack_bound_t* target = &bounds[next];
+                if (target->min_depth == J2ME_STACK_BOUND_UNSAFE) {
+                    safe = false;
+                    break;
+                }
+                int target_growth = max_stack - target->min_depth - target->depth_range;
+                if (target->min_depth - delta > min_depth) {
+                    min_depth = target->min_depth - delta;
+                }
+                if (delta + target_growth > max_growth) {
+                    max_growth = delta + target_growth;
+                }
+            }
+        }
+        if (safe && min_depth + max_growth <= max_stack) {
+            bounds[i].min_depth = (uint16_t)min_depth;
+            bounds[i].depth_range = (uint16_t)(max_stack - max_growth - min_depth);
+        }
+    }
+    
+    free(is_start);
+    return bounds;
+}
+
+#if J2ME_THREADED_DISPATCH
+#define TD_CASE(op)
+#define TD_TARGET(name) name:
+// 快速路径只从检查点进入，检查表保证向前的后继指令都在代码范围内，这里只需检查指令数
+#define TD_DISPATCH() do { \
+        if (count >= max_instructions) goto done; \
+        opcode = code[pc++]; \
+        count++; \
+        goto *dispatch_table[opcode]; \
+    } while (0)
+#else
+#define TD_CASE(op) case op:
+#define TD_TARGET(name)
+#define TD_DISPATCH() goto dispatch
+#endif
+
+#define TD_READ_S16(p) ((j2me_short)((code[(p)] << 8) | code[(p) + 1]))
+#define TD_READ_U16(p) ((uint16_t)((code[(p)] << 8) | code[(p) + 1]))
+#define TD_QUICK_ENTRY(index) (&((j2me_quick_entry_t*)owner->quick_entries)[(index)])
+// 栈顶缓存：栈非空时栈顶值保存在tos中，其余元素在sp之下；sp指向栈顶值写回时的槽位，
+// 栈空时指向保留槽位，因此压栈时可以无条件写回旧栈顶、出栈时无条件取回新栈顶。
+// 快速路径不检查栈深度，由检查点按栈深度检查表保证不会越界（见build_stack_bounds）
+#define TD_PUSH(v) do { \
+        *sp++ = tos; \
+        tos = (v); \
+    } while (0)
+#define TD_DROP(n) do { \
+        sp -= (n); \
+        tos = *sp; \
+    } while (0)
+// 局部变量索引在构建检查表时已确认小于max_locals
+#define TD_LOAD(index) TD_PUSH(locals[(index)])
+#define TD_STORE(index) do { \
+        locals[(index)] = tos; \
+        TD_DROP(1); \
+    } while (0)
+#define TD_BINOP(expr) do { \
+        value2 = tos; \
+        value1 = *--sp; \
+        tos = (expr); \
+    } while (0)
+// 向后跳转（循环）是检查点；向前跳转的目标已计入跳转指令自身的检查范围
+#define TD_BRANCH(cond, pops) do { \
+        uint32_t base_pc = pc - 1; \
+        j2me_short offset = TD_READ_S16(pc); \
+        pc += 2; \
+        TD_DROP(pops); \
+        if (cond) { \
+            pc = base_pc + offset; \
+            if (offset <= 0 && !TD_BOUNDS_OK()) TD_RESUME(); \
+        } \
+    } while (0)
+#define TD_IF(cond) do { \
+        value1 = tos; \
+        TD_BRANCH(cond, 1); \
+    } while (0)
+#define TD_IF_ICMP(cond) do { \
+        value2 = tos; \
+        value1 = sp[-1]; \
+        TD_BRANCH(cond, 2); \
+    } while (0)
+// 检查点（批次开始、慢速指令之后、向后跳转）：检查表确认从pc开始直到下一个检查点的快速路径
+// 不会越界时才进入快速路径。向后跳转的目标在构建检查表时已确认是方法内的指令开头
+#define TD_BOUNDS_OK() ((size_t)(sp - slots - bounds[pc].min_depth) <= bounds[pc].depth_range)
+#define TD_RESUME() goto resume
+
+/**
+ * @brief 批量执行栈帧字节码（线程化分发）
+ * 
+ * 在单个函数内连续执行一批指令：pc、操作数栈顶和局部变量表保存在局部变量中，
+ * 栈顶值缓存在tos中，常用的常量/局部变量/栈操作/整数运算/分支/返回指令直接在快速路径中完成，
+ * 每条指令的分发开销只有一次间接跳转。字段访问、方法调用、对象创建等
+ * 复杂指令回退到execute_single_instruction执行。
+ * 
+ * 快速路径不逐条检查栈溢出/下溢：只在检查点按方法的栈深度检查表检查一次，
+ * 检查不通过的指令交给慢速路径执行。
+ * 
+ * @param vm 虚拟机实例
+ * @param thread 所属线程（可为NULL），线程停止或栈帧切换时结束本批次
+ * @param frame 当前栈帧
+ * @param max_instructions 本批次最多执行的指令数
+ * @param executed 输出实际执行的指令数
+ * @return 错误码（只有内存不足会中断执行，其余错误记录后继续）
+ */
+static j2me_error_t execute_threaded(j2me_vm_t* vm, j2me_thread_t* thread, j2me_stack_frame_t* frame,
+                                     uint32_t max_instructions, uint32_t* executed) {
+    const uint8_t* code = frame->bytecode;
+    j2me_int* stack = frame->operand_stack.data;
+    const size_t stack_size = frame->operand_stack.size;
+    j2me_int* locals = frame->local_vars.variables;
+    const size_t locals_size = frame->local_vars.size;
+    // 未设置代码长度的栈帧只依靠返回指令把pc置为0xFFFFFFFF来结束
+    const uint32_t code_end = frame->code_length ? frame->code_length : 0xFFFFFFFF;
+    // 快速指令只出现在所属方法的字节码中，此时所属类的解析表一定存在
+    j2me_class_t* const owner = frame->method_info ? ((j2me_method_t*)frame->method_info)->owner_class : NULL;
+    
+    // 栈深度检查表只对方法自己的字节码有效，没有检查表时每条指令都在检查点回退到慢速路径
+    j2me_method_t* const method = (j2me_method_t*)frame->method_info;
+    const j2me_stack_bound_t* bounds = NULL;
+    uint32_t bounds_length = 0;
+    if (method && code && method->bytecode == code && frame->code_length == method->bytecode_length &&
+        locals_size >= method->max_locals && stack_size >= method->max_stack &&
+        method->max_stack < J2ME_STACK_BOUND_UNSAFE) {
+        if (!method->stack_bounds) {
+            method->stack_bounds = build_stack_bounds(method);
+        }
+        if (method->stack_bounds) {
+            bounds = (const j2me_stack_bound_t*)method->stack_bounds;
+            bounds_length = method->bytecode_length;
+        }
+    }
+    
+    uint32_t pc = frame->pc;
+    j2me_int* const slots = stack - J2ME_OPERAND_STACK_RESERVED;
+    j2me_int* sp = slots + frame->operand_stack.top;
+    j2me_int tos = *sp;
+    uint32_t count = 0;
+    uint8_t opcode;
+    j2me_int value1, value2;
+    j2me_error_t result = J2ME_SUCCESS;
+    
+    if (!code) {
+        *executed = 0;
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+#if J2ME_THREADED_DISPATCH
+    static const void* dispatch_table[256] = {
+        [0 ... 255] = &&op_slow,
+        [OPCODE_NOP] = &&op_nop,
+        [OPCODE_ACONST_NULL] = &&op_aconst_null,
+        [OPCODE_ICONST_M1] = &&op_iconst,
+        [OPCODE_ICONST_0] = &&op_iconst,
+        [OPCODE_ICONST_1] = &&op_iconst,
+        [OPCODE_ICONST_2] = &&op_iconst,
+        [OPCODE_ICONST_3] = &&op_iconst,
+        [OPCODE_ICONST_4] = &&op_iconst,
+        [OPCODE_ICONST_5] = &&op_iconst,
+        [OPCODE_BIPUSH] = &&op_bipush,
+        [OPCODE_SIPUSH] = &&op_sipush,
+        [OPCODE_ILOAD] = &&op_load,
+        [OPCODE_ALOAD] = &&op_load,
+        [OPCODE_ILOAD_0] = &&op_iload_n,
+        [OPCODE_ILOAD_1] = &&op_iload_n,
+        [OPCODE_ILOAD_2] = &&op_iload_n,
+        [OPCODE_ILOAD_3] = &&op_iload_n,
+        [OPCODE_ALOAD_0] = &&op_aload_n,
+        [OPCODE_ALOAD_1] = &&op_aload_n,
+        [OPCODE_ALOAD_2] = &&op_aload_n,
+        [OPCODE_ALOAD_3] = &&op_aload_n,
+        [OPCODE_ISTORE] = &&op_store,
+        [OPCODE_ASTORE] = &&op_store,
+        [OPCODE_ISTORE_0] = &&op_istore_n,
+        [OPCODE_ISTORE_1] = &&op_istore_n,
+        [OPCODE_ISTORE_2] = &&op_istore_n,
+        [OPCODE_ISTORE_3] = &&op_istore_n,
+        [OPCODE_ASTORE_0] = &&op_astore_n,
+        [OPCODE_ASTORE_1] = &&op_astore_n,
+        [OPCODE_ASTORE_2] = &&op_astore_n,
+        [OPCODE_ASTORE_3] = &&op_astore_n,
+        [OPCODE_POP] = &&op_pop,
+        [OPCODE_POP2] = &&op_pop2,
+        [OPCODE_DUP] = &&op_dup,
+        [OPCODE_SWAP] = &&op_swap,
+        [OPCODE_IADD] = &&op_iadd,
+        [OPCODE_ISUB] = &&op_isub,
+        [OPCODE_IMUL] = &&op_imul,
+        [OPCODE_IDIV] = &&op_idiv,
+        [OPCODE_IREM] = &&op_irem,
+        [OPCODE_INEG] = &&op_ineg,
+        [OPCODE_ISHL] = &&op_ishl,
+        [OPCODE_ISHR] = &&op_ishr,
+        [OPCODE_IUSHR] = &&op_iushr,
+        [OPCODE_IAND] = &&op_iand,
+        [OPCODE_IOR] = &&op_ior,
+        [OPCODE_IXOR] = &&op_ixor,
+        [OPCODE_IINC] = &&op_iinc,
+        [OPCODE_IFEQ] = &&op_ifeq,
+        [OPCODE_IFNE] = &&op_ifne,
+        [OPCODE_IFLT] = &&op_iflt,
+        [OPCODE_IFGE] = &&op_ifge,
+        [OPCODE_IFGT] = &&op_ifgt,
+        [OPCODE_IFLE] = &&op_ifle,
+        [OPCODE_IF_ICMPEQ] = &&op_if_icmpeq,
+        [OPCODE_IF_ICMPNE] = &&op_if_icmpne,
+        [OPCODE_IF_ICMPLT] = &&op_if_icmplt,
+        [OPCODE_IF_ICMPGE] = &&op_if_icmpge,
+        [OPCODE_IF_ICMPGT] = &&op_if_icmpgt,
+        [OPCODE_IF_ICMPLE] = &&op_if_icmple,
+        [OPCODE_IFNULL] = &&op_ifeq,
+        [OPCODE_IFNONNULL] = &&op_ifne,
+        [OPCODE_GOTO] = &&op_goto,
+        [OPCODE_IRETURN] = &&op_xreturn,
+        [OPCODE_ARETURN] = &&op_xreturn,
+        [OPCODE_RETURN] = &&op_return,
+        [OPCODE_LDC_QUICK] = &&op_ldc_quick,
+        [OPCODE_LDC_W_QUICK] = &&op_ldc_w_quick,
+        [OPCODE_GETSTATIC_QUICK] = &&op_getstatic_quick,
+        [OPCODE_PUTSTATIC_QUICK] = &&op_putstatic_quick,
+    };
+#endif
+    
+resume:
+    // 检查不通过时这条指令交给慢速路径（带完整检查）执行
+    if (pc >= code_end || count >= max_instructions) {
+        goto done;
+    }
+    if (pc >= bounds_length || !TD_BOUNDS_OK()) {
+        opcode = code[pc++];
+        count++;
+        goto op_slow;
+    }
+#if J2ME_THREADED_DISPATCH
+    TD_DISPATCH();
+#else
+dispatch:
+    if (pc >= code_end || count >= max_instructions) {
+        goto done;
+    }
+    opcode = code[pc++];
+    count++;
+    
+    switch (opcode) {
+#endif
+    
+    TD_CASE(OPCODE_NOP)
+    TD_TARGET(op_nop)
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ACONST_NULL)
+    TD_TARGET(op_aconst_null)
+        TD_PUSH(0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ICONST_M1)
+    TD_CASE(OPCODE_ICONST_0)
+    TD_CASE(OPCODE_ICONST_1)
+    TD_CASE(OPCODE_ICONST_2)
+    TD_CASE(OPCODE_ICONST_3)
+    TD_CASE(OPCODE_ICONST_4)
+    TD_CASE(OPCODE_ICONST_5)
+    TD_TARGET(op_iconst)
+        TD_PUSH((j2me_int)opcode - OPCODE_ICONST_0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_BIPUSH)
+    TD_TARGET(op_bipush)
+        value1 = (j2me_byte)code[pc++];
+        TD_PUSH(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_SIPUSH)
+    TD_TARGET(op_sipush)
+        value1 = TD_READ_S16(pc);
+        pc += 2;
+        TD_PUSH(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ILOAD)
+    TD_CASE(OPCODE_ALOAD)
+    TD_TARGET(op_load)
+        value1 = code[pc++];
+        TD_LOAD(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ILOAD_0)
+    TD_CASE(OPCODE_ILOAD_1)
+    TD_CASE(OPCODE_ILOAD_2)
+    TD_CASE(OPCODE_ILOAD_3)
+    TD_TARGET(op_iload_n)
+        TD_LOAD(opcode - OPCODE_ILOAD_0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ALOAD_0)
+    TD_CASE(OPCODE_ALOAD_1)
+    TD_CASE(OPCODE_ALOAD_2)
+    TD_CASE(OPCODE_ALOAD_3)
+    TD_TARGET(op_aload_n)
+        TD_LOAD(opcode - OPCODE_ALOAD_0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ISTORE)
+    TD_CASE(OPCODE_ASTORE)
+    TD_TARGET(op_store)
+        value1 = code[pc++];
+        TD_STORE(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ISTORE_0)
+    TD_CASE(OPCODE_ISTORE_1)
+    TD_CASE(OPCODE_ISTORE_2)
+    TD_CASE(OPCODE_ISTORE_3)
+    TD_TARGET(op_istore_n)
+        TD_STORE(opcode - OPCODE_ISTORE_0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ASTORE_0)
+    TD_CASE(OPCODE_ASTORE_1)
+    TD_CASE(OPCODE_ASTORE_2)
+    TD_CASE(OPCODE_ASTORE_3)
+    TD_TARGET(op_astore_n)
+        TD_STORE(opcode - OPCODE_ASTORE_0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_POP)
+    TD_TARGET(op_pop)
+        TD_DROP(1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_POP2)
+    TD_TARGET(op_pop2)
+        TD_DROP(2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_DUP)
+    TD_TARGET(op_dup)
+        TD_PUSH(tos);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_SWAP)
+    TD_TARGET(op_swap)
+        value1 = sp[-1];
+        sp[-1] = tos;
+        tos = value1;
+        TD_DISPATCH();
+    
+    // 整数运算按Java语义回绕，使用无符号运算避免C的有符号溢出
+    TD_CASE(OPCODE_IADD)
+    TD_TARGET(op_iadd)
+        TD_BINOP((j2me_int)((uint32_t)value1 + (uint32_t)value2));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ISUB)
+    TD_TARGET(op_isub)
+        TD_BINOP((j2me_int)((uint32_t)value1 - (uint32_t)value2));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IMUL)
+    TD_TARGET(op_imul)
+        TD_BINOP((j2me_int)((uint32_t)value1 * (uint32_t)value2));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IDIV)
+    TD_TARGET(op_idiv)
+        if (tos == 0) {
+            TD_DROP(2);
+            result = J2ME_ERROR_RUNTIME_EXCEPTION; // 除零异常
+            goto fault;
+        }
+        TD_BINOP(value2 == -1 ? (j2me_int)(0u - (uint32_t)value1) : value1 / value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IREM)
+    TD_TARGET(op_irem)
+        if (tos == 0) {
+            TD_DROP(2);
+            result = J2ME_ERROR_RUNTIME_EXCEPTION; // 除零异常
+            goto fault;
+        }
+        TD_BINOP(value2 == -1 ? 0 : value1 % value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_INEG)
+    TD_TARGET(op_ineg)
+        tos = (j2me_int)(0u - (uint32_t)tos);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ISHL)
+    TD_TARGET(op_ishl)
+        TD_BINOP((j2me_int)((uint32_t)value1 << (value2 & 0x1f)));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_ISHR)
+    TD_TARGET(op_ishr)
+        TD_BINOP(value1 >> (value2 & 0x1f));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IUSHR)
+    TD_TARGET(op_iushr)
+        TD_BINOP((j2me_int)((uint32_t)value1 >> (value2 & 0x1f)));
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IAND)
+    TD_TARGET(op_iand)
+        TD_BINOP(value1 & value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IOR)
+    TD_TARGET(op_ior)
+        TD_BINOP(value1 | value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IXOR)
+    TD_TARGET(op_ixor)
+        TD_BINOP(value1 ^ value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IINC)
+    TD_TARGET(op_iinc)
+        value1 = code[pc];
+        value2 = (int8_t)code[pc + 1];
+        pc += 2;
+        locals[value1] = (j2me_int)((uint32_t)locals[value1] + (uint32_t)value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFEQ)
+    TD_CASE(OPCODE_IFNULL)
+    TD_TARGET(op_ifeq)
+        TD_IF(value1 == 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFNE)
+    TD_CASE(OPCODE_IFNONNULL)
+    TD_TARGET(op_ifne)
+        TD_IF(value1 != 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFLT)
+    TD_TARGET(op_iflt)
+        TD_IF(value1 < 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFGE)
+    TD_TARGET(op_ifge)
+        TD_IF(value1 >= 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFGT)
+    TD_TARGET(op_ifgt)
+        TD_IF(value1 > 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IFLE)
+    TD_TARGET(op_ifle)
+        TD_IF(value1 <= 0);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPEQ)
+    TD_TARGET(op_if_icmpeq)
+        TD_IF_ICMP(value1 == value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPNE)
+    TD_TARGET(op_if_icmpne)
+        TD_IF_ICMP(value1 != value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPLT)
+    TD_TARGET(op_if_icmplt)
+        TD_IF_ICMP(value1 < value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPGE)
+    TD_TARGET(op_if_icmpge)
+        TD_IF_ICMP(value1 >= value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPGT)
+    TD_TARGET(op_if_icmpgt)
+        TD_IF_ICMP(value1 > value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IF_ICMPLE)
+    TD_TARGET(op_if_icmple)
+        TD_IF_ICMP(value1 <= value2);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_GOTO)
+    TD_TARGET(op_goto)
+        {
+            j2me_short offset = TD_READ_S16(pc);
+            pc = (pc - 1) + offset;
+            if (offset <= 0 && !TD_BOUNDS_OK()) TD_RESUME();
+        }
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_IRETURN)
+    TD_CASE(OPCODE_ARETURN)
+    TD_TARGET(op_xreturn)
+        frame->return_value = tos;
+        TD_DROP(1);
+        frame->has_return_value = true;
+        pc = 0xFFFFFFFF;
+        goto done;
+    
+    TD_CASE(OPCODE_RETURN)
+    TD_TARGET(op_return)
+        pc = 0xFFFFFFFF;
+        goto done;
+    
+    // 快速指令：直接使用解析表中的常量和静态字段槽
+    TD_CASE(OPCODE_LDC_QUICK)
+    TD_TARGET(op_ldc_quick)
+        value1 = TD_QUICK_ENTRY(code[pc])->u.constant;
+        pc++;
+        TD_PUSH(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_LDC_W_QUICK)
+    TD_TARGET(op_ldc_w_quick)
+        value1 = TD_QUICK_ENTRY(TD_READ_U16(pc))->u.constant;
+        pc += 2;
+        TD_PUSH(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_GETSTATIC_QUICK)
+    TD_TARGET(op_getstatic_quick)
+        value1 = TD_QUICK_ENTRY(TD_READ_U16(pc))->u.static_slot->int_value;
+        pc += 2;
+        TD_PUSH(value1);
+        TD_DISPATCH();
+    
+    TD_CASE(OPCODE_PUTSTATIC_QUICK)
+    TD_TARGET(op_putstatic_quick)
+        {
+            j2me_value_t* slot = TD_QUICK_ENTRY(TD_READ_U16(pc))->u.static_slot;
+            pc += 2;
+            slot->type = J2ME_TYPE_INT;
+            slot->int_value = tos;
+            TD_DROP(1);
+        }
+        TD_DISPATCH();
+    
+#if J2ME_THREADED_DISPATCH
+    op_slow:
+#else
+    default:
+    op_slow:
+#endif
+        // 慢速路径：写回栈顶缓存、同步寄存器状态后交给通用指令实现
+        *sp = tos;
+        frame->pc = pc - 1;
+        frame->operand_stack.top = (size_t)(sp - slots);
+        result = execute_single_instruction(vm, frame);
+        pc = frame->pc;
+        sp = slots + frame->operand_stack.top;
+        tos = *sp;
+        if (result != J2ME_SUCCESS) {
+            if (result == J2ME_ERROR_OUT_OF_MEMORY) {
+                goto done;
+            }
+            goto fault;
+        }
+        if (thread && (!thread->is_running || thread->current_frame != frame)) {
+            goto done;
+        }
+        TD_RESUME();
+    
+#if !J2ME_THREADED_DISPATCH
+    }
+#endif
+    
+fault:
+    // 非致命错误：记录后继续执行（与逐条解释的行为一致）
+    LOG_DEBUG("[解释器] 指令 0x%02x 执行出错: %d (pc=%u)，继续执行\n", opcode, result, pc);
+    result = J2ME_SUCCESS;
+    TD_RESUME();
+    
+done:
+    *sp = tos;
+    frame->pc = pc;
+    frame->operand_stack.top = (size_t)(sp - slots);
+    *executed = count;
+    return result;
+}
+
+#undef TD_CASE
+#undef TD_TARGET
+#undef TD_DISPATCH
+#undef TD_READ_S16
+#undef TD_READ_U16
+#undef TD_QUICK_ENTRY
+#undef TD_PUSH
+#undef TD_DROP
+#undef TD_LOAD
+#undef TD_STORE
+#undef TD_BINOP
+#undef TD_IF
+#undef TD_IF_ICMP
+#undef TD_BRANCH
+#undef TD_RESUME
+#undef TD_BOUNDS_OK
+
+/**
+ * @brief 记录一次解释器执行的性能统计
+ * @param vm 虚拟机实例
+ * @param instructions 执行的指令数
+ * @param start_us 开始时间（微秒），为0表示嵌套执行、不计时
+ */
+static void record_interpreter_stats(j2me_vm_t* vm, uint32_t instructions, j2me_long start_us) {
+    vm->instructions_executed += instructions;
+    if (!vm->perf_stats) {
+        return;
+    }
+    
+    j2me_long elapsed = start_us ? interpreter_time_us() - start_us : 0;
+    j2me_performance_stats_record_instructions(vm->perf_stats, (j2me_int)instructions, elapsed);
+    
+    // 统计区间只累计解释器实际执行的时间，时间片之间的空闲不计入指令速度
+    if (vm->perf_stats->start_time == 0 && start_us) {
+        vm->perf_stats->start_time = start_us;
+    }
+    vm->perf_stats->end_time = vm->perf_stats->start_time + vm->perf_stats->total_cycles;
+}
+
 j2me_error_t j2me_interpreter_execute_instruction(j2me_vm_t* vm, j2me_thread_t* thread) {
     if (!vm || !thread || !thread->current_frame) {
         return J2ME_ERROR_INVALID_PARAMETER;
@@ -1757,6 +2954,88 @@ j2me_error_t j2me_interpreter_execute_instruction(j2me_vm_t* vm, j2me_thread_t*
     return execute_single_instruction(vm, thread->current_frame);
 }
 
+j2me_error_t j2me_interpreter_execute_frame_instruction(j2me_vm_t* vm, j2me_stack_frame_t* frame) {
+    if (!vm || !frame || !frame->bytecode) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    return execute_single_instruction(vm, frame);
+}
+
+/**
+ * @brief 逐条执行栈帧并记录指令序列（指令序列分析模式）
+ * 
+ * 批次结束条件与线程化分发引擎相同：批次用完、方法返回、线程停止或栈帧切换。
+ */
+static j2me_error_t execute_profiled(j2me_vm_t* vm, j2me_thread_t* thread, j2me_stack_frame_t* frame,
+                                     uint32_t max_instructions, uint32_t* executed) {
+    j2me_opcode_profiler_t* profiler = vm->opcode_profiler;
+    const uint32_t code_end = frame->code_length ? frame->code_length : 0xFFFFFFFF;
+    uint32_t count = 0;
+    j2me_error_t result = J2ME_SUCCESS;
+    
+    while (count < max_instructions && frame->pc < code_end) {
+        j2me_opcode_profiler_record(profiler, frame, frame->pc, frame->bytecode[frame->pc]);
+        count++;
+        
+        result = execute_single_instruction(vm, frame);
+        if (result == J2ME_ERROR_OUT_OF_MEMORY) {
+            break;
+        }
+        if (result != J2ME_SUCCESS) {
+            // 非致命错误：记录后继续执行（与线程化分发引擎的行为一致）
+            LOG_DEBUG("[解释器] 指令执行出错: %d (pc=%u)，继续执行\n", result, frame->pc);
+            result = J2ME_SUCCESS;
+        }
+        if (thread && (!thread->is_running || thread->current_frame != frame)) {
+            break;
+        }
+    }
+    
+    *executed = count;
+    return result;
+}
+
+/**
+ * @brief 按虚拟机配置的执行模式批量执行栈帧
+ * 
+ * 启用JIT时热点方法用编译代码执行。预解码模式下使用方法上缓存的预解码指令流；
+ * 栈帧没有关联方法（或字节码不属于该方法）时回退到线程化分发引擎。启用指令序列分析时
+ * 所有栈帧都逐条执行。
+ */
+static j2me_error_t execute_frame(j2me_vm_t* vm, j2me_thread_t* thread, j2me_stack_frame_t* frame,
+                                  uint32_t max_instructions, uint32_t* executed) {
+    // 记录正在执行的栈帧（分配分析器据此采样分配点），嵌套执行返回后恢复外层栈帧
+    j2me_stack_frame_t* outer_frame = vm->executing_frame;
+    vm->executing_frame = frame;
+    
+    j2me_error_t result;
+    j2me_jit_method_t* compiled = NULL;
+    if (vm->jit && frame->method_info && !vm->opcode_profiler) {
+        compiled = j2me_jit_prepare(vm, frame);
+    }
+    j2me_predecoded_method_t* predecoded = NULL;
+    if (!compiled && vm->config.execution_mode == J2ME_EXEC_MODE_PREDECODED && frame->method_info && !vm->opcode_profiler) {
+        j2me_method_t* method = (j2me_method_t*)frame->method_info;
+        if (method->bytecode == frame->bytecode) {
+            predecoded = j2me_predecoded_method_get(method);
+        }
+    }
+    
+    if (vm->opcode_profiler) {
+        result = execute_profiled(vm, thread, frame, max_instructions, executed);
+    } else if (compiled) {
+        result = j2me_jit_execute(vm, thread, frame, compiled, max_instructions, executed);
+    } else if (predecoded) {
+        result = j2me_execute_predecoded(vm, thread, frame, predecoded, max_instructions, executed);
+    } else {
+        result = execute_threaded(vm, thread, frame, max_instructions, executed);
+    }
+    
+    vm->executing_frame = outer_frame;
+    return result;
+}
+
 j2me_error_t j2me_interpreter_execute_batch(j2me_vm_t* vm, j2me_thread_t* thread, uint32_t max_instructions) {
     if (!vm || !thread) {
         return J2ME_ERROR_INVALID_PARAMETER;
@@ -1764,22 +3043,31 @@ j2me_error_t j2me_interpreter_execute_batch(j2me_vm_t* vm, j2me_thread_t* thread
     
     j2me_error_t result = J2ME_SUCCESS;
     uint32_t executed = 0;
+    j2me_long start_us = vm->execution_depth == 0 ? interpreter_time_us() : 0;
     
+    vm->execution_depth++;
     while (executed < max_instructions && thread->is_running && thread->current_frame) {
-        result = execute_single_instruction(vm, thread->current_frame);
-
+        j2me_stack_frame_t* frame = thread->current_frame;
+        uint32_t count = 0;
+        
+        result = execute_frame(vm, thread, frame, max_instructions - executed, &count);
+        executed += count;
+        
         if (result != J2ME_SUCCESS) {
             if (result == J2ME_ERROR_OUT_OF_MEMORY) {
                 LOG_DEBUG("[Interpreter] FATAL: Out of memory in thread %u, stopping\n", thread->thread_id);
-                break;
             }
-            LOG_DEBUG("[Interpreter] Non-fatal error %d in thread %u, continuing\n", result, thread->thread_id);
-            result = J2ME_SUCCESS;
+            break;
+        }
+        
+        // 栈帧未切换说明本批次已用完、方法已返回或线程已停止
+        if (thread->current_frame == frame) {
+            break;
         }
-
-        executed++;
     }
+    vm->execution_depth--;
     
+    record_interpreter_stats(vm, executed, start_us);
     return result;
 }
 
@@ -1913,14 +3201,15 @@ j2me_error_t j2me_interpreter_execute_method(j2me_vm_t* vm, j2me_method_t* metho
         return J2ME_SUCCESS;
     }
     
-    // 创建栈帧
-    j2me_stack_frame_t* frame = j2me_stack_frame_create(method->max_stack, method->max_locals);
+    // 创建栈帧（从当前线程的帧栈区分配）
+    j2me_stack_frame_t* frame = j2me_thread_create_frame(vm, vm->current_thread, method->max_stack, method->max_locals);
     if (!frame) {
         return J2ME_ERROR_OUT_OF_MEMORY;
     }
     
     // 设置字节码和程序计数器
     frame->bytecode = method->bytecode;
+    frame->code_length = method->bytecode_length;
     frame->pc = 0;
     frame->method_info = method;
     
@@ -1940,38 +3229,20 @@ j2me_error_t j2me_interpreter_execute_method(j2me_vm_t* vm, j2me_method_t* metho
     j2me_error_t result = J2ME_SUCCESS;
     uint32_t instruction_count = 0;
     const uint32_t max_instructions = 1000000; // 增加到 100 万条指令
-    const uint32_t debug_interval = 10000; // 每10000条指令输出一次调试信息
+    j2me_long start_us = vm->execution_depth == 0 ? interpreter_time_us() : 0;
     
     LOG_DEBUG("[Interpreter] Starting execution, bytecode_length=%d\n", method->bytecode_length);
-    fflush(stdout);
     
-    while (frame->pc < method->bytecode_length && instruction_count < max_instructions) {
-        result = execute_single_instruction(vm, frame);
-
-        if (result != J2ME_SUCCESS) {
-            // 只在真正致命的错误时终止执行
-            if (result == J2ME_ERROR_OUT_OF_MEMORY) {
-                LOG_DEBUG("[Interpreter] FATAL: Out of memory at pc=%d, stopping\n", frame->pc);
-                break;
-            }
-            // 非致命错误（栈溢出、方法未找到等）：记录警告并继续执行
-            LOG_DEBUG("[Interpreter] Non-fatal error %d at pc=%d, continuing execution\n", result, frame->pc);
-            result = J2ME_SUCCESS;
-        }
-
-        instruction_count++;
-        
-        // 定期输出调试信息
-        if (instruction_count % debug_interval == 0) {
-            LOG_DEBUG("[Interpreter] Executed %d instructions, pc=%d/%d\n", instruction_count, frame->pc, method->bytecode_length);
-            fflush(stdout);
-        }
-    }
+    vm->execution_depth++;
+    result = execute_frame(vm, NULL, frame, max_instructions, &instruction_count);
+    vm->execution_depth--;
+    
+    record_interpreter_stats(vm, instruction_count, start_us);
+    j2me_performance_stats_record_method_call(vm->perf_stats);
     
     LOG_DEBUG("[Interpreter] Execution finished: instructions=%d, result=%d\n", instruction_count, result);
-    fflush(stdout);
     
-    if (instruction_count >= max_instructions) {
+    if (instruction_count >= max_instructions && frame->pc < method->bytecode_length) {
         LOG_ERROR("[Interpreter] ERROR: Max instructions reached!");
         result = J2ME_ERROR_RUNTIME_EXCEPTION;
     }
@@ -2017,6 +3288,12 @@ void j2me_thread_destroy(j2me_thread_t* thread) {
         thread->current_frame = frame->previous;
         j2me_stack_frame_destroy(frame);
     }
+    j2me_frame_arena_release(&thread->frame_arena);
+    
+    // 仍未释放的堆分配栈帧不再指向这个线程
+    for (j2me_stack_frame_t* frame = thread->heap_frames; frame; frame = frame->heap_next) {
+        frame->heap_list = NULL;
+    }
     
     LOG_DEBUG("[线程] 销毁线程 (ID: %d)\n", thread->thread_id);
     free(thread);
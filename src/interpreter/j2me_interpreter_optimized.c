@@ -7,6 +7,7 @@
  * - 跳转表优化的指令分发
  * - 内联缓存的方法调用
  * - 热点检测和批量执行
+ * - 方法级预解码执行引擎 (J2ME_EXEC_MODE_PREDECODED)
  * - 性能监控和统计
  */
 
@@ -14,6 +15,8 @@
 #include "j2me_bytecode.h"
 #include "j2me_vm.h"
 #include "j2me_native_methods.h"
+#include "j2me_quicken.h"
+#include "j2me_field_access.h"
 #include <stdlib.h>
 #include <string.h>
 #include "j2me_log.h"
@@ -397,6 +400,862 @@ j2me_int j2me_execute_batch(j2me_vm_t* vm,
     return executed;
 }
 
+// ============================================================================
+// 方法级预解码执行引擎
+// ============================================================================
+
+/**
+ * @brief 判断是否为16位偏移的分支指令
+ */
+static j2me_boolean is_branch_opcode(j2me_opcode_t opcode) {
+    return (opcode >= OPCODE_IFEQ && opcode <= OPCODE_IF_ACMPNE) ||
+           opcode == OPCODE_GOTO || opcode == OPCODE_IFNULL || opcode == OPCODE_IFNONNULL;
+}
+
+/**
+ * @brief 预解码一条指令的操作数
+ * 
+ * 快速路径指令的常量、局部变量索引和分支偏移在这里一次性解析；
+ * 其余指令标记为INST_FLAG_SLOW_PATH，执行时交给通用解释器。
+ */
+static void predecode_instruction(j2me_predecoded_instruction_t* inst, const uint8_t* code) {
+    const uint32_t pc = inst->pc;
+    const j2me_opcode_t opcode = inst->opcode;
+    
+    switch (opcode) {
+        case OPCODE_NOP:
+            break;
+            
+        case OPCODE_ACONST_NULL:
+            inst->operands[0] = 0;
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+        case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+            inst->operands[0] = (j2me_int)opcode - OPCODE_ICONST_0;
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_BIPUSH:
+            inst->operands[0] = (int8_t)code[pc + 1];
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_SIPUSH:
+            inst->operands[0] = (j2me_short)((code[pc + 1] << 8) | code[pc + 2]);
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_ILOAD: case OPCODE_ALOAD: case OPCODE_ISTORE: case OPCODE_ASTORE:
+            inst->operands[0] = code[pc + 1];
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+            inst->operands[0] = opcode - OPCODE_ILOAD_0;
+            inst->operand_count = 1;
+            break;
+        case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+            inst->operands[0] = opcode - OPCODE_ALOAD_0;
+            inst->operand_count = 1;
+            break;
+        case OPCODE_ISTORE_0: case OPCODE_ISTORE_1: case OPCODE_ISTORE_2: case OPCODE_ISTORE_3:
+            inst->operands[0] = opcode - OPCODE_ISTORE_0;
+            inst->operand_count = 1;
+            break;
+        case OPCODE_ASTORE_0: case OPCODE_ASTORE_1: case OPCODE_ASTORE_2: case OPCODE_ASTORE_3:
+            inst->operands[0] = opcode - OPCODE_ASTORE_0;
+            inst->operand_count = 1;
+            break;
+            
+        case OPCODE_POP: case OPCODE_POP2: case OPCODE_DUP: case OPCODE_SWAP:
+        case OPCODE_IADD: case OPCODE_ISUB: case OPCODE_IMUL: case OPCODE_IDIV: case OPCODE_IREM:
+        case OPCODE_INEG: case OPCODE_ISHL: case OPCODE_ISHR: case OPCODE_IUSHR:
+        case OPCODE_IAND: case OPCODE_IOR: case OPCODE_IXOR:
+            break;
+            
+        case OPCODE_IINC:
+            inst->operands[0] = code[pc + 1];
+            inst->operands[1] = (int8_t)code[pc + 2];
+            inst->operand_count = 2;
+            break;
+            
+        case OPCODE_IRETURN: case OPCODE_ARETURN: case OPCODE_RETURN:
+            inst->flags |= INST_FLAG_RETURN;
+            break;
+            
+        case OPCODE_GETSTATIC: case OPCODE_PUTSTATIC: case OPCODE_GETFIELD: case OPCODE_PUTFIELD:
+        case OPCODE_GETSTATIC_QUICK: case OPCODE_PUTSTATIC_QUICK:
+        case OPCODE_GETFIELD_QUICK: case OPCODE_PUTFIELD_QUICK:
+            inst->operands[0] = (code[pc + 1] << 8) | code[pc + 2];
+            inst->operand_count = 1;
+            inst->flags |= INST_FLAG_FIELD_ACCESS | INST_FLAG_SLOW_PATH;
+            break;
+            
+        case OPCODE_INVOKEVIRTUAL: case OPCODE_INVOKESPECIAL:
+        case OPCODE_INVOKESTATIC: case OPCODE_INVOKEINTERFACE:
+            inst->operands[0] = (code[pc + 1] << 8) | code[pc + 2];
+            inst->operand_count = 1;
+            inst->flags |= INST_FLAG_METHOD_CALL | INST_FLAG_SLOW_PATH;
+            break;
+            
+        default:
+            if (is_branch_opcode(opcode)) {
+                // 先保存相对偏移，指令边界确定后再解析为指令索引
+                inst->operands[0] = (j2me_short)((code[pc + 1] << 8) | code[pc + 2]);
+                inst->operand_count = 1;
+                inst->flags |= opcode == OPCODE_GOTO ? INST_FLAG_JUMP : INST_FLAG_BRANCH;
+            } else {
+                inst->flags |= INST_FLAG_SLOW_PATH;
+            }
+            break;
+    }
+}
+
+// 超级指令模式中的指令类别
+typedef enum {
+    SI_NONE = 0,
+    SI_ILOAD,               // iload, iload_<n>
+    SI_ALOAD,               // aload, aload_<n>
+    SI_GETFIELD,            // getfield_quick（getfield要等慢速路径解析后才能融合）
+    SI_ICONST,              // iconst_<n>, bipush, sipush
+    SI_IF_ICMP,             // if_icmp<cond>
+    SI_IINC,                // iinc
+    SI_GOTO                 // goto
+} superinstruction_class_t;
+
+#define SUPERINSTRUCTION_MAX_LENGTH 3
+
+// 超级指令模式
+typedef struct {
+    j2me_opcode_t opcode;                                   // 超级指令
+    uint8_t length;                                         // 融合的指令数
+    uint8_t classes[SUPERINSTRUCTION_MAX_LENGTH];           // 各条指令的类别
+    const char* name;                                       // 名称（指令序列分析报告用）
+} superinstruction_pattern_t;
+
+/**
+ * 超级指令表
+ *
+ * 按指令序列分析报告（-o/--opcode-profile）中执行次数最多的序列选取，报告中标出了
+ * 每个序列已融合的超级指令。新增超级指令时在这里加一行模式，并在j2me_execute_predecoded中
+ * 加处理代码。同一位置能匹配多个模式时取表中靠前的，较长的序列排在前面。
+ *
+ * aload; getfield; iload; iaload只融合前三条：数组引用目前是占位值，iaload走慢速路径。
+ */
+static const superinstruction_pattern_t g_superinstructions[] = {
+    { SUPER_ALOAD_GETFIELD_ILOAD, 3, { SI_ALOAD, SI_GETFIELD, SI_ILOAD },  "aload_getfield_iload" },
+    { SUPER_ILOAD_ILOAD_IF_ICMP,  3, { SI_ILOAD, SI_ILOAD, SI_IF_ICMP },   "iload_iload_if_icmp" },
+    { SUPER_ILOAD_CONST_IF_ICMP,  3, { SI_ILOAD, SI_ICONST, SI_IF_ICMP },  "iload_const_if_icmp" },
+    { SUPER_ALOAD_GETFIELD,       2, { SI_ALOAD, SI_GETFIELD },            "aload_getfield" },
+    { SUPER_IINC_GOTO,            2, { SI_IINC, SI_GOTO },                 "iinc_goto" },
+};
+
+#define SUPERINSTRUCTION_COUNT (sizeof(g_superinstructions) / sizeof(g_superinstructions[0]))
+
+static superinstruction_class_t superinstruction_class(j2me_opcode_t opcode) {
+    switch (opcode) {
+        case OPCODE_ILOAD: case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+            return SI_ILOAD;
+        case OPCODE_ALOAD: case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+            return SI_ALOAD;
+        case OPCODE_GETFIELD_QUICK:
+            return SI_GETFIELD;
+        case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+        case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+        case OPCODE_BIPUSH: case OPCODE_SIPUSH:
+            return SI_ICONST;
+        case OPCODE_IF_ICMPEQ: case OPCODE_IF_ICMPNE: case OPCODE_IF_ICMPLT:
+        case OPCODE_IF_ICMPGE: case OPCODE_IF_ICMPGT: case OPCODE_IF_ICMPLE:
+            return SI_IF_ICMP;
+        case OPCODE_IINC:
+            return SI_IINC;
+        case OPCODE_GOTO:
+            return SI_GOTO;
+        default:
+            return SI_NONE;
+    }
+}
+
+/**
+ * @brief if_icmp<cond>的比较结果掩码
+ *
+ * 比较结果按小于、等于、大于编号为0、1、2，掩码的对应位为1表示跳转
+ */
+static j2me_int icmp_taken_mask(j2me_opcode_t opcode) {
+    switch (opcode) {
+        case OPCODE_IF_ICMPEQ: return 0x2;
+        case OPCODE_IF_ICMPNE: return 0x5;
+        case OPCODE_IF_ICMPLT: return 0x1;
+        case OPCODE_IF_ICMPGE: return 0x6;
+        case OPCODE_IF_ICMPGT: return 0x4;
+        case OPCODE_IF_ICMPLE: return 0x3;
+        default:               return 0;
+    }
+}
+
+static inline j2me_boolean is_superinstruction(j2me_opcode_t opcode) {
+    return opcode >= SUPER_ALOAD_GETFIELD && opcode <= SUPER_IINC_GOTO;
+}
+
+/**
+ * @brief 尝试把从index开始的指令序列融合为超级指令
+ *
+ * 按当前字节码匹配（快速化后的getfield才能融合），参与融合的其余指令都必须能在
+ * 预解码循环中直接执行。只改写第一条指令：opcode改为超级指令，以if_icmp结尾的序列
+ * 把比较掩码保存在operands[2]中（这些序列以iload开头，不使用该操作数）。
+ */
+static void fuse_superinstruction(j2me_predecoded_method_t* predecoded, const uint8_t* bytecode, uint32_t index) {
+    j2me_predecoded_instruction_t* inst = &predecoded->code[index];
+    if (is_superinstruction(inst->opcode)) {
+        return;
+    }
+    
+    for (size_t p = 0; p < SUPERINSTRUCTION_COUNT; p++) {
+        const superinstruction_pattern_t* pattern = &g_superinstructions[p];
+        if (index + pattern->length > predecoded->count) {
+            continue;
+        }
+    
+        j2me_boolean match = true;
+        for (uint32_t m = 0; m < pattern->length && match; m++) {
+            const j2me_opcode_t opcode = bytecode[inst[m].pc];
+            match = superinstruction_class(opcode) == pattern->classes[m] &&
+                    (opcode == OPCODE_GETFIELD_QUICK || !(inst[m].flags & INST_FLAG_SLOW_PATH));
+        }
+        if (!match) {
+            continue;
+        }
+    
+        if (pattern->classes[pattern->length - 1] == SI_IF_ICMP) {
+            inst->operands[2] = icmp_taken_mask(bytecode[inst[pattern->length - 1].pc]);
+        }
+        inst->opcode = pattern->opcode;
+        return;
+    }
+}
+
+j2me_opcode_t j2me_opcode_family(j2me_opcode_t opcode) {
+    if (opcode >= OPCODE_ILOAD_0 && opcode <= OPCODE_ALOAD_3) {
+        return (j2me_opcode_t)(OPCODE_ILOAD + (opcode - OPCODE_ILOAD_0) / 4);
+    }
+    if (opcode >= OPCODE_ISTORE_0 && opcode <= OPCODE_ASTORE_3) {
+        return (j2me_opcode_t)(OPCODE_ISTORE + (opcode - OPCODE_ISTORE_0) / 4);
+    }
+    switch (opcode) {
+        case OPCODE_LDC_QUICK:              return OPCODE_LDC;
+        case OPCODE_LDC_W_QUICK:            return OPCODE_LDC_W;
+        case OPCODE_GETSTATIC_QUICK:        return OPCODE_GETSTATIC;
+        case OPCODE_PUTSTATIC_QUICK:        return OPCODE_PUTSTATIC;
+        case OPCODE_GETFIELD_QUICK:         return OPCODE_GETFIELD;
+        case OPCODE_PUTFIELD_QUICK:         return OPCODE_PUTFIELD;
+        case OPCODE_INVOKEVIRTUAL_QUICK:    return OPCODE_INVOKEVIRTUAL;
+        case OPCODE_INVOKESPECIAL_QUICK:    return OPCODE_INVOKESPECIAL;
+        case OPCODE_INVOKESTATIC_QUICK:     return OPCODE_INVOKESTATIC;
+        case OPCODE_INVOKEINTERFACE_QUICK:  return OPCODE_INVOKEINTERFACE;
+        default:                            return opcode;
+    }
+}
+
+const char* j2me_superinstruction_for_sequence(const j2me_opcode_t* opcodes, int length) {
+    if (!opcodes) {
+        return NULL;
+    }
+    
+    for (size_t p = 0; p < SUPERINSTRUCTION_COUNT; p++) {
+        const superinstruction_pattern_t* pattern = &g_superinstructions[p];
+        if (pattern->length != length) {
+            continue;
+        }
+    
+        j2me_boolean match = true;
+        for (int m = 0; m < length && match; m++) {
+            // 归并后的序列中是getfield，对应模式中快速化后的getfield
+            j2me_opcode_t opcode = opcodes[m] == OPCODE_GETFIELD ? OPCODE_GETFIELD_QUICK : opcodes[m];
+            match = superinstruction_class(opcode) == pattern->classes[m];
+        }
+        if (match) {
+            return pattern->name;
+        }
+    }
+    return NULL;
+}
+
+j2me_predecoded_method_t* j2me_predecoded_method_get(j2me_method_t* method) {
+    if (!method || !method->bytecode || method->bytecode_length == 0) {
+        return NULL;
+    }
+    
+    if (method->predecoded) {
+        return (j2me_predecoded_method_t*)method->predecoded;
+    }
+    
+    const uint8_t* code = method->bytecode;
+    const uint32_t length = method->bytecode_length;
+    
+    j2me_predecoded_method_t* predecoded = (j2me_predecoded_method_t*)calloc(1, sizeof(j2me_predecoded_method_t));
+    if (!predecoded) {
+        return NULL;
+    }
+    
+    // 指令条数不超过字节数，按字节数分配即可
+    predecoded->code = (j2me_predecoded_instruction_t*)calloc(length, sizeof(j2me_predecoded_instruction_t));
+    predecoded->pc_to_index = (uint32_t*)malloc(sizeof(uint32_t) * length);
+    if (!predecoded->code || !predecoded->pc_to_index) {
+        j2me_predecoded_method_destroy(predecoded);
+        return NULL;
+    }
+    memset(predecoded->pc_to_index, 0xFF, sizeof(uint32_t) * length);
+    predecoded->bytecode_length = length;
+    
+    // 第一遍：确定指令边界并解析操作数
+    uint32_t pc = 0;
+    uint32_t count = 0;
+    while (pc < length) {
+        j2me_predecoded_instruction_t* inst = &predecoded->code[count];
+        int inst_length = j2me_get_instruction_length(code, pc);
+        
+        predecoded->pc_to_index[pc] = count;
+        inst->opcode = code[pc];
+        inst->pc = pc;
+        
+        if (inst_length <= 0 || pc + (uint32_t)inst_length > length) {
+            // 截断的指令交给通用解释器报告错误
+            inst->flags = INST_FLAG_SLOW_PATH;
+            count++;
+            break;
+        }
+        
+        predecode_instruction(inst, code);
+        pc += (uint32_t)inst_length;
+        count++;
+    }
+    predecoded->count = count;
+    
+    // 第二遍：把分支偏移解析为目标指令索引
+    for (uint32_t i = 0; i < count; i++) {
+        j2me_predecoded_instruction_t* inst = &predecoded->code[i];
+        if (!(inst->flags & (INST_FLAG_JUMP | INST_FLAG_BRANCH)) || (inst->flags & INST_FLAG_SLOW_PATH)) {
+            continue;
+        }
+        
+        uint32_t target_pc = inst->pc + (uint32_t)inst->operands[0];
+        if (target_pc < length && predecoded->pc_to_index[target_pc] != PREDECODED_INVALID_INDEX) {
+            inst->operands[0] = (j2me_int)predecoded->pc_to_index[target_pc];
+        } else {
+            inst->flags |= INST_FLAG_SLOW_PATH;
+        }
+    }
+    
+    // 第三遍：把常见指令序列融合为超级指令
+    for (uint32_t i = 0; i < count; i++) {
+        fuse_superinstruction(predecoded, code, i);
+    }
+    
+    method->predecoded = predecoded;
+    LOG_DEBUG("[预解码] 方法 %s%s: %u 字节 -> %u 条指令\n",
+              method->name ? method->name : "?", method->descriptor ? method->descriptor : "",
+              length, count);
+    return predecoded;
+}
+
+/**
+ * @brief 慢速路径把指令快速化后，更新预解码指令
+ * 
+ * ldc和静态字段的快速指令改为在预解码循环中直接执行：ldc的常量值直接保存在操作数中，
+ * 静态字段保存常量池索引；其余快速指令仍走慢速路径，但已不再需要解析常量池。
+ * getfield快速化后可以作为超级指令的一部分执行，重新尝试融合它前面的指令。
+ */
+static void promote_quick_instruction(j2me_predecoded_method_t* predecoded, uint32_t index,
+                                      const uint8_t* bytecode, const j2me_stack_frame_t* frame) {
+    j2me_predecoded_instruction_t* inst = &predecoded->code[index];
+    const j2me_opcode_t quick_opcode = bytecode[inst->pc];
+    const uint32_t pc = inst->pc;
+    
+    inst->opcode = quick_opcode;
+    switch (quick_opcode) {
+        case OPCODE_LDC_QUICK:
+            inst->operands[0] = j2me_quicken_entry(frame, bytecode[pc + 1])->u.constant;
+            inst->operand_count = 1;
+            inst->flags &= ~INST_FLAG_SLOW_PATH;
+            break;
+            
+        case OPCODE_LDC_W_QUICK:
+            inst->operands[0] = j2me_quicken_entry(frame, (uint16_t)((bytecode[pc + 1] << 8) | bytecode[pc + 2]))->u.constant;
+            inst->operand_count = 1;
+            inst->flags &= ~INST_FLAG_SLOW_PATH;
+            break;
+            
+        case OPCODE_GETSTATIC_QUICK:
+        case OPCODE_PUTSTATIC_QUICK:
+            inst->flags &= ~INST_FLAG_SLOW_PATH;
+            break;
+            
+        case OPCODE_GETFIELD_QUICK:
+            for (uint32_t i = index >= SUPERINSTRUCTION_MAX_LENGTH - 1 ? index - (SUPERINSTRUCTION_MAX_LENGTH - 1) : 0;
+                 i < index; i++) {
+                fuse_superinstruction(predecoded, bytecode, i);
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+void j2me_predecoded_method_destroy(j2me_predecoded_method_t* predecoded) {
+    if (predecoded) {
+        if (predecoded->code) {
+            free(predecoded->code);
+        }
+        if (predecoded->pc_to_index) {
+            free(predecoded->pc_to_index);
+        }
+        free(predecoded);
+    }
+}
+
+/**
+ * @brief 获取调用点内联缓存
+ */
+j2me_call_site_cache_t* j2me_call_site_cache_get(j2me_method_t* method, uint32_t pc) {
+    if (!method || pc >= method->bytecode_length) {
+        return NULL;
+    }
+    
+    // 按字节码偏移索引，每个调用点的缓存单独分配，地址在方法生命周期内不变
+    if (!method->call_sites) {
+        method->call_sites = calloc(method->bytecode_length, sizeof(j2me_call_site_cache_t*));
+        if (!method->call_sites) {
+            return NULL;
+        }
+    }
+    
+    j2me_call_site_cache_t** sites = (j2me_call_site_cache_t**)method->call_sites;
+    if (!sites[pc]) {
+        sites[pc] = (j2me_call_site_cache_t*)calloc(1, sizeof(j2me_call_site_cache_t));
+    }
+    return sites[pc];
+}
+
+/**
+ * @brief 销毁方法上的调用点内联缓存
+ */
+void j2me_call_site_caches_destroy(j2me_method_t* method) {
+    if (!method || !method->call_sites) {
+        return;
+    }
+    
+    j2me_call_site_cache_t** sites = (j2me_call_site_cache_t**)method->call_sites;
+    for (uint32_t i = 0; i < method->bytecode_length; i++) {
+        free(sites[i]);
+    }
+    free(sites);
+    method->call_sites = NULL;
+}
+
+/**
+ * @brief 更新调用点内联缓存
+ */
+void j2me_call_site_cache_update(j2me_call_site_cache_t* cache,
+                                 j2me_class_t* receiver_class,
+                                 j2me_method_t* target) {
+    if (!cache || !receiver_class || !target || cache->state == J2ME_CALL_SITE_MEGAMORPHIC) {
+        return;
+    }
+    
+    if (cache->count < J2ME_CALL_SITE_CACHE_WAYS) {
+        cache->receiver_classes[cache->count] = receiver_class;
+        cache->targets[cache->count] = target;
+        cache->count++;
+        cache->state = cache->count == 1 ? J2ME_CALL_SITE_MONOMORPHIC : J2ME_CALL_SITE_POLYMORPHIC;
+        return;
+    }
+    
+    // 接收者类太多，清空缓存，之后直接查分派表
+    memset(cache->receiver_classes, 0, sizeof(cache->receiver_classes));
+    memset(cache->targets, 0, sizeof(cache->targets));
+    cache->count = 0;
+    cache->state = J2ME_CALL_SITE_MEGAMORPHIC;
+    LOG_DEBUG("[内联缓存] 调用点转为超多态: %s%s\n", target->name, target->descriptor);
+}
+
+/**
+ * @brief 读取实例字段（与通用解释器的getfield_quick相同，对象引用为null时返回0）
+ */
+static inline j2me_int predecoded_get_field(j2me_vm_t* vm, const j2me_stack_frame_t* frame,
+                                            j2me_int object_ref, uint16_t index) {
+    j2me_value_t field_value;
+    field_value.int_value = 0;
+    if (object_ref != 0) {
+        j2me_get_instance_field_value(vm, (j2me_object_t*)(intptr_t)object_ref,
+                                      j2me_quicken_entry(frame, index)->u.field, &field_value);
+    }
+    return field_value.int_value;
+}
+
+#define PD_REQUIRE(n) do { \
+        if (sp < (n)) { result = J2ME_ERROR_STACK_UNDERFLOW; goto fault; } \
+    } while (0)
+#define PD_PUSH(v) do { \
+        if (sp >= stack_size) { result = J2ME_ERROR_STACK_OVERFLOW; goto fault; } \
+        stack[sp++] = (v); \
+    } while (0)
+#define PD_BINOP(expr) do { \
+        PD_REQUIRE(2); \
+        value2 = stack[--sp]; \
+        value1 = stack[sp - 1]; \
+        stack[sp - 1] = (expr); \
+    } while (0)
+#define PD_IF(cond) do { \
+        PD_REQUIRE(1); \
+        value1 = stack[--sp]; \
+        if (cond) index = (uint32_t)inst->operands[0]; \
+    } while (0)
+#define PD_IF_ICMP(cond) do { \
+        PD_REQUIRE(2); \
+        value2 = stack[--sp]; \
+        value1 = stack[--sp]; \
+        if (cond) index = (uint32_t)inst->operands[0]; \
+    } while (0)
+
+j2me_error_t j2me_execute_predecoded(j2me_vm_t* vm,
+                                     j2me_thread_t* thread,
+                                     j2me_stack_frame_t* frame,
+                                     j2me_predecoded_method_t* predecoded,
+                                     uint32_t max_instructions,
+                                     uint32_t* executed) {
+    if (!vm || !frame || !predecoded || !executed) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    j2me_predecoded_instruction_t* code = predecoded->code;
+    const uint32_t inst_count = predecoded->count;
+    const uint8_t* bytecode = frame->bytecode;
+    j2me_int* stack = frame->operand_stack.data;
+    const size_t stack_size = frame->operand_stack.size;
+    j2me_int* locals = frame->local_vars.variables;
+    const size_t locals_size = frame->local_vars.size;
+    
+    size_t sp = frame->operand_stack.top;
+    uint32_t index = frame->pc < predecoded->bytecode_length ?
+                     predecoded->pc_to_index[frame->pc] : PREDECODED_INVALID_INDEX;
+    uint32_t count = 0;
+    j2me_int value1, value2;
+    j2me_error_t result = J2ME_SUCCESS;
+    
+    while (index < inst_count && count < max_instructions) {
+        j2me_predecoded_instruction_t* inst = &code[index++];
+        count++;
+        
+        if (inst->flags & INST_FLAG_SLOW_PATH) {
+            // 慢速路径：同步状态后交给通用指令实现，再把字节码偏移映射回指令索引
+            frame->pc = inst->pc;
+            frame->operand_stack.top = sp;
+            result = j2me_interpreter_execute_frame_instruction(vm, frame);
+            sp = frame->operand_stack.top;
+            if (bytecode[inst->pc] != inst->opcode && j2me_quicken_is_quick_opcode(bytecode[inst->pc])) {
+                promote_quick_instruction(predecoded, index - 1, bytecode, frame);
+            }
+            if (result == J2ME_ERROR_OUT_OF_MEMORY) {
+                goto exit;
+            }
+            if (result != J2ME_SUCCESS) {
+                LOG_DEBUG("[预解码] 指令 0x%02x 执行出错: %d (pc=%u)，继续执行\n", inst->opcode, result, inst->pc);
+                result = J2ME_SUCCESS;
+            }
+            if (thread && (!thread->is_running || thread->current_frame != frame)) {
+                goto exit;
+            }
+            if (frame->pc >= predecoded->bytecode_length ||
+                predecoded->pc_to_index[frame->pc] == PREDECODED_INVALID_INDEX) {
+                // 方法已返回或跳到了非指令边界，保留通用实现设置的pc
+                goto exit;
+            }
+            index = predecoded->pc_to_index[frame->pc];
+            continue;
+        }
+        
+        j2me_opcode_t opcode = inst->opcode;
+    dispatch:
+        switch (opcode) {
+            case OPCODE_NOP:
+                break;
+                
+            case OPCODE_ACONST_NULL:
+            case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+            case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+            case OPCODE_BIPUSH:
+            case OPCODE_SIPUSH:
+                PD_PUSH(inst->operands[0]);
+                break;
+                
+            case OPCODE_ILOAD: case OPCODE_ALOAD:
+            case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+            case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+                if ((uint32_t)inst->operands[0] >= locals_size) {
+                    result = J2ME_ERROR_INVALID_PARAMETER;
+                    goto fault;
+                }
+                PD_PUSH(locals[inst->operands[0]]);
+                break;
+                
+            case OPCODE_ISTORE: case OPCODE_ASTORE:
+            case OPCODE_ISTORE_0: case OPCODE_ISTORE_1: case OPCODE_ISTORE_2: case OPCODE_ISTORE_3:
+            case OPCODE_ASTORE_0: case OPCODE_ASTORE_1: case OPCODE_ASTORE_2: case OPCODE_ASTORE_3:
+                PD_REQUIRE(1);
+                sp--;
+                if ((uint32_t)inst->operands[0] >= locals_size) {
+                    result = J2ME_ERROR_INVALID_PARAMETER;
+                    goto fault;
+                }
+                locals[inst->operands[0]] = stack[sp];
+                break;
+                
+            case OPCODE_POP:
+                PD_REQUIRE(1);
+                sp--;
+                break;
+                
+            case OPCODE_POP2:
+                PD_REQUIRE(2);
+                sp -= 2;
+                break;
+                
+            case OPCODE_DUP:
+                PD_REQUIRE(1);
+                value1 = stack[sp - 1];
+                PD_PUSH(value1);
+                break;
+                
+            case OPCODE_SWAP:
+                PD_REQUIRE(2);
+                value1 = stack[sp - 1];
+                stack[sp - 1] = stack[sp - 2];
+                stack[sp - 2] = value1;
+                break;
+                
+            // 整数运算按Java语义回绕，使用无符号运算避免C的有符号溢出
+            case OPCODE_IADD:
+                PD_BINOP((j2me_int)((uint32_t)value1 + (uint32_t)value2));
+                break;
+            case OPCODE_ISUB:
+                PD_BINOP((j2me_int)((uint32_t)value1 - (uint32_t)value2));
+                break;
+            case OPCODE_IMUL:
+                PD_BINOP((j2me_int)((uint32_t)value1 * (uint32_t)value2));
+                break;
+            case OPCODE_IDIV:
+                PD_REQUIRE(2);
+                if (stack[sp - 1] == 0) {
+                    sp -= 2;
+                    result = J2ME_ERROR_RUNTIME_EXCEPTION; // 除零异常
+                    goto fault;
+                }
+                PD_BINOP(value2 == -1 ? (j2me_int)(0u - (uint32_t)value1) : value1 / value2);
+                break;
+            case OPCODE_IREM:
+                PD_REQUIRE(2);
+                if (stack[sp - 1] == 0) {
+                    sp -= 2;
+                    result = J2ME_ERROR_RUNTIME_EXCEPTION; // 除零异常
+                    goto fault;
+                }
+                PD_BINOP(value2 == -1 ? 0 : value1 % value2);
+                break;
+            case OPCODE_INEG:
+                PD_REQUIRE(1);
+                stack[sp - 1] = (j2me_int)(0u - (uint32_t)stack[sp - 1]);
+                break;
+            case OPCODE_ISHL:
+                PD_BINOP((j2me_int)((uint32_t)value1 << (value2 & 0x1f)));
+                break;
+            case OPCODE_ISHR:
+                PD_BINOP(value1 >> (value2 & 0x1f));
+                break;
+            case OPCODE_IUSHR:
+                PD_BINOP((j2me_int)((uint32_t)value1 >> (value2 & 0x1f)));
+                break;
+            case OPCODE_IAND:
+                PD_BINOP(value1 & value2);
+                break;
+            case OPCODE_IOR:
+                PD_BINOP(value1 | value2);
+                break;
+            case OPCODE_IXOR:
+                PD_BINOP(value1 ^ value2);
+                break;
+                
+            case OPCODE_IINC:
+                if ((uint32_t)inst->operands[0] >= locals_size) {
+                    result = J2ME_ERROR_INVALID_PARAMETER;
+                    goto fault;
+                }
+                locals[inst->operands[0]] = (j2me_int)((uint32_t)locals[inst->operands[0]] +
+                                                       (uint32_t)inst->operands[1]);
+                break;
+                
+            case OPCODE_IFEQ: case OPCODE_IFNULL:
+                PD_IF(value1 == 0);
+                break;
+            case OPCODE_IFNE: case OPCODE_IFNONNULL:
+                PD_IF(value1 != 0);
+                break;
+            case OPCODE_IFLT:
+                PD_IF(value1 < 0);
+                break;
+            case OPCODE_IFGE:
+                PD_IF(value1 >= 0);
+                break;
+            case OPCODE_IFGT:
+                PD_IF(value1 > 0);
+                break;
+            case OPCODE_IFLE:
+                PD_IF(value1 <= 0);
+                break;
+            case OPCODE_IF_ICMPEQ: case OPCODE_IF_ACMPEQ:
+                PD_IF_ICMP(value1 == value2);
+                break;
+            case OPCODE_IF_ICMPNE: case OPCODE_IF_ACMPNE:
+                PD_IF_ICMP(value1 != value2);
+                break;
+            case OPCODE_IF_ICMPLT:
+                PD_IF_ICMP(value1 < value2);
+                break;
+            case OPCODE_IF_ICMPGE:
+                PD_IF_ICMP(value1 >= value2);
+                break;
+            case OPCODE_IF_ICMPGT:
+                PD_IF_ICMP(value1 > value2);
+                break;
+            case OPCODE_IF_ICMPLE:
+                PD_IF_ICMP(value1 <= value2);
+                break;
+            case OPCODE_GOTO:
+                index = (uint32_t)inst->operands[0];
+                break;
+                
+            case OPCODE_IRETURN: case OPCODE_ARETURN:
+                PD_REQUIRE(1);
+                frame->return_value = stack[--sp];
+                frame->has_return_value = true;
+                frame->pc = 0xFFFFFFFF;
+                goto exit;
+                
+            case OPCODE_RETURN:
+                frame->pc = 0xFFFFFFFF;
+                goto exit;
+                
+            case OPCODE_LDC_QUICK:
+            case OPCODE_LDC_W_QUICK:
+                PD_PUSH(inst->operands[0]);
+                break;
+                
+            case OPCODE_GETSTATIC_QUICK:
+                value1 = j2me_quicken_entry(frame, (uint16_t)inst->operands[0])->u.static_slot->int_value;
+                PD_PUSH(value1);
+                break;
+                
+            case OPCODE_PUTSTATIC_QUICK:
+                PD_REQUIRE(1);
+                {
+                    j2me_value_t* slot = j2me_quicken_entry(frame, (uint16_t)inst->operands[0])->u.static_slot;
+                    slot->type = J2ME_TYPE_INT;
+                    slot->int_value = stack[--sp];
+                }
+                break;
+                
+            // 超级指令：整个序列的栈和局部变量访问都合法、本批次还能执行完整个序列时一次执行完，
+            // 否则只执行第一条指令，之后的指令照常逐条执行（出错行为与未融合时相同）
+            case SUPER_ALOAD_GETFIELD:
+                if (max_instructions - count < 1 || sp >= stack_size ||
+                    (uint32_t)inst->operands[0] >= locals_size) {
+                    goto unfused;
+                }
+                stack[sp++] = predecoded_get_field(vm, frame, locals[inst->operands[0]], (uint16_t)inst[1].operands[0]);
+                index += 1;
+                count += 1;
+                break;
+                
+            case SUPER_ALOAD_GETFIELD_ILOAD:
+                if (max_instructions - count < 2 || sp + 1 >= stack_size ||
+                    (uint32_t)inst->operands[0] >= locals_size || (uint32_t)inst[2].operands[0] >= locals_size) {
+                    goto unfused;
+                }
+                stack[sp++] = predecoded_get_field(vm, frame, locals[inst->operands[0]], (uint16_t)inst[1].operands[0]);
+                stack[sp++] = locals[inst[2].operands[0]];
+                index += 2;
+                count += 2;
+                break;
+                
+            case SUPER_ILOAD_ILOAD_IF_ICMP:
+                if (max_instructions - count < 2 || sp + 1 >= stack_size ||
+                    (uint32_t)inst->operands[0] >= locals_size || (uint32_t)inst[1].operands[0] >= locals_size) {
+                    goto unfused;
+                }
+                value1 = locals[inst->operands[0]];
+                value2 = locals[inst[1].operands[0]];
+                index = (inst->operands[2] >> ((value1 > value2) - (value1 < value2) + 1)) & 1 ?
+                        (uint32_t)inst[2].operands[0] : index + 2;
+                count += 2;
+                break;
+                
+            case SUPER_ILOAD_CONST_IF_ICMP:
+                if (max_instructions - count < 2 || sp + 1 >= stack_size ||
+                    (uint32_t)inst->operands[0] >= locals_size) {
+                    goto unfused;
+                }
+                value1 = locals[inst->operands[0]];
+                value2 = inst[1].operands[0];
+                index = (inst->operands[2] >> ((value1 > value2) - (value1 < value2) + 1)) & 1 ?
+                        (uint32_t)inst[2].operands[0] : index + 2;
+                count += 2;
+                break;
+                
+            case SUPER_IINC_GOTO:
+                if (max_instructions - count < 1 || (uint32_t)inst->operands[0] >= locals_size) {
+                    goto unfused;
+                }
+                locals[inst->operands[0]] = (j2me_int)((uint32_t)locals[inst->operands[0]] +
+                                                       (uint32_t)inst->operands[1]);
+                index = (uint32_t)inst[1].operands[0];
+                count += 1;
+                break;
+                
+            default:
+                // 预解码阶段已把其余指令标记为慢速路径，不会到达这里
+                result = J2ME_ERROR_INVALID_STATE;
+                goto fault;
+        }
+        continue;
+        
+    unfused:
+        // 序列中的第一条指令保留了自己的操作数，按原始字节码重新分发
+        opcode = bytecode[inst->pc];
+        goto dispatch;
+        
+    fault:
+        // 非致命错误：记录后继续执行（与逐条解释的行为一致）
+        LOG_DEBUG("[预解码] 指令 0x%02x 执行出错: %d (pc=%u)，继续执行\n", opcode, result, inst->pc);
+        result = J2ME_SUCCESS;
+    }
+    
+    // 批次用完或执行到方法末尾
+    frame->pc = index < inst_count ? code[index].pc : predecoded->bytecode_length;
+    
+exit:
+    frame->operand_stack.top = sp;
+    *executed = count;
+    return result;
+}
+
+#undef PD_REQUIRE
+#undef PD_PUSH
+#undef PD_BINOP
+#undef PD_IF
+#undef PD_IF_ICMP
+
 /**
  * @brief 创建内联缓存
  */
@@ -0,0 +1,1120 @@
+#include "j2me_jit.h"
+#include "j2me_jit_backend.h"
+#include "j2me_vm.h"
+#include "j2me_class.h"
+#include "j2me_bytecode.h"
+#include "j2me_quicken.h"
+#include "j2me_field_access.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#if J2ME_JIT_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file j2me_jit.c
+ * @brief 模板JIT编译器：栈深度分析、字节码模板、代码缓存和执行循环
+ *
+ * 编译分两遍。第一遍从方法入口沿控制流推算每条指令执行前的栈深度：
+ * 编译为机器码的指令栈效果是确定的；解释执行的指令只对栈效果固定的几种继续推算，
+ * 其余指令之后的栈深度记为未知（不能从那里进入编译代码）。同一条指令从不同路径
+ * 得到不同深度时也记为未知。第二遍按字节码顺序为深度已知的指令生成模板，
+ * 栈槽位按深度直接寻址；跳转到深度未知的指令时退出到解释器。
+ *
+ * 编译代码只在向后跳转时检查剩余指令数，所以一个批次可能多执行一段没有循环的代码。
+ */
+
+#define DEPTH_UNVISITED         (-1)            // 分析时尚未到达
+#define DEPTH_UNKNOWN           (-2)            // 栈深度无法确定
+#define DELTA_UNKNOWN           INT32_MIN       // 指令的栈效果无法预测
+#define JIT_MAX_METHOD_CODE     (1024 * 1024)   // 单个方法的机器码上限（AArch64条件跳转范围）
+#define JIT_BUFFER_INITIAL      4096            // 机器码缓冲区初始容量
+#define JIT_CODE_ALIGN          16              // 方法在代码缓存中的对齐
+
+// 静态字段槽的类型字段按32位写入
+_Static_assert(sizeof(((j2me_value_t*)0)->type) == 4, "j2me_value_t.type must be 32-bit");
+
+// 编译时的指令信息
+typedef struct {
+    uint32_t length;                    // 指令长度，0表示超出代码范围
+    bool native;                        // 可以编译为机器码（还需检查栈深度）
+    bool falls_through;                 // 可以顺序执行到下一条指令
+    bool branches;                      // 有跳转目标
+    uint32_t target;                    // 跳转目标
+    int pops;                           // 执行前至少需要的栈元素数
+    int delta;                          // 栈深度变化，DELTA_UNKNOWN表示无法预测
+    const j2me_resolved_call_t* call;   // 调用目标（快速调用指令）
+} jit_instruction_t;
+
+// 向前跳转：目标的机器码偏移在生成完所有指令后填写
+typedef struct {
+    size_t patch;
+    uint32_t target;
+} jit_fixup_t;
+
+// 编译器状态
+typedef struct {
+    j2me_method_t* method;
+    const uint8_t* code;
+    uint32_t length;
+    int32_t* depths;                    // 每条指令执行前的栈深度（分析结果）
+    uint8_t* is_start;                  // 是否为指令开头
+    size_t* labels;                     // 栈深度已知的指令的机器码偏移
+    j2me_jit_buffer_t buffer;           // 机器码
+    size_t epilogue;                    // 公共出口偏移
+    jit_fixup_t* fixups;                // 向前跳转
+    size_t fixup_count;
+    size_t fixup_capacity;
+    j2me_jit_method_t* result;          // 编译结果（入口表和调用点）
+} jit_compiler_t;
+
+void j2me_jit_buffer_emit(j2me_jit_buffer_t* buffer, const void* bytes, size_t size) {
+    if (buffer->failed) {
+        return;
+    }
+
+    if (buffer->length + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : JIT_BUFFER_INITIAL;
+        while (capacity < buffer->length + size) {
+            capacity *= 2;
+        }
+        uint8_t* data = (uint8_t*)realloc(buffer->data, capacity);
+        if (!data) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, bytes, size);
+    buffer->length += size;
+}
+
+// ============================================================================
+// 运行时函数（由编译代码调用）
+// ============================================================================
+
+/**
+ * @brief getfield_quick：对象引用为null时返回0（与解释器相同）
+ */
+static j2me_int jit_get_field(j2me_stack_frame_t* frame, j2me_jit_context_t* context,
+                              const void* field, j2me_int object_ref, j2me_int unused) {
+    (void)frame;
+    (void)unused;
+    j2me_value_t value;
+    value.int_value = 0;
+    if (object_ref != 0) {
+        j2me_get_instance_field_value(context->vm, (j2me_object_t*)(intptr_t)object_ref,
+                                      (j2me_field_t*)field, &value);
+    }
+    return value.int_value;
+}
+
+/**
+ * @brief putfield_quick：对象引用为null（构造过程中）时忽略
+ */
+static j2me_int jit_put_field(j2me_stack_frame_t* frame, j2me_jit_context_t* context,
+                              const void* field, j2me_int object_ref, j2me_int field_value) {
+    (void)frame;
+    if (object_ref != 0) {
+        j2me_value_t value;
+        value.type = J2ME_TYPE_INT;
+        value.int_value = field_value;
+        j2me_set_instance_field_value(context->vm, (j2me_object_t*)(intptr_t)object_ref,
+                                      (j2me_field_t*)field, &value);
+    }
+    return 0;
+}
+
+/**
+ * @brief 快速调用指令：调用编译时解析的目标
+ * @return 调用后栈帧状态与编译时预期一致时返回J2ME_JIT_EXIT_CONTINUE，否则返回退出原因
+ */
+static j2me_int jit_invoke(j2me_stack_frame_t* frame, j2me_jit_context_t* context,
+                           const void* arg, j2me_int a, j2me_int b) {
+    (void)a;
+    (void)b;
+    const j2me_jit_call_t* call = (const j2me_jit_call_t*)arg;
+
+    // 与解释器一致：调用时pc已经指向下一条指令
+    frame->pc = call->next_pc;
+    j2me_error_t result = j2me_interpreter_invoke_resolved(context->vm, frame, call->call, call->site);
+    if (result == J2ME_ERROR_OUT_OF_MEMORY) {
+        context->error = result;
+        return J2ME_JIT_EXIT_STOP;
+    }
+    if (context->thread && (!context->thread->is_running || context->thread->current_frame != frame)) {
+        return J2ME_JIT_EXIT_STOP;
+    }
+    if (result != J2ME_SUCCESS) {
+        // 非致命错误：记录后继续执行（异常处理可能已改变pc）
+        LOG_DEBUG("[JIT] 调用出错: %d (pc=%u)，继续执行\n", result, frame->pc);
+        return J2ME_JIT_EXIT_RESUME;
+    }
+    if (frame->pc != call->next_pc || frame->operand_stack.top != call->depth_after) {
+        return J2ME_JIT_EXIT_RESUME;
+    }
+    return J2ME_JIT_EXIT_CONTINUE;
+}
+
+// ============================================================================
+// 栈深度分析
+// ============================================================================
+
+static bool is_quickenable_opcode(j2me_opcode_t opcode) {
+    switch (opcode) {
+        case OPCODE_LDC: case OPCODE_LDC_W:
+        case OPCODE_GETSTATIC: case OPCODE_PUTSTATIC:
+        case OPCODE_GETFIELD: case OPCODE_PUTFIELD:
+        case OPCODE_INVOKEVIRTUAL: case OPCODE_INVOKESPECIAL:
+        case OPCODE_INVOKESTATIC: case OPCODE_INVOKEINTERFACE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 快速调用指令返回后压入的栈槽位数（按方法描述符的返回类型）
+ * @return 槽位数，无法解析方法引用时返回-1
+ */
+static int invoke_return_slots(const j2me_method_t* method, uint16_t index, const j2me_resolved_call_t* call) {
+    const char* class_name;
+    const char* method_name;
+    const char* descriptor;
+    if (j2me_interpreter_resolve_method_ref(method->owner_class, index, &class_name, &method_name,
+                                            &descriptor) != J2ME_SUCCESS || !descriptor) {
+        return -1;
+    }
+
+    const char* return_type = strchr(descriptor, ')');
+    if (!return_type) {
+        return -1;
+    }
+    switch (return_type[1]) {
+        case 'V':
+            return 0;
+        case 'J':
+        case 'D':
+            // 内建实现按两个槽位压入long/double，解释执行的方法只返回一个32位值
+            return call->kind == J2ME_CALL_BUILTIN ? 2 : 1;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief 解码一条指令的编译信息
+ */
+static void decode_instruction(const j2me_method_t* method, uint32_t pc, jit_instruction_t* insn) {
+    const uint8_t* code = method->bytecode;
+    j2me_opcode_t opcode = code[pc];
+    int length = j2me_get_instruction_length(code, pc);
+
+    memset(insn, 0, sizeof(*insn));
+    insn->falls_through = true;
+    insn->delta = DELTA_UNKNOWN;
+    if (length <= 0 || pc + (uint32_t)length > method->bytecode_length) {
+        insn->falls_through = false;
+        return;
+    }
+    insn->length = (uint32_t)length;
+
+    int local_index = -1;
+    switch (opcode) {
+        case OPCODE_NOP:
+            insn->native = true;
+            insn->delta = 0;
+            break;
+        case OPCODE_ACONST_NULL:
+        case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+        case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+        case OPCODE_BIPUSH: case OPCODE_SIPUSH:
+        case OPCODE_LDC_QUICK: case OPCODE_LDC_W_QUICK:
+        case OPCODE_GETSTATIC_QUICK:
+            insn->native = true;
+            insn->delta = 1;
+            break;
+        case OPCODE_ILOAD: case OPCODE_ALOAD:
+            local_index = code[pc + 1];
+            insn->native = true;
+            insn->delta = 1;
+            break;
+        case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+            local_index = opcode - OPCODE_ILOAD_0;
+            insn->native = true;
+            insn->delta = 1;
+            break;
+        case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+            local_index = opcode - OPCODE_ALOAD_0;
+            insn->native = true;
+            insn->delta = 1;
+            break;
+        case OPCODE_ISTORE: case OPCODE_ASTORE:
+            local_index = code[pc + 1];
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            break;
+        case OPCODE_ISTORE_0: case OPCODE_ISTORE_1: case OPCODE_ISTORE_2: case OPCODE_ISTORE_3:
+            local_index = opcode - OPCODE_ISTORE_0;
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            break;
+        case OPCODE_ASTORE_0: case OPCODE_ASTORE_1: case OPCODE_ASTORE_2: case OPCODE_ASTORE_3:
+            local_index = opcode - OPCODE_ASTORE_0;
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            break;
+        case OPCODE_IINC:
+            local_index = code[pc + 1];
+            insn->native = true;
+            insn->delta = 0;
+            break;
+        case OPCODE_POP:
+        case OPCODE_PUTSTATIC_QUICK:
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            break;
+        case OPCODE_POP2:
+        case OPCODE_PUTFIELD_QUICK:
+            insn->native = true;
+            insn->pops = 2;
+            insn->delta = -2;
+            break;
+        case OPCODE_DUP:
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = 1;
+            break;
+        case OPCODE_SWAP:
+            insn->native = true;
+            insn->pops = 2;
+            insn->delta = 0;
+            break;
+        case OPCODE_IADD: case OPCODE_ISUB: case OPCODE_IMUL: case OPCODE_IDIV: case OPCODE_IREM:
+        case OPCODE_ISHL: case OPCODE_ISHR: case OPCODE_IUSHR:
+        case OPCODE_IAND: case OPCODE_IOR: case OPCODE_IXOR:
+            insn->native = true;
+            insn->pops = 2;
+            insn->delta = -1;
+            break;
+        case OPCODE_INEG:
+        case OPCODE_GETFIELD_QUICK:
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = 0;
+            break;
+        case OPCODE_IFEQ: case OPCODE_IFNE: case OPCODE_IFLT: case OPCODE_IFGE: case OPCODE_IFGT: case OPCODE_IFLE:
+        case OPCODE_IFNULL: case OPCODE_IFNONNULL:
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            insn->branches = true;
+            break;
+        case OPCODE_IF_ICMPEQ: case OPCODE_IF_ICMPNE: case OPCODE_IF_ICMPLT:
+        case OPCODE_IF_ICMPGE: case OPCODE_IF_ICMPGT: case OPCODE_IF_ICMPLE:
+            insn->native = true;
+            insn->pops = 2;
+            insn->delta = -2;
+            insn->branches = true;
+            break;
+        case OPCODE_GOTO:
+            insn->native = true;
+            insn->delta = 0;
+            insn->branches = true;
+            insn->falls_through = false;
+            break;
+        case OPCODE_IRETURN: case OPCODE_ARETURN:
+            insn->native = true;
+            insn->pops = 1;
+            insn->delta = -1;
+            insn->falls_through = false;
+            break;
+        case OPCODE_RETURN:
+            insn->native = true;
+            insn->delta = 0;
+            insn->falls_through = false;
+            break;
+        case OPCODE_INVOKEVIRTUAL_QUICK: case OPCODE_INVOKESPECIAL_QUICK:
+        case OPCODE_INVOKESTATIC_QUICK: case OPCODE_INVOKEINTERFACE_QUICK:
+            {
+                uint16_t index = (uint16_t)((code[pc + 1] << 8) | code[pc + 2]);
+                const j2me_resolved_call_t* call =
+                    &((j2me_quick_entry_t*)method->owner_class->quick_entries)[index].u.call;
+                int return_slots = call->kind != J2ME_CALL_UNRESOLVED ? invoke_return_slots(method, index, call) : -1;
+                if (return_slots >= 0) {
+                    insn->native = true;
+                    insn->call = call;
+                    insn->pops = call->arg_slots + (call->has_receiver ? 1 : 0);
+                    insn->delta = return_slots - insn->pops;
+                }
+            }
+            break;
+
+        // 解释执行、栈效果固定的指令
+        case OPCODE_NEW:
+        case OPCODE_LDC: case OPCODE_LDC_W:
+        case OPCODE_GETSTATIC:
+            insn->delta = 1;
+            break;
+        case OPCODE_CHECKCAST: case OPCODE_INSTANCEOF:
+        case OPCODE_NEWARRAY: case OPCODE_ANEWARRAY:
+        case OPCODE_GETFIELD:
+            insn->delta = 0;
+            break;
+        case OPCODE_PUTSTATIC:
+            insn->delta = -1;
+            break;
+        case OPCODE_PUTFIELD:
+            insn->delta = -2;
+            break;
+        case OPCODE_TABLESWITCH: case OPCODE_LOOKUPSWITCH:
+            // 跳转目标在分析时逐个处理
+            insn->delta = -1;
+            insn->falls_through = false;
+            break;
+        default:
+            break;
+    }
+
+    if (local_index >= (int)method->max_locals) {
+        insn->native = false;
+        insn->delta = DELTA_UNKNOWN;
+    }
+    if (insn->branches) {
+        insn->target = pc + (j2me_short)((code[pc + 1] << 8) | code[pc + 2]);
+    }
+}
+
+/**
+ * @brief 指令在给定栈深度下能否编译为机器码（栈不会越界）
+ */
+static bool can_compile_at(const j2me_method_t* method, const jit_instruction_t* insn, int depth) {
+    return insn->native && depth >= insn->pops && depth + insn->delta >= 0 &&
+           depth + (insn->delta > 0 ? insn->delta : 0) <= (int)method->max_stack;
+}
+
+/**
+ * @brief 合并到达指令的栈深度，发生变化时加入工作表
+ */
+static void merge_depth(jit_compiler_t* compiler, uint32_t* worklist, size_t* worklist_size,
+                        uint32_t pc, int depth) {
+    // 负偏移回绕成大于length的值
+    if (pc >= compiler->length || !compiler->is_start[pc]) {
+        return;
+    }
+
+    int32_t old_depth = compiler->depths[pc];
+    int32_t new_depth = old_depth == DEPTH_UNVISITED || old_depth == depth ? depth : DEPTH_UNKNOWN;
+    if (new_depth != old_depth) {
+        compiler->depths[pc] = new_depth;
+        worklist[(*worklist_size)++] = pc;
+    }
+}
+
+/**
+ * @brief tableswitch/lookupswitch的跳转目标
+ * @return 目标数，超出代码范围时返回0
+ */
+static uint32_t switch_targets(const jit_compiler_t* compiler, uint32_t pc, uint32_t index, uint32_t* target) {
+    const uint8_t* code = compiler->code;
+    uint32_t base = (pc + 4) & ~3U;
+#define READ_S32(p) ((int32_t)(((uint32_t)code[(p)] << 24) | ((uint32_t)code[(p) + 1] << 16) | \
+                               ((uint32_t)code[(p) + 2] << 8) | code[(p) + 3]))
+    if (base + 12 > compiler->length) {
+        return 0;
+    }
+
+    uint32_t count;
+    uint32_t entry;
+    if (code[pc] == OPCODE_TABLESWITCH) {
+        count = (uint32_t)(READ_S32(base + 8) - READ_S32(base + 4)) + 1;
+        entry = base + 12 + index * 4;
+    } else {
+        count = (uint32_t)READ_S32(base + 4);
+        entry = base + 8 + index * 8 + 4;
+    }
+    // 目标数包括default
+    if (index == count) {
+        entry = base;
+    } else if (index > count || entry + 4 > compiler->length) {
+        return 0;
+    }
+    *target = pc + READ_S32(entry);
+#undef READ_S32
+    return count + 1;
+}
+
+/**
+ * @brief 从方法入口推算每条指令执行前的栈深度
+ */
+static bool analyze_depths(jit_compiler_t* compiler) {
+    const uint32_t length = compiler->length;
+    // 每条指令的深度最多改变两次（未到达 -> 已知 -> 未知）
+    uint32_t* worklist = (uint32_t*)malloc(sizeof(uint32_t) * (2 * (size_t)length + 1));
+    if (!worklist) {
+        return false;
+    }
+    size_t worklist_size = 0;
+
+    merge_depth(compiler, worklist, &worklist_size, 0, 0);
+    while (worklist_size > 0) {
+        uint32_t pc = worklist[--worklist_size];
+        int depth = compiler->depths[pc];
+        jit_instruction_t insn;
+        decode_instruction(compiler->method, pc, &insn);
+
+        int next_depth = DEPTH_UNKNOWN;
+        if (depth >= 0 && insn.delta != DELTA_UNKNOWN &&
+            (!insn.native || can_compile_at(compiler->method, &insn, depth)) &&
+            depth + insn.delta >= 0 && depth + insn.delta <= (int)compiler->method->max_stack) {
+            next_depth = depth + insn.delta;
+        }
+
+        if (insn.falls_through) {
+            merge_depth(compiler, worklist, &worklist_size, pc + insn.length, next_depth);
+        }
+        if (insn.branches) {
+            merge_depth(compiler, worklist, &worklist_size, insn.target, next_depth);
+        }
+        if (insn.length && (compiler->code[pc] == OPCODE_TABLESWITCH || compiler->code[pc] == OPCODE_LOOKUPSWITCH)) {
+            uint32_t target;
+            uint32_t count = switch_targets(compiler, pc, 0, &target);
+            for (uint32_t i = 0; i < count && switch_targets(compiler, pc, i, &target); i++) {
+                merge_depth(compiler, worklist, &worklist_size, target, next_depth);
+            }
+        }
+    }
+
+    free(worklist);
+    return true;
+}
+
+// ============================================================================
+// 字节码模板
+// ============================================================================
+
+/**
+ * @brief 跳转目标可以直接执行编译代码（栈深度一致）
+ */
+static bool target_compiled(const jit_compiler_t* compiler, uint32_t target, int depth) {
+    return target < compiler->length && compiler->is_start[target] && compiler->depths[target] == depth;
+}
+
+static void add_fixup(jit_compiler_t* compiler, size_t patch, uint32_t target) {
+    if (compiler->fixup_count == compiler->fixup_capacity) {
+        size_t capacity = compiler->fixup_capacity ? compiler->fixup_capacity * 2 : 64;
+        jit_fixup_t* fixups = (jit_fixup_t*)realloc(compiler->fixups, capacity * sizeof(jit_fixup_t));
+        if (!fixups) {
+            compiler->buffer.failed = true;
+            return;
+        }
+        compiler->fixups = fixups;
+        compiler->fixup_capacity = capacity;
+    }
+    compiler->fixups[compiler->fixup_count].patch = patch;
+    compiler->fixups[compiler->fixup_count].target = target;
+    compiler->fixup_count++;
+}
+
+/**
+ * @brief 无条件转移到target：向后跳转先检查剩余指令数，目标不能直接执行时退出到解释器
+ */
+static void emit_edge(jit_compiler_t* compiler, uint32_t pc, uint32_t target, int depth) {
+    j2me_jit_buffer_t* buffer = &compiler->buffer;
+    if (!target_compiled(compiler, target, depth)) {
+        j2me_jit_emit_exit(buffer, target, (uint32_t)depth, J2ME_JIT_EXIT_DEOPT, compiler->epilogue);
+    } else if (target <= pc) {
+        j2me_jit_patch(buffer, j2me_jit_emit_branch_budget(buffer), compiler->labels[target]);
+        j2me_jit_emit_exit(buffer, target, (uint32_t)depth, J2ME_JIT_EXIT_BUDGET, compiler->epilogue);
+    } else {
+        add_fixup(compiler, j2me_jit_emit_jump(buffer), target);
+    }
+}
+
+/**
+ * @brief 条件成立时转移到target（比较A和B，或A和0）
+ */
+static void emit_conditional(jit_compiler_t* compiler, uint32_t pc, uint32_t target, int depth,
+                             j2me_jit_cond_t cond, bool compare_zero) {
+    j2me_jit_buffer_t* buffer = &compiler->buffer;
+    if (target > pc && target_compiled(compiler, target, depth)) {
+        size_t patch = compare_zero ? j2me_jit_emit_branch_imm(buffer, J2ME_JIT_REG_A, cond, 0) :
+                                      j2me_jit_emit_branch(buffer, cond);
+        add_fixup(compiler, patch, target);
+        return;
+    }
+
+    // 条件取反跳过转移代码（EQ/NE、LT/GE、GT/LE成对排列）
+    j2me_jit_cond_t inverse = (j2me_jit_cond_t)(cond ^ 1);
+    size_t skip = compare_zero ? j2me_jit_emit_branch_imm(buffer, J2ME_JIT_REG_A, inverse, 0) :
+                                 j2me_jit_emit_branch(buffer, inverse);
+    emit_edge(compiler, pc, target, depth);
+    j2me_jit_patch(buffer, skip, buffer->length);
+}
+
+/**
+ * @brief 整数除法和取余：除数为0时退出到解释器（由解释器报告异常），除数为-1时避免溢出陷阱
+ */
+static void emit_division(jit_compiler_t* compiler, uint32_t pc, int depth, bool remainder) {
+    j2me_jit_buffer_t* buffer = &compiler->buffer;
+    j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+    j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_B, depth - 1);
+    size_t nonzero = j2me_jit_emit_branch_imm(buffer, J2ME_JIT_REG_B, J2ME_JIT_COND_NE, 0);
+    j2me_jit_emit_exit(buffer, pc, (uint32_t)depth, J2ME_JIT_EXIT_DEOPT, compiler->epilogue);
+    j2me_jit_patch(buffer, nonzero, buffer->length);
+    j2me_jit_emit_tick(buffer);
+
+    size_t minus_one = j2me_jit_emit_branch_imm(buffer, J2ME_JIT_REG_B, J2ME_JIT_COND_EQ, -1);
+    j2me_jit_emit_alu(buffer, remainder ? J2ME_JIT_ALU_REM : J2ME_JIT_ALU_DIV);
+    size_t done = j2me_jit_emit_jump(buffer);
+    j2me_jit_patch(buffer, minus_one, buffer->length);
+    if (remainder) {
+        j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, 0);
+    } else {
+        j2me_jit_emit_neg(buffer);
+    }
+    j2me_jit_patch(buffer, done, buffer->length);
+    j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+}
+
+/**
+ * @brief 生成一条指令的模板（指令在当前栈深度下可以编译）
+ */
+static void emit_instruction(jit_compiler_t* compiler, uint32_t pc, int depth, const jit_instruction_t* insn) {
+    j2me_jit_buffer_t* buffer = &compiler->buffer;
+    const uint8_t* code = compiler->code;
+    j2me_quick_entry_t* entries = (j2me_quick_entry_t*)compiler->method->owner_class->quick_entries;
+    j2me_opcode_t opcode = code[pc];
+    // 操作数：一字节(ldc_quick/bipush)或两字节(常量池索引/sipush)
+    uint16_t index = 0;
+    if (insn->length >= 3) {
+        index = (uint16_t)((code[pc + 1] << 8) | code[pc + 2]);
+    } else if (insn->length == 2) {
+        index = code[pc + 1];
+    }
+
+    // 除法在计数前检查除数
+    if (opcode == OPCODE_IDIV || opcode == OPCODE_IREM) {
+        emit_division(compiler, pc, depth, opcode == OPCODE_IREM);
+        return;
+    }
+
+    j2me_jit_emit_tick(buffer);
+    switch (opcode) {
+        case OPCODE_NOP:
+        case OPCODE_POP:
+        case OPCODE_POP2:
+            break;
+        case OPCODE_ACONST_NULL:
+            j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, 0);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_ICONST_M1: case OPCODE_ICONST_0: case OPCODE_ICONST_1: case OPCODE_ICONST_2:
+        case OPCODE_ICONST_3: case OPCODE_ICONST_4: case OPCODE_ICONST_5:
+            j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, opcode - OPCODE_ICONST_0);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_BIPUSH:
+            j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, (j2me_byte)code[pc + 1]);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_SIPUSH:
+            j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, (j2me_short)index);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_LDC_QUICK:
+        case OPCODE_LDC_W_QUICK:
+            j2me_jit_emit_load_imm(buffer, J2ME_JIT_REG_A, entries[index].u.constant);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_ILOAD: case OPCODE_ALOAD:
+            j2me_jit_emit_load_local(buffer, J2ME_JIT_REG_A, code[pc + 1]);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_ILOAD_0: case OPCODE_ILOAD_1: case OPCODE_ILOAD_2: case OPCODE_ILOAD_3:
+            j2me_jit_emit_load_local(buffer, J2ME_JIT_REG_A, opcode - OPCODE_ILOAD_0);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_ALOAD_0: case OPCODE_ALOAD_1: case OPCODE_ALOAD_2: case OPCODE_ALOAD_3:
+            j2me_jit_emit_load_local(buffer, J2ME_JIT_REG_A, opcode - OPCODE_ALOAD_0);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_ISTORE: case OPCODE_ASTORE:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_local(buffer, J2ME_JIT_REG_A, code[pc + 1]);
+            break;
+        case OPCODE_ISTORE_0: case OPCODE_ISTORE_1: case OPCODE_ISTORE_2: case OPCODE_ISTORE_3:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_local(buffer, J2ME_JIT_REG_A, opcode - OPCODE_ISTORE_0);
+            break;
+        case OPCODE_ASTORE_0: case OPCODE_ASTORE_1: case OPCODE_ASTORE_2: case OPCODE_ASTORE_3:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_local(buffer, J2ME_JIT_REG_A, opcode - OPCODE_ASTORE_0);
+            break;
+        case OPCODE_DUP:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_SWAP:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_B, depth - 1);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_B, depth - 2);
+            break;
+        case OPCODE_IADD: case OPCODE_ISUB: case OPCODE_IMUL:
+        case OPCODE_ISHL: case OPCODE_ISHR: case OPCODE_IUSHR:
+        case OPCODE_IAND: case OPCODE_IOR: case OPCODE_IXOR:
+            {
+                j2me_jit_alu_t op;
+                switch (opcode) {
+                    case OPCODE_IADD: op = J2ME_JIT_ALU_ADD; break;
+                    case OPCODE_ISUB: op = J2ME_JIT_ALU_SUB; break;
+                    case OPCODE_IMUL: op = J2ME_JIT_ALU_MUL; break;
+                    case OPCODE_ISHL: op = J2ME_JIT_ALU_SHL; break;
+                    case OPCODE_ISHR: op = J2ME_JIT_ALU_SHR; break;
+                    case OPCODE_IUSHR: op = J2ME_JIT_ALU_USHR; break;
+                    case OPCODE_IAND: op = J2ME_JIT_ALU_AND; break;
+                    case OPCODE_IOR: op = J2ME_JIT_ALU_OR; break;
+                    default: op = J2ME_JIT_ALU_XOR; break;
+                }
+                j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+                j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_B, depth - 1);
+                j2me_jit_emit_alu(buffer, op);
+                j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+            }
+            break;
+        case OPCODE_INEG:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_neg(buffer);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            break;
+        case OPCODE_IINC:
+            j2me_jit_emit_add_local(buffer, code[pc + 1], (j2me_byte)code[pc + 2]);
+            break;
+        case OPCODE_IFEQ: case OPCODE_IFNE: case OPCODE_IFLT: case OPCODE_IFGE: case OPCODE_IFGT: case OPCODE_IFLE:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            emit_conditional(compiler, pc, insn->target, depth - 1,
+                             (j2me_jit_cond_t)(J2ME_JIT_COND_EQ + (opcode - OPCODE_IFEQ)), true);
+            break;
+        case OPCODE_IFNULL: case OPCODE_IFNONNULL:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            emit_conditional(compiler, pc, insn->target, depth - 1,
+                             opcode == OPCODE_IFNULL ? J2ME_JIT_COND_EQ : J2ME_JIT_COND_NE, true);
+            break;
+        case OPCODE_IF_ICMPEQ: case OPCODE_IF_ICMPNE: case OPCODE_IF_ICMPLT:
+        case OPCODE_IF_ICMPGE: case OPCODE_IF_ICMPGT: case OPCODE_IF_ICMPLE:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_B, depth - 1);
+            emit_conditional(compiler, pc, insn->target, depth - 2,
+                             (j2me_jit_cond_t)(J2ME_JIT_COND_EQ + (opcode - OPCODE_IF_ICMPEQ)), false);
+            break;
+        case OPCODE_GOTO:
+            emit_edge(compiler, pc, insn->target, depth);
+            break;
+        case OPCODE_IRETURN: case OPCODE_ARETURN:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_set_return(buffer);
+            j2me_jit_emit_exit(buffer, 0xFFFFFFFF, (uint32_t)depth - 1, J2ME_JIT_EXIT_RETURN, compiler->epilogue);
+            break;
+        case OPCODE_RETURN:
+            j2me_jit_emit_exit(buffer, 0xFFFFFFFF, (uint32_t)depth, J2ME_JIT_EXIT_RETURN, compiler->epilogue);
+            break;
+        case OPCODE_GETSTATIC_QUICK:
+            j2me_jit_emit_load_static(buffer, entries[index].u.static_slot);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth);
+            break;
+        case OPCODE_PUTSTATIC_QUICK:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_store_static(buffer, entries[index].u.static_slot);
+            break;
+        case OPCODE_GETFIELD_QUICK:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            j2me_jit_emit_call(buffer, jit_get_field, entries[index].u.field, (uint32_t)depth - 1);
+            j2me_jit_emit_store_stack(buffer, J2ME_JIT_REG_A, depth - 1);
+            break;
+        case OPCODE_PUTFIELD_QUICK:
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_A, depth - 2);
+            j2me_jit_emit_load_stack(buffer, J2ME_JIT_REG_B, depth - 1);
+            j2me_jit_emit_call(buffer, jit_put_field, entries[index].u.field, (uint32_t)depth - 2);
+            break;
+        case OPCODE_INVOKEVIRTUAL_QUICK: case OPCODE_INVOKESPECIAL_QUICK:
+        case OPCODE_INVOKESTATIC_QUICK: case OPCODE_INVOKEINTERFACE_QUICK:
+            {
+                j2me_jit_call_t* call = &compiler->result->calls[compiler->result->call_count++];
+                call->call = insn->call;
+                call->site = NULL;
+                if (insn->call->flags & (J2ME_CALL_FLAG_VIRTUAL | J2ME_CALL_FLAG_INTERFACE)) {
+                    call->site = j2me_call_site_cache_get(compiler->method, pc);
+                }
+                call->next_pc = pc + insn->length;
+                call->depth_after = (uint32_t)(depth + insn->delta);
+                j2me_jit_emit_call(buffer, jit_invoke, call, (uint32_t)depth);
+                j2me_jit_emit_exit_if_nonzero(buffer, compiler->epilogue);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 为栈深度已知的指令生成机器码，填写入口表
+ */
+static void emit_method(jit_compiler_t* compiler) {
+    j2me_jit_buffer_t* buffer = &compiler->buffer;
+    j2me_jit_method_t* result = compiler->result;
+    compiler->epilogue = j2me_jit_emit_prologue(buffer);
+
+    for (uint32_t pc = 0; pc < compiler->length; pc++) {
+        int depth = compiler->depths[pc];
+        if (!compiler->is_start[pc] || depth < 0) {
+            continue;
+        }
+
+        compiler->labels[pc] = buffer->length;
+        jit_instruction_t insn;
+        decode_instruction(compiler->method, pc, &insn);
+        if (!can_compile_at(compiler->method, &insn, depth)) {
+            // 解释器执行这条指令
+            j2me_jit_emit_exit(buffer, pc, (uint32_t)depth, J2ME_JIT_EXIT_DEOPT, compiler->epilogue);
+            continue;
+        }
+
+        result->entries[pc] = (uint32_t)buffer->length;
+        result->depths[pc] = (uint16_t)depth;
+        emit_instruction(compiler, pc, depth, &insn);
+
+        // 下一条指令不是以相同栈深度编译的，顺序执行到它时退出
+        uint32_t next = pc + insn.length;
+        int next_depth = depth + insn.delta;
+        if (insn.falls_through && !target_compiled(compiler, next, next_depth)) {
+            j2me_jit_emit_exit(buffer, next, (uint32_t)next_depth, J2ME_JIT_EXIT_DEOPT, compiler->epilogue);
+        }
+    }
+
+    for (size_t i = 0; i < compiler->fixup_count; i++) {
+        j2me_jit_patch(buffer, compiler->fixups[i].patch, compiler->labels[compiler->fixups[i].target]);
+    }
+}
+
+// ============================================================================
+// 代码缓存
+// ============================================================================
+
+/**
+ * @brief 把机器码复制到代码缓存（临时改为可写，写完恢复为只读可执行）
+ * @return 代码缓存中的地址，缓存已满或修改页面权限失败时返回NULL
+ */
+static uint8_t* install_code(j2me_jit_t* jit, const uint8_t* code, size_t size) {
+#if J2ME_JIT_SUPPORTED
+    size_t start = (jit->cache_used + JIT_CODE_ALIGN - 1) & ~(size_t)(JIT_CODE_ALIGN - 1);
+    if (start + size > jit->cache_size) {
+        if (!jit->cache_full) {
+            LOG_WARN("[JIT] 代码缓存已满 (%zu bytes)，不再编译新方法", jit->cache_size);
+        }
+        jit->cache_full = true;
+        return NULL;
+    }
+
+    uint8_t* dest = jit->cache + start;
+    uintptr_t page_start = (uintptr_t)dest & ~(uintptr_t)(jit->page_size - 1);
+    uintptr_t page_end = ((uintptr_t)dest + size + jit->page_size - 1) & ~(uintptr_t)(jit->page_size - 1);
+    if (mprotect((void*)page_start, page_end - page_start, PROT_READ | PROT_WRITE) != 0) {
+        LOG_WARN("[JIT] 代码缓存不能写入");
+        return NULL;
+    }
+    memcpy(dest, code, size);
+    if (mprotect((void*)page_start, page_end - page_start, PROT_READ | PROT_EXEC) != 0) {
+        LOG_ERROR("[JIT] 代码缓存不能恢复为可执行，停止编译");
+        jit->cache_full = true;
+        return NULL;
+    }
+    __builtin___clear_cache((char*)dest, (char*)dest + size);
+
+    jit->cache_used = start + size;
+    return dest;
+#else
+    (void)jit;
+    (void)code;
+    (void)size;
+    return NULL;
+#endif
+}
+
+/**
+ * @brief 向perf映射文件追加编译后方法的符号
+ */
+static void write_perf_symbol(j2me_jit_t* jit, const j2me_method_t* method, const j2me_jit_method_t* compiled) {
+    if (!jit->perf_map) {
+        return;
+    }
+
+    const char* class_name = method->owner_class && method->owner_class->name ? method->owner_class->name : "?";
+    fprintf(jit->perf_map, "%lx %zx %s.%s%s\n", (unsigned long)(uintptr_t)compiled->code, compiled->code_size,
+            class_name, method->name ? method->name : "?", method->descriptor ? method->descriptor : "");
+    fflush(jit->perf_map);
+}
+
+// ============================================================================
+// 编译
+// ============================================================================
+
+static void free_compiler(jit_compiler_t* compiler) {
+    free(compiler->depths);
+    free(compiler->is_start);
+    free(compiler->labels);
+    free(compiler->buffer.data);
+    free(compiler->fixups);
+}
+
+/**
+ * @brief 编译方法
+ * @return 编译结果（方法不能编译时code为NULL），内存不足返回NULL
+ */
+static j2me_jit_method_t* compile_method(j2me_jit_t* jit, j2me_method_t* method) {
+    j2me_jit_method_t* result = (j2me_jit_method_t*)calloc(1, sizeof(j2me_jit_method_t));
+    if (!result) {
+        return NULL;
+    }
+    if (!method->bytecode || method->bytecode_length == 0 || !method->owner_class ||
+        method->max_stack > J2ME_JIT_MAX_FRAME_SLOTS || method->max_locals > J2ME_JIT_MAX_FRAME_SLOTS ||
+        jit->cache_full) {
+        jit->failed_methods++;
+        return result;
+    }
+
+    jit_compiler_t compiler;
+    memset(&compiler, 0, sizeof(compiler));
+    compiler.method = method;
+    compiler.code = method->bytecode;
+    compiler.length = method->bytecode_length;
+    compiler.result = result;
+    compiler.depths = (int32_t*)malloc(sizeof(int32_t) * compiler.length);
+    compiler.is_start = (uint8_t*)calloc(compiler.length, 1);
+    compiler.labels = (size_t*)calloc(compiler.length, sizeof(size_t));
+    result->length = compiler.length;
+    result->entries = (uint32_t*)malloc(sizeof(uint32_t) * compiler.length);
+    result->depths = (uint16_t*)calloc(compiler.length, sizeof(uint16_t));
+    if (!compiler.depths || !compiler.is_start || !compiler.labels || !result->entries || !result->depths) {
+        free_compiler(&compiler);
+        j2me_jit_method_destroy(result);
+        return NULL;
+    }
+
+    uint32_t invoke_count = 0;
+    for (uint32_t pc = 0; pc < compiler.length; ) {
+        int length = j2me_get_instruction_length(compiler.code, pc);
+        compiler.is_start[pc] = 1;
+        compiler.depths[pc] = DEPTH_UNVISITED;
+        result->entries[pc] = J2ME_JIT_NO_ENTRY;
+        if (compiler.code[pc] >= OPCODE_INVOKEVIRTUAL_QUICK && compiler.code[pc] <= OPCODE_INVOKEINTERFACE_QUICK) {
+            invoke_count++;
+        }
+        for (uint32_t i = pc + 1; i < pc + (uint32_t)length && i < compiler.length; i++) {
+            compiler.depths[i] = DEPTH_UNVISITED;
+            result->entries[i] = J2ME_JIT_NO_ENTRY;
+        }
+        pc += length > 0 ? (uint32_t)length : 1;
+    }
+    result->calls = invoke_count ? (j2me_jit_call_t*)calloc(invoke_count, sizeof(j2me_jit_call_t)) : NULL;
+    if ((invoke_count && !result->calls) || !analyze_depths(&compiler)) {
+        free_compiler(&compiler);
+        j2me_jit_method_destroy(result);
+        return NULL;
+    }
+
+    emit_method(&compiler);
+
+    bool has_entry = false;
+    for (uint32_t pc = 0; pc < compiler.length && !has_entry; pc++) {
+        has_entry = result->entries[pc] != J2ME_JIT_NO_ENTRY;
+    }
+    if (compiler.buffer.failed) {
+        free_compiler(&compiler);
+        j2me_jit_method_destroy(result);
+        return NULL;
+    }
+    if (has_entry && compiler.buffer.length <= JIT_MAX_METHOD_CODE) {
+        result->code = install_code(jit, compiler.buffer.data, compiler.buffer.length);
+        result->code_size = compiler.buffer.length;
+    }
+    free_compiler(&compiler);
+
+    if (!result->code) {
+        jit->failed_methods++;
+        return result;
+    }
+    jit->compiled_methods++;
+    write_perf_symbol(jit, method, result);
+    LOG_DEBUG("[JIT] 编译 %s%s: %u字节码 -> %zu字节机器码\n",
+              method->name ? method->name : "?", method->descriptor ? method->descriptor : "",
+              method->bytecode_length, result->code_size);
+    return result;
+}
+
+// ============================================================================
+// 公共接口
+// ============================================================================
+
+j2me_jit_t* j2me_jit_create(uint32_t threshold, bool perf_map) {
+#if J2ME_JIT_SUPPORTED
+    j2me_jit_t* jit = (j2me_jit_t*)calloc(1, sizeof(j2me_jit_t));
+    if (!jit) {
+        return NULL;
+    }
+
+    jit->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    jit->cache_size = J2ME_JIT_CODE_CACHE_SIZE;
+    jit->threshold = threshold ? threshold : J2ME_JIT_DEFAULT_THRESHOLD;
+    void* cache = mmap(NULL, jit->cache_size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (cache == MAP_FAILED) {
+        LOG_WARN("[JIT] 代码缓存分配失败");
+        free(jit);
+        return NULL;
+    }
+    jit->cache = (uint8_t*)cache;
+
+    if (perf_map) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%ld.map", (long)getpid());
+        jit->perf_map = fopen(path, "w");
+        if (!jit->perf_map) {
+            LOG_WARN("[JIT] 无法创建perf映射文件: %s", path);
+        }
+    }
+
+    LOG_DEBUG("[JIT] 模板JIT已启用，编译阈值 %u，代码缓存 %zu bytes\n", jit->threshold, jit->cache_size);
+    return jit;
+#else
+    (void)threshold;
+    (void)perf_map;
+    LOG_WARN("[JIT] 当前平台不支持JIT，使用解释器执行");
+    return NULL;
+#endif
+}
+
+void j2me_jit_destroy(j2me_jit_t* jit) {
+    if (!jit) {
+        return;
+    }
+
+    LOG_DEBUG("[JIT] 编译 %llu 个方法（%llu 个不能编译），代码缓存 %zu/%zu bytes，退出到解释器 %llu 次\n",
+              (unsigned long long)jit->compiled_methods, (unsigned long long)jit->failed_methods,
+              jit->cache_used, jit->cache_size, (unsigned long long)jit->deopts);
+#if J2ME_JIT_SUPPORTED
+    munmap(jit->cache, jit->cache_size);
+#endif
+    if (jit->perf_map) {
+        fclose(jit->perf_map);
+    }
+    free(jit);
+}
+
+void j2me_jit_method_destroy(void* compiled) {
+    j2me_jit_method_t* method = (j2me_jit_method_t*)compiled;
+    while (method) {
+        j2me_jit_method_t* previous = method->previous;
+        free(method->entries);
+        free(method->depths);
+        free(method->calls);
+        free(method);
+        method = previous;
+    }
+}
+
+j2me_jit_method_t* j2me_jit_prepare(j2me_vm_t* vm, j2me_stack_frame_t* frame) {
+    j2me_jit_t* jit = vm->jit;
+    j2me_method_t* method = (j2me_method_t*)frame->method_info;
+    // 编译代码不检查栈和局部变量越界，栈帧必须按方法的max_stack/max_locals分配
+    if (!jit || !method || !frame->bytecode || method->bytecode != frame->bytecode ||
+        frame->code_length != method->bytecode_length ||
+        frame->local_vars.size < method->max_locals || frame->operand_stack.size < method->max_stack) {
+        return NULL;
+    }
+
+    method->invocation_count++;
+    j2me_jit_method_t* compiled = (j2me_jit_method_t*)method->jit_code;
+    if (!compiled) {
+        if (method->invocation_count < jit->threshold) {
+            return NULL;
+        }
+        compiled = compile_method(jit, method);
+        method->jit_code = compiled;
+    } else if (compiled->stale && compiled->recompiles < J2ME_JIT_MAX_RECOMPILES && !jit->cache_full) {
+        // 旧版本可能还在外层执行（递归调用），保留到方法销毁
+        j2me_jit_method_t* recompiled = compile_method(jit, method);
+        compiled->stale = false;
+        if (recompiled && recompiled->code) {
+            recompiled->recompiles = compiled->recompiles + 1;
+            recompiled->previous = compiled;
+            method->jit_code = recompiled;
+            compiled = recompiled;
+        } else {
+            j2me_jit_method_destroy(recompiled);
+        }
+    }
+    return compiled && compiled->code ? compiled : NULL;
+}
+
+j2me_error_t j2me_jit_execute(j2me_vm_t* vm, j2me_thread_t* thread, j2me_stack_frame_t* frame,
+                              j2me_jit_method_t* compiled, uint32_t max_instructions, uint32_t* executed) {
+    j2me_jit_context_t context;
+    context.vm = vm;
+    context.thread = thread;
+    const uint32_t code_end = frame->code_length;
+    const j2me_jit_entry_t entry_point = (j2me_jit_entry_t)(void*)compiled->code;
+    uint32_t count = 0;
+    j2me_error_t result = J2ME_SUCCESS;
+
+    while (count < max_instructions && frame->pc < code_end) {
+        uint32_t pc = frame->pc;
+        uint32_t entry = compiled->entries[pc];
+        if (entry != J2ME_JIT_NO_ENTRY && frame->operand_stack.top == compiled->depths[pc]) {
+            int32_t budget = (int32_t)(max_instructions - count);
+            context.budget = budget;
+            context.error = J2ME_SUCCESS;
+            uint32_t reason = entry_point(frame, &context, compiled->code + entry);
+            // 编译代码只在向后跳转时检查剩余指令数，可能略微超出
+            count += (uint32_t)(budget - context.budget);
+            if (reason == J2ME_JIT_EXIT_STOP) {
+                result = context.error;
+                break;
+            }
+            if (reason != J2ME_JIT_EXIT_DEOPT || count >= max_instructions) {
+                continue;
+            }
+            vm->jit->deopts++;
+        }
+
+        // 解释执行一条指令；编译后才被快速化的指令下次进入方法时重新编译
+        j2me_opcode_t opcode = frame->bytecode[frame->pc];
+        pc = frame->pc;
+        count++;
+        result = j2me_interpreter_execute_frame_instruction(vm, frame);
+        if (result == J2ME_ERROR_OUT_OF_MEMORY) {
+            break;
+        }
+        if (result != J2ME_SUCCESS) {
+            // 非致命错误：记录后继续执行（与线程化分发引擎的行为一致）
+            LOG_DEBUG("[JIT] 指令执行出错: %d (pc=%u)，继续执行\n", result, frame->pc);
+            result = J2ME_SUCCESS;
+        }
+        if (is_quickenable_opcode(opcode) && j2me_quicken_is_quick_opcode(frame->bytecode[pc])) {
+            compiled->stale = true;
+        }
+        if (thread && (!thread->is_running || thread->current_frame != frame)) {
+            break;
+        }
+    }
+
+    *executed = count;
+    return result;
+}
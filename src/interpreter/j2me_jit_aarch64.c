@@ -0,0 +1,267 @@
+#include "j2me_jit_backend.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @file j2me_jit_aarch64.c
+ * @brief 模板JIT的AArch64机器码生成 (AAPCS64调用约定)
+ *
+ * 寄存器分配：x19 = 栈帧，x21 = 局部变量表，x22 = 操作数栈，x20 = 执行上下文，
+ * w23 = 剩余指令数；A = w0，B = w1，w2/w3和x16/x17用作临时寄存器。
+ * 局部变量和栈槽位用12位无符号缩放偏移寻址（因此限制max_locals/max_stack），
+ * 条件跳转的范围是±1MB，由编译器限制单个方法的机器码长度。
+ */
+
+#if J2ME_JIT_SUPPORTED && defined(__aarch64__)
+
+#define FRAME_PC        ((uint32_t)offsetof(j2me_stack_frame_t, pc))
+#define FRAME_TOP       ((uint32_t)offsetof(j2me_stack_frame_t, operand_stack.top))
+#define FRAME_STACK     ((uint32_t)offsetof(j2me_stack_frame_t, operand_stack.data))
+#define FRAME_LOCALS    ((uint32_t)offsetof(j2me_stack_frame_t, local_vars.variables))
+#define FRAME_RETURN    ((uint32_t)offsetof(j2me_stack_frame_t, return_value))
+#define FRAME_HAS_RETURN ((uint32_t)offsetof(j2me_stack_frame_t, has_return_value))
+#define CONTEXT_BUDGET  ((uint32_t)offsetof(j2me_jit_context_t, budget))
+#define SLOT_TYPE       ((uint32_t)offsetof(j2me_value_t, type))
+#define SLOT_INT        ((uint32_t)offsetof(j2me_value_t, int_value))
+
+// 缩放偏移寻址要求字段按访问宽度对齐
+_Static_assert(offsetof(j2me_stack_frame_t, pc) % 4 == 0, "frame->pc alignment");
+_Static_assert(offsetof(j2me_stack_frame_t, operand_stack.top) % 8 == 0, "operand_stack.top alignment");
+_Static_assert(offsetof(j2me_stack_frame_t, return_value) % 4 == 0, "frame->return_value alignment");
+_Static_assert(offsetof(j2me_value_t, int_value) % 4 == 0, "j2me_value_t alignment");
+
+#define REG_FRAME       19
+#define REG_CONTEXT     20
+#define REG_LOCALS      21
+#define REG_STACK       22
+#define REG_BUDGET      23
+#define REG_TMP0        2
+#define REG_TMP1        3
+#define REG_IP0         16
+#define REG_IP1         17
+#define REG_SP          31
+#define REG_ZR          31
+
+// B.cond的条件码
+static const uint8_t g_cond_codes[] = {
+    [J2ME_JIT_COND_EQ] = 0x0,
+    [J2ME_JIT_COND_NE] = 0x1,
+    [J2ME_JIT_COND_LT] = 0xb,
+    [J2ME_JIT_COND_GE] = 0xa,
+    [J2ME_JIT_COND_GT] = 0xc,
+    [J2ME_JIT_COND_LE] = 0xd
+};
+
+static void emit_insn(j2me_jit_buffer_t* buffer, uint32_t insn) {
+    uint8_t bytes[4] = { (uint8_t)insn, (uint8_t)(insn >> 8), (uint8_t)(insn >> 16), (uint8_t)(insn >> 24) };
+    j2me_jit_buffer_emit(buffer, bytes, 4);
+}
+
+/**
+ * @brief 把32位立即数装入Wd (movz + movk)
+ */
+static void emit_mov_w(j2me_jit_buffer_t* buffer, uint32_t rd, uint32_t value) {
+    emit_insn(buffer, 0x52800000 | ((value & 0xffff) << 5) | rd);
+    if (value >> 16) {
+        emit_insn(buffer, 0x72a00000 | ((value >> 16) << 5) | rd);
+    }
+}
+
+/**
+ * @brief 把64位立即数（指针）装入Xd
+ */
+static void emit_mov_x(j2me_jit_buffer_t* buffer, uint32_t rd, uint64_t value) {
+    emit_insn(buffer, 0xd2800000 | ((uint32_t)(value & 0xffff) << 5) | rd);
+    for (uint32_t hw = 1; hw < 4; hw++) {
+        uint32_t part = (uint32_t)(value >> (hw * 16)) & 0xffff;
+        if (part) {
+            emit_insn(buffer, 0xf2800000 | (hw << 21) | (part << 5) | rd);
+        }
+    }
+}
+
+static void emit_ldr_w(j2me_jit_buffer_t* buffer, uint32_t rt, uint32_t rn, uint32_t offset) {
+    emit_insn(buffer, 0xb9400000 | ((offset / 4) << 10) | (rn << 5) | rt);
+}
+
+static void emit_str_w(j2me_jit_buffer_t* buffer, uint32_t rt, uint32_t rn, uint32_t offset) {
+    emit_insn(buffer, 0xb9000000 | ((offset / 4) << 10) | (rn << 5) | rt);
+}
+
+static void emit_ldr_x(j2me_jit_buffer_t* buffer, uint32_t rt, uint32_t rn, uint32_t offset) {
+    emit_insn(buffer, 0xf9400000 | ((offset / 8) << 10) | (rn << 5) | rt);
+}
+
+static void emit_str_x(j2me_jit_buffer_t* buffer, uint32_t rt, uint32_t rn, uint32_t offset) {
+    emit_insn(buffer, 0xf9000000 | ((offset / 8) << 10) | (rn << 5) | rt);
+}
+
+/**
+ * @brief 生成跳转指令（目标由j2me_jit_patch填写），返回跳转位置
+ */
+static size_t emit_branch_insn(j2me_jit_buffer_t* buffer, uint32_t insn) {
+    size_t patch = buffer->length;
+    emit_insn(buffer, insn);
+    return patch;
+}
+
+size_t j2me_jit_emit_prologue(j2me_jit_buffer_t* buffer) {
+    emit_insn(buffer, 0xa9800000 | (0x78 << 15) | (30 << 10) | (REG_SP << 5) | 29);    // stp x29, x30, [sp, #-64]!
+    emit_insn(buffer, 0x910003fd);                                                  // mov x29, sp
+    emit_insn(buffer, 0xa9000000 | (2 << 15) | (20 << 10) | (REG_SP << 5) | 19);       // stp x19, x20, [sp, #16]
+    emit_insn(buffer, 0xa9000000 | (4 << 15) | (22 << 10) | (REG_SP << 5) | 21);       // stp x21, x22, [sp, #32]
+    emit_str_x(buffer, 23, REG_SP, 48);                                             // str x23, [sp, #48]
+    emit_insn(buffer, 0xaa0003e0 | (0 << 16) | REG_FRAME);                          // mov x19, x0
+    emit_insn(buffer, 0xaa0003e0 | (1 << 16) | REG_CONTEXT);                        // mov x20, x1
+    emit_ldr_x(buffer, REG_LOCALS, REG_FRAME, FRAME_LOCALS);
+    emit_ldr_x(buffer, REG_STACK, REG_FRAME, FRAME_STACK);
+    emit_ldr_w(buffer, REG_BUDGET, REG_CONTEXT, CONTEXT_BUDGET);
+    emit_insn(buffer, 0xd61f0000 | (2 << 5));                                       // br x2
+
+    size_t epilogue = buffer->length;
+    emit_str_w(buffer, REG_BUDGET, REG_CONTEXT, CONTEXT_BUDGET);
+    emit_ldr_x(buffer, 23, REG_SP, 48);                                             // ldr x23, [sp, #48]
+    emit_insn(buffer, 0xa9400000 | (4 << 15) | (22 << 10) | (REG_SP << 5) | 21);       // ldp x21, x22, [sp, #32]
+    emit_insn(buffer, 0xa9400000 | (2 << 15) | (20 << 10) | (REG_SP << 5) | 19);       // ldp x19, x20, [sp, #16]
+    emit_insn(buffer, 0xa8c00000 | (8 << 15) | (30 << 10) | (REG_SP << 5) | 29);       // ldp x29, x30, [sp], #64
+    emit_insn(buffer, 0xd65f03c0);                                                  // ret
+    return epilogue;
+}
+
+void j2me_jit_emit_load_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index) {
+    emit_ldr_w(buffer, (uint32_t)reg, REG_LOCALS, index * 4);
+}
+
+void j2me_jit_emit_store_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index) {
+    emit_str_w(buffer, (uint32_t)reg, REG_LOCALS, index * 4);
+}
+
+void j2me_jit_emit_load_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot) {
+    emit_ldr_w(buffer, (uint32_t)reg, REG_STACK, slot * 4);
+}
+
+void j2me_jit_emit_store_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot) {
+    emit_str_w(buffer, (uint32_t)reg, REG_STACK, slot * 4);
+}
+
+void j2me_jit_emit_load_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_int value) {
+    emit_mov_w(buffer, (uint32_t)reg, (uint32_t)value);
+}
+
+void j2me_jit_emit_add_local(j2me_jit_buffer_t* buffer, uint32_t index, j2me_int value) {
+    emit_ldr_w(buffer, REG_TMP0, REG_LOCALS, index * 4);
+    emit_mov_w(buffer, REG_TMP1, (uint32_t)value);
+    emit_insn(buffer, 0x0b000000 | (REG_TMP1 << 16) | (REG_TMP0 << 5) | REG_TMP0);   // add w2, w2, w3
+    emit_str_w(buffer, REG_TMP0, REG_LOCALS, index * 4);
+}
+
+void j2me_jit_emit_alu(j2me_jit_buffer_t* buffer, j2me_jit_alu_t op) {
+    switch (op) {
+        case J2ME_JIT_ALU_ADD:  emit_insn(buffer, 0x0b010000); break;   // add w0, w0, w1
+        case J2ME_JIT_ALU_SUB:  emit_insn(buffer, 0x4b010000); break;   // sub w0, w0, w1
+        case J2ME_JIT_ALU_MUL:  emit_insn(buffer, 0x1b017c00); break;   // mul w0, w0, w1
+        case J2ME_JIT_ALU_DIV:  emit_insn(buffer, 0x1ac10c00); break;   // sdiv w0, w0, w1
+        case J2ME_JIT_ALU_REM:
+            emit_insn(buffer, 0x1ac10c02);                              // sdiv w2, w0, w1
+            emit_insn(buffer, 0x1b018040);                              // msub w0, w2, w1, w0
+            break;
+        case J2ME_JIT_ALU_AND:  emit_insn(buffer, 0x0a010000); break;   // and w0, w0, w1
+        case J2ME_JIT_ALU_OR:   emit_insn(buffer, 0x2a010000); break;   // orr w0, w0, w1
+        case J2ME_JIT_ALU_XOR:  emit_insn(buffer, 0x4a010000); break;   // eor w0, w0, w1
+        // 32位变长移位取移位次数的低5位，与Java语义一致
+        case J2ME_JIT_ALU_SHL:  emit_insn(buffer, 0x1ac12000); break;   // lsl w0, w0, w1
+        case J2ME_JIT_ALU_SHR:  emit_insn(buffer, 0x1ac12800); break;   // asr w0, w0, w1
+        case J2ME_JIT_ALU_USHR: emit_insn(buffer, 0x1ac12400); break;   // lsr w0, w0, w1
+    }
+}
+
+void j2me_jit_emit_neg(j2me_jit_buffer_t* buffer) {
+    emit_insn(buffer, 0x4b0003e0);                                      // neg w0, w0
+}
+
+void j2me_jit_emit_load_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot) {
+    emit_mov_x(buffer, REG_IP0, (uint64_t)(uintptr_t)slot);
+    emit_ldr_w(buffer, 0, REG_IP0, SLOT_INT);
+}
+
+void j2me_jit_emit_store_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot) {
+    emit_mov_x(buffer, REG_IP0, (uint64_t)(uintptr_t)slot);
+    emit_mov_w(buffer, REG_IP1, J2ME_TYPE_INT);
+    emit_str_w(buffer, REG_IP1, REG_IP0, SLOT_TYPE);
+    emit_str_w(buffer, 0, REG_IP0, SLOT_INT);
+}
+
+size_t j2me_jit_emit_branch(j2me_jit_buffer_t* buffer, j2me_jit_cond_t cond) {
+    emit_insn(buffer, 0x6b01001f);                                      // cmp w0, w1
+    return emit_branch_insn(buffer, 0x54000000 | g_cond_codes[cond]);
+}
+
+size_t j2me_jit_emit_branch_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_jit_cond_t cond, j2me_int value) {
+    emit_mov_w(buffer, REG_IP0, (uint32_t)value);
+    emit_insn(buffer, 0x6b000000 | (REG_IP0 << 16) | ((uint32_t)reg << 5) | REG_ZR);    // cmp wreg, w16
+    return emit_branch_insn(buffer, 0x54000000 | g_cond_codes[cond]);
+}
+
+size_t j2me_jit_emit_jump(j2me_jit_buffer_t* buffer) {
+    return emit_branch_insn(buffer, 0x14000000);
+}
+
+size_t j2me_jit_emit_branch_budget(j2me_jit_buffer_t* buffer) {
+    emit_insn(buffer, 0x7100001f | (REG_BUDGET << 5));                 // cmp w23, #0
+    return emit_branch_insn(buffer, 0x54000000 | g_cond_codes[J2ME_JIT_COND_GT]);
+}
+
+void j2me_jit_patch(j2me_jit_buffer_t* buffer, size_t patch, size_t target) {
+    if (buffer->failed) {
+        return;
+    }
+
+    uint32_t insn;
+    memcpy(&insn, buffer->data + patch, 4);
+    int32_t delta = (int32_t)(((int64_t)target - (int64_t)patch) / 4);
+    if ((insn & 0xfc000000) == 0x14000000) {
+        insn = 0x14000000 | ((uint32_t)delta & 0x03ffffff);
+    } else {
+        // B.cond和CBNZ的19位偏移
+        insn = (insn & ~(0x7ffffU << 5)) | (((uint32_t)delta & 0x7ffff) << 5);
+    }
+    memcpy(buffer->data + patch, &insn, 4);
+}
+
+void j2me_jit_emit_tick(j2me_jit_buffer_t* buffer) {
+    emit_insn(buffer, 0x51000400 | (REG_BUDGET << 5) | REG_BUDGET);    // sub w23, w23, #1
+}
+
+void j2me_jit_emit_exit(j2me_jit_buffer_t* buffer, uint32_t pc, uint32_t depth, j2me_jit_exit_t reason,
+                        size_t epilogue) {
+    emit_mov_w(buffer, REG_IP0, pc);
+    emit_str_w(buffer, REG_IP0, REG_FRAME, FRAME_PC);
+    emit_mov_w(buffer, REG_IP0, depth);                                 // 写Wd时高32位清零
+    emit_str_x(buffer, REG_IP0, REG_FRAME, FRAME_TOP);
+    emit_mov_w(buffer, 0, (uint32_t)reason);
+    j2me_jit_patch(buffer, j2me_jit_emit_jump(buffer), epilogue);
+}
+
+void j2me_jit_emit_set_return(j2me_jit_buffer_t* buffer) {
+    emit_str_w(buffer, 0, REG_FRAME, FRAME_RETURN);
+    emit_mov_w(buffer, REG_IP0, 1);
+    emit_insn(buffer, 0x39000000 | (FRAME_HAS_RETURN << 10) | (REG_FRAME << 5) | REG_IP0);    // strb w16, [x19, #has_return_value]
+}
+
+void j2me_jit_emit_call(j2me_jit_buffer_t* buffer, j2me_jit_helper_t helper, const void* arg, uint32_t depth) {
+    emit_mov_w(buffer, REG_IP0, depth);
+    emit_str_x(buffer, REG_IP0, REG_FRAME, FRAME_TOP);
+    emit_insn(buffer, 0x2a0103e4);                                      // mov w4, w1 (b)
+    emit_insn(buffer, 0x2a0003e3);                                      // mov w3, w0 (a)
+    emit_insn(buffer, 0xaa0003e0 | (REG_FRAME << 16) | 0);              // mov x0, x19 (frame)
+    emit_insn(buffer, 0xaa0003e0 | (REG_CONTEXT << 16) | 1);            // mov x1, x20 (context)
+    emit_mov_x(buffer, 2, (uint64_t)(uintptr_t)arg);
+    emit_mov_x(buffer, REG_IP0, (uint64_t)(uintptr_t)helper);
+    emit_insn(buffer, 0xd63f0000 | (REG_IP0 << 5));                     // blr x16
+}
+
+void j2me_jit_emit_exit_if_nonzero(j2me_jit_buffer_t* buffer, size_t epilogue) {
+    j2me_jit_patch(buffer, emit_branch_insn(buffer, 0x35000000), epilogue);    // cbnz w0
+}
+
+#endif // J2ME_JIT_SUPPORTED && defined(__aarch64__)
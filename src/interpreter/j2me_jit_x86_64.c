@@ -0,0 +1,256 @@
+#include "j2me_jit_backend.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @file j2me_jit_x86_64.c
+ * @brief 模板JIT的x86-64机器码生成 (System V调用约定)
+ *
+ * 寄存器分配：rbx = 栈帧，r12 = 局部变量表，r15 = 操作数栈，r13 = 执行上下文，
+ * r14d = 剩余指令数；A = eax，B = ecx，edx和r8用作临时寄存器。
+ * 局部变量和栈槽位一律用32位位移寻址，跳转一律用32位相对偏移，省去长度选择。
+ */
+
+#if J2ME_JIT_SUPPORTED && defined(__x86_64__)
+
+#define FRAME_PC        ((uint32_t)offsetof(j2me_stack_frame_t, pc))
+#define FRAME_TOP       ((uint32_t)offsetof(j2me_stack_frame_t, operand_stack.top))
+#define FRAME_STACK     ((uint32_t)offsetof(j2me_stack_frame_t, operand_stack.data))
+#define FRAME_LOCALS    ((uint32_t)offsetof(j2me_stack_frame_t, local_vars.variables))
+#define FRAME_RETURN    ((uint32_t)offsetof(j2me_stack_frame_t, return_value))
+#define FRAME_HAS_RETURN ((uint32_t)offsetof(j2me_stack_frame_t, has_return_value))
+#define CONTEXT_BUDGET  ((uint32_t)offsetof(j2me_jit_context_t, budget))
+#define SLOT_TYPE       ((uint32_t)offsetof(j2me_value_t, type))
+#define SLOT_INT        ((uint32_t)offsetof(j2me_value_t, int_value))
+
+// A、B对应的寄存器编号 (eax, ecx)
+static const uint8_t g_reg_codes[] = { 0, 1 };
+
+// 条件跳转 (0F 8x) 的条件码
+static const uint8_t g_cond_codes[] = {
+    [J2ME_JIT_COND_EQ] = 0x84,
+    [J2ME_JIT_COND_NE] = 0x85,
+    [J2ME_JIT_COND_LT] = 0x8c,
+    [J2ME_JIT_COND_GE] = 0x8d,
+    [J2ME_JIT_COND_GT] = 0x8f,
+    [J2ME_JIT_COND_LE] = 0x8e
+};
+
+static void emit_u8(j2me_jit_buffer_t* buffer, uint8_t value) {
+    j2me_jit_buffer_emit(buffer, &value, 1);
+}
+
+static void emit_u32(j2me_jit_buffer_t* buffer, uint32_t value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    j2me_jit_buffer_emit(buffer, bytes, 4);
+}
+
+static void emit_u64(j2me_jit_buffer_t* buffer, uint64_t value) {
+    emit_u32(buffer, (uint32_t)value);
+    emit_u32(buffer, (uint32_t)(value >> 32));
+}
+
+#define EMIT(...) do { \
+        static const uint8_t bytes_[] = { __VA_ARGS__ }; \
+        j2me_jit_buffer_emit(buffer, bytes_, sizeof(bytes_)); \
+    } while (0)
+
+/**
+ * @brief 生成32位相对跳转的占位偏移，返回跳转位置
+ */
+static size_t emit_rel32(j2me_jit_buffer_t* buffer) {
+    size_t patch = buffer->length;
+    emit_u32(buffer, 0);
+    return patch;
+}
+
+size_t j2me_jit_emit_prologue(j2me_jit_buffer_t* buffer) {
+    // push rbp/rbx/r12~r15; sub rsp, 8（调用运行时函数时栈按16字节对齐）
+    EMIT(0x55, 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57, 0x48, 0x83, 0xec, 0x08);
+    EMIT(0x48, 0x89, 0xfb);                     // mov rbx, rdi
+    EMIT(0x49, 0x89, 0xf5);                     // mov r13, rsi
+    EMIT(0x4c, 0x8b, 0xa3);                     // mov r12, [rbx + locals]
+    emit_u32(buffer, FRAME_LOCALS);
+    EMIT(0x4c, 0x8b, 0xbb);                     // mov r15, [rbx + stack]
+    emit_u32(buffer, FRAME_STACK);
+    EMIT(0x45, 0x8b, 0xb5);                     // mov r14d, [r13 + budget]
+    emit_u32(buffer, CONTEXT_BUDGET);
+    EMIT(0xff, 0xe2);                           // jmp rdx
+
+    size_t epilogue = buffer->length;
+    EMIT(0x45, 0x89, 0xb5);                     // mov [r13 + budget], r14d
+    emit_u32(buffer, CONTEXT_BUDGET);
+    // add rsp, 8; pop r15~r12/rbx/rbp; ret
+    EMIT(0x48, 0x83, 0xc4, 0x08, 0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b, 0x5d, 0xc3);
+    return epilogue;
+}
+
+void j2me_jit_emit_load_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index) {
+    // mov reg, [r12 + index*4]
+    emit_u8(buffer, 0x41);
+    emit_u8(buffer, 0x8b);
+    emit_u8(buffer, 0x84 | (g_reg_codes[reg] << 3));
+    emit_u8(buffer, 0x24);
+    emit_u32(buffer, index * 4);
+}
+
+void j2me_jit_emit_store_local(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t index) {
+    // mov [r12 + index*4], reg
+    emit_u8(buffer, 0x41);
+    emit_u8(buffer, 0x89);
+    emit_u8(buffer, 0x84 | (g_reg_codes[reg] << 3));
+    emit_u8(buffer, 0x24);
+    emit_u32(buffer, index * 4);
+}
+
+void j2me_jit_emit_load_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot) {
+    // mov reg, [r15 + slot*4]
+    emit_u8(buffer, 0x41);
+    emit_u8(buffer, 0x8b);
+    emit_u8(buffer, 0x87 | (g_reg_codes[reg] << 3));
+    emit_u32(buffer, slot * 4);
+}
+
+void j2me_jit_emit_store_stack(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, uint32_t slot) {
+    // mov [r15 + slot*4], reg
+    emit_u8(buffer, 0x41);
+    emit_u8(buffer, 0x89);
+    emit_u8(buffer, 0x87 | (g_reg_codes[reg] << 3));
+    emit_u32(buffer, slot * 4);
+}
+
+void j2me_jit_emit_load_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_int value) {
+    // mov reg, imm32
+    emit_u8(buffer, 0xb8 + g_reg_codes[reg]);
+    emit_u32(buffer, (uint32_t)value);
+}
+
+void j2me_jit_emit_add_local(j2me_jit_buffer_t* buffer, uint32_t index, j2me_int value) {
+    // add dword [r12 + index*4], imm32
+    EMIT(0x41, 0x81, 0x84, 0x24);
+    emit_u32(buffer, index * 4);
+    emit_u32(buffer, (uint32_t)value);
+}
+
+void j2me_jit_emit_alu(j2me_jit_buffer_t* buffer, j2me_jit_alu_t op) {
+    switch (op) {
+        case J2ME_JIT_ALU_ADD:  EMIT(0x01, 0xc8); break;             // add eax, ecx
+        case J2ME_JIT_ALU_SUB:  EMIT(0x29, 0xc8); break;             // sub eax, ecx
+        case J2ME_JIT_ALU_MUL:  EMIT(0x0f, 0xaf, 0xc1); break;       // imul eax, ecx
+        case J2ME_JIT_ALU_DIV:  EMIT(0x99, 0xf7, 0xf9); break;       // cdq; idiv ecx
+        case J2ME_JIT_ALU_REM:  EMIT(0x99, 0xf7, 0xf9, 0x89, 0xd0); break; // cdq; idiv ecx; mov eax, edx
+        case J2ME_JIT_ALU_AND:  EMIT(0x21, 0xc8); break;             // and eax, ecx
+        case J2ME_JIT_ALU_OR:   EMIT(0x09, 0xc8); break;             // or eax, ecx
+        case J2ME_JIT_ALU_XOR:  EMIT(0x31, 0xc8); break;             // xor eax, ecx
+        // 移位次数取cl的低5位，与Java语义一致
+        case J2ME_JIT_ALU_SHL:  EMIT(0xd3, 0xe0); break;             // shl eax, cl
+        case J2ME_JIT_ALU_SHR:  EMIT(0xd3, 0xf8); break;             // sar eax, cl
+        case J2ME_JIT_ALU_USHR: EMIT(0xd3, 0xe8); break;             // shr eax, cl
+    }
+}
+
+void j2me_jit_emit_neg(j2me_jit_buffer_t* buffer) {
+    EMIT(0xf7, 0xd8);                           // neg eax
+}
+
+void j2me_jit_emit_load_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot) {
+    EMIT(0x48, 0xba);                           // mov rdx, slot
+    emit_u64(buffer, (uint64_t)(uintptr_t)slot);
+    EMIT(0x8b, 0x82);                           // mov eax, [rdx + int_value]
+    emit_u32(buffer, SLOT_INT);
+}
+
+void j2me_jit_emit_store_static(j2me_jit_buffer_t* buffer, j2me_value_t* slot) {
+    EMIT(0x48, 0xba);                           // mov rdx, slot
+    emit_u64(buffer, (uint64_t)(uintptr_t)slot);
+    EMIT(0xc7, 0x82);                           // mov dword [rdx + type], J2ME_TYPE_INT
+    emit_u32(buffer, SLOT_TYPE);
+    emit_u32(buffer, J2ME_TYPE_INT);
+    EMIT(0x89, 0x82);                           // mov [rdx + int_value], eax
+    emit_u32(buffer, SLOT_INT);
+}
+
+size_t j2me_jit_emit_branch(j2me_jit_buffer_t* buffer, j2me_jit_cond_t cond) {
+    EMIT(0x39, 0xc8);                           // cmp eax, ecx
+    emit_u8(buffer, 0x0f);
+    emit_u8(buffer, g_cond_codes[cond]);
+    return emit_rel32(buffer);
+}
+
+size_t j2me_jit_emit_branch_imm(j2me_jit_buffer_t* buffer, j2me_jit_reg_t reg, j2me_jit_cond_t cond, j2me_int value) {
+    // cmp reg, imm32
+    emit_u8(buffer, 0x81);
+    emit_u8(buffer, 0xf8 | g_reg_codes[reg]);
+    emit_u32(buffer, (uint32_t)value);
+    emit_u8(buffer, 0x0f);
+    emit_u8(buffer, g_cond_codes[cond]);
+    return emit_rel32(buffer);
+}
+
+size_t j2me_jit_emit_jump(j2me_jit_buffer_t* buffer) {
+    emit_u8(buffer, 0xe9);
+    return emit_rel32(buffer);
+}
+
+size_t j2me_jit_emit_branch_budget(j2me_jit_buffer_t* buffer) {
+    EMIT(0x45, 0x85, 0xf6, 0x0f, 0x8f);         // test r14d, r14d; jg
+    return emit_rel32(buffer);
+}
+
+void j2me_jit_patch(j2me_jit_buffer_t* buffer, size_t patch, size_t target) {
+    if (buffer->failed) {
+        return;
+    }
+
+    int32_t offset = (int32_t)((int64_t)target - (int64_t)(patch + 4));
+    memcpy(buffer->data + patch, &offset, 4);
+}
+
+void j2me_jit_emit_tick(j2me_jit_buffer_t* buffer) {
+    EMIT(0x41, 0x83, 0xee, 0x01);               // sub r14d, 1
+}
+
+void j2me_jit_emit_exit(j2me_jit_buffer_t* buffer, uint32_t pc, uint32_t depth, j2me_jit_exit_t reason,
+                        size_t epilogue) {
+    EMIT(0xc7, 0x83);                           // mov dword [rbx + pc], imm32
+    emit_u32(buffer, FRAME_PC);
+    emit_u32(buffer, pc);
+    EMIT(0x48, 0xc7, 0x83);                     // mov qword [rbx + top], imm32
+    emit_u32(buffer, FRAME_TOP);
+    emit_u32(buffer, depth);
+    emit_u8(buffer, 0xb8);                      // mov eax, reason
+    emit_u32(buffer, (uint32_t)reason);
+    j2me_jit_patch(buffer, j2me_jit_emit_jump(buffer), epilogue);
+}
+
+void j2me_jit_emit_set_return(j2me_jit_buffer_t* buffer) {
+    EMIT(0x89, 0x83);                           // mov [rbx + return_value], eax
+    emit_u32(buffer, FRAME_RETURN);
+    EMIT(0xc6, 0x83);                           // mov byte [rbx + has_return_value], 1
+    emit_u32(buffer, FRAME_HAS_RETURN);
+    emit_u8(buffer, 1);
+}
+
+void j2me_jit_emit_call(j2me_jit_buffer_t* buffer, j2me_jit_helper_t helper, const void* arg, uint32_t depth) {
+    EMIT(0x48, 0xc7, 0x83);                     // mov qword [rbx + top], depth
+    emit_u32(buffer, FRAME_TOP);
+    emit_u32(buffer, depth);
+    EMIT(0x41, 0x89, 0xc8);                     // mov r8d, ecx (b)
+    EMIT(0x89, 0xc1);                           // mov ecx, eax (a)
+    EMIT(0x48, 0x89, 0xdf);                     // mov rdi, rbx (frame)
+    EMIT(0x4c, 0x89, 0xee);                     // mov rsi, r13 (context)
+    EMIT(0x48, 0xba);                           // mov rdx, arg
+    emit_u64(buffer, (uint64_t)(uintptr_t)arg);
+    EMIT(0x48, 0xb8);                           // mov rax, helper
+    emit_u64(buffer, (uint64_t)(uintptr_t)helper);
+    EMIT(0xff, 0xd0);                           // call rax
+}
+
+void j2me_jit_emit_exit_if_nonzero(j2me_jit_buffer_t* buffer, size_t epilogue) {
+    EMIT(0x85, 0xc0, 0x0f, 0x85);               // test eax, eax; jnz
+    j2me_jit_patch(buffer, emit_rel32(buffer), epilogue);
+}
+
+#undef EMIT
+
+#endif // J2ME_JIT_SUPPORTED && defined(__x86_64__)
@@ -0,0 +1,293 @@
+#include "j2me_opcode_profiler.h"
+#include "j2me_interpreter_optimized.h"
+#include "j2me_bytecode.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * @file j2me_opcode_profiler.c
+ * @brief 指令序列分析器实现
+ *
+ * 每条指令执行前记录一次：最近执行的指令放在一个32位移位寄存器里，与当前指令连成
+ * 长度2~4的序列后按(指令, 长度)计数。当前指令与上一条指令不在同一栈帧、或不是上一条
+ * 指令顺序执行的下一条时，序列从当前指令重新开始。
+ */
+
+#define OPCODE_PROFILER_MIN_CAPACITY    1024    // 哈希表初始槽位数
+#define OPCODE_REPORT_TEXT_NGRAMS       30      // 文本报告每种长度列出的序列数
+
+static uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static j2me_opcode_ngram_t* find_ngram_slot(j2me_opcode_ngram_t* table, size_t capacity,
+                                            uint32_t opcodes, uint8_t length) {
+    size_t mask = capacity - 1;
+    size_t i = hash_u32(opcodes ^ (length * 0x9e3779b9U)) & mask;
+    while (table[i].length && (table[i].opcodes != opcodes || table[i].length != length)) {
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+/**
+ * @brief 装载率超过3/4时把序列表扩大一倍
+ */
+static bool grow_ngrams(j2me_opcode_profiler_t* profiler) {
+    if ((profiler->ngram_count + 1) * 4 <= profiler->ngram_capacity * 3) {
+        return true;
+    }
+    
+    size_t capacity = profiler->ngram_capacity * 2;
+    j2me_opcode_ngram_t* table = (j2me_opcode_ngram_t*)calloc(capacity, sizeof(j2me_opcode_ngram_t));
+    if (!table) {
+        return false;
+    }
+    for (size_t i = 0; i < profiler->ngram_capacity; i++) {
+        j2me_opcode_ngram_t* ngram = &profiler->ngrams[i];
+        if (ngram->length) {
+            *find_ngram_slot(table, capacity, ngram->opcodes, ngram->length) = *ngram;
+        }
+    }
+    free(profiler->ngrams);
+    profiler->ngrams = table;
+    profiler->ngram_capacity = capacity;
+    return true;
+}
+
+static void count_ngram(j2me_opcode_profiler_t* profiler, uint32_t opcodes, uint8_t length) {
+    j2me_opcode_ngram_t* ngram = find_ngram_slot(profiler->ngrams, profiler->ngram_capacity, opcodes, length);
+    if (!ngram->length) {
+        if (!grow_ngrams(profiler)) {
+            return;
+        }
+        ngram = find_ngram_slot(profiler->ngrams, profiler->ngram_capacity, opcodes, length);
+        ngram->opcodes = opcodes;
+        ngram->length = length;
+        profiler->ngram_count++;
+    }
+    ngram->count++;
+}
+
+j2me_opcode_profiler_t* j2me_opcode_profiler_create(const char* report_path) {
+    if (!report_path) {
+        return NULL;
+    }
+    
+    j2me_opcode_profiler_t* profiler = (j2me_opcode_profiler_t*)calloc(1, sizeof(j2me_opcode_profiler_t));
+    if (!profiler) {
+        return NULL;
+    }
+    
+    profiler->report_path = strdup(report_path);
+    profiler->ngram_capacity = OPCODE_PROFILER_MIN_CAPACITY;
+    profiler->ngrams = (j2me_opcode_ngram_t*)calloc(profiler->ngram_capacity, sizeof(j2me_opcode_ngram_t));
+    if (!profiler->report_path || !profiler->ngrams) {
+        free(profiler->report_path);
+        free(profiler->ngrams);
+        free(profiler);
+        return NULL;
+    }
+    
+    size_t path_length = strlen(report_path);
+    profiler->format = (path_length >= 5 && strcmp(report_path + path_length - 5, ".json") == 0)
+                       ? J2ME_OPCODE_REPORT_JSON : J2ME_OPCODE_REPORT_TEXT;
+    
+    // 指令长度按指令码预先查好，记录时不再查指令表
+    for (int opcode = 0; opcode < 256; opcode++) {
+        const j2me_instruction_info_t* info = j2me_get_instruction_info((j2me_opcode_t)opcode);
+        profiler->lengths[opcode] = info ? (uint8_t)(info->operand_count + 1) : 1;
+    }
+    profiler->lengths[OPCODE_TABLESWITCH] = 0;
+    profiler->lengths[OPCODE_LOOKUPSWITCH] = 0;
+    profiler->lengths[OPCODE_WIDE] = 0;
+    
+    LOG_INFO("[指令序列分析] 已启用，报告: %s", profiler->report_path);
+    return profiler;
+}
+
+void j2me_opcode_profiler_destroy(j2me_opcode_profiler_t* profiler) {
+    if (!profiler) {
+        return;
+    }
+    
+    j2me_opcode_profiler_write_report(profiler);
+    
+    free(profiler->report_path);
+    free(profiler->ngrams);
+    free(profiler);
+}
+
+void j2me_opcode_profiler_record(j2me_opcode_profiler_t* profiler, const j2me_stack_frame_t* frame,
+                                 uint32_t pc, j2me_opcode_t opcode) {
+    if (frame != profiler->last_frame || pc != profiler->next_pc) {
+        profiler->history_length = 0;
+    }
+    
+    profiler->history = (profiler->history << 8) | j2me_opcode_family(opcode);
+    profiler->total_instructions++;
+    
+    for (uint32_t length = J2ME_OPCODE_PROFILER_MIN_NGRAM;
+         length <= profiler->history_length + 1 && length <= J2ME_OPCODE_PROFILER_MAX_NGRAM; length++) {
+        uint32_t opcodes = length == 4 ? profiler->history : profiler->history & ((1U << (8 * length)) - 1);
+        count_ngram(profiler, opcodes << (8 * (4 - length)), (uint8_t)length);
+    }
+    
+    profiler->last_frame = frame;
+    if (profiler->lengths[opcode]) {
+        profiler->next_pc = pc + profiler->lengths[opcode];
+        if (profiler->history_length < J2ME_OPCODE_PROFILER_MAX_NGRAM - 1) {
+            profiler->history_length++;
+        }
+    } else {
+        // 变长指令之后的序列重新开始
+        profiler->history_length = 0;
+    }
+}
+
+/**
+ * @brief 取序列中的指令
+ */
+static void ngram_opcodes(const j2me_opcode_ngram_t* ngram, j2me_opcode_t* opcodes) {
+    for (int i = 0; i < ngram->length; i++) {
+        opcodes[i] = (j2me_opcode_t)(ngram->opcodes >> (24 - 8 * i));
+    }
+}
+
+static void format_sequence(const j2me_opcode_ngram_t* ngram, char* buffer, size_t size) {
+    j2me_opcode_t opcodes[J2ME_OPCODE_PROFILER_MAX_NGRAM];
+    ngram_opcodes(ngram, opcodes);
+    
+    size_t used = 0;
+    buffer[0] = '\0';
+    for (int i = 0; i < ngram->length && used < size; i++) {
+        int written = snprintf(buffer + used, size - used, "%s%s", i ? "; " : "", j2me_get_instruction_name(opcodes[i]));
+        if (written < 0) {
+            break;
+        }
+        used += (size_t)written;
+    }
+}
+
+static const char* ngram_superinstruction(const j2me_opcode_ngram_t* ngram) {
+    j2me_opcode_t opcodes[J2ME_OPCODE_PROFILER_MAX_NGRAM];
+    ngram_opcodes(ngram, opcodes);
+    return j2me_superinstruction_for_sequence(opcodes, ngram->length);
+}
+
+/**
+ * @brief 按长度升序、执行次数降序排列
+ */
+static int compare_ngrams(const void* a, const void* b) {
+    const j2me_opcode_ngram_t* x = *(const j2me_opcode_ngram_t* const*)a;
+    const j2me_opcode_ngram_t* y = *(const j2me_opcode_ngram_t* const*)b;
+    if (x->length != y->length) {
+        return x->length < y->length ? -1 : 1;
+    }
+    return x->count < y->count ? 1 : (x->count > y->count ? -1 : 0);
+}
+
+static void write_text_report(j2me_opcode_profiler_t* profiler, FILE* file, j2me_opcode_ngram_t** ngrams) {
+    char sequence[128];
+    
+    fprintf(file, "=== 指令序列分析报告 ===\n");
+    fprintf(file, "执行指令数: %llu\n", (unsigned long long)profiler->total_instructions);
+    fprintf(file, "序列种类数: %zu\n", profiler->ngram_count);
+    
+    size_t i = 0;
+    for (int length = J2ME_OPCODE_PROFILER_MIN_NGRAM; length <= J2ME_OPCODE_PROFILER_MAX_NGRAM; length++) {
+        size_t first = i;
+        while (i < profiler->ngram_count && ngrams[i]->length == length) {
+            i++;
+        }
+        size_t limit = i - first < OPCODE_REPORT_TEXT_NGRAMS ? i - first : OPCODE_REPORT_TEXT_NGRAMS;
+    
+        fprintf(file, "\n%d条指令的序列（按执行次数排序，前%zu/%zu个，占比 = 序列覆盖的指令数 / 执行指令数）:\n",
+                length, limit, i - first);
+        fprintf(file, "%14s %7s  %-22s %s\n", "次数", "占比", "超级指令", "序列");
+        for (size_t j = first; j < first + limit; j++) {
+            j2me_opcode_ngram_t* ngram = ngrams[j];
+            const char* super = ngram_superinstruction(ngram);
+            double percent = profiler->total_instructions ?
+                             (double)ngram->count * length * 100.0 / (double)profiler->total_instructions : 0.0;
+            format_sequence(ngram, sequence, sizeof(sequence));
+            fprintf(file, "%14llu %6.1f%%  %-22s %s\n",
+                    (unsigned long long)ngram->count, percent, super ? super : "-", sequence);
+        }
+    }
+}
+
+static void write_json_report(j2me_opcode_profiler_t* profiler, FILE* file, j2me_opcode_ngram_t** ngrams) {
+    fprintf(file, "{\n  \"total_instructions\": %llu,\n", (unsigned long long)profiler->total_instructions);
+    fprintf(file, "  \"sequences\": [");
+    for (size_t i = 0; i < profiler->ngram_count; i++) {
+        j2me_opcode_ngram_t* ngram = ngrams[i];
+        j2me_opcode_t opcodes[J2ME_OPCODE_PROFILER_MAX_NGRAM];
+        ngram_opcodes(ngram, opcodes);
+    
+        fprintf(file, "%s\n    {\"opcodes\": [", i ? "," : "");
+        for (int j = 0; j < ngram->length; j++) {
+            fprintf(file, "%s\"%s\"", j ? ", " : "", j2me_get_instruction_name(opcodes[j]));
+        }
+        const char* super = ngram_superinstruction(ngram);
+        fprintf(file, "], \"count\": %llu, \"superinstruction\": ", (unsigned long long)ngram->count);
+        if (super) {
+            fprintf(file, "\"%s\"}", super);
+        } else {
+            fprintf(file, "null}");
+        }
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+j2me_error_t j2me_opcode_profiler_write_report(j2me_opcode_profiler_t* profiler) {
+    if (!profiler) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    // 排序用的指针数组（多分配一个元素，避免计数为0时calloc返回NULL）
+    j2me_opcode_ngram_t** ngrams = (j2me_opcode_ngram_t**)calloc(profiler->ngram_count + 1, sizeof(*ngrams));
+    if (!ngrams) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    size_t n = 0;
+    for (size_t i = 0; i < profiler->ngram_capacity; i++) {
+        if (profiler->ngrams[i].length) {
+            ngrams[n++] = &profiler->ngrams[i];
+        }
+    }
+    qsort(ngrams, n, sizeof(*ngrams), compare_ngrams);
+    
+    j2me_error_t result = J2ME_SUCCESS;
+    FILE* file = fopen(profiler->report_path, "w");
+    if (file) {
+        if (profiler->format == J2ME_OPCODE_REPORT_JSON) {
+            write_json_report(profiler, file, ngrams);
+        } else {
+            write_text_report(profiler, file, ngrams);
+        }
+        if (fclose(file) != 0) {
+            result = J2ME_ERROR_IO_EXCEPTION;
+        }
+    } else {
+        result = J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    free(ngrams);
+    
+    if (result == J2ME_SUCCESS) {
+        LOG_INFO("[指令序列分析] 报告已写入: %s (%llu条指令, %zu种序列)",
+                 profiler->report_path, (unsigned long long)profiler->total_instructions, profiler->ngram_count);
+    } else {
+        LOG_ERROR("[指令序列分析] 无法写入报告: %s", profiler->report_path);
+    }
+    return result;
+}
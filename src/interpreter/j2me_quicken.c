@@ -0,0 +1,281 @@
+/**
+ * @file j2me_quicken.c
+ * @brief 字节码快速化实现
+ *
+ * 解析结果按常量池索引保存在类的quick_entries表中，同一常量池条目被多条指令
+ * 引用时只解析一次。解析失败的指令保持原样，继续走通用路径。
+ */
+
+#include "j2me_quicken.h"
+#include "j2me_vm.h"
+#include "j2me_constant_pool.h"
+#include "j2me_field_access.h"
+#include "j2me_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 获取类的快速指令解析表，不存在时创建
+ */
+static j2me_quick_entry_t* get_quick_entries(j2me_class_t* class_info) {
+    if (!class_info->quick_entries && class_info->constant_pool.count > 0) {
+        class_info->quick_entries = calloc(class_info->constant_pool.count, sizeof(j2me_quick_entry_t));
+    }
+    return (j2me_quick_entry_t*)class_info->quick_entries;
+}
+
+/**
+ * @brief 原始指令对应的快速指令，不支持快速化返回0
+ */
+static j2me_opcode_t quick_opcode_for(j2me_opcode_t opcode) {
+    switch (opcode) {
+        case OPCODE_LDC:             return OPCODE_LDC_QUICK;
+        case OPCODE_LDC_W:           return OPCODE_LDC_W_QUICK;
+        case OPCODE_GETSTATIC:       return OPCODE_GETSTATIC_QUICK;
+        case OPCODE_PUTSTATIC:       return OPCODE_PUTSTATIC_QUICK;
+        case OPCODE_GETFIELD:        return OPCODE_GETFIELD_QUICK;
+        case OPCODE_PUTFIELD:        return OPCODE_PUTFIELD_QUICK;
+        case OPCODE_INVOKEVIRTUAL:   return OPCODE_INVOKEVIRTUAL_QUICK;
+        case OPCODE_INVOKESPECIAL:   return OPCODE_INVOKESPECIAL_QUICK;
+        case OPCODE_INVOKESTATIC:    return OPCODE_INVOKESTATIC_QUICK;
+        case OPCODE_INVOKEINTERFACE: return OPCODE_INVOKEINTERFACE_QUICK;
+        default:                     return 0;
+    }
+}
+
+/**
+ * @brief 原始指令需要的解析结果类型
+ */
+static j2me_quick_kind_t quick_kind_for(j2me_opcode_t opcode) {
+    switch (opcode) {
+        case OPCODE_LDC:
+        case OPCODE_LDC_W:
+            return J2ME_QUICK_CONSTANT;
+        case OPCODE_GETSTATIC:
+        case OPCODE_PUTSTATIC:
+            return J2ME_QUICK_STATIC_FIELD;
+        case OPCODE_GETFIELD:
+        case OPCODE_PUTFIELD:
+            return J2ME_QUICK_INSTANCE_FIELD;
+        default:
+            return J2ME_QUICK_CALL;
+    }
+}
+
+/**
+ * @brief 解析ldc常量
+ */
+static j2me_error_t resolve_constant(j2me_vm_t* vm, j2me_class_t* owner, uint16_t index,
+                                     j2me_quick_entry_t* entry) {
+    j2me_constant_value_t constant_value;
+    j2me_error_t result = j2me_resolve_constant_pool_entry(vm, owner, index, &constant_value);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+
+    switch (constant_value.type) {
+        case J2ME_CONSTANT_INTEGER:
+            entry->u.constant = constant_value.data.int_value;
+            break;
+
+        case J2ME_CONSTANT_FLOAT:
+            // 与ldc一致，按位压入float
+            memcpy(&entry->u.constant, &constant_value.data.float_value, sizeof(j2me_int));
+            break;
+
+        case J2ME_CONSTANT_STRING: {
+            // 字符串对象由常量池缓存持有，整个类生命周期内复用同一个对象；
+            // 没能放进缓存时没有人持有它，不快速化，每次按普通ldc解析
+            j2me_ref_t string_ref = (j2me_ref_t)(intptr_t)constant_value.data.object_ref;
+            if (string_ref == J2ME_NULL_REF) {
+                return J2ME_ERROR_INVALID_PARAMETER;
+            }
+            const j2me_constant_value_t* cached = j2me_constant_pool_lookup(owner, index);
+            if (!cached || cached->type != J2ME_CONSTANT_STRING ||
+                (j2me_ref_t)(intptr_t)cached->data.object_ref != string_ref) {
+                return J2ME_ERROR_OUT_OF_MEMORY;
+            }
+            entry->u.constant = (j2me_int)string_ref;
+            break;
+        }
+
+        case J2ME_CONSTANT_CLASS:
+            entry->u.constant = (j2me_int)(intptr_t)constant_value.data.class_ref;
+            break;
+
+        default:
+            return J2ME_ERROR_INVALID_CONSTANT_TYPE;
+    }
+
+    entry->kind = J2ME_QUICK_CONSTANT;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 加载并初始化字段引用所在的类（与getstatic/putstatic的通用路径一致）
+ * @return 类已初始化返回true
+ */
+static bool initialize_field_class(j2me_vm_t* vm, j2me_class_t* owner, uint16_t index) {
+    j2me_constant_pool_t* pool = &owner->constant_pool;
+    j2me_constant_pool_entry_t* field_ref = &pool->entries[index - 1];
+    if (field_ref->tag != J2ME_CONSTANT_FIELDREF) {
+        return false;
+    }
+
+    uint16_t class_index = field_ref->info.ref_info.class_index;
+    if (class_index == 0 || class_index >= pool->count ||
+        pool->entries[class_index - 1].tag != J2ME_CONSTANT_CLASS) {
+        return false;
+    }
+
+    uint16_t name_index = pool->entries[class_index - 1].info.class_info.name_index;
+    if (name_index == 0 || name_index >= pool->count ||
+        pool->entries[name_index - 1].tag != J2ME_CONSTANT_UTF8) {
+        return false;
+    }
+
+    const char* class_name = pool->entries[name_index - 1].info.utf8.bytes;
+    j2me_class_t* target_class = j2me_class_loader_find_class(vm->class_loader, class_name);
+    if (!target_class) {
+        target_class = j2me_class_loader_load_class(vm->class_loader, class_name);
+    }
+    if (!target_class) {
+        return false;
+    }
+
+    if (target_class->state != CLASS_INITIALIZED) {
+        j2me_error_t init_result = j2me_class_initialize(target_class);
+        if (init_result != J2ME_SUCCESS) {
+            LOG_DEBUG("[快速化] 类初始化失败: %s (%d)\n", class_name, init_result);
+            return false;
+        }
+    }
+
+    return target_class->state == CLASS_INITIALIZED;
+}
+
+/**
+ * @brief 解析常量池条目，结果写入entry
+ */
+static j2me_error_t resolve_entry(j2me_vm_t* vm, j2me_class_t* owner, j2me_opcode_t opcode,
+                                  uint16_t index, uint8_t count, j2me_quick_entry_t* entry) {
+    j2me_error_t result;
+
+    switch (quick_kind_for(opcode)) {
+        case J2ME_QUICK_CONSTANT:
+            result = resolve_constant(vm, owner, index, entry);
+            break;
+
+        case J2ME_QUICK_STATIC_FIELD:
+            if (!initialize_field_class(vm, owner, index)) {
+                return J2ME_ERROR_CLASS_NOT_FOUND;
+            }
+            result = j2me_resolve_static_field_slot(vm, owner, index, &entry->u.static_slot);
+            if (result == J2ME_SUCCESS) {
+                entry->kind = J2ME_QUICK_STATIC_FIELD;
+            }
+            break;
+
+        case J2ME_QUICK_INSTANCE_FIELD:
+            result = j2me_resolve_instance_field(vm, owner, index, &entry->u.field);
+            if (result == J2ME_SUCCESS) {
+                entry->kind = J2ME_QUICK_INSTANCE_FIELD;
+            }
+            break;
+
+        default:
+            result = j2me_method_invocation_resolve_call(vm, owner, opcode, index, count, &entry->u.call);
+            if (result != J2ME_SUCCESS) {
+                break;
+            }
+            // 目标类以后可能被加载，未解析的调用不缓存
+            if (entry->u.call.kind == J2ME_CALL_UNRESOLVED) {
+                return J2ME_ERROR_METHOD_NOT_FOUND;
+            }
+            entry->kind = J2ME_QUICK_CALL;
+            break;
+    }
+
+    if (result == J2ME_SUCCESS) {
+        entry->opcode = opcode;
+    }
+    return result;
+}
+
+j2me_error_t j2me_quicken_instruction(j2me_vm_t* vm, j2me_stack_frame_t* frame, uint32_t pc) {
+    if (!vm || !frame || !frame->bytecode) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    // 只改写属于方法本身的字节码
+    j2me_method_t* method = (j2me_method_t*)frame->method_info;
+    if (!method || !method->owner_class || frame->bytecode != method->bytecode) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t* code = frame->bytecode;
+    j2me_opcode_t opcode = code[pc];
+    j2me_opcode_t quick_opcode = quick_opcode_for(opcode);
+    if (!quick_opcode) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    j2me_class_t* owner = method->owner_class;
+    uint16_t index = opcode == OPCODE_LDC ? code[pc + 1] : (uint16_t)((code[pc + 1] << 8) | code[pc + 2]);
+    if (index == 0 || index >= owner->constant_pool.count) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    j2me_quick_entry_t* entries = get_quick_entries(owner);
+    if (!entries) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+
+    j2me_quick_entry_t* entry = &entries[index];
+    j2me_quick_kind_t kind = quick_kind_for(opcode);
+    if (entry->kind == J2ME_QUICK_NONE) {
+        uint8_t count = opcode == OPCODE_INVOKEINTERFACE ? code[pc + 3] : 0;
+        j2me_error_t result = resolve_entry(vm, owner, opcode, index, count, entry);
+        if (result != J2ME_SUCCESS) {
+            memset(entry, 0, sizeof(j2me_quick_entry_t));
+            return result;
+        }
+    } else if (entry->kind != kind || (kind == J2ME_QUICK_CALL && entry->opcode != opcode)) {
+        // 同一方法引用被不同调用指令使用时（如invokevirtual和invokespecial），只快速化先解析的一种
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+
+    code[pc] = quick_opcode;
+    LOG_DEBUG("[快速化] pc=%u: %s -> %s (#%d)\n", pc,
+              j2me_get_instruction_name(opcode), j2me_get_instruction_name(quick_opcode), index);
+    return J2ME_SUCCESS;
+}
+
+const j2me_resolved_call_t* j2me_quicken_find_call(j2me_class_t* owner, j2me_opcode_t opcode, uint16_t index) {
+    if (!owner || !owner->quick_entries || index >= owner->constant_pool.count) {
+        return NULL;
+    }
+
+    j2me_quick_entry_t* entry = &((j2me_quick_entry_t*)owner->quick_entries)[index];
+    if (entry->kind != J2ME_QUICK_CALL || entry->opcode != opcode) {
+        return NULL;
+    }
+    return &entry->u.call;
+}
+
+void j2me_quicken_remember_call(j2me_class_t* owner, j2me_opcode_t opcode, uint16_t index,
+                                const j2me_resolved_call_t* call) {
+    if (!owner || !call || call->kind == J2ME_CALL_UNRESOLVED ||
+        index == 0 || index >= owner->constant_pool.count) {
+        return;
+    }
+
+    j2me_quick_entry_t* entries = get_quick_entries(owner);
+    if (!entries || entries[index].kind != J2ME_QUICK_NONE) {
+        return;
+    }
+
+    entries[index].u.call = *call;
+    entries[index].opcode = opcode;
+    entries[index].kind = J2ME_QUICK_CALL;
+}
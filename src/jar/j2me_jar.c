@@ -1,14 +1,19 @@
 #include "j2me_jar.h"
 #include "j2me_vm.h"
 #include "j2me_midlet_executor.h"
+#include "j2me_class_cache.h"
 #include <stdlib.h>
 #include <string.h>
 #include "j2me_log.h"
 #include <stdio.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <zlib.h>
 #include <errno.h>
+#include <pthread.h>
+#include <strings.h>
 
 /**
  * @file j2me_jar.c
@@ -25,6 +30,12 @@
 #define ZIP_COMPRESSION_STORED              0
 #define ZIP_COMPRESSION_DEFLATED            8
 
+// ZIP记录的固定长度部分
+#define ZIP_LOCAL_FILE_HEADER_SIZE          30
+#define ZIP_CENTRAL_DIR_HEADER_SIZE         46
+#define ZIP_END_OF_CENTRAL_DIR_SIZE         22
+#define ZIP_MAX_COMMENT_LENGTH              0xFFFF
+
 // ZIP文件头结构
 typedef struct {
     uint32_t signature;
@@ -71,37 +82,61 @@ typedef struct {
     uint16_t comment_length;
 } zip_end_of_central_dir_t;
 
+// 后台解压最多使用的线程数
+#define JAR_PREFETCH_MAX_THREADS            8
+
+// 条目的后台解压状态 (j2me_jar_entry_t.prefetch_state)
+#define JAR_PREFETCH_NONE                   0   // 不在队列中
+#define JAR_PREFETCH_QUEUED                 1   // 排队等待解压
+#define JAR_PREFETCH_INFLATING              2   // 正在解压（后台线程或调用者）
+
+// 后台解压线程池
+typedef struct {
+    pthread_mutex_t lock;               // 保护队列和条目的加载状态
+    pthread_cond_t entry_done;          // 有条目解压结束
+    pthread_t* workers;                 // 工作线程
+    int worker_count;                   // 工作线程数
+    j2me_jar_entry_t** queue;           // 解压顺序
+    size_t queue_length;                // 队列长度
+    size_t next;                        // 下一个待领取的队列位置
+    bool stopping;                      // 正在停止
+    
+    // 统计
+    size_t inflated_count;              // 后台解压完成的条目数
+    size_t ready_count;                 // 加载时已经就绪的次数
+    size_t wait_count;                  // 加载时等待后台解压的次数
+    size_t miss_count;                  // 加载时由调用者同步解压的次数
+} jar_inflate_pool_t;
+
 /**
  * @brief 读取小端序16位整数
  */
-static uint16_t read_uint16_le(FILE* file) {
-    uint8_t bytes[2];
-    fread(bytes, 1, 2, file);
-    return (uint16_t)bytes[0] | ((uint16_t)bytes[1] << 8);
+static uint16_t read_uint16_le(const uint8_t* p) {
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
 }
 
 /**
  * @brief 读取小端序32位整数
  */
-static uint32_t read_uint32_le(FILE* file) {
-    uint8_t bytes[4];
-    fread(bytes, 1, 4, file);
-    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | 
-           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+static uint32_t read_uint32_le(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | 
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
 }
 
 /**
- * @brief 查找ZIP文件的中央目录结束记录
+ * @brief 查找ZIP文件的中央目录结束记录（位于文件末尾，后面可能跟有注释）
  */
-static long find_end_of_central_dir(FILE* file, size_t file_size) {
-    // 从文件末尾开始搜索
-    long search_start = file_size - sizeof(zip_end_of_central_dir_t);
-    if (search_start < 0) search_start = 0;
-    
-    for (long pos = file_size - 4; pos >= search_start; pos--) {
-        fseek(file, pos, SEEK_SET);
-        uint32_t signature = read_uint32_le(file);
-        if (signature == ZIP_END_OF_CENTRAL_DIR_SIGNATURE) {
+static long find_end_of_central_dir(const uint8_t* data, size_t file_size) {
+    if (file_size < ZIP_END_OF_CENTRAL_DIR_SIZE) {
+        return -1;
+    }
+    
+    long last = (long)(file_size - ZIP_END_OF_CENTRAL_DIR_SIZE);
+    long first = last - ZIP_MAX_COMMENT_LENGTH;
+    if (first < 0) first = 0;
+    
+    for (long pos = last; pos >= first; pos--) {
+        if (read_uint32_le(data + pos) == ZIP_END_OF_CENTRAL_DIR_SIGNATURE) {
             return pos;
         }
     }
@@ -109,6 +144,88 @@ static long find_end_of_central_dir(FILE* file, size_t file_size) {
     return -1;
 }
 
+/**
+ * @brief 计算条目名哈希 (FNV-1a)
+ */
+static uint32_t hash_entry_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 建立条目名哈希索引（开放寻址，线性探测，负载因子不超过1/2）
+ */
+static j2me_error_t build_entry_index(j2me_jar_file_t* jar_file) {
+    size_t capacity = 16;
+    while (capacity < (size_t)jar_file->entry_count * 2) {
+        capacity *= 2;
+    }
+    
+    jar_file->entry_index = (j2me_jar_entry_t**)calloc(capacity, sizeof(j2me_jar_entry_t*));
+    if (!jar_file->entry_index) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    jar_file->entry_index_capacity = capacity;
+    
+    size_t mask = capacity - 1;
+    for (int i = 0; i < jar_file->entry_count; i++) {
+        j2me_jar_entry_t* entry = jar_file->entries[i];
+        size_t slot = entry->name_hash & mask;
+        while (jar_file->entry_index[slot]) {
+            // 重名条目保留第一个
+            if (jar_file->entry_index[slot]->name_hash == entry->name_hash &&
+                strcmp(jar_file->entry_index[slot]->name, entry->name) == 0) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (!jar_file->entry_index[slot]) {
+            jar_file->entry_index[slot] = entry;
+        }
+    }
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 把整个文件映射到内存，不支持mmap时读入堆内存
+ */
+static j2me_error_t map_jar_file(j2me_jar_file_t* jar_file, int fd) {
+    if (jar_file->file_size == 0) {
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    void* mapping = mmap(NULL, jar_file->file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+        jar_file->mapping = (const uint8_t*)mapping;
+        jar_file->mapped = true;
+        return J2ME_SUCCESS;
+    }
+    
+    LOG_DEBUG("[JAR解析器] mmap失败 (%s)，改为读入内存\n", strerror(errno));
+    uint8_t* buffer = (uint8_t*)malloc(jar_file->file_size);
+    if (!buffer) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    size_t total = 0;
+    while (total < jar_file->file_size) {
+        ssize_t n = read(fd, buffer + total, jar_file->file_size - total);
+        if (n <= 0) {
+            free(buffer);
+            return J2ME_ERROR_IO_EXCEPTION;
+        }
+        total += (size_t)n;
+    }
+    
+    jar_file->mapping = buffer;
+    jar_file->mapped = false;
+    return J2ME_SUCCESS;
+}
+
 /**
  * @brief 确定JAR条目类型
  */
@@ -149,35 +266,44 @@ j2me_jar_file_t* j2me_jar_open(const char* filename) {
         return NULL;
     }
     
-    // 检查文件是否存在
-    struct stat st;
-    if (stat(filename, &st) != 0) {
-        LOG_DEBUG("[JAR解析器] 文件不存在: %s\n", filename);
+    // 打开文件
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        LOG_DEBUG("[JAR解析器] 打开文件失败: %s\n", filename);
         return NULL;
     }
     
-    // 打开文件
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        LOG_DEBUG("[JAR解析器] 打开文件失败: %s\n", filename);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        LOG_DEBUG("[JAR解析器] 文件不存在: %s\n", filename);
+        close(fd);
         return NULL;
     }
     
     // 创建JAR文件对象
     j2me_jar_file_t* jar_file = (j2me_jar_file_t*)malloc(sizeof(j2me_jar_file_t));
     if (!jar_file) {
-        fclose(file);
+        close(fd);
         return NULL;
     }
     
     memset(jar_file, 0, sizeof(j2me_jar_file_t));
-    
-    jar_file->filename = strdup(filename);
-    jar_file->file = file;
     jar_file->file_size = st.st_size;
     jar_file->parsed = false;
     
-    LOG_DEBUG("[JAR解析器] JAR文件打开成功: %s (大小: %zu bytes)\n", filename, jar_file->file_size);
+    // 映射整个文件，条目数据直接从映射区读取
+    j2me_error_t result = map_jar_file(jar_file, fd);
+    close(fd);
+    if (result != J2ME_SUCCESS) {
+        LOG_DEBUG("[JAR解析器] 读取文件失败: %s\n", filename);
+        free(jar_file);
+        return NULL;
+    }
+    
+    jar_file->filename = strdup(filename);
+    
+    LOG_DEBUG("[JAR解析器] JAR文件打开成功: %s (大小: %zu bytes, %s)\n", filename, jar_file->file_size,
+              jar_file->mapped ? "mmap" : "内存");
     
     return jar_file;
 }
@@ -187,11 +313,12 @@ void j2me_jar_close(j2me_jar_file_t* jar_file) {
         return;
     }
     
-    // 关闭文件
-    if (jar_file->file) {
-        fclose(jar_file->file);
-        jar_file->file = NULL;
-    }
+    // 先停止后台解压，之后才能释放条目
+    j2me_jar_stop_prefetch(jar_file);
+    
+    // 释放JAR持有的类缓存引用（类加载器各自持有引用）
+    j2me_class_cache_release((j2me_class_cache_t*)jar_file->class_cache);
+    jar_file->class_cache = NULL;
     
     // 释放条目数组
     if (jar_file->entries) {
@@ -200,13 +327,27 @@ void j2me_jar_close(j2me_jar_file_t* jar_file) {
             if (entry) {
                 if (entry->name) free(entry->name);
                 if (entry->full_path) free(entry->full_path);
-                if (entry->data) free(entry->data);
+                if (entry->data && entry->data_owned) free(entry->data);
                 free(entry);
             }
         }
         free(jar_file->entries);
     }
     
+    if (jar_file->entry_index) {
+        free(jar_file->entry_index);
+    }
+    
+    // 解除文件映射（STORED条目的数据指向映射区，必须在条目之后释放）
+    if (jar_file->mapping) {
+        if (jar_file->mapped) {
+            munmap((void*)jar_file->mapping, jar_file->file_size);
+        } else {
+            free((void*)jar_file->mapping);
+        }
+        jar_file->mapping = NULL;
+    }
+    
     // 释放清单文件内容
     if (jar_file->manifest_content) {
         free(jar_file->manifest_content);
@@ -227,7 +368,7 @@ void j2me_jar_close(j2me_jar_file_t* jar_file) {
 }
 
 j2me_error_t j2me_jar_parse(j2me_jar_file_t* jar_file) {
-    if (!jar_file || !jar_file->file) {
+    if (!jar_file || !jar_file->mapping) {
         return J2ME_ERROR_INVALID_PARAMETER;
     }
     
@@ -237,85 +378,110 @@ j2me_error_t j2me_jar_parse(j2me_jar_file_t* jar_file) {
     
     LOG_DEBUG("[JAR解析器] 开始解析JAR文件...\n");
     
+    const uint8_t* data = jar_file->mapping;
+    size_t file_size = jar_file->file_size;
+    
     // 查找中央目录结束记录
-    long eocd_pos = find_end_of_central_dir(jar_file->file, jar_file->file_size);
+    long eocd_pos = find_end_of_central_dir(data, file_size);
     if (eocd_pos < 0) {
         LOG_DEBUG("[JAR解析器] 未找到ZIP中央目录结束记录\n");
         return J2ME_ERROR_IO_EXCEPTION;
     }
     
     // 读取中央目录结束记录
-    fseek(jar_file->file, eocd_pos, SEEK_SET);
+    const uint8_t* p = data + eocd_pos;
     zip_end_of_central_dir_t eocd;
-    eocd.signature = read_uint32_le(jar_file->file);
-    eocd.disk_number = read_uint16_le(jar_file->file);
-    eocd.central_dir_disk = read_uint16_le(jar_file->file);
-    eocd.entries_on_disk = read_uint16_le(jar_file->file);
-    eocd.total_entries = read_uint16_le(jar_file->file);
-    eocd.central_dir_size = read_uint32_le(jar_file->file);
-    eocd.central_dir_offset = read_uint32_le(jar_file->file);
-    eocd.comment_length = read_uint16_le(jar_file->file);
-    
-    // LOG_DEBUG("[JAR解析器] 找到 %d 个条目\n", eocd.total_entries);
+    eocd.signature = read_uint32_le(p);
+    eocd.disk_number = read_uint16_le(p + 4);
+    eocd.central_dir_disk = read_uint16_le(p + 6);
+    eocd.entries_on_disk = read_uint16_le(p + 8);
+    eocd.total_entries = read_uint16_le(p + 10);
+    eocd.central_dir_size = read_uint32_le(p + 12);
+    eocd.central_dir_offset = read_uint32_le(p + 16);
+    eocd.comment_length = read_uint16_le(p + 20);
+    
+    if ((size_t)eocd.central_dir_offset > (size_t)eocd_pos) {
+        LOG_DEBUG("[JAR解析器] 中央目录偏移无效: %u\n", eocd.central_dir_offset);
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
     
     // 分配条目数组
     jar_file->entry_count = eocd.total_entries;
     jar_file->entries = (j2me_jar_entry_t**)calloc(jar_file->entry_count, sizeof(j2me_jar_entry_t*));
-    if (!jar_file->entries) {
+    if (!jar_file->entries && jar_file->entry_count > 0) {
         return J2ME_ERROR_OUT_OF_MEMORY;
     }
     
     // 读取中央目录条目
-    fseek(jar_file->file, eocd.central_dir_offset, SEEK_SET);
+    size_t offset = eocd.central_dir_offset;
     
     for (int i = 0; i < jar_file->entry_count; i++) {
+        if (offset + ZIP_CENTRAL_DIR_HEADER_SIZE > (size_t)eocd_pos) {
+            LOG_DEBUG("[JAR解析器] 中央目录被截断 (条目 #%d)\n", i);
+            jar_file->entry_count = i;
+            return J2ME_ERROR_IO_EXCEPTION;
+        }
+        
         // 读取中央目录头
+        p = data + offset;
         zip_central_dir_header_t header;
-        header.signature = read_uint32_le(jar_file->file);
+        header.signature = read_uint32_le(p);
         
         if (header.signature != ZIP_CENTRAL_DIR_HEADER_SIGNATURE) {
             LOG_DEBUG("[JAR解析器] 无效的中央目录头签名: 0x%08x\n", header.signature);
+            jar_file->entry_count = i;
             return J2ME_ERROR_IO_EXCEPTION;
         }
         
-        header.version_made_by = read_uint16_le(jar_file->file);
-        header.version_needed = read_uint16_le(jar_file->file);
-        header.flags = read_uint16_le(jar_file->file);
-        header.compression_method = read_uint16_le(jar_file->file);
-        header.last_mod_time = read_uint16_le(jar_file->file);
-        header.last_mod_date = read_uint16_le(jar_file->file);
-        header.crc32 = read_uint32_le(jar_file->file);
-        header.compressed_size = read_uint32_le(jar_file->file);
-        header.uncompressed_size = read_uint32_le(jar_file->file);
-        header.filename_length = read_uint16_le(jar_file->file);
-        header.extra_field_length = read_uint16_le(jar_file->file);
-        header.comment_length = read_uint16_le(jar_file->file);
-        header.disk_number = read_uint16_le(jar_file->file);
-        header.internal_attributes = read_uint16_le(jar_file->file);
-        header.external_attributes = read_uint32_le(jar_file->file);
-        header.local_header_offset = read_uint32_le(jar_file->file);
+        header.version_made_by = read_uint16_le(p + 4);
+        header.version_needed = read_uint16_le(p + 6);
+        header.flags = read_uint16_le(p + 8);
+        header.compression_method = read_uint16_le(p + 10);
+        header.last_mod_time = read_uint16_le(p + 12);
+        header.last_mod_date = read_uint16_le(p + 14);
+        header.crc32 = read_uint32_le(p + 16);
+        header.compressed_size = read_uint32_le(p + 20);
+        header.uncompressed_size = read_uint32_le(p + 24);
+        header.filename_length = read_uint16_le(p + 28);
+        header.extra_field_length = read_uint16_le(p + 30);
+        header.comment_length = read_uint16_le(p + 32);
+        header.disk_number = read_uint16_le(p + 34);
+        header.internal_attributes = read_uint16_le(p + 36);
+        header.external_attributes = read_uint32_le(p + 38);
+        header.local_header_offset = read_uint32_le(p + 42);
+        
+        size_t record_size = ZIP_CENTRAL_DIR_HEADER_SIZE + header.filename_length +
+                             header.extra_field_length + header.comment_length;
+        if (offset + record_size > (size_t)eocd_pos) {
+            LOG_DEBUG("[JAR解析器] 中央目录被截断 (条目 #%d)\n", i);
+            jar_file->entry_count = i;
+            return J2ME_ERROR_IO_EXCEPTION;
+        }
         
         // 读取文件名
         char* filename = (char*)malloc(header.filename_length + 1);
         if (!filename) {
+            jar_file->entry_count = i;
             return J2ME_ERROR_OUT_OF_MEMORY;
         }
-        fread(filename, 1, header.filename_length, jar_file->file);
+        memcpy(filename, p + ZIP_CENTRAL_DIR_HEADER_SIZE, header.filename_length);
         filename[header.filename_length] = '\0';
         
         // 跳过额外字段和注释
-        fseek(jar_file->file, header.extra_field_length + header.comment_length, SEEK_CUR);
+        offset += record_size;
         
         // 创建JAR条目
         j2me_jar_entry_t* entry = (j2me_jar_entry_t*)malloc(sizeof(j2me_jar_entry_t));
         if (!entry) {
             free(filename);
+            jar_file->entry_count = i;
             return J2ME_ERROR_OUT_OF_MEMORY;
         }
         
         memset(entry, 0, sizeof(j2me_jar_entry_t));
         
         entry->name = filename;
+        entry->name_hash = hash_entry_name(filename);
         entry->full_path = strdup(filename);
         entry->type = determine_entry_type(filename);
         entry->compressed_size = header.compressed_size;
@@ -333,6 +499,12 @@ j2me_error_t j2me_jar_parse(j2me_jar_file_t* jar_file) {
         //        entry->compressed_size, entry->uncompressed_size);
     }
     
+    // 建立条目名索引
+    j2me_error_t result = build_entry_index(jar_file);
+    if (result != J2ME_SUCCESS) {
+        return result;
+    }
+    
     jar_file->parsed = true;
     
     // 解析清单文件
@@ -347,15 +519,20 @@ int j2me_jar_get_entry_count(j2me_jar_file_t* jar_file) {
 }
 
 j2me_jar_entry_t* j2me_jar_find_entry(j2me_jar_file_t* jar_file, const char* name) {
-    if (!jar_file || !name || !jar_file->entries) {
+    if (!jar_file || !name || !jar_file->entry_index) {
         return NULL;
     }
     
-    for (int i = 0; i < jar_file->entry_count; i++) {
-        j2me_jar_entry_t* entry = jar_file->entries[i];
-        if (entry && entry->name && strcmp(entry->name, name) == 0) {
+    uint32_t hash = hash_entry_name(name);
+    size_t mask = jar_file->entry_index_capacity - 1;
+    size_t slot = hash & mask;
+    
+    j2me_jar_entry_t* entry;
+    while ((entry = jar_file->entry_index[slot]) != NULL) {
+        if (entry->name_hash == hash && strcmp(entry->name, name) == 0) {
             return entry;
         }
+        slot = (slot + 1) & mask;
     }
     
     return NULL;
@@ -369,113 +546,317 @@ j2me_jar_entry_t* j2me_jar_get_entry(j2me_jar_file_t* jar_file, int index) {
     return jar_file->entries[index];
 }
 
-j2me_error_t j2me_jar_load_entry(j2me_jar_file_t* jar_file, j2me_jar_entry_t* entry) {
-    if (!jar_file || !entry || !jar_file->file) {
-        return J2ME_ERROR_INVALID_PARAMETER;
-    }
-    
-    if (entry->loaded) {
-        return J2ME_SUCCESS; // 已经加载
-    }
+/**
+ * @brief 读取条目数据（不修改条目，可在解压线程中调用）
+ * @param jar_file JAR文件对象
+ * @param entry JAR条目
+ * @param data 输出数据（STORED条目指向映射区）
+ * @param owned 输出数据是否为新分配的内存
+ * @return 错误码
+ */
+static j2me_error_t read_entry_data(j2me_jar_file_t* jar_file, j2me_jar_entry_t* entry,
+                                    uint8_t** data, bool* owned) {
+    *data = NULL;
+    *owned = false;
     
     // 定位到本地文件头
-    fseek(jar_file->file, entry->file_offset, SEEK_SET);
+    size_t offset = (size_t)entry->file_offset;
+    if (offset + ZIP_LOCAL_FILE_HEADER_SIZE > jar_file->file_size) {
+        LOG_DEBUG("[JAR解析器] 本地文件头偏移越界: %s\n", entry->name);
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
     
-    // 读取本地文件头
+    // 读取本地文件头（只需要签名和变长字段长度，大小以中央目录为准）
+    const uint8_t* p = jar_file->mapping + offset;
     zip_local_file_header_t header;
-    header.signature = read_uint32_le(jar_file->file);
+    header.signature = read_uint32_le(p);
     
     if (header.signature != ZIP_LOCAL_FILE_HEADER_SIGNATURE) {
         LOG_DEBUG("[JAR解析器] 无效的本地文件头签名: 0x%08x\n", header.signature);
         return J2ME_ERROR_IO_EXCEPTION;
     }
     
-    header.version_needed = read_uint16_le(jar_file->file);
-    header.flags = read_uint16_le(jar_file->file);
-    header.compression_method = read_uint16_le(jar_file->file);
-    header.last_mod_time = read_uint16_le(jar_file->file);
-    header.last_mod_date = read_uint16_le(jar_file->file);
-    header.crc32 = read_uint32_le(jar_file->file);
-    header.compressed_size = read_uint32_le(jar_file->file);
-    header.uncompressed_size = read_uint32_le(jar_file->file);
-    header.filename_length = read_uint16_le(jar_file->file);
-    header.extra_field_length = read_uint16_le(jar_file->file);
+    header.filename_length = read_uint16_le(p + 26);
+    header.extra_field_length = read_uint16_le(p + 28);
     
     // 跳过文件名和额外字段
-    fseek(jar_file->file, header.filename_length + header.extra_field_length, SEEK_CUR);
+    size_t data_offset = offset + ZIP_LOCAL_FILE_HEADER_SIZE + header.filename_length + header.extra_field_length;
     
     // 读取压缩数据
     if (entry->compressed_size == 0) {
-        entry->data = NULL;
-        entry->loaded = true;
         return J2ME_SUCCESS;
     }
     
-    uint8_t* compressed_data = (uint8_t*)malloc(entry->compressed_size);
-    if (!compressed_data) {
-        return J2ME_ERROR_OUT_OF_MEMORY;
-    }
-    
-    size_t bytes_read = fread(compressed_data, 1, entry->compressed_size, jar_file->file);
-    if (bytes_read != entry->compressed_size) {
-        free(compressed_data);
+    if (data_offset > jar_file->file_size || entry->compressed_size > jar_file->file_size - data_offset) {
         LOG_DEBUG("[JAR解析器] 读取压缩数据失败\n");
         return J2ME_ERROR_IO_EXCEPTION;
     }
+    const uint8_t* compressed_data = jar_file->mapping + data_offset;
     
     // 解压数据
     if (entry->compression_method == ZIP_COMPRESSION_STORED) {
-        // 未压缩，直接使用
-        entry->data = compressed_data;
-    } else if (entry->compression_method == ZIP_COMPRESSION_DEFLATED) {
-        // 使用zlib解压
-        entry->data = (uint8_t*)malloc(entry->uncompressed_size);
-        if (!entry->data) {
-            free(compressed_data);
-            return J2ME_ERROR_OUT_OF_MEMORY;
-        }
-        
-        z_stream stream;
-        memset(&stream, 0, sizeof(stream));
-        stream.next_in = compressed_data;
-        stream.avail_in = entry->compressed_size;
-        stream.next_out = entry->data;
-        stream.avail_out = entry->uncompressed_size;
-        
-        // 初始化inflateInit2用于原始deflate数据
-        int ret = inflateInit2(&stream, -MAX_WBITS);
-        if (ret != Z_OK) {
-            free(compressed_data);
-            free(entry->data);
-            entry->data = NULL;
-            LOG_DEBUG("[JAR解析器] zlib初始化失败: %d\n", ret);
+        // 未压缩，直接指向映射区，不复制
+        if (entry->uncompressed_size > entry->compressed_size) {
+            LOG_DEBUG("[JAR解析器] STORED条目大小不一致: %s\n", entry->name);
             return J2ME_ERROR_IO_EXCEPTION;
         }
+        *data = (uint8_t*)compressed_data;
+        return J2ME_SUCCESS;
+    }
+    
+    if (entry->compression_method != ZIP_COMPRESSION_DEFLATED) {
+        LOG_DEBUG("[JAR解析器] 不支持的压缩方法: %d\n", entry->compression_method);
+        return J2ME_ERROR_NOT_IMPLEMENTED;
+    }
+    
+    // 使用zlib解压
+    uint8_t* inflated = (uint8_t*)malloc(entry->uncompressed_size > 0 ? entry->uncompressed_size : 1);
+    if (!inflated) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.next_in = (Bytef*)compressed_data;
+    stream.avail_in = entry->compressed_size;
+    stream.next_out = inflated;
+    stream.avail_out = entry->uncompressed_size;
+    
+    // 初始化inflateInit2用于原始deflate数据
+    int ret = inflateInit2(&stream, -MAX_WBITS);
+    if (ret != Z_OK) {
+        free(inflated);
+        LOG_DEBUG("[JAR解析器] zlib初始化失败: %d\n", ret);
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    ret = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    
+    if (ret != Z_STREAM_END) {
+        free(inflated);
+        LOG_DEBUG("[JAR解析器] 解压失败: %d\n", ret);
+        return J2ME_ERROR_IO_EXCEPTION;
+    }
+    
+    *data = inflated;
+    *owned = true;
+    return J2ME_SUCCESS;
+}
+
+/**
+ * @brief 后台解压线程
+ *
+ * 按队列顺序领取条目。调用者已经开始加载的条目（不再是排队状态）直接跳过。
+ */
+static void* inflate_worker_main(void* arg) {
+    j2me_jar_file_t* jar_file = (j2me_jar_file_t*)arg;
+    jar_inflate_pool_t* pool = (jar_inflate_pool_t*)jar_file->inflate_pool;
+    
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopping && pool->next < pool->queue_length) {
+        j2me_jar_entry_t* entry = pool->queue[pool->next++];
+        if (entry->prefetch_state != JAR_PREFETCH_QUEUED) {
+            continue;
+        }
+        entry->prefetch_state = JAR_PREFETCH_INFLATING;
+        pthread_mutex_unlock(&pool->lock);
         
-        ret = inflate(&stream, Z_FINISH);
-        inflateEnd(&stream);
+        uint8_t* data;
+        bool owned;
+        j2me_error_t result = read_entry_data(jar_file, entry, &data, &owned);
         
-        if (ret != Z_STREAM_END) {
-            free(compressed_data);
-            free(entry->data);
-            entry->data = NULL;
-            LOG_DEBUG("[JAR解析器] 解压失败: %d\n", ret);
-            return J2ME_ERROR_IO_EXCEPTION;
+        pthread_mutex_lock(&pool->lock);
+        if (result == J2ME_SUCCESS) {
+            entry->data = data;
+            entry->data_owned = owned;
+            entry->loaded = true;
+            pool->inflated_count++;
         }
-        
-        free(compressed_data);
-    } else {
-        free(compressed_data);
-        LOG_DEBUG("[JAR解析器] 不支持的压缩方法: %d\n", entry->compression_method);
-        return J2ME_ERROR_NOT_IMPLEMENTED;
+        // 失败的条目留给调用者同步加载并报告错误
+        entry->prefetch_state = JAR_PREFETCH_NONE;
+        pthread_cond_broadcast(&pool->entry_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+j2me_error_t j2me_jar_load_entry(j2me_jar_file_t* jar_file, j2me_jar_entry_t* entry) {
+    if (!jar_file || !entry || !jar_file->mapping) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    
+    jar_inflate_pool_t* pool = (jar_inflate_pool_t*)jar_file->inflate_pool;
+    if (pool) {
+        // 后台解压进行中：等待正在解压的条目，排队中的条目由调用者自己解压
+        pthread_mutex_lock(&pool->lock);
+        if (entry->prefetch_state == JAR_PREFETCH_INFLATING) {
+            pool->wait_count++;
+            while (entry->prefetch_state == JAR_PREFETCH_INFLATING) {
+                pthread_cond_wait(&pool->entry_done, &pool->lock);
+            }
+        }
+        if (entry->loaded) {
+            pool->ready_count++;
+            pthread_mutex_unlock(&pool->lock);
+            return J2ME_SUCCESS;
+        }
+        entry->prefetch_state = JAR_PREFETCH_INFLATING;
+        pool->miss_count++;
+        pthread_mutex_unlock(&pool->lock);
+    } else if (entry->loaded) {
+        return J2ME_SUCCESS; // 已经加载
     }
     
-    entry->loaded = true;
+    uint8_t* data;
+    bool owned;
+    j2me_error_t result = read_entry_data(jar_file, entry, &data, &owned);
+    
+    if (pool) {
+        pthread_mutex_lock(&pool->lock);
+    }
+    if (result == J2ME_SUCCESS) {
+        entry->data = data;
+        entry->data_owned = owned;
+        entry->loaded = true;
+    }
+    if (pool) {
+        entry->prefetch_state = JAR_PREFETCH_NONE;
+        pthread_cond_broadcast(&pool->entry_done);
+        pthread_mutex_unlock(&pool->lock);
+    }
     
     // // LOG_DEBUG("[JAR解析器] 条目加载成功: %s (%zu bytes)\n", entry->name, entry->uncompressed_size);
+    return result;
+}
+
+/**
+ * @brief 把条目加入预解压队列（只有DEFLATED条目需要解压）
+ */
+static void enqueue_prefetch_entry(jar_inflate_pool_t* pool, j2me_jar_entry_t* entry) {
+    if (!entry || entry->loaded || entry->prefetch_state != JAR_PREFETCH_NONE ||
+        entry->compression_method != ZIP_COMPRESSION_DEFLATED || entry->compressed_size == 0) {
+        return;
+    }
+    entry->prefetch_state = JAR_PREFETCH_QUEUED;
+    pool->queue[pool->queue_length++] = entry;
+}
+
+/**
+ * @brief 判断资源是否值得预先解压（图片和音频）
+ */
+static bool is_prefetch_resource(const char* name) {
+    const char* ext = strrchr(name, '.');
+    if (!ext) {
+        return false;
+    }
+    return strcasecmp(ext, ".png") == 0 || strcasecmp(ext, ".jpg") == 0 ||
+           strcasecmp(ext, ".gif") == 0 || strcasecmp(ext, ".mid") == 0 ||
+           strcasecmp(ext, ".wav") == 0 || strcasecmp(ext, ".amr") == 0;
+}
+
+j2me_error_t j2me_jar_start_prefetch(j2me_jar_file_t* jar_file, int thread_count, bool include_resources) {
+    if (!jar_file || !jar_file->parsed) {
+        return J2ME_ERROR_INVALID_PARAMETER;
+    }
+    if (jar_file->inflate_pool) {
+        return J2ME_SUCCESS;
+    }
+    
+    if (thread_count <= 0) {
+        // 留一个核给解释器
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 1 ? (int)(cpus - 1) : 1;
+        if (thread_count > JAR_PREFETCH_MAX_THREADS) {
+            thread_count = JAR_PREFETCH_MAX_THREADS;
+        }
+    }
+    
+    jar_inflate_pool_t* pool = (jar_inflate_pool_t*)calloc(1, sizeof(jar_inflate_pool_t));
+    if (!pool) {
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    pool->queue = (j2me_jar_entry_t**)malloc(sizeof(j2me_jar_entry_t*) * (jar_file->entry_count + 1));
+    pool->workers = (pthread_t*)malloc(sizeof(pthread_t) * thread_count);
+    if (!pool->queue || !pool->workers) {
+        free(pool->queue);
+        free(pool->workers);
+        free(pool);
+        return J2ME_ERROR_OUT_OF_MEMORY;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->entry_done, NULL);
+    
+    // 启动顺序：清单中的MIDlet主类，其余类文件，最后是图片和音频
+    j2me_midlet_suite_t* suite = jar_file->midlet_suite;
+    for (int i = 0; suite && i < suite->midlet_count; i++) {
+        const char* class_name = suite->midlets[i] ? suite->midlets[i]->class_name : NULL;
+        if (!class_name) {
+            continue;
+        }
+        char class_path[256];
+        size_t len = 0;
+        for (; class_name[len] && len < sizeof(class_path) - 7; len++) {
+            class_path[len] = class_name[len] == '.' ? '/' : class_name[len];
+        }
+        strcpy(class_path + len, ".class");
+        enqueue_prefetch_entry(pool, j2me_jar_find_entry(jar_file, class_path));
+    }
+    for (int i = 0; i < jar_file->entry_count; i++) {
+        if (jar_file->entries[i]->type == JAR_ENTRY_CLASS) {
+            enqueue_prefetch_entry(pool, jar_file->entries[i]);
+        }
+    }
+    if (include_resources) {
+        for (int i = 0; i < jar_file->entry_count; i++) {
+            j2me_jar_entry_t* entry = jar_file->entries[i];
+            if (entry->type == JAR_ENTRY_RESOURCE && is_prefetch_resource(entry->name)) {
+                enqueue_prefetch_entry(pool, entry);
+            }
+        }
+    }
+    
+    jar_file->inflate_pool = pool;
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&pool->workers[pool->worker_count], NULL, inflate_worker_main, jar_file) == 0) {
+            pool->worker_count++;
+        }
+    }
+    
+    LOG_DEBUG("[JAR解析器] 后台解压启动: %d个线程, %zu个条目\n", pool->worker_count, pool->queue_length);
     return J2ME_SUCCESS;
 }
 
+void j2me_jar_stop_prefetch(j2me_jar_file_t* jar_file) {
+    if (!jar_file || !jar_file->inflate_pool) {
+        return;
+    }
+    
+    jar_inflate_pool_t* pool = (jar_inflate_pool_t*)jar_file->inflate_pool;
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (int i = 0; i < pool->worker_count; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+    
+    // 未被领取的条目恢复为普通状态
+    for (size_t i = pool->next; i < pool->queue_length; i++) {
+        pool->queue[i]->prefetch_state = JAR_PREFETCH_NONE;
+    }
+    
+    LOG_DEBUG("[JAR解析器] 后台解压结束: 预解压%zu个, 命中%zu次, 等待%zu次, 同步解压%zu次\n",
+              pool->inflated_count, pool->ready_count, pool->wait_count, pool->miss_count);
+    
+    jar_file->inflate_pool = NULL;
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->entry_done);
+    free(pool->workers);
+    free(pool->queue);
+    free(pool);
+}
+
 j2me_error_t j2me_jar_extract_entry(j2me_jar_file_t* jar_file, j2me_jar_entry_t* entry, const char* output_path) {
     if (!jar_file || !entry || !output_path) {
         return J2ME_ERROR_INVALID_PARAMETER;
@@ -2,11 +2,13 @@
 #include "j2me_graphics.h"
 #include "j2me_native_methods.h"
 #include "j2me_jar.h"
+#include "j2me_class_cache.h"
 #include "j2me_midlet_executor.h"
 #include "j2me_input.h"
 #include "j2me_log.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <SDL2/SDL.h>
 
 /**
@@ -70,11 +72,27 @@ int main(int argc, char* argv[]) {
         LOG_INFO("选项:");
         LOG_INFO("  -v, --verbose    显示详细调试信息");
         LOG_INFO("  -q, --quiet      只显示错误信息");
+        LOG_INFO("  -p, --predecoded 使用预解码解释器执行字节码");
+        LOG_INFO("  -n, --no-class-cache 不使用解析后类缓存");
+        LOG_INFO("  -a, --alloc-profile <文件> 分析堆分配，退出或收到SIGUSR1时写出报告（.json结尾输出JSON）");
+        LOG_INFO("  -d, --heap-dump <文件> 收到SIGUSR2时写出堆快照（用tools/heap_analyzer分析）");
+        LOG_INFO("  -s, --string-dedup 回收时合并内容相同的字符串");
+        LOG_INFO("  -o, --opcode-profile <文件> 统计执行的指令序列，退出时写出报告（用于选取超级指令，.json结尾输出JSON）");
+        LOG_INFO("  -j, --jit        把热点方法编译为机器码执行（x86-64/AArch64 Linux）");
+        LOG_INFO("  --perf-map       启用JIT并写出/tmp/perf-<pid>.map供perf解析编译代码");
         LOG_INFO("示例: %s test_jar/zxfml.jar", argv[0]);
         return 1;
     }
     
     const char* jar_path = argv[1];
+    j2me_execution_mode_t execution_mode = J2ME_EXEC_MODE_THREADED;
+    bool use_class_cache = true;
+    const char* alloc_profile_path = NULL;
+    const char* heap_dump_path = NULL;
+    bool string_dedup = false;
+    const char* opcode_profile_path = NULL;
+    bool enable_jit = false;
+    bool jit_perf_map = false;
     
     // 处理命令行选项
     for (int i = 2; i < argc; i++) {
@@ -83,6 +101,29 @@ int main(int argc, char* argv[]) {
             LOG_INFO("调试模式已启用");
         } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
             j2me_log_set_level(J2ME_LOG_LEVEL_ERROR);
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--predecoded") == 0) {
+            execution_mode = J2ME_EXEC_MODE_PREDECODED;
+            LOG_INFO("预解码解释器已启用");
+        } else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--no-class-cache") == 0) {
+            use_class_cache = false;
+        } else if ((strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--alloc-profile") == 0) && i + 1 < argc) {
+            alloc_profile_path = argv[++i];
+            LOG_INFO("分配分析已启用，报告: %s", alloc_profile_path);
+        } else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--heap-dump") == 0) && i + 1 < argc) {
+            heap_dump_path = argv[++i];
+            LOG_INFO("堆快照已启用（kill -USR2 %ld），路径: %s", (long)getpid(), heap_dump_path);
+        } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--string-dedup") == 0) {
+            string_dedup = true;
+        } else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--opcode-profile") == 0) && i + 1 < argc) {
+            opcode_profile_path = argv[++i];
+            LOG_INFO("指令序列分析已启用（逐条解释执行），报告: %s", opcode_profile_path);
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jit") == 0) {
+            enable_jit = true;
+            LOG_INFO("JIT编译已启用");
+        } else if (strcmp(argv[i], "--perf-map") == 0) {
+            enable_jit = true;
+            jit_perf_map = true;
+            LOG_INFO("JIT编译已启用，perf映射: /tmp/perf-%ld.map", (long)getpid());
         }
     }
     
@@ -107,6 +148,13 @@ int main(int argc, char* argv[]) {
     // 创建虚拟机（使用Phase 1的堆系统）
     j2me_vm_config_t vm_config = j2me_vm_get_default_config();
     vm_config.heap_size = 2 * 1024 * 1024;  // 2MB堆
+    vm_config.execution_mode = execution_mode;
+    vm_config.alloc_profile_path = alloc_profile_path;
+    vm_config.heap_dump_path = heap_dump_path;
+    vm_config.string_dedup = string_dedup;
+    vm_config.opcode_profile_path = opcode_profile_path;
+    vm_config.enable_jit = enable_jit;
+    vm_config.jit_perf_map = jit_perf_map;
     
     j2me_vm_t* vm = j2me_vm_create(&vm_config);
     if (!vm) {
@@ -169,6 +217,16 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // 后台预先解压类文件和图片/音频资源
+    if (j2me_jar_start_prefetch(jar_file, 0, true) != J2ME_SUCCESS) {
+        LOG_WARN("后台解压启动失败，改为按需解压");
+    }
+    
+    // 打开解析后类缓存（类加载器设置JAR文件时取得引用）
+    if (use_class_cache) {
+        jar_file->class_cache = j2me_class_cache_open(NULL, jar_file);
+    }
+    
     // 将JAR文件设置到类加载器
     if (vm->class_loader) {
         j2me_error_t loader_result = j2me_class_loader_set_jar_file(vm->class_loader, jar_file);
@@ -254,7 +312,7 @@ int main(int argc, char* argv[]) {
             if (repaint_counter % 30 == 0) {
                 LOG_DEBUG("[主循环] 触发Canvas重绘 (Canvas=0x%x)\n", vm->current_canvas_ref);
                 
-                j2me_stack_frame_t* frame = j2me_stack_frame_create(10, 5);
+                j2me_stack_frame_t* frame = j2me_thread_create_frame(vm, vm->current_thread, 10, 5);
                 if (frame) {
                     // 压入Canvas对象引用
                     j2me_operand_stack_push(&frame->operand_stack, vm->current_canvas_ref);
@@ -0,0 +1,684 @@
+#include "j2me_heap_dump.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @file j2me_heap_analyzer.c
+ * @brief 堆快照离线分析工具
+ *
+ * 读取j2me_heap_dump写出的快照，输出：
+ *   - 按类统计的对象数、浅大小和保留大小（该类所有实例一起释放时能回收的字节数）
+ *   - 保留大小最大的对象（支配者）
+ *   - 内容相同的可达String对象
+ *
+ * 支配树用Cooper-Harvey-Kennedy迭代算法计算，虚拟根节点指向快照中的所有回收根。
+ * 从根不可达的对象（尚未回收的垃圾）单独统计，不参与支配树。
+ *
+ * 用法: j2me_heap_analyzer <快照文件> [-n 条数]
+ */
+
+#define DEFAULT_TOP_COUNT   20          // 每个列表默认输出的条数
+#define STRING_PREVIEW      60          // 重复字符串预览的最大字节数
+#define UNDEFINED           UINT32_MAX
+
+// 图节点（0号为虚拟根，其余为快照中的对象）
+typedef struct {
+    uint32_t ref;                   // 对象引用
+    uint32_t class_index;           // 类在类表中的下标
+    uint32_t block_size;            // 浅大小（堆块大小）
+    uint32_t flags;                 // 对象标志
+    const uint32_t* references;     // 引用的对象（指向快照数据）
+    uint32_t reference_count;
+    const char* payload;            // 附带内容（String字符）
+    uint32_t payload_length;
+} heap_node_t;
+
+// 类
+typedef struct {
+    uint32_t class_id;
+    char* name;                     // 快照中没有名称时为"<class 0x...>"
+    uint64_t objects;               // 可达实例数
+    uint64_t shallow;               // 可达实例的浅大小
+    uint64_t retained;              // 保留大小
+    uint64_t unreachable_objects;   // 不可达实例数
+} heap_class_t;
+
+// 快照及分析结果
+typedef struct {
+    uint8_t* data;                  // 快照文件内容
+    size_t data_size;
+    j2me_heap_dump_header_t header;
+    
+    heap_class_t* classes;          // 按class_id排序
+    uint32_t class_count;
+    
+    heap_node_t* nodes;             // node_count = 对象数 + 1
+    uint32_t node_count;
+    uint32_t* node_of_ref;          // 引用 -> 节点下标，不在快照中为UNDEFINED
+    const uint32_t* roots;
+    uint32_t root_count;
+    
+    // 支配树
+    uint32_t* postorder;            // 按后序排列的可达节点
+    uint32_t reachable_count;
+    uint32_t* post_number;          // 节点 -> 后序编号，不可达为UNDEFINED
+    uint32_t* idom;                 // 直接支配者
+    uint64_t* retained;             // 保留大小
+    uint32_t* retained_count;       // 被支配的对象数（含自身）
+} heap_snapshot_t;
+
+// 图的后继（虚拟根的后继是回收根）
+static uint32_t successor_count(const heap_snapshot_t* snapshot, uint32_t node) {
+    return node == 0 ? snapshot->root_count : snapshot->nodes[node].reference_count;
+}
+
+static uint32_t successor(const heap_snapshot_t* snapshot, uint32_t node, uint32_t i) {
+    uint32_t ref = node == 0 ? snapshot->roots[i] : snapshot->nodes[node].references[i];
+    return ref < snapshot->header.ref_limit ? snapshot->node_of_ref[ref] : UNDEFINED;
+}
+
+static int compare_class_id(const void* a, const void* b) {
+    uint32_t x = ((const heap_class_t*)a)->class_id;
+    uint32_t y = ((const heap_class_t*)b)->class_id;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * @brief 按class_id查找类在类表中的下标（类表已排序）
+ */
+static uint32_t find_class(heap_snapshot_t* snapshot, uint32_t class_id) {
+    heap_class_t key = { class_id, NULL, 0, 0, 0, 0 };
+    heap_class_t* found = (heap_class_t*)bsearch(&key, snapshot->classes, snapshot->class_count,
+                                                 sizeof(heap_class_t), compare_class_id);
+    return found ? (uint32_t)(found - snapshot->classes) : UNDEFINED;
+}
+
+// 按顺序读取快照数据（每项补齐到4字节）
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+} reader_t;
+
+/**
+ * @brief 读取length字节，数据不足时返回NULL
+ */
+static const void* read_bytes(reader_t* reader, size_t length) {
+    size_t padded = J2ME_HEAP_DUMP_ALIGN4(length);
+    if (padded > reader->size - reader->offset) {
+        return NULL;
+    }
+    const void* p = reader->data + reader->offset;
+    reader->offset += padded;
+    return p;
+}
+
+static bool load_snapshot(heap_snapshot_t* snapshot, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "无法打开快照: %s\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_size < (long)sizeof(j2me_heap_dump_header_t)) {
+        fprintf(stderr, "快照文件太小: %s\n", path);
+        fclose(file);
+        return false;
+    }
+    snapshot->data_size = (size_t)file_size;
+    snapshot->data = (uint8_t*)malloc(snapshot->data_size);
+    if (!snapshot->data || fread(snapshot->data, 1, snapshot->data_size, file) != snapshot->data_size) {
+        fprintf(stderr, "读取快照失败: %s\n", path);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    
+    reader_t reader = { snapshot->data, snapshot->data_size, 0 };
+    memcpy(&snapshot->header, read_bytes(&reader, sizeof(j2me_heap_dump_header_t)), sizeof(j2me_heap_dump_header_t));
+    const j2me_heap_dump_header_t* header = &snapshot->header;
+    if (header->magic != J2ME_HEAP_DUMP_MAGIC || header->endian_tag != J2ME_HEAP_DUMP_ENDIAN_TAG) {
+        fprintf(stderr, "不是堆快照文件或字节序不同: %s\n", path);
+        return false;
+    }
+    if (header->version != J2ME_HEAP_DUMP_VERSION) {
+        fprintf(stderr, "不支持的快照版本: %u\n", header->version);
+        return false;
+    }
+    
+    // 类名（对象中出现但没有名称的类在读对象时补上）
+    snapshot->classes = (heap_class_t*)calloc((size_t)header->class_count + header->object_count + 1, sizeof(heap_class_t));
+    snapshot->nodes = (heap_node_t*)calloc((size_t)header->object_count + 1, sizeof(heap_node_t));
+    snapshot->node_of_ref = (uint32_t*)malloc(((size_t)header->ref_limit + 1) * sizeof(uint32_t));
+    if (!snapshot->classes || !snapshot->nodes || !snapshot->node_of_ref) {
+        fprintf(stderr, "内存不足\n");
+        return false;
+    }
+    memset(snapshot->node_of_ref, 0xFF, ((size_t)header->ref_limit + 1) * sizeof(uint32_t));
+    
+    for (uint32_t i = 0; i < header->class_count; i++) {
+        const j2me_heap_dump_class_t* record = (const j2me_heap_dump_class_t*)read_bytes(&reader, sizeof(j2me_heap_dump_class_t));
+        const char* name = record ? (const char*)read_bytes(&reader, record->name_length) : NULL;
+        if (!name) {
+            fprintf(stderr, "快照已截断（类名）\n");
+            return false;
+        }
+        heap_class_t* cls = &snapshot->classes[snapshot->class_count++];
+        cls->class_id = record->class_id;
+        cls->name = (char*)malloc(record->name_length + 1);
+        memcpy(cls->name, name, record->name_length);
+        cls->name[record->name_length] = '\0';
+    }
+    qsort(snapshot->classes, snapshot->class_count, sizeof(heap_class_t), compare_class_id);
+    
+    snapshot->root_count = header->root_count;
+    snapshot->roots = (const uint32_t*)read_bytes(&reader, (size_t)header->root_count * sizeof(uint32_t));
+    if (!snapshot->roots && header->root_count > 0) {
+        fprintf(stderr, "快照已截断（根）\n");
+        return false;
+    }
+    
+    snapshot->node_count = 1;
+    for (uint32_t i = 0; i < header->object_count; i++) {
+        const j2me_heap_dump_object_t* record = (const j2me_heap_dump_object_t*)read_bytes(&reader, sizeof(j2me_heap_dump_object_t));
+        const uint32_t* references = record ? (const uint32_t*)read_bytes(&reader, (size_t)record->reference_count * sizeof(uint32_t)) : NULL;
+        const char* payload = record ? (const char*)read_bytes(&reader, record->payload_length) : NULL;
+        if (!record || (!references && record->reference_count > 0) || (!payload && record->payload_length > 0) ||
+            record->ref >= header->ref_limit) {
+            fprintf(stderr, "快照已截断（对象 %u/%u）\n", i, header->object_count);
+            return false;
+        }
+    
+        heap_node_t* node = &snapshot->nodes[snapshot->node_count];
+        node->ref = record->ref;
+        node->class_index = record->class_id;   // 暂存class_id，类表排序完成后再换成下标
+        node->block_size = record->block_size;
+        node->flags = record->flags;
+        node->references = references;
+        node->reference_count = record->reference_count;
+        node->payload = payload;
+        node->payload_length = record->payload_length;
+        snapshot->node_of_ref[record->ref] = snapshot->node_count++;
+    }
+    
+    // 补上没有名称的类
+    uint32_t named_count = snapshot->class_count;
+    for (uint32_t n = 1; n < snapshot->node_count; n++) {
+        uint32_t class_id = snapshot->nodes[n].class_index;
+        heap_class_t key = { class_id, NULL, 0, 0, 0, 0 };
+        if (bsearch(&key, snapshot->classes, named_count, sizeof(heap_class_t), compare_class_id)) {
+            continue;
+        }
+        bool added = false;
+        for (uint32_t i = named_count; i < snapshot->class_count; i++) {
+            if (snapshot->classes[i].class_id == class_id) {
+                added = true;
+                break;
+            }
+        }
+        if (!added) {
+            heap_class_t* cls = &snapshot->classes[snapshot->class_count++];
+            cls->class_id = class_id;
+            cls->name = (char*)malloc(32);
+            snprintf(cls->name, 32, "<class 0x%08x>", class_id);
+        }
+    }
+    qsort(snapshot->classes, snapshot->class_count, sizeof(heap_class_t), compare_class_id);
+    for (uint32_t n = 1; n < snapshot->node_count; n++) {
+        snapshot->nodes[n].class_index = find_class(snapshot, snapshot->nodes[n].class_index);
+    }
+    return true;
+}
+
+/**
+ * @brief 从虚拟根做深度优先遍历，得到可达节点的后序
+ */
+static bool compute_postorder(heap_snapshot_t* snapshot) {
+    uint32_t n = snapshot->node_count;
+    snapshot->postorder = (uint32_t*)malloc(n * sizeof(uint32_t));
+    snapshot->post_number = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* stack_node = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* stack_edge = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint8_t* visited = (uint8_t*)calloc(n, 1);
+    if (!snapshot->postorder || !snapshot->post_number || !stack_node || !stack_edge || !visited) {
+        free(stack_node);
+        free(stack_edge);
+        free(visited);
+        return false;
+    }
+    memset(snapshot->post_number, 0xFF, n * sizeof(uint32_t));
+    
+    uint32_t depth = 0;
+    uint32_t count = 0;
+    stack_node[depth] = 0;
+    stack_edge[depth] = 0;
+    visited[0] = 1;
+    depth = 1;
+    while (depth > 0) {
+        uint32_t node = stack_node[depth - 1];
+        if (stack_edge[depth - 1] < successor_count(snapshot, node)) {
+            uint32_t next = successor(snapshot, node, stack_edge[depth - 1]++);
+            if (next != UNDEFINED && !visited[next]) {
+                visited[next] = 1;
+                stack_node[depth] = next;
+                stack_edge[depth] = 0;
+                depth++;
+            }
+        } else {
+            snapshot->post_number[node] = count;
+            snapshot->postorder[count++] = node;
+            depth--;
+        }
+    }
+    snapshot->reachable_count = count;
+    
+    free(stack_node);
+    free(stack_edge);
+    free(visited);
+    return true;
+}
+
+static uint32_t intersect(const heap_snapshot_t* snapshot, uint32_t a, uint32_t b) {
+    while (a != b) {
+        while (snapshot->post_number[a] < snapshot->post_number[b]) {
+            a = snapshot->idom[a];
+        }
+        while (snapshot->post_number[b] < snapshot->post_number[a]) {
+            b = snapshot->idom[b];
+        }
+    }
+    return a;
+}
+
+/**
+ * @brief 计算直接支配者（Cooper-Harvey-Kennedy迭代算法，按逆后序处理）
+ */
+static bool compute_dominators(heap_snapshot_t* snapshot) {
+    uint32_t n = snapshot->node_count;
+    
+    // 可达节点的前驱（CSR）
+    uint32_t* pred_start = (uint32_t*)calloc((size_t)n + 1, sizeof(uint32_t));
+    snapshot->idom = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!pred_start || !snapshot->idom) {
+        free(pred_start);
+        return false;
+    }
+    size_t edge_count = 0;
+    for (uint32_t i = 0; i < snapshot->reachable_count; i++) {
+        uint32_t node = snapshot->postorder[i];
+        for (uint32_t e = 0; e < successor_count(snapshot, node); e++) {
+            uint32_t next = successor(snapshot, node, e);
+            if (next != UNDEFINED) {
+                pred_start[next + 1]++;
+                edge_count++;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        pred_start[i + 1] += pred_start[i];
+    }
+    uint32_t* preds = (uint32_t*)malloc((edge_count + 1) * sizeof(uint32_t));
+    uint32_t* fill = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    if (!preds || !fill) {
+        free(pred_start);
+        free(preds);
+        free(fill);
+        return false;
+    }
+    memcpy(fill, pred_start, (size_t)n * sizeof(uint32_t));
+    for (uint32_t i = 0; i < snapshot->reachable_count; i++) {
+        uint32_t node = snapshot->postorder[i];
+        for (uint32_t e = 0; e < successor_count(snapshot, node); e++) {
+            uint32_t next = successor(snapshot, node, e);
+            if (next != UNDEFINED) {
+                preds[fill[next]++] = node;
+            }
+        }
+    }
+    
+    memset(snapshot->idom, 0xFF, n * sizeof(uint32_t));
+    snapshot->idom[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // 逆后序：跳过最后一个（虚拟根）
+        for (uint32_t i = snapshot->reachable_count - 1; i-- > 0;) {
+            uint32_t node = snapshot->postorder[i];
+            uint32_t new_idom = UNDEFINED;
+            for (uint32_t p = pred_start[node]; p < pred_start[node + 1]; p++) {
+                uint32_t pred = preds[p];
+                if (snapshot->idom[pred] == UNDEFINED) {
+                    continue;
+                }
+                new_idom = new_idom == UNDEFINED ? pred : intersect(snapshot, pred, new_idom);
+            }
+            if (new_idom != UNDEFINED && snapshot->idom[node] != new_idom) {
+                snapshot->idom[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+    
+    free(pred_start);
+    free(preds);
+    free(fill);
+    return true;
+}
+
+/**
+ * @brief 计算保留大小：后序中支配树的子节点总在父节点之前
+ */
+static bool compute_retained(heap_snapshot_t* snapshot) {
+    uint32_t n = snapshot->node_count;
+    snapshot->retained = (uint64_t*)calloc(n, sizeof(uint64_t));
+    snapshot->retained_count = (uint32_t*)calloc(n, sizeof(uint32_t));
+    if (!snapshot->retained || !snapshot->retained_count) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < snapshot->reachable_count; i++) {
+        uint32_t node = snapshot->postorder[i];
+        if (node == 0) {
+            continue;
+        }
+        snapshot->retained[node] += snapshot->nodes[node].block_size;
+        snapshot->retained_count[node]++;
+        uint32_t parent = snapshot->idom[node];
+        snapshot->retained[parent] += snapshot->retained[node];
+        snapshot->retained_count[parent] += snapshot->retained_count[node];
+    }
+    return true;
+}
+
+/**
+ * @brief 按类汇总：类的保留大小是支配树中没有同类祖先的实例的保留大小之和
+ */
+static bool compute_class_stats(heap_snapshot_t* snapshot) {
+    uint32_t n = snapshot->node_count;
+    uint32_t* child_start = (uint32_t*)calloc((size_t)n + 1, sizeof(uint32_t));
+    uint32_t* children = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t* stack = (uint32_t*)malloc((size_t)n * 2 * sizeof(uint32_t));
+    uint32_t* active = (uint32_t*)calloc(snapshot->class_count + 1, sizeof(uint32_t));
+    if (!child_start || !children || !stack || !active) {
+        free(child_start);
+        free(children);
+        free(stack);
+        free(active);
+        return false;
+    }
+    
+    for (uint32_t node = 1; node < n; node++) {
+        heap_class_t* cls = &snapshot->classes[snapshot->nodes[node].class_index];
+        if (snapshot->post_number[node] == UNDEFINED) {
+            cls->unreachable_objects++;
+            continue;
+        }
+        cls->objects++;
+        cls->shallow += snapshot->nodes[node].block_size;
+        child_start[snapshot->idom[node] + 1]++;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        child_start[i + 1] += child_start[i];
+    }
+    uint32_t* fill = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    if (!fill) {
+        free(child_start);
+        free(children);
+        free(stack);
+        free(active);
+        return false;
+    }
+    memcpy(fill, child_start, (size_t)n * sizeof(uint32_t));
+    for (uint32_t node = 1; node < n; node++) {
+        if (snapshot->post_number[node] != UNDEFINED) {
+            children[fill[snapshot->idom[node]]++] = node;
+        }
+    }
+    
+    // 栈元素：节点下标，最高位表示退出
+    const uint32_t exit_bit = 0x80000000U;
+    size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        uint32_t item = stack[--depth];
+        uint32_t node = item & ~exit_bit;
+        uint32_t class_index = node ? snapshot->nodes[node].class_index : 0;
+        if (item & exit_bit) {
+            active[class_index]--;
+            continue;
+        }
+        if (node != 0) {
+            if (active[class_index] == 0) {
+                snapshot->classes[class_index].retained += snapshot->retained[node];
+            }
+            active[class_index]++;
+            stack[depth++] = node | exit_bit;
+        }
+        for (uint32_t c = child_start[node]; c < child_start[node + 1]; c++) {
+            stack[depth++] = children[c];
+        }
+    }
+    
+    free(child_start);
+    free(children);
+    free(stack);
+    free(active);
+    free(fill);
+    return true;
+}
+
+static void print_preview(const char* text, uint32_t length) {
+    putchar('"');
+    for (uint32_t i = 0; i < length && i < STRING_PREVIEW; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c < 0x20) {
+            printf("\\x%02x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    printf(length > STRING_PREVIEW ? "\"...(%u bytes)" : "\"", length);
+}
+
+static const heap_snapshot_t* g_sort_snapshot;  // qsort比较函数使用
+
+static int compare_class_retained(const void* a, const void* b) {
+    const heap_class_t* x = &g_sort_snapshot->classes[*(const uint32_t*)a];
+    const heap_class_t* y = &g_sort_snapshot->classes[*(const uint32_t*)b];
+    if (x->retained != y->retained) {
+        return x->retained < y->retained ? 1 : -1;
+    }
+    return x->shallow < y->shallow ? 1 : (x->shallow > y->shallow ? -1 : 0);
+}
+
+static int compare_node_retained(const void* a, const void* b) {
+    uint64_t x = g_sort_snapshot->retained[*(const uint32_t*)a];
+    uint64_t y = g_sort_snapshot->retained[*(const uint32_t*)b];
+    return x < y ? 1 : (x > y ? -1 : 0);
+}
+
+static int compare_string_content(const void* a, const void* b) {
+    const heap_node_t* x = &g_sort_snapshot->nodes[*(const uint32_t*)a];
+    const heap_node_t* y = &g_sort_snapshot->nodes[*(const uint32_t*)b];
+    if (x->payload_length != y->payload_length) {
+        return x->payload_length < y->payload_length ? -1 : 1;
+    }
+    return memcmp(x->payload, y->payload, x->payload_length);
+}
+
+// 重复字符串分组
+typedef struct {
+    uint32_t first;                 // 组内第一个节点
+    uint32_t count;                 // 份数
+    uint64_t wasted;                // 除一份外其余副本占用的字节数
+} string_group_t;
+
+static int compare_group_wasted(const void* a, const void* b) {
+    const string_group_t* x = (const string_group_t*)a;
+    const string_group_t* y = (const string_group_t*)b;
+    return x->wasted < y->wasted ? 1 : (x->wasted > y->wasted ? -1 : 0);
+}
+
+static void print_report(heap_snapshot_t* snapshot, const char* path, uint32_t top) {
+    const j2me_heap_dump_header_t* header = &snapshot->header;
+    g_sort_snapshot = snapshot;
+    
+    uint64_t unreachable_bytes = 0;
+    for (uint32_t node = 1; node < snapshot->node_count; node++) {
+        if (snapshot->post_number[node] == UNDEFINED) {
+            unreachable_bytes += snapshot->nodes[node].block_size;
+        }
+    }
+    
+    time_t timestamp = (time_t)header->timestamp;
+    char time_text[64];
+    strftime(time_text, sizeof(time_text), "%Y-%m-%d %H:%M:%S", localtime(&timestamp));
+    
+    printf("=== 堆快照: %s ===\n", path);
+    printf("写出时间: %s\n", time_text);
+    printf("堆使用: %llu/%llu bytes\n", (unsigned long long)header->heap_used, (unsigned long long)header->heap_size);
+    printf("对象数: %u (可达 %u, 不可达 %u / %llu bytes)\n", header->object_count,
+           snapshot->reachable_count - 1, header->object_count - (snapshot->reachable_count - 1),
+           (unsigned long long)unreachable_bytes);
+    printf("根: %u\n\n", header->root_count);
+    
+    // 按类统计
+    uint32_t* order = (uint32_t*)malloc(((size_t)snapshot->class_count + snapshot->node_count + 1) * sizeof(uint32_t));
+    if (!order) {
+        return;
+    }
+    for (uint32_t i = 0; i < snapshot->class_count; i++) {
+        order[i] = i;
+    }
+    qsort(order, snapshot->class_count, sizeof(uint32_t), compare_class_retained);
+    printf("按类统计（按保留大小排序）:\n");
+    printf("%10s %12s %12s %10s  %s\n", "对象数", "浅大小", "保留大小", "不可达", "类");
+    for (uint32_t i = 0; i < snapshot->class_count; i++) {
+        heap_class_t* cls = &snapshot->classes[order[i]];
+        printf("%10llu %12llu %12llu %10llu  %s\n", (unsigned long long)cls->objects,
+               (unsigned long long)cls->shallow, (unsigned long long)cls->retained,
+               (unsigned long long)cls->unreachable_objects, cls->name);
+    }
+    
+    // 支配者
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < snapshot->reachable_count; i++) {
+        if (snapshot->postorder[i] != 0) {
+            order[count++] = snapshot->postorder[i];
+        }
+    }
+    qsort(order, count, sizeof(uint32_t), compare_node_retained);
+    printf("\n保留大小最大的对象（前%u个）:\n", count < top ? count : top);
+    printf("%12s %10s %10s %10s %10s  %s\n", "保留大小", "浅大小", "支配对象", "引用", "支配者", "类");
+    for (uint32_t i = 0; i < count && i < top; i++) {
+        uint32_t node = order[i];
+        uint32_t idom = snapshot->idom[node];
+        char idom_text[16];
+        if (idom == 0) {
+            snprintf(idom_text, sizeof(idom_text), "<root>");
+        } else {
+            snprintf(idom_text, sizeof(idom_text), "0x%x", snapshot->nodes[idom].ref);
+        }
+        printf("%12llu %10u %10u %#10x %10s  %s\n", (unsigned long long)snapshot->retained[node],
+               snapshot->nodes[node].block_size, snapshot->retained_count[node], snapshot->nodes[node].ref,
+               idom_text, snapshot->classes[snapshot->nodes[node].class_index].name);
+    }
+    
+    // 重复字符串（只看可达的String，不可达的下次回收时就会释放）
+    count = 0;
+    for (uint32_t node = 1; node < snapshot->node_count; node++) {
+        if (snapshot->post_number[node] != UNDEFINED &&
+            snapshot->classes[snapshot->nodes[node].class_index].class_id == J2ME_CLASS_ID_STRING) {
+            order[count++] = node;
+        }
+    }
+    qsort(order, count, sizeof(uint32_t), compare_string_content);
+    string_group_t* groups = (string_group_t*)malloc(((size_t)count + 1) * sizeof(string_group_t));
+    uint32_t group_count = 0;
+    uint64_t total_wasted = 0;
+    for (uint32_t i = 0; groups && i < count;) {
+        uint32_t j = i + 1;
+        uint64_t wasted = 0;
+        while (j < count && compare_string_content(&order[i], &order[j]) == 0) {
+            wasted += snapshot->nodes[order[j]].block_size;
+            j++;
+        }
+        if (j - i > 1) {
+            groups[group_count].first = order[i];
+            groups[group_count].count = j - i;
+            groups[group_count].wasted = wasted;
+            group_count++;
+            total_wasted += wasted;
+        }
+        i = j;
+    }
+    if (groups) {
+        qsort(groups, group_count, sizeof(string_group_t), compare_group_wasted);
+        printf("\n重复字符串: %u组, 可节省 %llu bytes（前%u组）:\n", group_count,
+               (unsigned long long)total_wasted, group_count < top ? group_count : top);
+        printf("%8s %12s  %s\n", "份数", "浪费字节", "内容");
+        for (uint32_t i = 0; i < group_count && i < top; i++) {
+            heap_node_t* node = &snapshot->nodes[groups[i].first];
+            printf("%8u %12llu  ", groups[i].count, (unsigned long long)groups[i].wasted);
+            print_preview(node->payload, node->payload_length);
+            putchar('\n');
+        }
+    }
+    
+    free(groups);
+    free(order);
+}
+
+static void free_snapshot(heap_snapshot_t* snapshot) {
+    for (uint32_t i = 0; snapshot->classes && i < snapshot->class_count; i++) {
+        free(snapshot->classes[i].name);
+    }
+    free(snapshot->classes);
+    free(snapshot->nodes);
+    free(snapshot->node_of_ref);
+    free(snapshot->postorder);
+    free(snapshot->post_number);
+    free(snapshot->idom);
+    free(snapshot->retained);
+    free(snapshot->retained_count);
+    free(snapshot->data);
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    uint32_t top = DEFAULT_TOP_COUNT;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            top = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (!path) {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "用法: %s <快照文件> [-n 条数]\n", argv[0]);
+        return 1;
+    }
+    
+    heap_snapshot_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    bool ok = load_snapshot(&snapshot, path) &&
+              compute_postorder(&snapshot) &&
+              compute_dominators(&snapshot) &&
+              compute_retained(&snapshot) &&
+              compute_class_stats(&snapshot);
+    if (ok) {
+        print_report(&snapshot, path, top);
+    } else {
+        fprintf(stderr, "分析失败: %s\n", path);
+    }
+    
+    free_snapshot(&snapshot);
+    return ok ? 0 : 1;
+}